@@ -29,10 +29,15 @@ public:
     // for the currently loaded map, regardless whether it is due for a save or not.
     // Call the "runAutosaveCheck" method to see if an autosave is overdue.
     virtual void performAutosave() = 0;
+
+    // The map file is written by a worker thread after performAutosave() returned.
+    // Blocks until any pending write is finished.
+    virtual void waitForPendingSave() = 0;
 };
 
 constexpr const char* const RKEY_AUTOSAVE_SNAPSHOTS_ENABLED = "user/ui/map/autoSaveSnapshots";
 constexpr const char* const RKEY_AUTOSAVE_SNAPSHOTS_FOLDER = "user/ui/map/snapshotFolder";
+constexpr const char* const RKEY_AUTOSAVE_SNAPSHOTS_DEDUPLICATED = "user/ui/map/deduplicateSnapshots";
 constexpr const char* const RKEY_AUTOSAVE_MAX_SNAPSHOT_FOLDER_SIZE = "user/ui/map/maxSnapshotFolderSize";
 constexpr const char* const RKEY_AUTOSAVE_SNAPSHOT_FOLDER_SIZE_HISTORY = "user/ui/map/snapshotFolderSizeHistory";
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "inode.h"
+#include "math/Vector3.h"
 
 namespace scene
 {
@@ -22,6 +23,12 @@ public:
 	 */
 	virtual void addOriginToChildren() = 0;
 	virtual void removeOriginFromChildren() = 0;
+
+	/**
+	 * Returns the translation removeOriginFromChildren() is applying
+	 * to the child primitives, without moving them.
+	 */
+	virtual Vector3 getChildPrimitiveOffset() const = 0;
 };
 typedef std::shared_ptr<GroupNode> GroupNodePtr;
 
@@ -111,6 +111,14 @@ public:
      */
     virtual ImagePtr imageFromVFS(const std::string& vfsPath) const = 0;
 
+    /**
+     * \brief
+     * Return the full VFS path (including prefix and extension) of the file
+     * imageFromVFS() would load for the given name, or an empty string if
+     * there is no such file.
+     */
+    virtual std::string findImageInVFS(const std::string& vfsPath) const = 0;
+
     /**
      * \brief
      * Load an image from a filesystem path.
@@ -2,6 +2,9 @@
 
 #include <set>
 #include <string>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
 #include <functional>
 #include "imodule.h"
 #include <sigc++/signal.h>
@@ -15,6 +18,140 @@ typedef std::shared_ptr<INode> INodePtr;
 // A list of named layers
 typedef std::set<int> LayerList;
 
+/**
+ * Compact set of layer IDs, one bit per layer. The bits of the IDs 0..63
+ * are stored inline, which covers the layers of almost every map, so checking
+ * two sets for a common layer usually is a single AND operation.
+ */
+class LayerBitset
+{
+private:
+    std::uint64_t _bits = 0;
+
+    // The bits of the layer IDs 64 and above, in blocks of 64
+    std::vector<std::uint64_t> _extraBits;
+
+public:
+    LayerBitset()
+    {}
+
+    LayerBitset(const LayerList& layers)
+    {
+        for (int layerId : layers)
+        {
+            set(layerId);
+        }
+    }
+
+    void set(int layerId, bool value = true)
+    {
+        if (layerId < 0) return;
+
+        auto mask = std::uint64_t(1) << (layerId % 64);
+
+        if (layerId < 64)
+        {
+            _bits = value ? _bits | mask : _bits & ~mask;
+            return;
+        }
+
+        auto index = static_cast<std::size_t>(layerId / 64 - 1);
+
+        if (index >= _extraBits.size())
+        {
+            if (!value) return; // nothing to clear
+
+            _extraBits.resize(index + 1, 0);
+        }
+
+        _extraBits[index] = value ? _extraBits[index] | mask : _extraBits[index] & ~mask;
+    }
+
+    bool test(int layerId) const
+    {
+        if (layerId < 64)
+        {
+            return layerId >= 0 && (_bits & (std::uint64_t(1) << layerId)) != 0;
+        }
+
+        auto index = static_cast<std::size_t>(layerId / 64 - 1);
+
+        return index < _extraBits.size() && (_extraBits[index] & (std::uint64_t(1) << (layerId % 64))) != 0;
+    }
+
+    void clear()
+    {
+        _bits = 0;
+        _extraBits.clear();
+    }
+
+    bool empty() const
+    {
+        return *this == LayerBitset();
+    }
+
+    // Returns true if the two sets share at least one layer
+    bool intersects(const LayerBitset& other) const
+    {
+        if ((_bits & other._bits) != 0) return true;
+
+        auto count = std::min(_extraBits.size(), other._extraBits.size());
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if ((_extraBits[i] & other._extraBits[i]) != 0) return true;
+        }
+
+        return false;
+    }
+
+    // Invokes the functor with each layer ID in this set, in ascending order
+    void foreachLayer(const std::function<void(int)>& functor) const
+    {
+        foreachBit(_bits, 0, functor);
+
+        for (std::size_t i = 0; i < _extraBits.size(); ++i)
+        {
+            foreachBit(_extraBits[i], static_cast<int>(i + 1) * 64, functor);
+        }
+    }
+
+    bool operator==(const LayerBitset& other) const
+    {
+        if (_bits != other._bits) return false;
+
+        // Missing blocks count as zero
+        auto count = std::max(_extraBits.size(), other._extraBits.size());
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto block = i < _extraBits.size() ? _extraBits[i] : 0;
+            auto otherBlock = i < other._extraBits.size() ? other._extraBits[i] : 0;
+
+            if (block != otherBlock) return false;
+        }
+
+        return true;
+    }
+
+    bool operator!=(const LayerBitset& other) const
+    {
+        return !operator==(other);
+    }
+
+private:
+    static void foreachBit(std::uint64_t block, int firstLayerId, const std::function<void(int)>& functor)
+    {
+        for (int bit = 0; block != 0; ++bit, block >>= 1)
+        {
+            if (block & 1)
+            {
+                functor(firstLayerId + bit);
+            }
+        }
+    }
+};
+
 /**
  * greebo: Interface of a Layered object.
  */
@@ -45,6 +182,11 @@ public:
      */
     virtual const LayerList& getLayers() const = 0;
 
+    /**
+     * Return the layers of this object as bitset, matching getLayers().
+     */
+    virtual const LayerBitset& getLayerBitset() const = 0;
+
 	/**
 	 * greebo: This assigns the given node to the given set of layers. Any previous
 	 * assignments of the node will be overwritten by this routine.
@@ -171,6 +313,13 @@ public:
 	 */
 	virtual bool updateNodeVisibility(const INodePtr& node) = 0;
 
+	/**
+	 * Keeps the per-layer member index of this manager up to date. This is called
+	 * by the nodes themselves when they are inserted into or removed from the scene
+	 * (with one of the sets being empty) and when their layers change while in the scene.
+	 */
+	virtual void onNodeLayersChanged(INode& node, const LayerBitset& oldLayers, const LayerBitset& newLayers) = 0;
+
 	/**
 	 * greebo: Sets the selection status of the entire layer.
 	 *
@@ -43,6 +43,9 @@ namespace selection
 namespace scene
 {
 
+// see imaterialusage.h
+class IMaterialUsageIndex;
+
 /**
  * greebo: A root node is the top level element of a map.
  * It also owns the namespace of the corresponding map.
@@ -89,6 +92,11 @@ public:
 	 */
 	virtual ILayerManager& getLayerManager() = 0;
 
+    /**
+     * The index of the materials used by the nodes of this map.
+     */
+    virtual IMaterialUsageIndex& getMaterialUsageIndex() = 0;
+
     // The UndoSystem of this map
     virtual IUndoSystem& getUndoSystem() = 0;
 
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <memory>
+#include <functional>
+
+namespace scene
+{
+
+class INode;
+typedef std::shared_ptr<INode> INodePtr;
+
+/**
+ * Reverse index of the materials used in a scene, from material name to the
+ * brushes, patches, models and particles using it. Each map root holds one,
+ * the nodes keep it up to date when they are inserted, removed or change
+ * their materials, such that material queries don't need to traverse the scene.
+ */
+class IMaterialUsageIndex
+{
+public:
+    enum UsageType
+    {
+        Face = 0,
+        Patch = 1,
+        Model = 2,
+        Particle = 3,
+    };
+
+    // Number of usages of a material, indexed by UsageType.
+    // Brushes count one usage per face, the other nodes one usage per material.
+    typedef std::array<std::size_t, 4> UsageCounts;
+
+    virtual ~IMaterialUsageIndex() {}
+
+    // Called by the nodes when they are inserted into or removed from the scene
+    virtual void addNode(INode& node) = 0;
+    virtual void removeNode(INode& node) = 0;
+
+    // Called by a node in the scene when the set of materials it is using has changed
+    virtual void onNodeMaterialsChanged(INode& node) = 0;
+
+    // Returns true if any node is using the given material (case-insensitive)
+    virtual bool isMaterialUsed(const std::string& material) = 0;
+
+    // Visits each node using the given material (case-insensitive)
+    virtual void foreachNodeUsingMaterial(const std::string& material,
+        const std::function<void(const INodePtr&)>& functor) = 0;
+
+    // Visits each used material name (as spelled by the nodes) with its usage counts
+    virtual void foreachUsedMaterial(
+        const std::function<void(const std::string&, const UsageCounts&)>& functor) = 0;
+};
+
+}
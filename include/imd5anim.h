@@ -55,7 +55,8 @@ public:
 	};
 	
 	// Each frame has a series of float values, applied to one or more animated components (x, y, z, yaw, pitch, roll)
-	typedef std::vector<float> FrameKeys;
+	// The values are pointing into a buffer holding all frames, valid as long as the animation is alive.
+	typedef const float* FrameKeys;
 
 	/**
 	 * Get the number of joints in this animation.
@@ -83,9 +84,15 @@ public:
 	virtual std::size_t getNumFrames() const = 0;
 
 	/**
-	 * Returns the float values of the given frame index.
+	 * Returns the number of float values stored for each frame.
 	 */
-	virtual const FrameKeys& getFrameKeys(std::size_t index) const = 0;
+	virtual std::size_t getNumAnimatedComponents() const = 0;
+
+	/**
+	 * Returns the float values of the given frame index,
+	 * which has getNumAnimatedComponents() elements.
+	 */
+	virtual FrameKeys getFrameKeys(std::size_t index) const = 0;
 };
 typedef std::shared_ptr<IMD5Anim> IMD5AnimPtr;
 
@@ -98,6 +105,17 @@ public:
 	 * the file does not exist or the anim was found to be invalid.
 	 */
 	virtual IMD5AnimPtr getAnim(const std::string& vfsPath) = 0;
+
+	// The joint keys of an anim at a given time, with the parent transforms applied
+	typedef std::vector<IMD5Anim::Key> Pose;
+	typedef std::shared_ptr<const Pose> PosePtr;
+
+	/**
+	 * Returns the pose of the given anim at the given time (in msec).
+	 * Recently evaluated poses are cached, such that models playing the
+	 * same anim in sync don't need to evaluate the joint hierarchy again.
+	 */
+	virtual PosePtr getPose(const IMD5AnimPtr& anim, std::size_t time) = 0;
 };
 
 const char* const MODULE_ANIMATIONCACHE("MD5AnimationCache");
@@ -84,6 +84,26 @@ public:
      * The surface index, must be in [0..getSurfaceCount())
 	 */
 	virtual const IModelSurface& getSurface(unsigned surfaceNum) const = 0;
+
+	/**
+	 * Returns the approximate number of bytes occupied by the geometry
+	 * of this model. This is used to keep the model cache within the
+	 * configured memory limit.
+	 */
+	virtual std::size_t getMemoryUsage() const
+	{
+		std::size_t usage = 0;
+
+		for (int i = 0; i < getSurfaceCount(); ++i)
+		{
+			const auto& surface = getSurface(static_cast<unsigned>(i));
+
+			usage += surface.getNumVertices() * sizeof(MeshVertex) +
+				surface.getNumTriangles() * 3 * sizeof(unsigned int);
+		}
+
+		return usage;
+	}
 };
 
 // Smart pointer typedefs
@@ -3,7 +3,11 @@
 #include "imodule.h"
 #include "imodel.h"
 #include "inode.h"
+#include "math/AABB.h"
+#include <functional>
+#include <set>
 #include <sigc++/signal.h>
+#include <sigc++/slot.h>
 
 namespace model 
 {
@@ -28,6 +32,50 @@ public:
 	 */
 	virtual scene::INodePtr getModelNode(const std::string& modelPath) = 0;
 
+	/**
+	 * Asynchronous variant of getModelNode(). If background loading is enabled
+	 * and the model is not in the cache yet, a lightweight placeholder node is
+	 * returned right away, while the model file is parsed by a worker thread.
+	 * The placeholder is sized to the given bounds (if they are valid).
+	 *
+	 * Once the model is available, the given callback is invoked on the main
+	 * thread (see processFinishedModelLoads()), the requester can then acquire
+	 * the real node through getModelNode() without blocking.
+	 *
+	 * If the model is already cached, or background loading is disabled, this
+	 * behaves like getModelNode() and the callback is never invoked.
+	 */
+	virtual scene::INodePtr getModelNodeAsync(const std::string& modelPath,
+		const AABB& placeholderBounds, const sigc::slot<void>& onLoaded) = 0;
+
+	/**
+	 * Queues the given models for parsing on the background workers, independently
+	 * of the background loading setting. Subsequent getModel() requests for these
+	 * paths pick up the parsed result, waiting for the worker if it's still busy.
+	 * Particles, absolute paths and models already in the cache are ignored.
+	 * The unrequested results are moved into the cache by processFinishedModelLoads().
+	 */
+	virtual void prefetchModels(const std::set<std::string>& modelPaths) = 0;
+
+	/**
+	 * Moves all models finished by the background workers into the cache
+	 * and invokes the callbacks passed to getModelNodeAsync().
+	 * Must be called from the main thread.
+	 */
+	virtual void processFinishedModelLoads() = 0;
+
+	// Blocks until all models queued for background loading have been parsed.
+	// The finished models still need to be picked up by processFinishedModelLoads().
+	virtual void waitForPendingModelLoads() = 0;
+
+	/**
+	 * Sets the function to call after models have been loaded in the background.
+	 * It is invoked on a worker thread, once per batch of finished models, and is
+	 * expected to queue a processFinishedModelLoads() call on the main thread.
+	 * Pass an empty function to remove the notifier.
+	 */
+	virtual void setBackgroundLoadNotifier(const std::function<void()>& notifier) = 0;
+
 	/**
 	 * greebo: Get the IModel object for the given VFS path. The request is cached,
 	 * so calling this with the same path twice will return the same
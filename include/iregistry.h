@@ -62,6 +62,8 @@ public:
 	virtual void exportToFile(const std::string& key, const std::string& filename = "-") = 0;
 
 	// Retrieves the nodelist corresponding for the specified XPath (wraps to xml::Document)
+	// The returned nodes might be modified by the caller, which needs to happen right
+	// away: get() caches the values of the keys until the registry is changed again.
 	virtual xml::NodeList findXPath(const std::string& path) = 0;
 
 	// Creates an empty key
@@ -99,6 +101,11 @@ public:
 
     /// Return a signal which will be emitted when a given key changes
     virtual sigc::signal<void> signalForKey(const std::string& key) const = 0;
+
+    /// Returns the number of XPath queries evaluated so far. Reading plain keys
+    /// like "user/ui/map/numMRU" through get() is answered from a hashed cache
+    /// after the first time, such reads are not adding to this number.
+    virtual std::size_t getXPathQueryCount() const = 0;
 };
 typedef std::shared_ptr<Registry> RegistryPtr;
 
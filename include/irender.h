@@ -190,6 +190,18 @@ public:
      */
     virtual void foreachRenderableTouchingBounds(const AABB& bounds, const ObjectVisitFunction& functor) = 0;
 
+    /**
+     * Returns the combined world bounds of all attached renderables,
+     * the returned AABB is invalid if there are no renderables.
+     */
+    virtual AABB getRenderableBounds() = 0;
+
+    /**
+     * Emitted when renderables are added or removed, or when any of them reports changed bounds.
+     * The renderer's light interaction index uses this to track moving entities.
+     */
+    virtual sigc::signal<void>& signal_renderableBoundsChanged() = 0;
+
     // Returns true if this entity produces shadows when lit (i.e.returns false when the entity has "noshadows" set to 1)
     virtual bool isShadowCasting() const = 0;
 };
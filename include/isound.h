@@ -4,6 +4,7 @@
 #include "ideclmanager.h"
 #include "igameresource.h"
 
+#include <cstdint>
 #include <vector>
 #include <functional>
 
@@ -76,6 +77,19 @@ public:
 	virtual const std::string& getDisplayFolder() = 0;
 };
 
+/// Receiver of the PCM data of a decoded sound file
+class IPcmSink
+{
+public:
+    virtual ~IPcmSink() {}
+
+    /// Called once before the first samples are delivered
+    virtual void setFormat(int numChannels, int sampleRate) = 0;
+
+    /// Receives the next block of interleaved signed 16 bit samples
+    virtual void writeSamples(const std::int16_t* samples, std::size_t numSamples) = 0;
+};
+
 constexpr const char* const MODULE_SOUNDMANAGER("SoundManager");
 
 /// Sound manager interface.
@@ -116,6 +130,12 @@ public:
     // Will throw a std::out_of_range exception if the path cannot be resolved
     virtual float getSoundFileDuration(const std::string& vfsPath) = 0;
 
+    // Decodes the given OGG file chunk by chunk into the sink, using the same
+    // decoder as the streamed playback but without any audio output.
+    // Will throw a std::out_of_range exception if the path cannot be resolved,
+    // and a std::runtime_error if the file cannot be decoded.
+    virtual void decodeSoundFile(const std::string& vfsPath, IPcmSink& sink) = 0;
+
     // Reloads all sound shader definitions from the VFS
     virtual void reloadSounds() = 0;
 };
@@ -3,6 +3,7 @@
 #include "irenderableobject.h"
 #include "igeometrystore.h"
 
+#include <memory>
 #include <vector>
 #include <limits>
 #include <cstdint>
@@ -31,6 +32,19 @@ public:
 
     // Returns the indices to render the triangle primitives
     virtual const std::vector<unsigned int>& getIndices() = 0;
+
+    // Surfaces returning the same non-empty handle are guaranteed to deliver
+    // identical vertices and indices, the renderer is storing that data only once.
+    // The handle is kept alive as long as the renderer is referencing the data.
+    virtual std::shared_ptr<const void> getSharedGeometry()
+    {
+        return {};
+    }
+
+    // Invoked by the renderer after it moved the surface data to a different
+    // storage location, which happens when the shared geometry handle changes.
+    virtual void onStorageLocationChanged()
+    {}
 };
 
 /**
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include <vector>
+#include <sigc++/signal.h>
+#include "imodule.h"
+#include "iimage.h"
+
+namespace shaders
+{
+
+/// Location of a material preview within the pages of the thumbnail atlas
+struct Thumbnail
+{
+    // Index of the atlas page holding the preview
+    std::size_t page = 0;
+
+    // Pixel rectangle covered by the preview, rows are starting at the top
+    std::size_t x = 0;
+    std::size_t y = 0;
+    std::size_t width = 0;
+    std::size_t height = 0;
+};
+
+/**
+ * Provides downsampled previews of the material editor images, such that
+ * browsing large texture folders doesn't need the full-resolution images.
+ *
+ * The previews are decoded on worker threads and packed into a few shared
+ * atlas pages the views are rendering from. Decoded previews are stored on
+ * disk, tagged with the size and modification time of their source image
+ * (or its containing archive).
+ *
+ * Only the thumbnails passed to the most recent requestThumbnails() call are
+ * guaranteed to stay in the atlas, others are evicted when it runs full.
+ */
+class IThumbnailManager :
+    public RegisterableModule
+{
+public:
+    enum class Status
+    {
+        NotRequested,   // not requested or evicted from the atlas
+        Pending,        // queued for loading
+        Ready,          // available in the atlas
+        Unavailable,    // no preview could be produced (missing or precompressed image)
+    };
+
+    virtual ~IThumbnailManager() {}
+
+    // Maximum width and height of a thumbnail in pixels
+    virtual std::size_t getThumbnailSize() const = 0;
+
+    /**
+     * Requests the thumbnails of the given materials, in order of priority.
+     * This replaces any previous request, queued materials missing in the
+     * given list are dropped from the queue.
+     */
+    virtual void requestThumbnails(const std::vector<std::string>& materialNames) = 0;
+
+    // Returns the state of the given material's thumbnail, the location is filled in if it is Ready
+    virtual Status getThumbnail(const std::string& materialName, Thumbnail& thumbnail) = 0;
+
+    // Returns true and fills in the dimensions of the full editor image if they are known
+    // without loading the image, i.e. from a previous thumbnail (which might be stored on disk)
+    virtual bool getImageSize(const std::string& materialName, std::size_t& width, std::size_t& height) = 0;
+
+    // The RGBA pixels of the atlas pages, all pages have the same size
+    virtual std::size_t getNumPages() const = 0;
+    virtual ImagePtr getPage(std::size_t index) const = 0;
+
+    // Incremented whenever the pixels of the given page are changed
+    virtual std::size_t getPageRevision(std::size_t index) const = 0;
+
+    /**
+     * Moves the thumbnails finished by the workers into the atlas and emits
+     * signal_thumbnailsChanged() if anything has been added.
+     * Must be called from the main thread.
+     */
+    virtual void processFinishedThumbnails() = 0;
+
+    // Blocks until the workers are done with all queued thumbnails.
+    // The results still need to be picked up by processFinishedThumbnails().
+    virtual void waitForPendingThumbnails() = 0;
+
+    /**
+     * Sets the function to call after thumbnails have been decoded by the workers.
+     * It is invoked on a worker thread, once per batch of finished thumbnails, and is
+     * expected to queue a processFinishedThumbnails() call on the main thread.
+     * Pass an empty function to remove the notifier.
+     */
+    virtual void setThumbnailLoadNotifier(const std::function<void()>& notifier) = 0;
+
+    // Emitted on the main thread after thumbnails have been added to the atlas
+    virtual sigc::signal<void>& signal_thumbnailsChanged() = 0;
+};
+
+}
+
+constexpr const char* const MODULE_THUMBNAILMANAGER("ThumbnailManager");
+
+inline shaders::IThumbnailManager& GlobalThumbnailManager()
+{
+    static module::InstanceReference<shaders::IThumbnailManager> _reference(MODULE_THUMBNAILMANAGER);
+    return _reference;
+}
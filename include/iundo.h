@@ -7,6 +7,7 @@
 #include "imap.h"
 #include <cstddef>
 #include <memory>
+#include <functional>
 #include <sigc++/signal.h>
 
 /** 
@@ -18,6 +19,16 @@ class IUndoMemento
 {
 public:
     virtual ~IUndoMemento() {}
+
+    /**
+     * Returns the approximate number of bytes occupied by this memento,
+     * including any heap memory it owns. This is used to keep the undo
+     * history within the configured memory limit.
+     */
+    virtual std::size_t getMemoryUsage() const
+    {
+        return sizeof(*this);
+    }
 };
 typedef std::shared_ptr<IUndoMemento> IUndoMementoPtr;
 
@@ -42,6 +53,14 @@ public:
     // May be used by Undoable objects to perform a post-undo cleanup.
     virtual void onOperationRestored()
     {}
+
+    // Optional method invoked once the operation the given state has been exported for
+    // is complete. Undoables may return a smaller memento storing only the differences
+    // to their current state, since they will be back in that state when it is imported.
+    virtual IUndoMementoPtr compactState(const IUndoMementoPtr& state) const
+    {
+        return state;
+    }
 };
 
 /**
@@ -86,6 +105,13 @@ public:
 	// it immediately from the stack, therefore it never existed.
 	virtual void cancel() = 0;
 
+    // Returns the approximate number of bytes occupied by all recorded undo and redo operations
+    virtual std::size_t getMemoryUsage() const = 0;
+
+    // Invokes the given functor for each recorded undo operation, starting with the oldest one,
+    // passing the operation name and its approximate memory usage in bytes
+    virtual void foreachUndoOperation(const std::function<void(const std::string&, std::size_t)>& functor) const = 0;
+
     enum class EventType
     {
         OperationRecorded,
@@ -7,14 +7,10 @@ uniform sampler2D	u_attenuationmap_xy;
 uniform sampler2D	u_attenuationmap_z;
 uniform sampler2D	u_ShadowMap;
 
-uniform vec3    u_LocalViewOrigin;
-uniform vec3    u_WorldUpLocal; // world 0,0,1 direction in local space
-uniform vec3    u_LocalLightOrigin; // Light origin in local space
 uniform vec3    u_LightColour;  // the RGB colour as defined on the light entity
 uniform float   u_LightScale;
 uniform vec4    u_ColourModulation;
 uniform vec4    u_ColourAddition;
-uniform mat4    u_ObjectTransform;     // object to world
 
 // Defines the region within the shadow map atlas containing the depth information of the current light
 uniform vec4        u_ShadowMapRect; // x,y,w,h
@@ -35,6 +31,11 @@ varying vec4 var_Colour; // colour to be multiplied on the final fragment
 varying vec3 var_WorldLightDirection; // direction the light is coming from in world space
 varying vec3 var_LocalViewerDirection; // viewer direction in local space
 
+flat in vec3 var_LocalViewOrigin;  // view origin in local space
+flat in vec3 var_LocalLightOrigin; // light origin in local space
+flat in vec3 var_WorldUpLocal;     // world 0,0,1 direction in local space
+flat in mat3 var_ObjectToWorld;    // rotation and scale of the object transform
+
 // Function ported from TDM tdm_shadowmaps.glsl, determining the cube map face for the given direction
 vec3 CubeMapDirectionToUv(vec3 v, out int faceIdx)
 {
@@ -132,10 +133,10 @@ void main()
         vec4 lightParms = vec4(.7, 1.8, 10.0, 30.0);
 
         // compute view direction in tangent space
-        vec3 localV = normalize(var_mat_os2ts * (u_LocalViewOrigin - var_vertex));
+        vec3 localV = normalize(var_mat_os2ts * (var_LocalViewOrigin - var_vertex));
 
         // compute light direction in tangent space
-        vec3 localL = normalize(var_mat_os2ts * (u_LocalLightOrigin - var_vertex));
+        vec3 localL = normalize(var_mat_os2ts * (var_LocalLightOrigin - var_vertex));
 
         vec3 RawN = normalize(bumpTexel.xyz);
         vec3 N = var_mat_os2ts * RawN;
@@ -172,7 +173,7 @@ void main()
             float maxAbsL = max(absL.x, max(absL.y, absL.z));
             float centerFragZ = maxAbsL;
 
-            vec3 normal = mat3(u_ObjectTransform) * N;
+            vec3 normal = var_ObjectToWorld * N;
 
             float lightFallAngle = -dot(normal, L);
             float errorMargin = 5.0 * maxAbsL / ( shadowMapResolution * max(lightFallAngle, 0.1) );
@@ -192,13 +193,13 @@ void main()
         vec3 N = normalize(var_mat_os2ts * localNormal);
 
         vec3 light1 = vec3(.5); // directionless half
-        light1 += max(dot(N, u_WorldUpLocal) * (1. - specular) * .5, 0);
+        light1 += max(dot(N, var_WorldUpLocal) * (1. - specular) * .5, 0);
 
         // Calculate specularity
         vec3 nViewDir = normalize(var_LocalViewerDirection);
         vec3 reflect = - (nViewDir - 2 * N * dot(N, nViewDir));
 
-        float spec = max(dot(reflect, u_WorldUpLocal), 0);
+        float spec = max(dot(reflect, var_WorldUpLocal), 0);
         float specPow = clamp((spec * spec), 0.0, 1.1);
         light1 += vec3(spec * specPow * specPow) * specular * 1.0;
 
@@ -10,9 +10,12 @@ in vec4 attr_Colour;    // bound to attribute 12 in source
 uniform vec4 u_ColourModulation;    // vertex colour weight
 uniform vec4 u_ColourAddition;      // constant additive vertex colour value
 uniform mat4 u_ModelViewProjection; // combined modelview and projection matrix
-uniform mat4 u_ObjectTransform;     // object to world
 uniform vec3 u_WorldLightOrigin;    // light origin in world space
-uniform vec3 u_LocalViewOrigin;     // view origin in local space
+uniform vec3 u_WorldViewOrigin;     // view origin in world space
+
+// Object to world transforms and their inverse, indexed by gl_InstanceID
+uniform mat4 u_ObjectTransforms[16];
+uniform mat4 u_InverseObjectTransforms[16];
 
 // Texture Matrices (the two top rows of each)
 uniform vec4 u_DiffuseTextureMatrix[2];
@@ -34,9 +37,23 @@ varying vec4 var_Colour; // colour to be multiplied on the final fragment
 varying vec3 var_WorldLightDirection; // direction the light is coming from in world space
 varying vec3 var_LocalViewerDirection; // viewer direction in local space
 
+flat out vec3 var_LocalViewOrigin;  // view origin in local space
+flat out vec3 var_LocalLightOrigin; // light origin in local space
+flat out vec3 var_WorldUpLocal;     // world 0,0,1 direction in local space
+flat out mat3 var_ObjectToWorld;    // rotation and scale of the object transform
+
 void main()
 {
-    vec4 worldVertex = u_ObjectTransform * attr_Position;
+    mat4 worldToObject = u_InverseObjectTransforms[gl_InstanceID];
+    mat4 objectToWorld = u_ObjectTransforms[gl_InstanceID];
+    vec4 worldVertex = objectToWorld * attr_Position;
+    var_ObjectToWorld = mat3(objectToWorld);
+
+    // Move the viewer and light origin into the object's local space,
+    // world up is needed for ambient lights
+    var_LocalViewOrigin = (worldToObject * vec4(u_WorldViewOrigin, 1)).xyz;
+    var_LocalLightOrigin = (worldToObject * vec4(u_WorldLightOrigin, 1)).xyz;
+    var_WorldUpLocal = worldToObject[2].xyz;
 
 	// transform vertex position into homogenous clip-space
 	gl_Position = u_ModelViewProjection * worldVertex;
@@ -68,7 +85,7 @@ void main()
     );
 
     // Calculate the viewer direction in local space (attr_Position is already in local space)
-    var_LocalViewerDirection = u_LocalViewOrigin - attr_Position.xyz;
+    var_LocalViewerDirection = var_LocalViewOrigin - attr_Position.xyz;
 
     // Vertex colour factor
     var_Colour = (attr_Colour * u_ColourModulation + u_ColourAddition);
@@ -4,7 +4,7 @@ in vec4 attr_Position; // bound to attribute 0 in source, in object space
 in vec4 attr_TexCoord; // bound to attribute 8 in source
 
 uniform vec3 u_LightOrigin;     // light origin in world coords
-uniform mat4 u_ObjectTransform; // object transform (object2world)
+uniform mat4 u_ObjectTransforms[16]; // object transforms (object2world), one for every 6 instances
 
 // The two top-rows of the diffuse stage texture transformation matrix
 uniform vec4 u_DiffuseTextureMatrix[2];
@@ -53,16 +53,20 @@ const vec4 ClipPlanes[4] = vec4[4]
 
 void main()
 {
+    // Every object is rendered 6 times, once for each cubemap face
+    int object = gl_InstanceID / 6;
+    int face = gl_InstanceID % 6;
+
     // Transform the model vertex to world space, then subtract the light origin
     // to move the vertex into light space (with the light residing at 0,0,0)
-    vec4 lightSpacePos = u_ObjectTransform * attr_Position;
+    vec4 lightSpacePos = u_ObjectTransforms[object] * attr_Position;
     lightSpacePos.xyz -= u_LightOrigin;
 
-    // Render the vertex 6 times, once for each cubemap face (gl_InstanceID = [0..5])
+    // Rotate the vertex into the cubemap face (face = [0..5])
     // This is just a rotation, no scaling or projection involved
-    vec4 fragPos = vec4(cubicTransformations[gl_InstanceID] * lightSpacePos.xyz, 1);
+    vec4 fragPos = vec4(cubicTransformations[face] * lightSpacePos.xyz, 1);
 
-    gl_Position.x = fragPos.x / 6 + fragPos.z * 5/6 - fragPos.z / 3 * gl_InstanceID;
+    gl_Position.x = fragPos.x / 6 + fragPos.z * 5/6 - fragPos.z / 3 * face;
     gl_Position.y = fragPos.y;
     gl_Position.z = -fragPos.z - 2;
     gl_Position.w = -fragPos.z;
@@ -2,7 +2,6 @@
 
 uniform sampler2D   u_Diffuse;
 uniform float       u_AlphaTest;
-uniform mat4        u_ObjectTransform;
 
 // The final diffuse texture coordinate at this vertex, calculated in the vertex shader
 varying vec2 var_TexDiffuse;
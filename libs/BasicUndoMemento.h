@@ -1,10 +1,40 @@
 #pragma once
 
 #include "iundo.h"
+#include <string>
+#include <vector>
+#include <list>
 
 namespace undo
 {
 
+// Returns the approximate amount of heap memory owned by the given object,
+// not including sizeof(T) itself. Overloads are provided for the container
+// types that are commonly stored in undo mementos.
+template<typename T>
+inline std::size_t getHeapMemoryUsage(const T&)
+{
+    return 0;
+}
+
+inline std::size_t getHeapMemoryUsage(const std::string& str)
+{
+    return str.capacity();
+}
+
+template<typename T>
+inline std::size_t getHeapMemoryUsage(const std::vector<T>& vector)
+{
+    return vector.capacity() * sizeof(T);
+}
+
+template<typename T>
+inline std::size_t getHeapMemoryUsage(const std::list<T>& list)
+{
+    // Each list element is stored in a node with two sibling pointers
+    return list.size() * (sizeof(T) + 2 * sizeof(void*));
+}
+
 /**
  * An UndoMemento implementation capable of holding a single
  * copyable object, which is stored by value.
@@ -23,6 +53,11 @@ public:
 	{
 		return _data;
 	}
+
+    std::size_t getMemoryUsage() const override
+    {
+        return sizeof(*this) + getHeapMemoryUsage(_data);
+    }
 };
 
 } // namespace
@@ -0,0 +1,216 @@
+#pragma once
+
+#include "iundo.h"
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace undo
+{
+
+// Serialised form of an undoable's state
+using StateBuffer = std::vector<std::uint8_t>;
+
+// Thrown if a serialised state can't be restored
+class InvalidStateError :
+    public std::runtime_error
+{
+public:
+    InvalidStateError(const std::string& what) :
+        std::runtime_error(what)
+    {}
+};
+
+inline std::size_t hashState(const StateBuffer& buffer)
+{
+    return std::hash<std::string_view>()(std::string_view(reinterpret_cast<const char*>(buffer.data()), buffer.size()));
+}
+
+// Appends the raw bytes of the given value to the buffer
+template<typename T>
+inline void writeState(StateBuffer& buffer, const T& value)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be written as raw bytes");
+
+    auto offset = buffer.size();
+    buffer.resize(offset + sizeof(T));
+    std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+inline void writeState(StateBuffer& buffer, const std::string& str)
+{
+    writeState(buffer, static_cast<std::uint64_t>(str.size()));
+    buffer.insert(buffer.end(), str.begin(), str.end());
+}
+
+/**
+ * Reads back the values written by writeState(), in the same order.
+ * Throws InvalidStateError when reading past the end of the buffer.
+ */
+class StateReader
+{
+private:
+    const StateBuffer& _buffer;
+    std::size_t _offset;
+
+public:
+    StateReader(const StateBuffer& buffer) :
+        _buffer(buffer),
+        _offset(0)
+    {}
+
+    template<typename T>
+    void read(T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be read as raw bytes");
+
+        ensureAvailable(sizeof(T));
+        std::memcpy(&value, _buffer.data() + _offset, sizeof(T));
+        _offset += sizeof(T);
+    }
+
+    void read(std::string& str)
+    {
+        std::uint64_t size;
+        read(size);
+
+        ensureAvailable(size);
+        str.assign(reinterpret_cast<const char*>(_buffer.data() + _offset), static_cast<std::size_t>(size));
+        _offset += str.size();
+    }
+
+private:
+    void ensureAvailable(std::uint64_t size) const
+    {
+        if (size > _buffer.size() - _offset)
+        {
+            throw InvalidStateError("Serialised state is truncated");
+        }
+    }
+};
+
+/**
+ * A memento storing only the bytes of a serialised state which differ
+ * from the state the undoable is in right after the operation.
+ *
+ * Undo and redo operations are always restored in reverse order, so by
+ * the time this memento is imported the undoable is back in exactly that
+ * state, and applying the stored byte runs to its serialised current
+ * state yields the full state again. The size and hash of that state are
+ * stored along with the runs, in case the undoable has been changed
+ * without saving its state to the undo system.
+ */
+class DeltaUndoMemento final :
+    public IUndoMemento
+{
+private:
+    // Equal stretches shorter than this are stored as part of the surrounding run,
+    // since that's cheaper than starting a new one
+    constexpr static std::size_t MinGap = 2 * sizeof(std::uint32_t);
+
+    // The size of the full state, followed by (offset, length, bytes) runs
+    StateBuffer _data;
+
+    // The state the runs are applied to
+    std::size_t _baseSize;
+    std::size_t _baseHash;
+
+public:
+    DeltaUndoMemento(const StateBuffer& state, const StateBuffer& current) :
+        _baseSize(current.size()),
+        _baseHash(hashState(current))
+    {
+        writeState(_data, static_cast<std::uint32_t>(state.size()));
+
+        auto isDifferent = [&](std::size_t i)
+        {
+            return i >= current.size() || state[i] != current[i];
+        };
+
+        for (std::size_t i = 0; i < state.size();)
+        {
+            if (!isDifferent(i))
+            {
+                ++i;
+                continue;
+            }
+
+            auto start = i;
+            auto end = i + 1;
+
+            for (auto j = end; j < state.size() && j - end < MinGap; ++j)
+            {
+                if (isDifferent(j))
+                {
+                    end = j + 1;
+                }
+            }
+
+            writeState(_data, static_cast<std::uint32_t>(start));
+            writeState(_data, static_cast<std::uint32_t>(end - start));
+            _data.insert(_data.end(), state.begin() + start, state.begin() + end);
+
+            i = end;
+        }
+
+        _data.shrink_to_fit();
+    }
+
+    // Reconstructs the full state from the serialised current state. Throws InvalidStateError
+    // if the given state is not the one this memento has been created against.
+    StateBuffer apply(const StateBuffer& current) const
+    {
+        if (current.size() != _baseSize || hashState(current) != _baseHash)
+        {
+            throw InvalidStateError("Current state doesn't match the base of the undo delta");
+        }
+
+        std::uint32_t size;
+        std::memcpy(&size, _data.data(), sizeof(size));
+
+        StateBuffer state(current);
+        state.resize(size);
+
+        for (auto offset = sizeof(size); offset < _data.size();)
+        {
+            std::uint32_t start, length;
+            std::memcpy(&start, _data.data() + offset, sizeof(start));
+            std::memcpy(&length, _data.data() + offset + sizeof(start), sizeof(length));
+            offset += sizeof(start) + sizeof(length);
+
+            std::memcpy(state.data() + start, _data.data() + offset, length);
+            offset += length;
+        }
+
+        return state;
+    }
+
+    std::size_t getMemoryUsage() const override
+    {
+        return sizeof(*this) + _data.capacity();
+    }
+};
+
+/**
+ * Returns a delta memento of the given full state against the current one,
+ * or the full memento itself if the delta doesn't turn out any smaller.
+ */
+inline IUndoMementoPtr createDeltaMemento(const IUndoMementoPtr& fullMemento,
+    const StateBuffer& state, const StateBuffer& current)
+{
+    auto delta = std::make_shared<DeltaUndoMemento>(state, current);
+
+    if (delta->getMemoryUsage() < fullMemento->getMemoryUsage())
+    {
+        return delta;
+    }
+
+    return fullMemento;
+}
+
+} // namespace
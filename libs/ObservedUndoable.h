@@ -1,8 +1,12 @@
 #pragma once
 
 #include "iundo.h"
+#include "itextstream.h"
 #include <functional>
+#include <string>
+#include <type_traits>
 #include "BasicUndoMemento.h"
+#include "DeltaUndoMemento.h"
 
 namespace undo
 {
@@ -74,11 +78,48 @@ public:
 
 	void importState(const IUndoMementoPtr& state) override
 	{
-		save();
+		if constexpr (std::is_same_v<Copyable, std::string>)
+		{
+			if (auto delta = std::dynamic_pointer_cast<DeltaUndoMemento>(state); delta)
+			{
+				StateBuffer value;
+
+				try
+				{
+					value = delta->apply(StateBuffer(_object.begin(), _object.end()));
+				}
+				catch (const InvalidStateError& ex)
+				{
+					rError() << "Cannot restore state of " << _debugName << ": " << ex.what() << std::endl;
+					return;
+				}
+
+				save();
+				_importCallback(std::string(value.begin(), value.end()));
+				return;
+			}
+		}
 
+		save();
 		_importCallback(std::static_pointer_cast<BasicUndoMemento<Copyable> >(state)->data());
 	}
 
+	IUndoMementoPtr compactState(const IUndoMementoPtr& state) const override
+	{
+		// String values (like entity spawnargs) are stored as delta against the current value
+		if constexpr (std::is_same_v<Copyable, std::string>)
+		{
+			if (auto fullState = std::dynamic_pointer_cast<BasicUndoMemento<Copyable>>(state); fullState)
+			{
+				const auto& value = fullState->data();
+				return createDeltaMemento(state, StateBuffer(value.begin(), value.end()),
+					StateBuffer(_object.begin(), _object.end()));
+			}
+		}
+
+		return state;
+	}
+
     void onOperationRestored() override
     {
         if (_finishedCallback)
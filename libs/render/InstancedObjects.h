@@ -0,0 +1,60 @@
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <vector>
+#include "igeometrystore.h"
+#include "math/Matrix4.h"
+
+namespace render
+{
+
+/**
+ * Collects the transforms of oriented objects, grouped by their geometry slot.
+ * Objects sharing the same geometry (like all instances of a static model)
+ * can then be submitted using a single instanced draw call, the GLSL program
+ * picking the object transform from a uniform array using gl_InstanceID.
+ */
+class InstancedObjects
+{
+public:
+    // The number of transforms the instancing GLSL programs can take per draw call
+    static constexpr std::size_t MaxInstancesPerDraw = 16;
+
+private:
+    std::map<IGeometryStore::Slot, std::vector<Matrix4>> _transformsBySlot;
+
+public:
+    bool empty() const
+    {
+        return _transformsBySlot.empty();
+    }
+
+    void clear()
+    {
+        _transformsBySlot.clear();
+    }
+
+    void add(IGeometryStore::Slot slot, const Matrix4& objectTransform)
+    {
+        _transformsBySlot[slot].push_back(objectTransform);
+    }
+
+    // Invokes the given functor once per draw call, passing the geometry slot,
+    // a pointer to the first transform and the number of instances to draw
+    // (which is never larger than MaxInstancesPerDraw)
+    template<typename Functor>
+    void foreachDrawCall(const Functor& functor) const
+    {
+        for (const auto& [slot, transforms] : _transformsBySlot)
+        {
+            for (std::size_t first = 0; first < transforms.size(); first += MaxInstancesPerDraw)
+            {
+                functor(slot, transforms.data() + first,
+                    std::min(transforms.size() - first, MaxInstancesPerDraw));
+            }
+        }
+    }
+};
+
+}
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "math/Vector3.h"
+#include "math/Quaternion.h"
+#include "util/ParallelFor.h"
+#include "MeshVertex.h"
+
+namespace render
+{
+
+/**
+ * Joint transform in single precision, stored as the upper three rows
+ * of a 4x4 matrix (rotation followed by the translation column).
+ */
+struct JointMatrix
+{
+    float m[12];
+
+    // Constructs the matrix transforming a point like rotation.transformPoint(p) + origin
+    static JointMatrix fromRotationAndOrigin(const Quaternion& rotation, const Vector3& origin)
+    {
+        auto xx = rotation.x() * rotation.x();
+        auto yy = rotation.y() * rotation.y();
+        auto zz = rotation.z() * rotation.z();
+        auto ww = rotation.w() * rotation.w();
+
+        auto xy2 = rotation.x() * rotation.y() * 2;
+        auto xz2 = rotation.x() * rotation.z() * 2;
+        auto xw2 = rotation.x() * rotation.w() * 2;
+        auto yz2 = rotation.y() * rotation.z() * 2;
+        auto yw2 = rotation.y() * rotation.w() * 2;
+        auto zw2 = rotation.z() * rotation.w() * 2;
+
+        return JointMatrix
+        {{
+            static_cast<float>(ww + xx - yy - zz), static_cast<float>(xy2 - zw2), static_cast<float>(xz2 + yw2), static_cast<float>(origin.x()),
+            static_cast<float>(xy2 + zw2), static_cast<float>(ww - xx + yy - zz), static_cast<float>(yz2 - xw2), static_cast<float>(origin.y()),
+            static_cast<float>(xz2 - yw2), static_cast<float>(yz2 + xw2), static_cast<float>(ww - xx - yy + zz), static_cast<float>(origin.z()),
+        }};
+    }
+};
+
+/**
+ * Weights of a skinned mesh, flattened to a structure-of-arrays layout and
+ * sorted by vertex. Also holds the triangles adjacent to each vertex, such
+ * that normals can be rebuilt in a linear pass instead of scattering every
+ * triangle normal into its three vertices.
+ *
+ * Both tables are using the compressed row layout: the entries belonging to
+ * vertex n are found in the range [offsets[n], offsets[n+1]).
+ */
+class SkinningData
+{
+public:
+    std::vector<std::uint32_t> weightOffsets;
+    std::vector<std::uint32_t> joints;
+    std::vector<float> weights;
+    std::vector<float> offsetsX;
+    std::vector<float> offsetsY;
+    std::vector<float> offsetsZ;
+
+    std::vector<std::uint32_t> triangleOffsets;
+    std::vector<std::uint32_t> adjacentTriangles;
+
+    SkinningData() :
+        weightOffsets(1, 0)
+    {}
+
+    std::size_t getNumVertices() const
+    {
+        return weightOffsets.size() - 1;
+    }
+
+    // Adds a weight to the vertex currently being built
+    void addWeight(std::size_t joint, float weight, const Vector3& offset)
+    {
+        joints.push_back(static_cast<std::uint32_t>(joint));
+        weights.push_back(weight);
+        offsetsX.push_back(static_cast<float>(offset.x()));
+        offsetsY.push_back(static_cast<float>(offset.y()));
+        offsetsZ.push_back(static_cast<float>(offset.z()));
+    }
+
+    // Finishes the vertex currently being built, subsequent weights are assigned to the next one
+    void finishVertex()
+    {
+        weightOffsets.push_back(static_cast<std::uint32_t>(joints.size()));
+    }
+
+    // Builds the vertex-to-triangle table, to be called after all vertices have been added
+    void buildAdjacency(const std::vector<unsigned int>& indices)
+    {
+        auto numVertices = getNumVertices();
+        triangleOffsets.assign(numVertices + 1, 0);
+
+        for (auto index : indices)
+        {
+            ++triangleOffsets[index + 1];
+        }
+
+        for (std::size_t i = 0; i < numVertices; ++i)
+        {
+            triangleOffsets[i + 1] += triangleOffsets[i];
+        }
+
+        adjacentTriangles.resize(indices.size());
+        auto insertPosition = triangleOffsets;
+
+        // Triangles are inserted in ascending order, the normals are summed up in the same order as before
+        for (std::size_t i = 0; i < indices.size(); ++i)
+        {
+            adjacentTriangles[insertPosition[indices[i]]++] = static_cast<std::uint32_t>(i / 3);
+        }
+    }
+};
+
+// Meshes with fewer vertices than this are skinned on the calling thread alone
+constexpr std::size_t MIN_SKINNED_VERTICES_PER_THREAD = 4096;
+
+/**
+ * Writes the skinned position of every vertex to the given vertex array,
+ * which needs to be sized to the vertex count of the skinning data.
+ * Large meshes are split across several threads.
+ */
+inline void skinVertices(const SkinningData& data, const std::vector<JointMatrix>& jointMatrices,
+    std::vector<MeshVertex>& vertices)
+{
+    const auto* joints = data.joints.data();
+    const auto* weights = data.weights.data();
+    const auto* offsetsX = data.offsetsX.data();
+    const auto* offsetsY = data.offsetsY.data();
+    const auto* offsetsZ = data.offsetsZ.data();
+    const auto* matrices = jointMatrices.data();
+
+    util::parallelFor(data.getNumVertices(), [&](std::size_t v)
+    {
+        float x = 0, y = 0, z = 0;
+
+        for (auto w = data.weightOffsets[v]; w < data.weightOffsets[v + 1]; ++w)
+        {
+            const auto& m = matrices[joints[w]].m;
+            auto t = weights[w];
+
+            x += t * (m[0] * offsetsX[w] + m[1] * offsetsY[w] + m[2] * offsetsZ[w] + m[3]);
+            y += t * (m[4] * offsetsX[w] + m[5] * offsetsY[w] + m[6] * offsetsZ[w] + m[7]);
+            z += t * (m[8] * offsetsX[w] + m[9] * offsetsY[w] + m[10] * offsetsZ[w] + m[11]);
+        }
+
+        vertices[v].vertex.set(x, y, z);
+    }, MIN_SKINNED_VERTICES_PER_THREAD);
+}
+
+/**
+ * Rebuilds the normals of the given vertices using the adjacency table.
+ * The triangle normal buffer is passed in to avoid reallocating it every frame.
+ */
+inline void calculateVertexNormals(const SkinningData& data, const std::vector<unsigned int>& indices,
+    std::vector<MeshVertex>& vertices, std::vector<Vector3>& triangleNormals)
+{
+    auto numTriangles = indices.size() / 3;
+    triangleNormals.resize(numTriangles);
+
+    util::parallelFor(numTriangles, [&](std::size_t t)
+    {
+        const auto& a = vertices[indices[t * 3 + 0]].vertex;
+        const auto& b = vertices[indices[t * 3 + 1]].vertex;
+        const auto& c = vertices[indices[t * 3 + 2]].vertex;
+
+        auto cx = c.x() - a.x(), cy = c.y() - a.y(), cz = c.z() - a.z();
+        auto bx = b.x() - a.x(), by = b.y() - a.y(), bz = b.z() - a.z();
+
+        triangleNormals[t].set(cy * bz - cz * by, cz * bx - cx * bz, cx * by - cy * bx);
+    }, MIN_SKINNED_VERTICES_PER_THREAD);
+
+    const auto* adjacentTriangles = data.adjacentTriangles.data();
+    const auto* normals = triangleNormals.data();
+
+    util::parallelFor(data.getNumVertices(), [&](std::size_t v)
+    {
+        double x = 0, y = 0, z = 0;
+
+        for (auto i = data.triangleOffsets[v]; i < data.triangleOffsets[v + 1]; ++i)
+        {
+            const auto& normal = normals[adjacentTriangles[i]];
+
+            x += normal.x();
+            y += normal.y();
+            z += normal.z();
+        }
+
+        auto length = std::sqrt(x * x + y * y + z * z);
+
+        // Vertices without triangles or with cancelling normals keep the zero vector
+        if (length > 0)
+        {
+            x /= length;
+            y /= length;
+            z /= length;
+        }
+
+        vertices[v].normal.set(x, y, z);
+    }, MIN_SKINNED_VERTICES_PER_THREAD);
+}
+
+}
@@ -30,6 +30,9 @@ private:
     // The render entity the adapter is attached to
     IRenderEntity* _renderEntity;
 
+    // When attached to an entity, this is the shader holding the geometry
+    ShaderPtr _entityShader;
+
     // When attached to an entity, this is the backend storage handle
     IGeometryStore::Slot _storageLocation;
 
@@ -107,6 +110,7 @@ public:
 
         _renderEntity = entity;
         _renderEntity->addRenderable(shared_from_this(), shader.get());
+        _entityShader = shader;
         _storageLocation = shader->getSurfaceStorageLocation(_shaders[shader]);
     }
 
@@ -130,6 +134,15 @@ public:
         return _storageLocation;
     }
 
+    void onStorageLocationChanged() override
+    {
+        // The surface switched to different shared geometry, refresh the cached handle
+        if (_entityShader)
+        {
+            _storageLocation = _entityShader->getSurfaceStorageLocation(_shaders.at(_entityShader));
+        }
+    }
+
 private:
     void detachFromEntity()
     {
@@ -139,6 +152,7 @@ private:
             _renderEntity = nullptr;
         }
 
+        _entityShader.reset();
         _storageLocation = std::numeric_limits<IGeometryStore::Slot>::max();
     }
 
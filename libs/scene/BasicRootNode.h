@@ -10,6 +10,7 @@
 #include "inamespace.h"
 #include "UndoFileChangeTracker.h"
 #include "KeyValueStore.h"
+#include "MaterialUsageIndex.h"
 
 namespace scene
 {
@@ -30,6 +31,7 @@ private:
     selection::ISelectionSetManager::Ptr _selectionSetManager;
     ILayerManager::Ptr _layerManager;
     IUndoSystem::Ptr _undoSystem;
+    MaterialUsageIndex _materialUsageIndex;
     AABB _emptyAABB;
 
 public:
@@ -78,6 +80,11 @@ public:
         return *_layerManager;
     }
 
+    IMaterialUsageIndex& getMaterialUsageIndex() override
+    {
+        return _materialUsageIndex;
+    }
+
     IUndoSystem& getUndoSystem() override
     {
         return *_undoSystem;
@@ -244,6 +244,16 @@ void EntityNode::foreachRenderableTouchingBounds(const AABB& bounds,
     _renderObjects.foreachRenderableTouchingBounds(bounds, functor);
 }
 
+AABB EntityNode::getRenderableBounds()
+{
+    return _renderObjects.getBounds();
+}
+
+sigc::signal<void>& EntityNode::signal_renderableBoundsChanged()
+{
+    return _renderObjects.signal_boundsChanged();
+}
+
 bool EntityNode::isShadowCasting() const
 {
     return _isShadowCasting;
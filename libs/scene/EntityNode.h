@@ -151,6 +151,8 @@ public:
     virtual void foreachRenderable(const ObjectVisitFunction& functor) override;
     virtual void foreachRenderableTouchingBounds(const AABB& bounds,
         const ObjectVisitFunction& functor) override;
+    virtual AABB getRenderableBounds() override;
+    virtual sigc::signal<void>& signal_renderableBoundsChanged() override;
     virtual bool isShadowCasting() const override;
 
     // IMatrixTransform implementation
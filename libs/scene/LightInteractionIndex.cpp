@@ -0,0 +1,295 @@
+#include "LightInteractionIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace render
+{
+
+namespace
+{
+    // Entities covering more cells than this are checked against every light
+    constexpr std::size_t MaxCellsPerEntity = 64;
+
+    // Keep the cell coordinates within a sensible range for far-off or huge bounds
+    constexpr double MaxCellCoordinate = 1 << 20;
+}
+
+std::size_t LightInteractionIndex::CellRange::getNumCells() const
+{
+    return static_cast<std::size_t>(max.x - min.x + 1) *
+        static_cast<std::size_t>(max.y - min.y + 1) *
+        static_cast<std::size_t>(max.z - min.z + 1);
+}
+
+bool LightInteractionIndex::CellRange::contains(const CellKey& key) const
+{
+    return key.x >= min.x && key.x <= max.x &&
+        key.y >= min.y && key.y <= max.y &&
+        key.z >= min.z && key.z <= max.z;
+}
+
+LightInteractionIndex::LightInteractionIndex(double cellSize) :
+    _cellSize(cellSize),
+    _queryCount(0)
+{}
+
+LightInteractionIndex::~LightInteractionIndex()
+{
+    clear();
+}
+
+void LightInteractionIndex::addEntity(const IRenderEntityPtr& entity)
+{
+    auto* raw = entity.get();
+    auto& record = _entities.emplace(raw, EntityRecord{ raw }).first->second;
+
+    record.boundsChanged = entity->signal_renderableBoundsChanged().connect(
+        [this, raw]() { onEntityBoundsChanged(raw); });
+
+    // Sort it into the grid before the next query
+    _changedEntities.insert(raw);
+}
+
+void LightInteractionIndex::removeEntity(const IRenderEntityPtr& entity)
+{
+    auto found = _entities.find(entity.get());
+
+    if (found == _entities.end()) return;
+
+    auto& record = found->second;
+    record.boundsChanged.disconnect();
+
+    // The cached lists must not refer to this entity anymore
+    if (record.isInGrid)
+    {
+        invalidateLightsTouching(record.bounds);
+        removeFromGrid(record);
+    }
+
+    _changedEntities.erase(entity.get());
+    _entities.erase(found);
+
+    if (auto light = dynamic_cast<const RendererLight*>(entity.get()); light != nullptr)
+    {
+        _lights.erase(light);
+    }
+}
+
+void LightInteractionIndex::clear()
+{
+    for (auto& [_, record] : _entities)
+    {
+        record.boundsChanged.disconnect();
+    }
+
+    _entities.clear();
+    _cells.clear();
+    _largeEntities.clear();
+    _changedEntities.clear();
+    _lights.clear();
+}
+
+const std::vector<IRenderEntity*>& LightInteractionIndex::getInteractingEntities(
+    const RendererLight& light, const AABB& lightBounds)
+{
+    updateChangedEntities();
+
+    auto& record = _lights[&light];
+
+    if (record.isValid && record.bounds == lightBounds)
+    {
+        return record.entities;
+    }
+
+    record.bounds = lightBounds;
+    record.isValid = true;
+    record.entities.clear();
+
+    if (!lightBounds.isValid()) return record.entities;
+
+    findEntities(lightBounds, record.entities);
+
+    // Keep the order of the render system's entity set
+    std::sort(record.entities.begin(), record.entities.end());
+
+    return record.entities;
+}
+
+LightInteractionIndex::CellRange LightInteractionIndex::getCellRange(const AABB& bounds) const
+{
+    auto toCell = [&](double coordinate)
+    {
+        return static_cast<int>(std::clamp(std::floor(coordinate / _cellSize), -MaxCellCoordinate, MaxCellCoordinate));
+    };
+
+    auto min = bounds.getOrigin() - bounds.getExtents();
+    auto max = bounds.getOrigin() + bounds.getExtents();
+
+    return CellRange
+    {
+        CellKey{ toCell(min.x()), toCell(min.y()), toCell(min.z()) },
+        CellKey{ toCell(max.x()), toCell(max.y()), toCell(max.z()) }
+    };
+}
+
+void LightInteractionIndex::onEntityBoundsChanged(IRenderEntity* entity)
+{
+    // Entities are reporting every single change while being dragged around,
+    // defer the update until the next query
+    _changedEntities.insert(entity);
+}
+
+void LightInteractionIndex::updateChangedEntities()
+{
+    if (_changedEntities.empty()) return;
+
+    for (auto* entity : _changedEntities)
+    {
+        auto& record = _entities.at(entity);
+        auto newBounds = entity->getRenderableBounds();
+
+        if (record.isInGrid)
+        {
+            if (newBounds.isValid() && newBounds == record.bounds) continue; // nothing changed
+
+            invalidateLightsTouching(record.bounds);
+            removeFromGrid(record);
+        }
+
+        if (!newBounds.isValid()) continue; // no renderables, can't interact with any light
+
+        record.bounds = newBounds;
+        invalidateLightsTouching(record.bounds);
+        insertIntoGrid(record);
+    }
+
+    _changedEntities.clear();
+}
+
+void LightInteractionIndex::insertIntoGrid(EntityRecord& record)
+{
+    record.cells = getCellRange(record.bounds);
+    record.isLarge = record.cells.getNumCells() > MaxCellsPerEntity;
+    record.isInGrid = true;
+
+    if (record.isLarge)
+    {
+        _largeEntities.push_back(&record);
+        return;
+    }
+
+    for (auto x = record.cells.min.x; x <= record.cells.max.x; ++x)
+    {
+        for (auto y = record.cells.min.y; y <= record.cells.max.y; ++y)
+        {
+            for (auto z = record.cells.min.z; z <= record.cells.max.z; ++z)
+            {
+                _cells[CellKey{ x, y, z }].push_back(&record);
+            }
+        }
+    }
+}
+
+void LightInteractionIndex::removeFromGrid(EntityRecord& record)
+{
+    record.isInGrid = false;
+
+    if (record.isLarge)
+    {
+        _largeEntities.erase(std::remove(_largeEntities.begin(), _largeEntities.end(), &record), _largeEntities.end());
+        return;
+    }
+
+    for (auto x = record.cells.min.x; x <= record.cells.max.x; ++x)
+    {
+        for (auto y = record.cells.min.y; y <= record.cells.max.y; ++y)
+        {
+            for (auto z = record.cells.min.z; z <= record.cells.max.z; ++z)
+            {
+                auto cell = _cells.find(CellKey{ x, y, z });
+
+                if (cell == _cells.end()) continue;
+
+                auto& records = cell->second;
+                records.erase(std::remove(records.begin(), records.end(), &record), records.end());
+
+                if (records.empty())
+                {
+                    _cells.erase(cell);
+                }
+            }
+        }
+    }
+}
+
+void LightInteractionIndex::invalidateLightsTouching(const AABB& bounds)
+{
+    for (auto& [_, light] : _lights)
+    {
+        if (light.isValid && light.bounds.intersects(bounds))
+        {
+            light.isValid = false;
+        }
+    }
+}
+
+void LightInteractionIndex::findEntities(const AABB& bounds, std::vector<IRenderEntity*>& result)
+{
+    auto query = ++_queryCount;
+
+    auto visit = [&](EntityRecord& record)
+    {
+        if (record.lastQuery == query) return;
+
+        record.lastQuery = query;
+
+        if (record.bounds.intersects(bounds))
+        {
+            result.push_back(record.entity);
+        }
+    };
+
+    for (auto* record : _largeEntities)
+    {
+        visit(*record);
+    }
+
+    auto range = getCellRange(bounds);
+
+    // Huge lights are cheaper to check against the occupied cells only
+    if (range.getNumCells() > _cells.size())
+    {
+        for (auto& [key, records] : _cells)
+        {
+            if (!range.contains(key)) continue;
+
+            for (auto* record : records)
+            {
+                visit(*record);
+            }
+        }
+
+        return;
+    }
+
+    for (auto x = range.min.x; x <= range.max.x; ++x)
+    {
+        for (auto y = range.min.y; y <= range.max.y; ++y)
+        {
+            for (auto z = range.min.z; z <= range.max.z; ++z)
+            {
+                auto cell = _cells.find(CellKey{ x, y, z });
+
+                if (cell == _cells.end()) continue;
+
+                for (auto* record : cell->second)
+                {
+                    visit(*record);
+                }
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <sigc++/connection.h>
+#include "irender.h"
+#include "math/AABB.h"
+
+namespace render
+{
+
+/**
+ * Spatial index of the registered render entities, used by the lighting mode
+ * renderer to find the entities a light might be interacting with.
+ *
+ * Entities are sorted into a uniform grid by the bounds of their renderables,
+ * entities spanning too many cells (like worldspawn) are kept in a separate
+ * list which is checked for every light. Entities are re-inserted lazily
+ * after they report changed renderable bounds.
+ *
+ * The entity list of each light is cached between frames and is only
+ * rebuilt if the light bounds changed or an entity touching the old or new
+ * bounds of that light has been moved, added or removed.
+ */
+class LightInteractionIndex final
+{
+public:
+    constexpr static double DefaultCellSize = 512;
+
+private:
+    double _cellSize;
+
+    struct CellKey
+    {
+        int x;
+        int y;
+        int z;
+
+        bool operator==(const CellKey& other) const
+        {
+            return x == other.x && y == other.y && z == other.z;
+        }
+    };
+
+    struct CellKeyHash
+    {
+        std::size_t operator()(const CellKey& key) const
+        {
+            return static_cast<std::size_t>(key.x) * 73856093u ^
+                static_cast<std::size_t>(key.y) * 19349663u ^
+                static_cast<std::size_t>(key.z) * 83492791u;
+        }
+    };
+
+    struct CellRange
+    {
+        CellKey min;
+        CellKey max;
+
+        std::size_t getNumCells() const;
+        bool contains(const CellKey& key) const;
+    };
+
+    struct EntityRecord
+    {
+        IRenderEntity* entity;
+        sigc::connection boundsChanged;
+
+        // The bounds the entity is currently sorted in with
+        AABB bounds;
+        CellRange cells;
+        bool isLarge = false;
+        bool isInGrid = false;
+
+        // Used to visit each entity only once per query
+        std::size_t lastQuery = 0;
+    };
+
+    std::unordered_map<IRenderEntity*, EntityRecord> _entities;
+
+    std::unordered_map<CellKey, std::vector<EntityRecord*>, CellKeyHash> _cells;
+    std::vector<EntityRecord*> _largeEntities;
+
+    // Entities that need to be re-inserted before the next query
+    std::unordered_set<IRenderEntity*> _changedEntities;
+
+    std::size_t _queryCount;
+
+    struct LightRecord
+    {
+        AABB bounds;
+        bool isValid = false;
+        std::vector<IRenderEntity*> entities;
+    };
+
+    std::map<const RendererLight*, LightRecord> _lights;
+
+public:
+    LightInteractionIndex(double cellSize = DefaultCellSize);
+    ~LightInteractionIndex();
+
+    void addEntity(const IRenderEntityPtr& entity);
+
+    // Removes the entity from the index, lights are removed along with their cached entity lists
+    void removeEntity(const IRenderEntityPtr& entity);
+
+    void clear();
+
+    /**
+     * Returns the entities with renderables (potentially) touching the given
+     * light bounds, sorted by address. The returned reference stays valid
+     * until the next modification of the index.
+     */
+    const std::vector<IRenderEntity*>& getInteractingEntities(const RendererLight& light, const AABB& lightBounds);
+
+private:
+    CellRange getCellRange(const AABB& bounds) const;
+
+    void onEntityBoundsChanged(IRenderEntity* entity);
+
+    void updateChangedEntities();
+
+    void insertIntoGrid(EntityRecord& record);
+    void removeFromGrid(EntityRecord& record);
+
+    // Marks the cached entity lists of all lights touching the given bounds as outdated
+    void invalidateLightsTouching(const AABB& bounds);
+
+    void findEntities(const AABB& bounds, std::vector<IRenderEntity*>& result);
+};
+
+}
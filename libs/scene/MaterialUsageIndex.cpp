@@ -0,0 +1,236 @@
+#include "MaterialUsageIndex.h"
+
+#include "inode.h"
+#include "ipatch.h"
+#include "ibrush.h"
+#include "imodel.h"
+#include "iparticlenode.h"
+#include "iparticles.h"
+#include "iparticlestage.h"
+#include "string/case_conv.h"
+
+#include <vector>
+
+namespace scene
+{
+
+namespace
+{
+    // Determines the usage type of the given node, returns false if it isn't using any materials
+    bool getUsageType(const INodePtr& node, IMaterialUsageIndex::UsageType& type)
+    {
+        if (Node_isPatch(node))
+        {
+            type = IMaterialUsageIndex::Patch;
+            return true;
+        }
+
+        if (Node_isBrush(node))
+        {
+            type = IMaterialUsageIndex::Face;
+            return true;
+        }
+
+        if (std::dynamic_pointer_cast<particles::IParticleNode>(node))
+        {
+            type = IMaterialUsageIndex::Particle;
+            return true;
+        }
+
+        if (Node_isModel(node))
+        {
+            type = IMaterialUsageIndex::Model;
+            return true;
+        }
+
+        return false;
+    }
+
+    void collectMaterials(const INodePtr& node, IMaterialUsageIndex::UsageType type,
+        std::map<std::string, std::size_t>& materials)
+    {
+        switch (type)
+        {
+        case IMaterialUsageIndex::Patch:
+            materials[Node_getIPatch(node)->getShader()] = 1;
+            break;
+
+        case IMaterialUsageIndex::Face:
+        {
+            auto brush = Node_getIBrush(node);
+
+            for (std::size_t i = 0; i < brush->getNumFaces(); ++i)
+            {
+                ++materials[brush->getFace(i).getShader()];
+            }
+            break;
+        }
+
+        case IMaterialUsageIndex::Particle:
+        {
+            auto particleDef = std::dynamic_pointer_cast<particles::IParticleNode>(node)
+                ->getParticle()->getParticleDef();
+
+            if (!particleDef) break;
+
+            for (std::size_t i = 0; i < particleDef->getNumStages(); ++i)
+            {
+                materials[particleDef->getStage(i)->getMaterialName()] = 1;
+            }
+            break;
+        }
+
+        case IMaterialUsageIndex::Model:
+            for (const auto& material : Node_getModel(node)->getIModel().getActiveMaterials())
+            {
+                materials[material] = 1;
+            }
+            break;
+        }
+    }
+}
+
+void MaterialUsageIndex::addNode(INode& node)
+{
+    auto self = node.getSelf();
+
+    UsageType type;
+
+    if (!getUsageType(self, type)) return;
+
+    auto& indexed = _nodes[&node];
+    unindexMaterials(&node, indexed);
+
+    indexed.node = self;
+    indexed.type = type;
+
+    indexMaterials(&node, indexed);
+}
+
+void MaterialUsageIndex::removeNode(INode& node)
+{
+    auto found = _nodes.find(&node);
+
+    if (found == _nodes.end()) return;
+
+    unindexMaterials(&node, found->second);
+
+    _changedNodes.erase(&node);
+    _nodes.erase(found);
+}
+
+void MaterialUsageIndex::onNodeMaterialsChanged(INode& node)
+{
+    if (_nodes.count(&node) > 0)
+    {
+        _changedNodes.insert(&node);
+    }
+}
+
+bool MaterialUsageIndex::isMaterialUsed(const std::string& material)
+{
+    ensureUpToDate();
+
+    return _nodesByMaterial.count(string::to_lower_copy(material)) > 0;
+}
+
+void MaterialUsageIndex::foreachNodeUsingMaterial(const std::string& material,
+    const std::function<void(const INodePtr&)>& functor)
+{
+    ensureUpToDate();
+
+    auto found = _nodesByMaterial.find(string::to_lower_copy(material));
+
+    if (found == _nodesByMaterial.end()) return;
+
+    // Copy the node list, the functor might change the materials
+    std::vector<INodePtr> nodes;
+    nodes.reserve(found->second.size());
+
+    for (auto key : found->second)
+    {
+        if (auto node = _nodes[key].node.lock(); node)
+        {
+            nodes.push_back(node);
+        }
+    }
+
+    for (const auto& node : nodes)
+    {
+        functor(node);
+    }
+}
+
+void MaterialUsageIndex::foreachUsedMaterial(
+    const std::function<void(const std::string&, const UsageCounts&)>& functor)
+{
+    ensureUpToDate();
+
+    for (const auto& [material, counts] : _usageCounts)
+    {
+        functor(material, counts);
+    }
+}
+
+void MaterialUsageIndex::ensureUpToDate()
+{
+    for (auto key : _changedNodes)
+    {
+        auto& indexed = _nodes[key];
+
+        unindexMaterials(key, indexed);
+        indexMaterials(key, indexed);
+    }
+
+    _changedNodes.clear();
+}
+
+void MaterialUsageIndex::indexMaterials(INode* key, IndexedNode& indexed)
+{
+    auto node = indexed.node.lock();
+
+    if (!node) return;
+
+    collectMaterials(node, indexed.type, indexed.materials);
+
+    for (const auto& [material, count] : indexed.materials)
+    {
+        auto& counts = _usageCounts.emplace(material, UsageCounts{ 0, 0, 0, 0 }).first->second;
+        counts[indexed.type] += count;
+
+        _nodesByMaterial[string::to_lower_copy(material)].insert(key);
+    }
+}
+
+void MaterialUsageIndex::unindexMaterials(INode* key, IndexedNode& indexed)
+{
+    for (const auto& [material, count] : indexed.materials)
+    {
+        auto counts = _usageCounts.find(material);
+
+        if (counts != _usageCounts.end())
+        {
+            counts->second[indexed.type] -= count;
+
+            if (counts->second == UsageCounts{ 0, 0, 0, 0 })
+            {
+                _usageCounts.erase(counts);
+            }
+        }
+
+        auto nodes = _nodesByMaterial.find(string::to_lower_copy(material));
+
+        if (nodes == _nodesByMaterial.end()) continue;
+
+        nodes->second.erase(key);
+
+        if (nodes->second.empty())
+        {
+            _nodesByMaterial.erase(nodes);
+        }
+    }
+
+    indexed.materials.clear();
+}
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <map>
+#include <set>
+#include "imaterialusage.h"
+
+namespace scene
+{
+
+/**
+ * Default implementation of the material usage index held by the map roots.
+ *
+ * Nodes reporting a material change are only marked, their materials
+ * are read again the next time the index is queried, such that applying
+ * a material to many faces of the same brush is not re-indexing it each time.
+ */
+class MaterialUsageIndex final :
+    public IMaterialUsageIndex
+{
+private:
+    struct IndexedNode
+    {
+        std::weak_ptr<INode> node;
+        UsageType type;
+
+        // Number of usages per material name
+        std::map<std::string, std::size_t> materials;
+    };
+
+    std::map<INode*, IndexedNode> _nodes;
+
+    // Nodes whose materials need to be read again
+    std::set<INode*> _changedNodes;
+
+    // Usages per material name, as spelled by the nodes
+    std::map<std::string, UsageCounts> _usageCounts;
+
+    // Nodes per lowercase material name
+    std::map<std::string, std::set<INode*>> _nodesByMaterial;
+
+public:
+    void addNode(INode& node) override;
+    void removeNode(INode& node) override;
+    void onNodeMaterialsChanged(INode& node) override;
+
+    bool isMaterialUsed(const std::string& material) override;
+
+    void foreachNodeUsingMaterial(const std::string& material,
+        const std::function<void(const INodePtr&)>& functor) override;
+
+    void foreachUsedMaterial(
+        const std::function<void(const std::string&, const UsageCounts&)>& functor) override;
+
+private:
+    void ensureUpToDate();
+    void indexMaterials(INode* key, IndexedNode& indexed);
+    void unindexMaterials(INode* key, IndexedNode& indexed);
+};
+
+}
@@ -1,8 +1,10 @@
 #include "ModelKey.h"
 
 #include <functional>
+#include <sigc++/bind.h>
 
 #include "entitylib.h"
+#include "scene/Entity.h"
 #include "imodelcache.h"
 #include "modelskin.h"
 #include "string/replace.h"
@@ -11,7 +13,8 @@
 ModelKey::ModelKey(scene::INode& parentNode) :
 	_parentNode(parentNode),
 	_active(true),
-	_undo(_model, std::bind(&ModelKey::importState, this, std::placeholders::_1))
+	_undo(_model, std::bind(&ModelKey::importState, this, std::placeholders::_1),
+        std::bind(&ModelKey::onUndoRedoOperationFinished, this), "ModelKey")
 {}
 
 const scene::INodePtr& ModelKey::getNode() const
@@ -80,9 +83,12 @@ void ModelKey::attachModelNode()
         subscribeToModelDef(modelDef);
     }
 
-	// We have a non-empty model key, send the request to
-	// the model cache to acquire a new child node
-	_model.node = GlobalModelCache().getModelNode(actualModelPath);
+	// We have a non-empty model key, send the request to the model cache to
+	// acquire a new child node. If the model needs to be loaded from disk,
+	// the cache might hand out a placeholder node while parsing it in the background.
+	_requestedModelPath = actualModelPath;
+	_model.node = GlobalModelCache().getModelNodeAsync(actualModelPath, getPlaceholderBounds(),
+		sigc::bind(sigc::mem_fun(*this, &ModelKey::onBackgroundModelLoaded), actualModelPath));
 
 	// The model loader should not return NULL, but a sanity check is always ok
     if (!_model.node) return;
@@ -133,6 +139,28 @@ void ModelKey::onModelDefChanged()
     attachModelNodeKeepingSkin();
 }
 
+void ModelKey::onBackgroundModelLoaded(const std::string& modelPath)
+{
+    // Ignore this notification if the model key has been changed in the meantime
+    if (!_active || modelPath != _requestedModelPath) return;
+
+    // The model is in the cache now, exchange the placeholder node
+    attachModelNodeKeepingSkin();
+}
+
+AABB ModelKey::getPlaceholderBounds()
+{
+    // Fixed-size entity classes are defining the expected size through editor_mins/maxs
+    auto entity = _parentNode.tryGetEntity();
+
+    if (entity != nullptr && entity->getEntityClass())
+    {
+        return entity->getEntityClass()->getBounds();
+    }
+
+    return AABB();
+}
+
 void ModelKey::attachModelNodeKeepingSkin()
 {
     if (_model.node)
@@ -191,6 +219,23 @@ void ModelKey::importState(const ModelNodeAndPath& data)
     }
 }
 
+void ModelKey::onUndoRedoOperationFinished()
+{
+    // The restored node might be the placeholder of an earlier background request,
+    // whose load notification is ignored since the key has been changed in the meantime.
+    // Request the model again, to receive the loaded model or a placeholder for this request.
+    if (!_active || !_model.node || getMeshPath() == _requestedModelPath) return;
+
+    attachModelNodeKeepingSkin();
+}
+
+std::string ModelKey::getMeshPath() const
+{
+    auto modelDef = GlobalEntityClassManager().findModel(_model.path);
+
+    return modelDef ? modelDef->getMesh() : _model.path;
+}
+
 void ModelKey::subscribeToModelDef(const IModelDef::Ptr& modelDef)
 {
     // Monitor this modelDef for potential mesh changes
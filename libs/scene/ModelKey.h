@@ -3,6 +3,7 @@
 #include <string>
 #include "inode.h"
 #include "ieclass.h"
+#include "math/AABB.h"
 #include "ObservedUndoable.h"
 #include <sigc++/connection.h>
 
@@ -37,6 +38,10 @@ private:
 
     sigc::connection _modelDefChanged;
 
+    // The mesh path of the most recent model request, used to match
+    // up the notifications of models loaded in the background
+    std::string _requestedModelPath;
+
 public:
 	ModelKey(scene::INode& parentNode);
 
@@ -65,6 +70,12 @@ public:
 private:
     void onModelDefChanged();
 
+    // Invoked by the model cache once a model requested in the background is available
+    void onBackgroundModelLoaded(const std::string& modelPath);
+
+    // Size of the placeholder node shown while a model is loading
+    AABB getPlaceholderBounds();
+
 	// Loads the model node and attaches it to the parent node
     void attachModelNode();
     void detachModelNode();
@@ -73,6 +84,10 @@ private:
     void attachModelNodeKeepingSkin();
 
 	void importState(const ModelNodeAndPath& data);
+    void onUndoRedoOperationFinished();
+
+    // Returns the path to request from the model cache, resolving modelDefs to their mesh
+    std::string getMeshPath() const;
 
     void subscribeToModelDef(const IModelDef::Ptr& modelDef);
     void unsubscribeFromModelDef();
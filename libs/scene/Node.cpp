@@ -2,6 +2,7 @@
 
 #include "itransformnode.h"
 #include "iscenegraph.h"
+#include "imaterialusage.h"
 #include "debugging/debugging.h"
 #include "InstanceWalkers.h"
 #include "AABBAccumulateWalker.h"
@@ -13,6 +14,7 @@ Node::Node(): _children(*this)
 {
     // Each node is part of layer 0 by default
     _layers.insert(0);
+    _layerBitset.set(0);
 }
 
 Node::Node(const Node& other) :
@@ -22,6 +24,7 @@ Node::Node(const Node& other) :
     _children(*this),
     _local2world(other._local2world),
     _layers(other._layers),
+    _layerBitset(other._layerBitset),
     _renderEntity(other._renderEntity),
     _renderState(other._renderState)
 {}
@@ -97,12 +100,14 @@ bool Node::excluded() const
 void Node::addToLayer(int layerId)
 {
     _layers.insert(layerId);
+    onLayersChanged();
 }
 
 void Node::moveToLayer(int layerId)
 {
     _layers.clear();
     _layers.insert(layerId);
+    onLayersChanged();
 }
 
 void Node::removeFromLayer(int layerId)
@@ -117,6 +122,8 @@ void Node::removeFromLayer(int layerId)
         if (_layers.empty()) {
             _layers.insert(0);
         }
+
+        onLayersChanged();
     }
 }
 
@@ -125,11 +132,34 @@ const LayerList& Node::getLayers() const
     return _layers;
 }
 
+const LayerBitset& Node::getLayerBitset() const
+{
+    return _layerBitset;
+}
+
 void Node::assignToLayers(const LayerList& newLayers)
 {
     if (!newLayers.empty())
     {
         _layers = newLayers;
+        onLayersChanged();
+    }
+}
+
+void Node::onLayersChanged()
+{
+    LayerBitset newBitset(_layers);
+
+    if (newBitset == _layerBitset) return;
+
+    std::swap(_layerBitset, newBitset);
+
+    // Nodes in the scene are indexed by the layer manager
+    if (!_instantiated || _isRoot) return;
+
+    if (auto root = getRootNode(); root)
+    {
+        root->getLayerManager().onNodeLayersChanged(*this, newBitset, _layerBitset);
     }
 }
 
@@ -265,6 +295,12 @@ void Node::onInsertIntoScene(IMapRootNode& root)
 {
     _instantiated = true;
 
+    if (!_isRoot)
+    {
+        root.getLayerManager().onNodeLayersChanged(*this, LayerBitset(), _layerBitset);
+        root.getMaterialUsageIndex().addNode(*this);
+    }
+
     // The node was 100% not visible before, check if it is now
     if (visible())
     {
@@ -278,6 +314,12 @@ void Node::onRemoveFromScene(IMapRootNode& root)
 {
     disconnectUndoSystem(root.getUndoSystem());
 
+    if (!_isRoot)
+    {
+        root.getLayerManager().onNodeLayersChanged(*this, _layerBitset, LayerBitset());
+        root.getMaterialUsageIndex().removeNode(*this);
+    }
+
     bool wasVisible = visible();
 
     _instantiated = false;
@@ -395,6 +437,17 @@ void Node::evaluateChildBounds() const {
     }
 }
 
+void Node::materialsChanged()
+{
+    // Nodes outside the scene are indexed once they get inserted
+    if (!_instantiated || _isRoot) return;
+
+    if (auto root = getRootNode(); root)
+    {
+        root->getMaterialUsageIndex().onNodeMaterialsChanged(*this);
+    }
+}
+
 void Node::boundsChanged() {
     _boundsChanged = true;
     _childBoundsChanged = true;
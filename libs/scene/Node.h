@@ -57,6 +57,9 @@ private:
     // The list of layers this object is associated to
     LayerList _layers;
 
+    // The same layers as bitset, for quick visibility checks
+    LayerBitset _layerBitset;
+
     RenderState _renderState = RenderState::Active;
 
 protected:
@@ -97,6 +100,7 @@ public:
     void removeFromLayer(int layerId) override;
     void moveToLayer(int layerId) override;
     const LayerList& getLayers() const override;
+    const LayerBitset& getLayerBitset() const override;
     void assignToLayers(const LayerList& newLayers) override;
 
     void addChildNode(const INodePtr& node) override;
@@ -117,6 +121,10 @@ public:
 
     void boundsChanged() override;
 
+    /// Lets the material usage index of the scene know that this node
+    /// is using a different set of materials now
+    void materialsChanged();
+
     /**
      * Return the filtered status of this Instance.
      */
@@ -217,6 +225,10 @@ protected:
     virtual void removeAllChildNodes();
 
 private:
+    // Updates the layer bitset after a change to the _layers member
+    // and notifies the layer manager of the scene, if any
+    void onLayersChanged();
+
     void connectUndoSystem(IUndoSystem& undoSystem);
     void disconnectUndoSystem(IUndoSystem& undoSystem);
 
@@ -0,0 +1,182 @@
+#include "RayTrace.h"
+
+#include <queue>
+#include <limits>
+#include "iscenegraph.h"
+#include "itraceable.h"
+
+namespace scene
+{
+
+double getRayEntryDistance(const Ray& ray, const AABB& aabb)
+{
+    if (!aabb.isValid()) return -1;
+
+    double tEnter = 0;
+    double tLeave = std::numeric_limits<double>::max();
+
+    // Slab test, clip the ray against each pair of axis-aligned planes
+    for (int i = 0; i < 3; ++i)
+    {
+        auto min = aabb.origin[i] - aabb.extents[i];
+        auto max = aabb.origin[i] + aabb.extents[i];
+
+        if (ray.direction[i] == 0)
+        {
+            // Ray is parallel to this slab, it must start in between the planes
+            if (ray.origin[i] < min || ray.origin[i] > max)
+            {
+                return -1;
+            }
+
+            continue;
+        }
+
+        auto t1 = (min - ray.origin[i]) / ray.direction[i];
+        auto t2 = (max - ray.origin[i]) / ray.direction[i];
+
+        if (t1 > t2)
+        {
+            std::swap(t1, t2);
+        }
+
+        tEnter = std::max(tEnter, t1);
+        tLeave = std::min(tLeave, t2);
+
+        if (tEnter > tLeave)
+        {
+            return -1;
+        }
+    }
+
+    return tEnter;
+}
+
+namespace
+{
+
+// Partition node candidate, sorted by entry distance (nearest first)
+using Candidate = std::pair<double, const ISPNode*>;
+
+struct CandidateIsFarther
+{
+    bool operator()(const Candidate& a, const Candidate& b) const
+    {
+        return a.first > b.first;
+    }
+};
+
+}
+
+RayTraceResult traceRay(const ISpacePartitionSystem& partition, const Ray& ray, const RayTraceFilter& filter)
+{
+    RayTraceResult result;
+
+    auto root = partition.getRoot();
+
+    if (!root || ray.direction.getLengthSquared() == 0) return result;
+
+    Ray normalisedRay(ray.origin, ray.direction.getNormalised());
+    auto bestDistance = std::numeric_limits<double>::max();
+
+    std::priority_queue<Candidate, std::vector<Candidate>, CandidateIsFarther> candidates;
+
+    // The root node is always visited, it might host members exceeding its bounds
+    candidates.emplace(0.0, root.get());
+
+    while (!candidates.empty())
+    {
+        auto [entryDistance, spNode] = candidates.top();
+        candidates.pop();
+
+        // All remaining candidates are farther away than the best hit
+        if (entryDistance > bestDistance) break;
+
+        for (const auto& member : spNode->getMembers())
+        {
+            if (!member->visible() || (filter && !filter(member))) continue;
+
+            auto memberDistance = getRayEntryDistance(normalisedRay, member->worldAABB());
+
+            if (memberDistance < 0 || memberDistance > bestDistance) continue;
+
+            auto traceable = dynamic_cast<ITraceable*>(member.get());
+            Vector3 intersection;
+
+            if (traceable == nullptr || !traceable->getIntersection(normalisedRay, intersection))
+            {
+                continue;
+            }
+
+            auto distance = (intersection - normalisedRay.origin).getLength();
+
+            // Ignore geometry enclosing the ray origin
+            if (distance > 0 && distance < bestDistance)
+            {
+                bestDistance = distance;
+                result.node = member;
+                result.point = intersection;
+                result.distance = distance;
+            }
+        }
+
+        for (const auto& child : spNode->getChildNodes())
+        {
+            auto childDistance = getRayEntryDistance(normalisedRay, child->getBounds());
+
+            if (childDistance >= 0 && childDistance <= bestDistance)
+            {
+                candidates.emplace(childDistance, child.get());
+            }
+        }
+    }
+
+    return result;
+}
+
+std::vector<RayTraceResult> traceRays(const ISpacePartitionSystem& partition,
+    const std::vector<Ray>& rays, const RayTraceFilter& filter)
+{
+    std::vector<RayTraceResult> results;
+    results.reserve(rays.size());
+
+    for (const auto& ray : rays)
+    {
+        results.emplace_back(traceRay(partition, ray, filter));
+    }
+
+    return results;
+}
+
+namespace
+{
+
+ISpacePartitionSystemPtr getUpToDateScenePartition()
+{
+    auto& sceneGraph = GlobalSceneGraph();
+
+    // Evaluating the root bounds will flush any pending octree re-links,
+    // the partition must not change while we're walking it
+    if (sceneGraph.root())
+    {
+        sceneGraph.root()->worldAABB();
+    }
+
+    return sceneGraph.getSpacePartition();
+}
+
+}
+
+RayTraceResult traceRay(const Ray& ray, const RayTraceFilter& filter)
+{
+    auto partition = getUpToDateScenePartition();
+    return partition ? traceRay(*partition, ray, filter) : RayTraceResult();
+}
+
+std::vector<RayTraceResult> traceRays(const std::vector<Ray>& rays, const RayTraceFilter& filter)
+{
+    auto partition = getUpToDateScenePartition();
+    return partition ? traceRays(*partition, rays, filter) : std::vector<RayTraceResult>(rays.size());
+}
+
+}
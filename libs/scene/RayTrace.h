@@ -0,0 +1,71 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include "inode.h"
+#include "ispacepartition.h"
+#include "math/Ray.h"
+
+namespace scene
+{
+
+/**
+ * Result of a ray trace against the scene. If the ray didn't hit
+ * anything, the node member is empty and hit() returns false.
+ */
+struct RayTraceResult
+{
+    // The node that has been hit first
+    INodePtr node;
+
+    // The intersection point in world coordinates
+    Vector3 point;
+
+    // Distance between ray origin and intersection point
+    double distance = -1;
+
+    bool hit() const
+    {
+        return static_cast<bool>(node);
+    }
+};
+
+// Optional predicate to exclude nodes from the trace, returns false to skip a node
+using RayTraceFilter = std::function<bool(const INodePtr&)>;
+
+/**
+ * Returns the distance along the ray at which it enters the given box,
+ * measured in units of the ray's (normalised) direction. Returns a negative
+ * value if the ray misses the box, or 0 if the ray origin is inside.
+ */
+double getRayEntryDistance(const Ray& ray, const AABB& aabb);
+
+/**
+ * Traces the given ray against all visible ITraceable members of the given
+ * space partition (brushes, patches, models) and returns the nearest hit.
+ *
+ * The partition nodes are visited front-to-back, sorted by the distance at
+ * which the ray enters them. Traversal stops as soon as the next partition
+ * node is farther away than the best intersection found so far, such that
+ * only the members along the ray's path are actually tested.
+ *
+ * Intersections located right at the ray origin (e.g. if the ray starts
+ * inside a brush) are not considered to be hits.
+ */
+RayTraceResult traceRay(const ISpacePartitionSystem& partition, const Ray& ray,
+    const RayTraceFilter& filter = RayTraceFilter());
+
+/**
+ * Batch variant of traceRay(), returning one result per ray (in the same order).
+ */
+std::vector<RayTraceResult> traceRays(const ISpacePartitionSystem& partition,
+    const std::vector<Ray>& rays, const RayTraceFilter& filter = RayTraceFilter());
+
+/**
+ * Convenience overloads tracing against the space partition of the global scene graph.
+ * The root bounds are evaluated first, to make sure the octree is up to date.
+ */
+RayTraceResult traceRay(const Ray& ray, const RayTraceFilter& filter = RayTraceFilter());
+std::vector<RayTraceResult> traceRays(const std::vector<Ray>& rays, const RayTraceFilter& filter = RayTraceFilter());
+
+}
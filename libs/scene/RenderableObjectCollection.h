@@ -2,6 +2,7 @@
 
 #include <map>
 #include <sigc++/connection.h>
+#include <sigc++/signal.h>
 #include <sigc++/trackable.h>
 #include <sigc++/functors/mem_fun.h>
 #include "irender.h"
@@ -23,6 +24,8 @@ private:
 
     std::map<render::IRenderableObject::Ptr, ObjectData> _objects;
 
+    sigc::signal<void> _sigBoundsChanged;
+
 public:
     RenderableObjectCollection() :
         _collectionBoundsNeedUpdate(true)
@@ -42,6 +45,7 @@ public:
         }
 
         _collectionBoundsNeedUpdate = true;
+        _sigBoundsChanged.emit();
     }
 
     void removeRenderable(const render::IRenderableObject::Ptr& object)
@@ -59,6 +63,20 @@ public:
         }
 
         _collectionBoundsNeedUpdate = true;
+        _sigBoundsChanged.emit();
+    }
+
+    // The combined bounds of all objects, invalid if the collection is empty
+    const AABB& getBounds()
+    {
+        ensureBoundsUpToDate();
+        return _collectionBounds;
+    }
+
+    // Emitted when objects are added, removed or report changed bounds
+    sigc::signal<void>& signal_boundsChanged()
+    {
+        return _sigBoundsChanged;
     }
 
     void foreachRenderable(const IRenderEntity::ObjectVisitFunction& functor)
@@ -107,6 +125,7 @@ private:
     void onObjectBoundsChanged()
     {
         _collectionBoundsNeedUpdate = true;
+        _sigBoundsChanged.emit();
     }
 
     void ensureBoundsUpToDate()
@@ -1,9 +1,12 @@
 #include "Traverse.h"
 
 #include "iscenegraph.h"
+#include "imap.h"
+#include "imaterialusage.h"
 #include "scenelib.h"
 #include "ibrush.h"
 #include "ipatch.h"
+#include "string/predicate.h"
 
 namespace scene
 {
@@ -130,6 +133,39 @@ void foreachVisiblePatch(const std::function<void(const IPatchNodePtr&)>& functo
 	});
 }
 
+void foreachVisibleFaceUsingMaterial(const std::string& material, const std::function<void(IFace&)>& functor)
+{
+	GlobalSceneGraph().root()->getMaterialUsageIndex().foreachNodeUsingMaterial(material,
+		[&](const scene::INodePtr& node)
+	{
+		if (!Node_isBrush(node) || !node->visible()) return;
+
+		auto* brush = Node_getIBrush(node);
+
+		for (std::size_t i = 0; i < brush->getNumFaces(); ++i)
+		{
+			auto& face = brush->getFace(i);
+
+			if (face.isVisible() && string::iequals(face.getShader(), material))
+			{
+				functor(face);
+			}
+		}
+	});
+}
+
+void foreachVisiblePatchUsingMaterial(const std::string& material, const std::function<void(const IPatchNodePtr&)>& functor)
+{
+	GlobalSceneGraph().root()->getMaterialUsageIndex().foreachNodeUsingMaterial(material,
+		[&](const scene::INodePtr& node)
+	{
+		if (Node_isPatch(node) && node->visible())
+		{
+			functor(std::dynamic_pointer_cast<IPatchNode>(node));
+		}
+	});
+}
+
 std::function<void(const scene::INodePtr&, scene::NodeVisitor&)> traverseSubset(const std::set<scene::INode*> &nodes) {
 	//note: copy nodes set into lambda
 	auto functor = [nodes](const scene::INodePtr& root, scene::NodeVisitor& nodeExporter) {
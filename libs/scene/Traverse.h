@@ -27,6 +27,17 @@ void foreachVisibleFace(const std::function<void(IFace&)>& functor);
  */
 void foreachVisiblePatch(const std::function<void(const IPatchNodePtr&)>& functor);
 
+/**
+ * Visit each visible face using the given material (case-insensitive). The candidate
+ * brushes are looked up through the material usage index of the scene.
+ */
+void foreachVisibleFaceUsingMaterial(const std::string& material, const std::function<void(IFace&)>& functor);
+
+/**
+ * Visit each visible patch node using the given material (case-insensitive).
+ */
+void foreachVisiblePatchUsingMaterial(const std::string& material, const std::function<void(const IPatchNodePtr&)>& functor);
+
 /** stgatilov: Returns traverser, which traverses only specified set of items (and their ancestors/descendants)
  */
 std::function<void(const scene::INodePtr&, scene::NodeVisitor&)> traverseSubset(const std::set<scene::INode*>& nodes);
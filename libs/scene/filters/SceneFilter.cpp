@@ -3,7 +3,6 @@
 #include "scene/Entity.h"
 #include "scene/EntityClass.h"
 #include "ifilter.h"
-#include <regex>
 #include <algorithm>
 
 namespace filters
@@ -87,15 +86,17 @@ bool SceneFilter::isVisible(const FilterType type, const std::string& name) cons
 
     bool visible = true; // default if unmodified by rules
 
-    for (const FilterRule& rule: _rules)
+    for (std::size_t i = 0; i < _rules.size(); ++i)
     {
+        const auto& rule = _rules[i];
+
         // Check the item type.
         if (rule.type != type)
             continue;
 
         // If we have a rule for this item, use a regex to match the query name
         // against the "match" parameter
-        if (const std::regex ex(rule.match); std::regex_match(name, ex))
+        if (std::regex_match(name, _ruleExpressions[i]))
         {
             // Overwrite the visible flag with the value from the rule.
             visible = rule.show;
@@ -110,20 +111,21 @@ bool SceneFilter::isEntityVisible(const Entity& entity) const
 {
     bool visible = true; // default if unmodified by rules
 
-    for (const FilterRule& rule: _rules)
+    for (std::size_t i = 0; i < _rules.size(); ++i)
     {
+        const auto& rule = _rules[i];
+
         if (rule.type == FilterType::ECLASS)
         {
             scene::EntityClass::CPtr eclass = entity.getEntityClass();
-            if (const std::regex ex(rule.match); std::regex_match(eclass->getDeclName(), ex))
+            if (std::regex_match(eclass->getDeclName(), _ruleExpressions[i]))
             {
                 visible = rule.show;
             }
         }
         else if (rule.type == FilterType::SPAWNARG)
         {
-            if (const std::regex ex(rule.match);
-                std::regex_match(entity.getKeyValue(rule.entityKey), ex))
+            if (std::regex_match(entity.getKeyValue(rule.entityKey), _ruleExpressions[i]))
             {
                 visible = rule.show;
             }
@@ -133,6 +135,14 @@ bool SceneFilter::isEntityVisible(const Entity& entity) const
     return visible;
 }
 
+bool SceneFilter::hasRulesOfType(FilterType type) const
+{
+    return std::any_of(_rules.begin(), _rules.end(), [&](const FilterRule& rule)
+    {
+        return rule.type == type;
+    });
+}
+
 void SceneFilter::setName(const std::string& newName) {
     // Set the name ...
     _name = newName;
@@ -143,6 +153,14 @@ void SceneFilter::setName(const std::string& newName) {
 
 void SceneFilter::setRules(const FilterRules& rules) {
     _rules = rules;
+
+    // Compile the match expressions once, instead of on every query
+    _ruleExpressions.clear();
+
+    for (const auto& rule : _rules)
+    {
+        _ruleExpressions.emplace_back(rule.match);
+    }
 }
 
 void SceneFilter::updateEventName() {
@@ -5,6 +5,7 @@
 
 #include <string>
 #include <memory>
+#include <regex>
 
 class Entity;
 
@@ -29,6 +30,9 @@ class SceneFilter
     // Ordered list of rule objects
     FilterRules _rules;
 
+    // The compiled match expression of each rule, in the same order
+    std::vector<std::regex> _ruleExpressions;
+
     // True if this filter can't be changed
     bool _readonly;
 
@@ -71,6 +75,7 @@ public:
     void addRule(filters::Query query, bool show = false)
     {
         _rules.push_back({std::move(query), show});
+        _ruleExpressions.emplace_back(_rules.back().match);
     }
 
     /**
@@ -88,6 +93,9 @@ public:
     /// Test a given entity for visibility against all of the rules in this SceneFilter.
     bool isEntityVisible(const Entity& entity) const;
 
+    /// Returns true if this filter has at least one rule of the given type
+    bool hasRulesOfType(FilterType type) const;
+
     /** greebo: Returns the name of the toggle event associated to this filter.
     * It's lacking any spaces or other incompatible characters, compared to the actual
     * name returned in getName().
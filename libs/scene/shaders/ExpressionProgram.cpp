@@ -0,0 +1,218 @@
+#include "ExpressionProgram.h"
+
+#include <algorithm>
+
+namespace shaders
+{
+
+ExpressionProgram::ExpressionProgram() :
+    _registers(NUM_INPUTS, 0.0f),
+    _isConstant(NUM_INPUTS, false),
+    _usedInputs(0),
+    _isValid(true),
+    _nextCachedResult(0),
+    _cacheHits(0)
+{}
+
+std::size_t ExpressionProgram::getTimeRegister()
+{
+    _usedInputs |= 1u << TIME_REGISTER;
+    return TIME_REGISTER;
+}
+
+std::size_t ExpressionProgram::getShaderParmRegister(int parmNum)
+{
+    if (parmNum < 0 || parmNum >= static_cast<int>(NUM_SHADERPARMS))
+    {
+        setInvalid();
+        return TIME_REGISTER;
+    }
+
+    auto index = TIME_REGISTER + 1 + static_cast<std::size_t>(parmNum);
+    _usedInputs |= 1u << index;
+
+    return index;
+}
+
+std::size_t ExpressionProgram::addConstant(float value)
+{
+    // Re-use registers holding the same constant
+    for (auto i = NUM_INPUTS; i < _registers.size(); ++i)
+    {
+        if (_isConstant[i] && _registers[i] == value)
+        {
+            return i;
+        }
+    }
+
+    return addRegister(value, true);
+}
+
+std::size_t ExpressionProgram::addOperation(OpCode opCode, std::size_t a, std::size_t b)
+{
+    if (_isConstant[a] && _isConstant[b])
+    {
+        return addConstant(ApplyOperation(opCode, _registers[a], _registers[b]));
+    }
+
+    auto result = addRegister(0, false);
+
+    _instructions.push_back(Instruction{ opCode, static_cast<std::uint32_t>(result),
+        static_cast<std::uint32_t>(a), static_cast<std::uint32_t>(b) });
+
+    return result;
+}
+
+std::size_t ExpressionProgram::addTableLookup(const ITableDefinition::Ptr& table, std::size_t lookupRegister)
+{
+    // Table lookups are never folded, the table declaration might be reloaded
+    auto tableIndex = std::find(_tables.begin(), _tables.end(), table) - _tables.begin();
+
+    if (tableIndex == static_cast<std::ptrdiff_t>(_tables.size()))
+    {
+        _tables.push_back(table);
+    }
+
+    auto result = addRegister(0, false);
+
+    _instructions.push_back(Instruction{ OpCode::TableLookup, static_cast<std::uint32_t>(result),
+        static_cast<std::uint32_t>(lookupRegister), static_cast<std::uint32_t>(tableIndex) });
+
+    return result;
+}
+
+void ExpressionProgram::setInvalid()
+{
+    _isValid = false;
+}
+
+void ExpressionProgram::addOutput(std::size_t source, std::size_t targetRegister)
+{
+    _outputs.push_back(Output{ source, targetRegister });
+}
+
+bool ExpressionProgram::isValid() const
+{
+    return _isValid;
+}
+
+std::size_t ExpressionProgram::getNumInstructions() const
+{
+    return _instructions.size();
+}
+
+std::size_t ExpressionProgram::getCacheHitCount() const
+{
+    return _cacheHits;
+}
+
+void ExpressionProgram::execute(std::size_t time, Registers& targetRegisters)
+{
+    Inputs inputs{};
+
+    if (_usedInputs & (1u << TIME_REGISTER))
+    {
+        inputs[TIME_REGISTER] = time / 1000.0f; // convert msecs to secs
+    }
+
+    for (std::size_t parm = 0; parm < NUM_SHADERPARMS; ++parm)
+    {
+        auto index = TIME_REGISTER + 1 + parm;
+
+        // Same as ShaderParmExpression: RGBA parms [0-3] are 1.0 without entity, the rest is 0
+        if ((_usedInputs & (1u << index)) && parm < 4)
+        {
+            inputs[index] = 1.0f;
+        }
+    }
+
+    run(inputs, targetRegisters);
+}
+
+void ExpressionProgram::execute(std::size_t time, const IRenderEntity& entity, Registers& targetRegisters)
+{
+    Inputs inputs{};
+
+    if (_usedInputs & (1u << TIME_REGISTER))
+    {
+        inputs[TIME_REGISTER] = time / 1000.0f; // convert msecs to secs
+    }
+
+    for (std::size_t parm = 0; parm < NUM_SHADERPARMS; ++parm)
+    {
+        auto index = TIME_REGISTER + 1 + parm;
+
+        if (_usedInputs & (1u << index))
+        {
+            inputs[index] = entity.getShaderParm(static_cast<int>(parm));
+        }
+    }
+
+    run(inputs, targetRegisters);
+}
+
+std::size_t ExpressionProgram::addRegister(float value, bool isConstant)
+{
+    _registers.push_back(value);
+    _isConstant.push_back(isConstant);
+
+    return _registers.size() - 1;
+}
+
+void ExpressionProgram::run(const Inputs& inputs, Registers& targetRegisters)
+{
+    // Unused inputs are always 0, so the whole array can serve as cache key
+    for (const auto& cached : _cachedResults)
+    {
+        if (cached.inputs == inputs)
+        {
+            ++_cacheHits;
+
+            for (std::size_t i = 0; i < _outputs.size(); ++i)
+            {
+                targetRegisters[_outputs[i].target] = cached.outputs[i];
+            }
+
+            return;
+        }
+    }
+
+    std::copy(inputs.begin(), inputs.end(), _registers.begin());
+
+    auto* registers = _registers.data();
+
+    for (const auto& instruction : _instructions)
+    {
+        if (instruction.opCode == OpCode::TableLookup)
+        {
+            registers[instruction.result] = _tables[instruction.b]->getValue(registers[instruction.a]);
+        }
+        else
+        {
+            registers[instruction.result] = ApplyOperation(instruction.opCode,
+                registers[instruction.a], registers[instruction.b]);
+        }
+    }
+
+    // Remember the result, replacing the oldest entry once the cache is full
+    if (_cachedResults.size() < NUM_CACHED_RESULTS)
+    {
+        _cachedResults.emplace_back();
+    }
+
+    auto& cached = _cachedResults[_nextCachedResult];
+    _nextCachedResult = (_nextCachedResult + 1) % NUM_CACHED_RESULTS;
+
+    cached.inputs = inputs;
+    cached.outputs.resize(_outputs.size());
+
+    for (std::size_t i = 0; i < _outputs.size(); ++i)
+    {
+        auto value = registers[_outputs[i].source];
+
+        cached.outputs[i] = value;
+        targetRegisters[_outputs[i].target] = value;
+    }
+}
+
+}
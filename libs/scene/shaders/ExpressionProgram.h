@@ -0,0 +1,168 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "ishaders.h"
+#include "irender.h"
+
+namespace shaders
+{
+
+/**
+ * Flat, register-based form of a set of shader expressions, replacing the
+ * recursive evaluation of the expression trees by a single loop over an
+ * instruction list.
+ *
+ * The program's working registers are laid out like this:
+ * [time, parm0 .. parm11, constants and instruction results ...]
+ * Every instruction writes its result into a register of its own, such that
+ * the time and shaderparm inputs are the only registers changing between runs.
+ * Instructions which only depend on constants are evaluated while the program
+ * is compiled, only their result is stored in the program.
+ *
+ * The outputs of the program are copied to the target registers (i.e. the ones
+ * of the owning shader layer). The outputs of the most recent runs are kept
+ * together with the input values they have been calculated from: entities
+ * sharing the same parms are served from that cache instead of running the
+ * program again. Only the inputs actually referenced by the program are part
+ * of that cache key, a program not referring to any entity parm is evaluated
+ * once per time value.
+ */
+class ExpressionProgram
+{
+public:
+    // Number of shaderparms an entity can provide, parm0 .. parm11
+    static constexpr std::size_t NUM_SHADERPARMS = 12;
+
+    // The time input (in seconds) followed by the shaderparms
+    static constexpr std::size_t NUM_INPUTS = NUM_SHADERPARMS + 1;
+
+    static constexpr std::size_t TIME_REGISTER = 0;
+
+    // Number of recent results remembered by the program
+    static constexpr std::size_t NUM_CACHED_RESULTS = 4;
+
+    enum class OpCode : std::uint8_t
+    {
+        Add,
+        Subtract,
+        Multiply,
+        Divide,
+        Modulo,
+        LessThan,
+        LessThanOrEqual,
+        GreaterThan,
+        GreaterThanOrEqual,
+        Equal,
+        NotEqual,
+        LogicalAnd,
+        LogicalOr,
+        TableLookup,        // a = lookup value register, b = table index
+    };
+
+    struct Instruction
+    {
+        OpCode opCode;
+        std::uint32_t result;
+        std::uint32_t a;
+        std::uint32_t b;
+    };
+
+private:
+    std::vector<float> _registers;
+
+    // True for each register holding a value known at compile time
+    std::vector<bool> _isConstant;
+
+    std::vector<Instruction> _instructions;
+    std::vector<ITableDefinition::Ptr> _tables;
+
+    struct Output
+    {
+        std::size_t source;
+        std::size_t target;
+    };
+    std::vector<Output> _outputs;
+
+    // One bit per input register referenced by the program
+    std::uint32_t _usedInputs;
+
+    // False if the program failed to represent one of the expressions
+    bool _isValid;
+
+    using Inputs = std::array<float, NUM_INPUTS>;
+
+    struct CachedResult
+    {
+        Inputs inputs;
+        std::vector<float> outputs;
+    };
+    std::vector<CachedResult> _cachedResults;
+    std::size_t _nextCachedResult;
+    std::size_t _cacheHits;
+
+public:
+    ExpressionProgram();
+
+    // Compilation interface, used by the ShaderExpression implementations.
+    // All methods return the register index holding the result.
+
+    std::size_t getTimeRegister();
+    std::size_t getShaderParmRegister(int parmNum);
+    std::size_t addConstant(float value);
+
+    // Appends the given operation, or folds it into a constant if both operands are constant
+    std::size_t addOperation(OpCode opCode, std::size_t a, std::size_t b);
+
+    std::size_t addTableLookup(const ITableDefinition::Ptr& table, std::size_t lookupRegister);
+
+    // Marks the program as unusable, for expressions which cannot be compiled
+    void setInvalid();
+
+    // Declares that the value of the given register is copied to the given target register after each run
+    void addOutput(std::size_t source, std::size_t targetRegister);
+
+    bool isValid() const;
+
+    // Number of instructions executed per run (after constant folding)
+    std::size_t getNumInstructions() const;
+
+    // Number of runs answered from the cached results
+    std::size_t getCacheHitCount() const;
+
+    // Runs the program without an entity, shaderparms are using their default values
+    void execute(std::size_t time, Registers& targetRegisters);
+
+    // Runs the program using the shaderparms of the given entity
+    void execute(std::size_t time, const IRenderEntity& entity, Registers& targetRegisters);
+
+    // Evaluates the given operation, used by both the constant folding and the execution
+    static float ApplyOperation(OpCode opCode, float a, float b)
+    {
+        switch (opCode)
+        {
+        case OpCode::Add: return a + b;
+        case OpCode::Subtract: return a - b;
+        case OpCode::Multiply: return a * b;
+        case OpCode::Divide: return a / b;
+        case OpCode::Modulo: return fmod(a, b);
+        case OpCode::LessThan: return a < b ? 1.0f : 0;
+        case OpCode::LessThanOrEqual: return a <= b ? 1.0f : 0;
+        case OpCode::GreaterThan: return a > b ? 1.0f : 0;
+        case OpCode::GreaterThanOrEqual: return a >= b ? 1.0f : 0;
+        case OpCode::Equal: return a == b ? 1.0f : 0;
+        case OpCode::NotEqual: return a != b ? 1.0f : 0;
+        case OpCode::LogicalAnd: return (a != 0 && b != 0) ? 1.0f : 0;
+        case OpCode::LogicalOr: return (a != 0 || b != 0) ? 1.0f : 0;
+        default: return 0;
+        }
+    }
+
+private:
+    std::size_t addRegister(float value, bool isConstant);
+    void run(const Inputs& inputs, Registers& targetRegisters);
+};
+
+}
@@ -3,6 +3,7 @@
 #include "ishaders.h"
 #include "irender.h"
 #include "parser/DefTokeniser.h"
+#include "ExpressionProgram.h"
 
 namespace shaders
 {
@@ -115,6 +116,23 @@ public:
 
     // To be implemented by the subclasses
     virtual std::string convertToString() = 0;
+
+    // Appends the instructions calculating this expression to the given program,
+    // returns the index of the program register holding the result
+    virtual std::size_t compile(ExpressionProgram& program) = 0;
+
+    // Compiles the given expression into the program, marks the program
+    // as invalid if the expression is not a ShaderExpression
+    static std::size_t Compile(const IShaderExpression::Ptr& expression, ExpressionProgram& program)
+    {
+        if (auto shaderExpression = std::dynamic_pointer_cast<ShaderExpression>(expression); shaderExpression)
+        {
+            return shaderExpression->compile(program);
+        }
+
+        program.setInvalid();
+        return ExpressionProgram::TIME_REGISTER;
+    }
 };
 
 // Detail namespace
@@ -160,6 +178,11 @@ public:
         return fmt::format("parm{0}", _parmNum);
     }
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return program.getShaderParmRegister(_parmNum);
+    }
+
     virtual Ptr clone() const override
     {
         return std::make_shared<ShaderParmExpression>(*this);
@@ -200,6 +223,11 @@ public:
         return fmt::format("global{0}", _parmNum);
     }
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return program.addConstant(0.0f);
+    }
+
     virtual Ptr clone() const override
     {
         return std::make_shared<GlobalShaderParmExpression>(*this);
@@ -234,6 +262,11 @@ public:
         return "time";
     }
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return program.getTimeRegister();
+    }
+
     virtual Ptr clone() const override
     {
         return std::make_shared<TimeExpression>(*this);
@@ -273,6 +306,11 @@ public:
         return fmt::format("{0}", _value);
     }
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return program.addConstant(_value);
+    }
+
     virtual Ptr clone() const override
     {
         return std::make_shared<ConstantExpression>(*this);
@@ -322,6 +360,11 @@ public:
         return fmt::format("{0}[{1}]", _tableDef->getDeclName(), _lookupExpr->getExpressionString());
     }
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return program.addTableLookup(_tableDef, Compile(_lookupExpr, program));
+    }
+
     virtual Ptr clone() const override
     {
         return std::make_shared<TableLookupExpression>(*this);
@@ -386,6 +429,15 @@ public:
     {
         _b = b;
     }
+
+protected:
+    std::size_t compileOperation(ExpressionProgram& program, ExpressionProgram::OpCode opCode)
+    {
+        auto a = Compile(_a, program);
+        auto b = Compile(_b, program);
+
+        return program.addOperation(opCode, a, b);
+    }
 };
 typedef std::shared_ptr<BinaryExpression> BinaryExpressionPtr;
 
@@ -418,6 +470,11 @@ public:
         return fmt::format("{0} + {1}", _a->getExpressionString(), _b->getExpressionString());
     }
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(program, ExpressionProgram::OpCode::Add);
+    }
+
     virtual Ptr clone() const override
     {
         return std::make_shared<AddExpression>(*this);
@@ -453,6 +510,11 @@ public:
         return fmt::format("{0} - {1}", _a->getExpressionString(), _b->getExpressionString());
     }
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(program, ExpressionProgram::OpCode::Subtract);
+    }
+
     virtual Ptr clone() const override
     {
         return std::make_shared<SubtractExpression>(*this);
@@ -488,6 +550,11 @@ public:
         return fmt::format("{0} * {1}", _a->getExpressionString(), _b->getExpressionString());
     }
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(program, ExpressionProgram::OpCode::Multiply);
+    }
+
     virtual Ptr clone() const override
     {
         return std::make_shared<MultiplyExpression>(*this);
@@ -523,6 +590,11 @@ public:
         return fmt::format("{0} / {1}", _a->getExpressionString(), _b->getExpressionString());
     }
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(program, ExpressionProgram::OpCode::Divide);
+    }
+
     virtual Ptr clone() const override
     {
         return std::make_shared<DivideExpression>(*this);
@@ -558,6 +630,11 @@ public:
         return fmt::format("{0} % {1}", _a->getExpressionString(), _b->getExpressionString());
     }
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(program, ExpressionProgram::OpCode::Modulo);
+    }
+
     virtual Ptr clone() const override
     {
         return std::make_shared<ModuloExpression>(*this);
@@ -593,6 +670,11 @@ public:
         return fmt::format("{0} < {1}", _a->getExpressionString(), _b->getExpressionString());
     }
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(program, ExpressionProgram::OpCode::LessThan);
+    }
+
     virtual Ptr clone() const override
     {
         return std::make_shared<LessThanExpression>(*this);
@@ -628,6 +710,11 @@ public:
         return fmt::format("{0} <= {1}", _a->getExpressionString(), _b->getExpressionString());
     }
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(program, ExpressionProgram::OpCode::LessThanOrEqual);
+    }
+
     virtual Ptr clone() const override
     {
         return std::make_shared<LessThanOrEqualExpression>(*this);
@@ -663,6 +750,11 @@ public:
         return fmt::format("{0} > {1}", _a->getExpressionString(), _b->getExpressionString());
     }
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(program, ExpressionProgram::OpCode::GreaterThan);
+    }
+
     virtual Ptr clone() const override
     {
         return std::make_shared<GreaterThanExpression>(*this);
@@ -698,6 +790,11 @@ public:
         return fmt::format("{0} >= {1}", _a->getExpressionString(), _b->getExpressionString());
     }
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(program, ExpressionProgram::OpCode::GreaterThanOrEqual);
+    }
+
     virtual Ptr clone() const override
     {
         return std::make_shared<GreaterThanOrEqualExpression>(*this);
@@ -733,6 +830,11 @@ public:
         return fmt::format("{0} == {1}", _a->getExpressionString(), _b->getExpressionString());
     }
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(program, ExpressionProgram::OpCode::Equal);
+    }
+
     virtual Ptr clone() const override
     {
         return std::make_shared<EqualityExpression>(*this);
@@ -768,6 +870,11 @@ public:
         return fmt::format("{0} != {1}", _a->getExpressionString(), _b->getExpressionString());
     }
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(program, ExpressionProgram::OpCode::NotEqual);
+    }
+
     virtual Ptr clone() const override
     {
         return std::make_shared<InequalityExpression>(*this);
@@ -803,6 +910,11 @@ public:
         return fmt::format("{0} && {1}", _a->getExpressionString(), _b->getExpressionString());
     }
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(program, ExpressionProgram::OpCode::LogicalAnd);
+    }
+
     virtual Ptr clone() const override
     {
         return std::make_shared<LogicalAndExpression>(*this);
@@ -838,6 +950,11 @@ public:
         return fmt::format("{0} || {1}", _a->getExpressionString(), _b->getExpressionString());
     }
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(program, ExpressionProgram::OpCode::LogicalOr);
+    }
+
     virtual Ptr clone() const override
     {
         return std::make_shared<LogicalOrExpression>(*this);
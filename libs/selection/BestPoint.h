@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+#include <algorithm>
 #include "math/Vector3.h"
 #include "math/Ray.h"
 #include "iselectiontest.h"
@@ -512,6 +514,70 @@ inline std::size_t clipTriangle(const Matrix4& matrix, const Vector3& p0,
 	return homogenous_clip_triangle(clipped);
 }
 
+/**
+ * \brief Clip-space representation of a batch of vertices.
+ *
+ * Every vertex of a mesh is transformed exactly once (instead of once per
+ * triangle it belongs to), and its clip result bitmask is stored alongside.
+ * Triangles having all three vertices outside the same clip plane can then
+ * be rejected without running them through the polygon clipper, which would
+ * produce an empty polygon for them anyway. Triangles passing this test are
+ * clipped exactly like clipTriangle() would do it.
+ */
+class ClipSpaceVertices
+{
+private:
+    std::vector<Vector4> _vertices;
+    std::vector<ClipResult> _clipResults;
+
+public:
+    void transform(const Matrix4& matrix, const VertexPointer& vertices, std::size_t count)
+    {
+        _vertices.resize(count);
+        _clipResults.resize(count);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            _clipResults[i] = clipPoint(matrix, vertices[i], _vertices[i]);
+        }
+    }
+
+    // Transforms all vertices up to the highest index referenced by the given indices
+    void transform(const Matrix4& matrix, const VertexPointer& vertices, const IndexPointer& indices)
+    {
+        std::size_t count = 0;
+
+        for (auto i = indices.begin(); i != indices.end(); ++i)
+        {
+            count = std::max(count, static_cast<std::size_t>(*i) + 1);
+        }
+
+        transform(matrix, vertices, count);
+    }
+
+    // Returns true if the given triangle is completely outside one of the clip planes
+    bool triangleIsOutside(std::size_t a, std::size_t b, std::size_t c) const
+    {
+        return (_clipResults[a] & _clipResults[b] & _clipResults[c]) != c_CLIP_PASS;
+    }
+
+    // Clips the given triangle and stores the resulting polygon in clipped,
+    // returns the number of points in the resulting polygon.
+    std::size_t clipTriangle(std::size_t a, std::size_t b, std::size_t c, Vector4 clipped[9]) const
+    {
+        if (triangleIsOutside(a, b, c))
+        {
+            return 0;
+        }
+
+        clipped[0] = _vertices[a];
+        clipped[1] = _vertices[b];
+        clipped[2] = _vertices[c];
+
+        return homogenous_clip_triangle(clipped);
+    }
+};
+
 inline void Circle_BestPoint(const Matrix4& local2view, clipcull_t cull, const Vertex3* vertices, const std::size_t size, SelectionIntersection& best)
 {
     Vector4 clipped[9];
@@ -23,6 +23,10 @@ class SelectionVolume :
     clipcull_t _cull;
     Vector3 _near;
     Vector3 _far;
+
+    // Re-used buffer for the clip-space vertices of the mesh being tested
+    ClipSpaceVertices _clipSpace;
+
 public:
     SelectionVolume(const render::View& view) :
         _view(view)
@@ -69,12 +73,14 @@ public:
 
     void TestPolygon(const VertexPointer& vertices, std::size_t count, SelectionIntersection& best) override
     {
+        if (count < 3) return;
+
+        _clipSpace.transform(_local2view, vertices, count);
+
         Vector4 clipped[9];
         for (std::size_t i = 0; i + 2 < count; ++i)
         {
-            BestPoint(clipTriangle(_local2view, vertices[0], vertices[i + 1],
-                                   vertices[i + 2], clipped),
-                      clipped, best, _cull);
+            BestPoint(_clipSpace.clipTriangle(0, i + 1, i + 2, clipped), clipped, best, _cull);
         }
     }
 
@@ -92,45 +98,36 @@ public:
 
     void TestTriangles(const VertexPointer& vertices, const IndexPointer& indices, SelectionIntersection& best) override
     {
+        _clipSpace.transform(_local2view, vertices, indices);
+
         Vector4 clipped[9];
         for (IndexPointer::iterator i(indices.begin()); i != indices.end(); i += 3)
         {
-            BestPoint(clipTriangle(_local2view, vertices[*i],
-                                   vertices[*(i + 1)], vertices[*(i + 2)],
-                                   clipped),
-                      clipped, best, _cull);
+            BestPoint(_clipSpace.clipTriangle(*i, *(i + 1), *(i + 2), clipped), clipped, best, _cull);
         }
     }
 
     void TestQuads(const VertexPointer& vertices, const IndexPointer& indices, SelectionIntersection& best) override
     {
+        _clipSpace.transform(_local2view, vertices, indices);
+
         Vector4 clipped[9];
         for (IndexPointer::iterator i(indices.begin()); i != indices.end(); i += 4)
         {
-            BestPoint(clipTriangle(_local2view, vertices[*i],
-                                   vertices[*(i + 1)], vertices[*(i + 3)],
-                                   clipped),
-                      clipped, best, _cull);
-            BestPoint(clipTriangle(_local2view, vertices[*(i + 1)],
-                                   vertices[*(i + 2)], vertices[*(i + 3)],
-                                   clipped),
-                      clipped, best, _cull);
+            BestPoint(_clipSpace.clipTriangle(*i, *(i + 1), *(i + 3), clipped), clipped, best, _cull);
+            BestPoint(_clipSpace.clipTriangle(*(i + 1), *(i + 2), *(i + 3), clipped), clipped, best, _cull);
         }
     }
 
     void TestQuadStrip(const VertexPointer& vertices, const IndexPointer& indices, SelectionIntersection& best) override
     {
+        _clipSpace.transform(_local2view, vertices, indices);
+
         Vector4 clipped[9];
         for (IndexPointer::iterator i(indices.begin()); i + 2 != indices.end(); i += 2)
         {
-            BestPoint(clipTriangle(_local2view, vertices[*i],
-                                   vertices[*(i + 1)], vertices[*(i + 2)],
-                                   clipped),
-                      clipped, best, _cull);
-            BestPoint(clipTriangle(_local2view, vertices[*(i + 2)],
-                                   vertices[*(i + 1)], vertices[*(i + 3)],
-                                   clipped),
-                      clipped, best, _cull);
+            BestPoint(_clipSpace.clipTriangle(*i, *(i + 1), *(i + 2), clipped), clipped, best, _cull);
+            BestPoint(_clipSpace.clipTriangle(*(i + 2), *(i + 1), *(i + 3), clipped), clipped, best, _cull);
         }
     }
 };
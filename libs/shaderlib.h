@@ -112,8 +112,9 @@ inline int findAndReplaceShader(const std::string& find, const std::string& repl
 	}
 	else
 	{
-		scene::foreachVisibleFace(std::ref(replacer));
-		scene::foreachVisiblePatch(std::ref(replacer));
+		// Only visit the faces and patches using the material
+		scene::foreachVisibleFaceUsingMaterial(find, std::ref(replacer));
+		scene::foreachVisiblePatchUsingMaterial(find, std::ref(replacer));
 	}
 
 	return replacer.getReplacedCount();
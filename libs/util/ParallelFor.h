@@ -0,0 +1,64 @@
+#pragma once
+
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace util
+{
+
+/**
+ * Invokes functor(index) for every index in [0, count), distributing the range
+ * in contiguous chunks across worker threads. The calling thread processes the
+ * first chunk itself and blocks until all other chunks are finished.
+ *
+ * Ranges not exceeding minChunkSize are processed on the calling thread alone.
+ * The functor must not touch any state shared between the individual indices.
+ * Exceptions thrown by the functor are propagated to the caller.
+ */
+template<typename Functor>
+void parallelFor(std::size_t count, const Functor& functor, std::size_t minChunkSize = 64)
+{
+    auto numThreads = static_cast<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u));
+    auto numChunks = std::min(numThreads, (count + minChunkSize - 1) / std::max(minChunkSize, std::size_t(1)));
+
+    if (numChunks <= 1)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            functor(i);
+        }
+
+        return;
+    }
+
+    auto chunkSize = (count + numChunks - 1) / numChunks;
+
+    auto processChunk = [&](std::size_t start)
+    {
+        auto end = std::min(start + chunkSize, count);
+
+        for (std::size_t i = start; i < end; ++i)
+        {
+            functor(i);
+        }
+    };
+
+    std::vector<std::future<void>> workers;
+    workers.reserve(numChunks - 1);
+
+    for (std::size_t start = chunkSize; start < count; start += chunkSize)
+    {
+        workers.emplace_back(std::async(std::launch::async, processChunk, start));
+    }
+
+    processChunk(0);
+
+    for (auto& worker : workers)
+    {
+        worker.get();
+    }
+}
+
+}
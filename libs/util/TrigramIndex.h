@@ -0,0 +1,222 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace util
+{
+
+/**
+ * Substring index mapping keys to a piece of text each. Every three-byte
+ * sequence (trigram) of the text is stored in a posting list, such that a
+ * substring query only has to check the texts sharing all the trigrams of
+ * the needle instead of visiting every single entry.
+ *
+ * Matching is byte-exact, callers wanting case-insensitive queries need
+ * to convert both the indexed texts and the needles to lower case.
+ *
+ * Entries can be replaced and removed at any time, removed entries are
+ * left in the posting lists until they make up the majority of the index,
+ * at which point the lists are rebuilt.
+ */
+template<typename Key, typename Hash = std::hash<Key>>
+class TrigramIndex
+{
+private:
+    struct Entry
+    {
+        Key key;
+        std::string text;
+        bool removed;
+    };
+
+    // Entries in insertion order, the posting lists refer to the index in this vector
+    std::vector<Entry> _entries;
+    std::unordered_map<Key, std::uint32_t, Hash> _slotByKey;
+    std::size_t _numRemoved = 0;
+
+    // Slots containing the trigram, in ascending order
+    std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> _postings;
+
+public:
+    // Adds the given text to the index, replacing any previous text of that key
+    void insert(const Key& key, const std::string& text)
+    {
+        erase(key);
+
+        auto slot = static_cast<std::uint32_t>(_entries.size());
+
+        _entries.push_back(Entry{ key, text, false });
+        _slotByKey.emplace(key, slot);
+
+        addPostings(slot);
+    }
+
+    void erase(const Key& key)
+    {
+        auto found = _slotByKey.find(key);
+
+        if (found == _slotByKey.end()) return;
+
+        auto& entry = _entries[found->second];
+        entry.removed = true;
+        entry.text.clear();
+
+        _slotByKey.erase(found);
+
+        if (++_numRemoved > _slotByKey.size() && _numRemoved > 64)
+        {
+            compact();
+        }
+    }
+
+    void clear()
+    {
+        _entries.clear();
+        _slotByKey.clear();
+        _postings.clear();
+        _numRemoved = 0;
+    }
+
+    std::size_t size() const
+    {
+        return _slotByKey.size();
+    }
+
+    bool empty() const
+    {
+        return _slotByKey.empty();
+    }
+
+    // Invokes the functor with the key of each entry containing the needle.
+    // Keys are visited in the order they have been inserted.
+    template<typename Functor>
+    void foreachMatch(const std::string& needle, const Functor& functor) const
+    {
+        if (needle.size() < 3)
+        {
+            // Too short to have a trigram, check every entry
+            for (const auto& entry : _entries)
+            {
+                if (!entry.removed && entry.text.find(needle) != std::string::npos)
+                {
+                    functor(entry.key);
+                }
+            }
+
+            return;
+        }
+
+        auto trigrams = getTrigrams(needle);
+
+        std::vector<const std::vector<std::uint32_t>*> lists;
+        lists.reserve(trigrams.size());
+
+        for (auto trigram : trigrams)
+        {
+            auto found = _postings.find(trigram);
+
+            if (found == _postings.end()) return; // no text contains this trigram
+
+            lists.push_back(&found->second);
+        }
+
+        // Start with the shortest list to keep the intersections small
+        std::sort(lists.begin(), lists.end(), [](const auto* a, const auto* b) { return a->size() < b->size(); });
+
+        std::vector<std::uint32_t> candidates(*lists.front());
+        std::vector<std::uint32_t> intersection;
+
+        for (auto list = lists.begin() + 1; list != lists.end() && !candidates.empty(); ++list)
+        {
+            intersection.clear();
+            std::set_intersection(candidates.begin(), candidates.end(),
+                (*list)->begin(), (*list)->end(), std::back_inserter(intersection));
+            candidates.swap(intersection);
+        }
+
+        // Having all trigrams doesn't mean they're appearing in the right order
+        for (auto slot : candidates)
+        {
+            const auto& entry = _entries[slot];
+
+            if (!entry.removed && entry.text.find(needle) != std::string::npos)
+            {
+                functor(entry.key);
+            }
+        }
+    }
+
+    // Returns the keys of all entries containing the needle
+    std::vector<Key> find(const std::string& needle) const
+    {
+        std::vector<Key> result;
+        foreachMatch(needle, [&](const Key& key) { result.push_back(key); });
+        return result;
+    }
+
+private:
+    static std::vector<std::uint32_t> getTrigrams(const std::string& text)
+    {
+        std::vector<std::uint32_t> trigrams;
+
+        if (text.size() < 3) return trigrams;
+
+        trigrams.reserve(text.size() - 2);
+
+        for (std::size_t i = 0; i + 2 < text.size(); ++i)
+        {
+            trigrams.push_back(
+                static_cast<std::uint32_t>(static_cast<unsigned char>(text[i])) << 16 |
+                static_cast<std::uint32_t>(static_cast<unsigned char>(text[i + 1])) << 8 |
+                static_cast<std::uint32_t>(static_cast<unsigned char>(text[i + 2])));
+        }
+
+        std::sort(trigrams.begin(), trigrams.end());
+        trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+        return trigrams;
+    }
+
+    // Slots are handed out in ascending order, so appending keeps the lists sorted
+    void addPostings(std::uint32_t slot)
+    {
+        for (auto trigram : getTrigrams(_entries[slot].text))
+        {
+            _postings[trigram].push_back(slot);
+        }
+    }
+
+    // Drops the removed entries and rebuilds the posting lists
+    void compact()
+    {
+        std::vector<Entry> entries;
+        entries.reserve(_slotByKey.size());
+
+        for (auto& entry : _entries)
+        {
+            if (!entry.removed)
+            {
+                entries.emplace_back(std::move(entry));
+            }
+        }
+
+        _entries.swap(entries);
+        _slotByKey.clear();
+        _postings.clear();
+        _numRemoved = 0;
+
+        for (std::uint32_t slot = 0; slot < _entries.size(); ++slot)
+        {
+            _slotByKey.emplace(_entries[slot].key, slot);
+            addPostings(slot);
+        }
+    }
+};
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include "ifilesystem.h"
+#include "os/fs.h"
+
+namespace vfs
+{
+
+/**
+ * Size and modification time of a file in the VFS, used to detect changes
+ * of the source file when storing derived data on disk. Files in PK4s are
+ * using the modification time of the containing archive.
+ */
+struct FileStamp
+{
+    std::uint64_t size = 0;
+    std::int64_t modificationTime = 0;
+
+    bool operator==(const FileStamp& other) const
+    {
+        return size == other.size && modificationTime == other.modificationTime;
+    }
+
+    bool operator!=(const FileStamp& other) const
+    {
+        return !operator==(other);
+    }
+};
+
+// Determines the stamp of the given VFS file, returns false if the file can't be found
+inline bool getFileStamp(const std::string& vfsPath, FileStamp& stamp)
+{
+    auto fileInfo = GlobalFileSystem().getFileInfo(vfsPath);
+
+    if (fileInfo.isEmpty()) return false;
+
+    fs::path sourcePath(fileInfo.getArchivePath());
+
+    if (fileInfo.getIsPhysicalFile())
+    {
+        sourcePath /= vfsPath;
+    }
+
+    std::error_code ec;
+    auto modificationTime = fs::last_write_time(sourcePath, ec);
+
+    if (ec) return false;
+
+    stamp.size = fileInfo.getSize();
+    stamp.modificationTime = static_cast<std::int64_t>(modificationTime.time_since_epoch().count());
+
+    return true;
+}
+
+}
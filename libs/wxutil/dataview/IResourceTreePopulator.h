@@ -1,7 +1,9 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 #include <wx/event.h>
+#include "TreeModel.h"
 
 namespace wxutil
 {
@@ -26,6 +28,10 @@ public:
     // Define the event handler that is notified once population is done
     virtual void SetFinishedHandler(wxEvtHandler* finishedHandler) = 0;
 
+    // Define the columns the tree view is filtering by, the populated
+    // model should carry a search index for these (see TreeModel::SetSearchColumns)
+    virtual void SetSearchColumns(const std::vector<TreeModel::Column>& columns) = 0;
+
     // Will start the population and block until population is done.
     virtual void EnsurePopulated() = 0;
 
@@ -102,6 +102,8 @@ void ResourceTreeView::SetTreeModel(const TreeModel::Ptr& model)
 
 void ResourceTreeView::SetupTreeModelFilter()
 {
+    UpdateFilterMatches();
+
     // Set up the filter
     _treeModelFilter.reset(new TreeModelFilter(_treeStore));
 
@@ -221,7 +223,7 @@ bool ResourceTreeView::SetFilterText(const wxString& filterText)
     {
         TreeModel::Row row(item, *GetModel());
 
-        if (!_filterText.empty() && !TreeModel::RowContainsString(row, _filterText, _colsToSearch, true))
+        if (IsTreeModelRowFiltered(row))
         {
             // The selected row is not relevant anymore
             return JumpToFirstFilterMatch();
@@ -238,6 +240,8 @@ bool ResourceTreeView::SetFilterText(const wxString& filterText)
 
 void ResourceTreeView::UpdateTreeVisibility()
 {
+    UpdateFilterMatches();
+
     if (_treeModelFilter)
     {
 #if defined(__WXGTK__) && !wxCHECK_VERSION(3, 0, 5)
@@ -411,6 +415,9 @@ void ResourceTreeView::Populate(const IResourceTreePopulator::Ptr& populator)
     // It will fire the TreeModel::PopulationFinishedEvent when done, point it to ourselves
     populator->SetFinishedHandler(this);
 
+    // Let the populator index the rows for our filter
+    populator->SetSearchColumns(_colsToSearch);
+
     // Start population (this might be a thread or not)
     _populator = populator;
     _populator->Populate();
@@ -624,6 +631,12 @@ bool ResourceTreeView::IsFavouriteSelected()
 
 bool ResourceTreeView::IsTreeModelRowOrAnyChildVisible(TreeModel::Row& row)
 {
+    // Rows without any matches in their subtree are invisible, no need to dive in
+    if (!_filterText.empty() && _filterMatchesAndParents.count(row.getItem().GetID()) == 0)
+    {
+        return false;
+    }
+
     // Test the node itself
     if (IsTreeModelRowVisible(row))
     {
@@ -665,7 +678,32 @@ bool ResourceTreeView::IsTreeModelRowVisible(wxutil::TreeModel::Row& row)
 
 bool ResourceTreeView::IsTreeModelRowFiltered(wxutil::TreeModel::Row& row)
 {
-    return !_filterText.empty() && !TreeModel::RowContainsString(row, _filterText, _colsToSearch, true);
+    return !_filterText.empty() && _filterMatches.count(row.getItem().GetID()) == 0;
+}
+
+void ResourceTreeView::UpdateFilterMatches()
+{
+    _filterMatches.clear();
+    _filterMatchesAndParents.clear();
+
+    if (_filterText.empty() || !_treeStore) return;
+
+    // Models populated without our search columns are indexed on first use,
+    // after that the tree store keeps the index up to date on its own
+    if (!_treeStore->HasSearchIndex(_colsToSearch) && !_colsToSearch.empty())
+    {
+        _treeStore->SetSearchColumns(_colsToSearch);
+    }
+
+    _treeStore->ForeachItemContaining(_filterText, [&](const wxDataViewItem& item)
+    {
+        _filterMatches.insert(item.GetID());
+
+        // Mark the parents, stop at the first one that has been visited already
+        for (auto parent = item; parent.IsOk() && _filterMatchesAndParents.insert(parent.GetID()).second;
+             parent = _treeStore->GetParent(parent))
+        {}
+    });
 }
 
 bool ResourceTreeView::IsTreeModelRowVisibleByViewMode(wxutil::TreeModel::Row& row)
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <unordered_set>
 #include "idecltypes.h"
 #include "TreeView.h"
 #include "TreeModel.h"
@@ -94,6 +95,10 @@ private:
 
     wxString _filterText;
 
+    // Items matching the filter text, and the same set including all their parents
+    std::unordered_set<void*> _filterMatches;
+    std::unordered_set<void*> _filterMatchesAndParents;
+
     // The column that is hosting the declaration path (used by e.g. "copy to clipboard")
     TreeModel::Column _declPathColumn;
     TreeModel::Column _favouriteKeyColumn;
@@ -194,6 +199,9 @@ private:
     // Returns true if the given row is filtered by an active filter text
     bool IsTreeModelRowFiltered(wxutil::TreeModel::Row& row);
 
+    // Looks up the items matching the filter text in the search index of the tree store
+    void UpdateFilterMatches();
+
     void _onContextMenu(wxDataViewEvent& ev);
     void _onTreeStorePopulationProgress(TreeModel::PopulationProgressEvent& ev);
     void _onTreeStorePopulationFinished(TreeModel::PopulationFinishedEvent& ev);
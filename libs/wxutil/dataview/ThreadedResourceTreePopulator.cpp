@@ -56,6 +56,12 @@ wxThread::ExitCode ThreadedResourceTreePopulator::Entry()
 
         ThrowIfCancellationRequested();
 
+        // Build the filter index here rather than on the first keystroke in the UI
+        if (!_searchColumns.empty())
+        {
+            _treeStore->SetSearchColumns(_searchColumns);
+        }
+
         wxQueueEvent(_finishedHandler, new TreeModel::PopulationFinishedEvent(_treeStore));
     }
     catch (const ThreadAbortedException&)
@@ -76,6 +82,11 @@ void ThreadedResourceTreePopulator::SetFinishedHandler(wxEvtHandler* finishedHan
     _finishedHandler = finishedHandler;
 }
 
+void ThreadedResourceTreePopulator::SetSearchColumns(const std::vector<TreeModel::Column>& columns)
+{
+    _searchColumns = columns;
+}
+
 void ThreadedResourceTreePopulator::EnsurePopulated()
 {
     // Start the thread now if we have to
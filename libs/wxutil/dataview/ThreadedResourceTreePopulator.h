@@ -36,6 +36,9 @@ private:
     // updating the target tree store from a different thread isn't safe
     TreeModel::Ptr _treeStore;
 
+    // The columns to index once the model is populated
+    std::vector<TreeModel::Column> _searchColumns;
+
     // Whether this thread has been started at all
     bool _started;
 
@@ -69,6 +72,8 @@ public:
 
     virtual void SetFinishedHandler(wxEvtHandler* finishedHandler) override;
 
+    virtual void SetSearchColumns(const std::vector<TreeModel::Column>& columns) override;
+
     // Blocks until the worker thread is done.
     virtual void EnsurePopulated() override;
 
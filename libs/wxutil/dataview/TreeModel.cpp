@@ -2,6 +2,8 @@
 
 #include <algorithm>
 #include <functional>
+#include <unordered_set>
+#include "util/TrigramIndex.h"
 
 namespace wxutil
 {
@@ -86,6 +88,14 @@ public:
 	}
 };
 
+struct TreeModel::SearchIndex
+{
+	std::vector<Column> columns;
+
+	// Keyed by node, the text is the lowercase values of all columns, separated by newlines
+	util::TrigramIndex<void*> index;
+};
+
 // -------------------------------------------------------------------------------
 
 wxDEFINE_EVENT(EV_TREEMODEL_POPULATION_FINISHED, TreeModel::PopulationFinishedEvent);
@@ -158,6 +168,7 @@ void TreeModel::PopulationProgressEvent::SetMessage(const wxString& message)
 TreeModel::TreeModel(const ColumnRecord& columns, bool isListModel) :
 	_columns(columns),
 	_rootNode(Node::createRoot()),
+	_searchIndex(std::make_shared<SearchIndex>()),
 	_defaultStringSortColumn(-1),
 	_hasDefaultCompare(false),
 	_isListModel(isListModel)
@@ -166,6 +177,7 @@ TreeModel::TreeModel(const ColumnRecord& columns, bool isListModel) :
 TreeModel::TreeModel(const TreeModel& existingModel) :
 	_columns(existingModel._columns),
 	_rootNode(existingModel._rootNode),
+	_searchIndex(existingModel._searchIndex),
 	_defaultStringSortColumn(existingModel._defaultStringSortColumn),
 	_hasDefaultCompare(existingModel._hasDefaultCompare),
 	_isListModel(existingModel._isListModel)
@@ -210,6 +222,8 @@ bool TreeModel::RemoveItem(const wxDataViewItem& item)
 
 		if (parent == NULL) return false; // cannot remove the root node
 
+		UnindexNodeRecursively(*node);
+
 		if (parent->remove(node))
 		{
 			ItemDeleted(parent->item, item);
@@ -253,6 +267,7 @@ int TreeModel::RemoveItemsRecursively(const wxDataViewItem& parent, const std::f
 		std::for_each(itemsToDelete.begin(), itemsToDelete.end(), [&] (const wxDataViewItem& item)
 		{
 			Node* nodeToDelete = static_cast<Node*>(item.GetID());
+			UnindexNodeRecursively(*nodeToDelete);
 			parentNode->remove(nodeToDelete);
 			deleteCount++;
 		});
@@ -281,6 +296,8 @@ void TreeModel::Clear()
     NodePtr newRoot = Node::createRoot();
     std::swap(_rootNode, newRoot);
 
+    _searchIndex->index.clear();
+
     Cleared();
 }
 
@@ -567,6 +584,69 @@ bool TreeModel::RowContainsString(const Row& row, const wxString& value, const s
     return false;
 }
 
+void TreeModel::SetSearchColumns(const std::vector<Column>& columns)
+{
+    _searchIndex->index.clear();
+    _searchIndex->columns = columns;
+
+    if (columns.empty()) return;
+
+    ForeachNode([&](Row& row)
+    {
+        IndexNode(*static_cast<Node*>(row.getItem().GetID()));
+    });
+}
+
+bool TreeModel::HasSearchIndex(const std::vector<Column>& columns) const
+{
+    const auto& indexed = _searchIndex->columns;
+
+    return !indexed.empty() && indexed.size() == columns.size() &&
+        std::equal(indexed.begin(), indexed.end(), columns.begin(), [](const Column& a, const Column& b)
+        {
+            return a.getColumnIndex() == b.getColumnIndex();
+        });
+}
+
+void TreeModel::ForeachItemContaining(const wxString& value, const std::function<void(const wxDataViewItem&)>& functor) const
+{
+    _searchIndex->index.foreachMatch(value.ToUTF8().data(), [&](void* id)
+    {
+        functor(wxDataViewItem(id));
+    });
+}
+
+void TreeModel::IndexNode(Node& node)
+{
+    wxString text;
+    Row row(node.item, *this);
+
+    for (const auto& column : _searchIndex->columns)
+    {
+        // Filter texts can't contain newlines, so matches never span multiple columns
+        if (&column != &_searchIndex->columns.front())
+        {
+            text.Append('\n');
+        }
+
+        text.Append(row[column].getString().Lower());
+    }
+
+    _searchIndex->index.insert(node.item.GetID(), text.ToUTF8().data());
+}
+
+void TreeModel::UnindexNodeRecursively(Node& node)
+{
+    if (_searchIndex->columns.empty()) return;
+
+    _searchIndex->index.erase(node.item.GetID());
+
+    for (const auto& child : node.children)
+    {
+        UnindexNodeRecursively(*child);
+    }
+}
+
 bool TreeModel::HasDefaultCompare() const
 {
 	return _hasDefaultCompare;
@@ -638,6 +718,12 @@ bool TreeModel::SetValue(const wxVariant& variant, const wxDataViewItem& item, u
     // Assign the value
     owningNode->values[col] = value;
 
+    if (owningNode != _rootNode.get() && std::any_of(_searchIndex->columns.begin(), _searchIndex->columns.end(),
+        [&](const Column& column) { return column.getColumnIndex() == static_cast<int>(col); }))
+    {
+        IndexNode(*owningNode);
+    }
+
     return true;
 }
 
@@ -942,7 +1028,7 @@ bool TreeModel::CompareFoldersFirst(const wxDataViewItem& a, const wxDataViewIte
 class TreeModel::SearchFunctor
 {
 private:
-	const std::vector<TreeModel::Column>& _columns;
+	std::function<bool(TreeModel::Row&)> _isMatch;
 
 	wxDataViewItem _previousMatch;
 	wxDataViewItem _match;
@@ -956,16 +1042,12 @@ private:
 
 	SearchState _state;
 
-	wxString _searchString;
-
 public:
-	SearchFunctor(const wxString& searchString,
-				  const std::vector<TreeModel::Column>& columns,
+	SearchFunctor(const std::function<bool(TreeModel::Row&)>& isMatch,
 				  const wxDataViewItem& previousMatch) :
-		_columns(columns),
+		_isMatch(isMatch),
 		_previousMatch(previousMatch),
-		_state(previousMatch.IsOk() ? SearchingForLastMatch : Searching),
-		_searchString(searchString.Lower())
+		_state(previousMatch.IsOk() ? SearchingForLastMatch : Searching)
 	{}
 
 	const wxDataViewItem& getMatch() const
@@ -989,7 +1071,7 @@ public:
 			}
 
 		case Searching:
-            if (TreeModel::RowContainsString(row, _searchString, _columns, true))
+            if (_isMatch(row))
             {
                 _match = row.getItem();
                 _state = Found;
@@ -1002,10 +1084,37 @@ public:
 	}
 };
 
+std::function<bool(TreeModel::Row&)> TreeModel::GetStringMatchPredicate(const wxString& needle,
+	const std::vector<TreeModel::Column>& columns) const
+{
+	auto searchString = needle.Lower();
+
+	if (!HasSearchIndex(columns))
+	{
+		return [searchString, columns](Row& row)
+		{
+			return RowContainsString(row, searchString, columns, true);
+		};
+	}
+
+	// Collect the matches up front, the visited rows just need to be looked up
+	auto matches = std::make_shared<std::unordered_set<void*>>();
+
+	ForeachItemContaining(searchString, [&](const wxDataViewItem& item)
+	{
+		matches->insert(item.GetID());
+	});
+
+	return [matches](Row& row)
+	{
+		return matches->count(row.getItem().GetID()) > 0;
+	};
+}
+
 wxDataViewItem TreeModel::FindNextString(const wxString& needle,
 	const std::vector<TreeModel::Column>& columns, const wxDataViewItem& previousMatch)
 {
-	SearchFunctor functor(needle, columns, previousMatch);
+	SearchFunctor functor(GetStringMatchPredicate(needle, columns), previousMatch);
 
 	ForeachNode([&] (Row& row)
 	{
@@ -1019,7 +1128,7 @@ wxDataViewItem TreeModel::FindNextString(const wxString& needle,
 wxDataViewItem TreeModel::FindPrevString(const wxString& needle,
 	const std::vector<TreeModel::Column>& columns, const wxDataViewItem& previousMatch)
 {
-	SearchFunctor functor(needle, columns, previousMatch);
+	SearchFunctor functor(GetStringMatchPredicate(needle, columns), previousMatch);
 
 	ForeachNodeReverse([&] (Row& row)
 	{
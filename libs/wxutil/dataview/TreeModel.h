@@ -369,11 +369,16 @@ protected:
 
 	class SearchFunctor;
 
+	struct SearchIndex;
+
 private:
 	const ColumnRecord& _columns;
 
 	NodePtr _rootNode;
 
+	// Substring index over the search columns, shared with any filter models on top of this one
+	std::shared_ptr<SearchIndex> _searchIndex;
+
 	int _defaultStringSortColumn;
 
 	bool _hasDefaultCompare;
@@ -476,6 +481,19 @@ public:
     static bool RowContainsString(const Row& row, const wxString& value, 
         const std::vector<Column>& columnsToSearch, bool lowerStrings = true);
 
+    // Maintains a trigram index over the given columns of every row, which is updated
+    // whenever rows are changed or removed. Existing rows are indexed right away,
+    // so this can be called by populator threads once the model is complete.
+    // Passing an empty column list discards the index.
+    void SetSearchColumns(const std::vector<Column>& columns);
+
+    // Returns true if the search index is covering exactly the given columns
+    bool HasSearchIndex(const std::vector<Column>& columns) const;
+
+    // Invokes the functor for each item containing the given value in any of the search columns.
+    // Like RowContainsString() the value needs to be lowercase already.
+    void ForeachItemContaining(const wxString& value, const std::function<void(const wxDataViewItem&)>& functor) const;
+
 	void SetAttr(const wxDataViewItem& item, unsigned int col, const wxDataViewItemAttr& attr) const;
 	void SetIsListModel(bool isListModel);
 
@@ -549,6 +567,13 @@ protected:
 	wxDataViewItem FindRecursive(const TreeModel::Node& node, const std::function<bool (const TreeModel::Node&)>& predicate);
 	wxDataViewItem FindRecursiveUsingRows(const TreeModel::Node& node, const std::function<bool (TreeModel::Row&)>& predicate);
 	int RemoveItemsRecursively(const wxDataViewItem& parent, const std::function<bool (const Row&)>& predicate);
+
+	// Returns the row test used by FindNextString/FindPrevString, served by the search index if possible
+	std::function<bool(Row&)> GetStringMatchPredicate(const wxString& needle, const std::vector<Column>& columns) const;
+
+	// Updates the search index entry of the given node, or removes the node and its children
+	void IndexNode(Node& node);
+	void UnindexNodeRecursively(Node& node);
 };
 
 // wx event macros
@@ -14,7 +14,6 @@ namespace gameconn
 namespace
 {
     const char* const DEFAULT_HOST = "localhost";
-    const int DEFAULT_PORT = 3879;
 
     inline std::string seqnoPreamble(std::size_t seq) {
         return fmt::format("seqno {0}\n", seq);
@@ -47,18 +46,17 @@ bool AutomationEngine::hasLostConnection() const
     return _connection && !_connection->isAlive();
 }
 
-bool AutomationEngine::connect()
+bool AutomationEngine::connect(int port)
 {
     if (isAlive())
         return true;    //already connected
 
     // Make connection using clsocket
-    // TODO: make port configurable, as it is in TDM?
     std::unique_ptr<CActiveSocket> connection(new CActiveSocket());
     if (
         !connection->Initialize() ||
         !connection->SetNonblocking() ||
-        !connection->Open(DEFAULT_HOST, DEFAULT_PORT))
+        !connection->Open(DEFAULT_HOST, static_cast<uint16>(port)))
     {
         return false;
     }
@@ -40,13 +40,16 @@ struct MultistepProcReturn {
 class AutomationEngine
 {
 public:
+    // The port TDM's automation listens on by default
+    static constexpr int DefaultPort = 3879;
+
     AutomationEngine();
     ~AutomationEngine();
 
 
-    // Connect to TDM instance if not connected yet.
+    // Connect to TDM instance listening on the given port if not connected yet.
     // Returns false if failed to connect, true on success.
-    bool connect();
+    bool connect(int port = DefaultPort);
     // Disconnect from TDM instance if connected.
     // If force = false, then it waits until all pending requests are finished.
     // If force = true, then all pending requests are dropped, no blocking for sure.
@@ -40,9 +40,11 @@ void DiffDoom3MapWriter::beginWriteEntity(const EntityNodePtr& entity, std::ostr
     const std::string& name = entity->name();
     writeEntityPreamble(name, stream);
     stream << "{" << std::endl;
+    writeEntitySpawnargs(entity->getEntity(), stream);
+}
 
-    // Entity key values
-    entity->getEntity().forEachKeyValue([&](const std::string& key, const std::string& value)
+void DiffDoom3MapWriter::writeEntitySpawnargs(const Entity& entity, std::ostream& stream) {
+    entity.forEachKeyValue([&](const std::string& key, const std::string& value)
     {
         stream << "\"" << key << "\" \"" << value << "\"" << std::endl;
     });
@@ -19,10 +19,14 @@ class DiffDoom3MapWriter : public map::IMapWriter
 {
     const std::map<std::string, DiffStatus>& _entityStatuses;
 
-    void writeEntityPreamble(const std::string& name, std::ostream& stream);
 public:
     DiffDoom3MapWriter(const std::map<std::string, DiffStatus>& statuses);
 
+    // Writes the "add/modify/remove entity" line for the entity with given name
+    void writeEntityPreamble(const std::string& name, std::ostream& stream);
+    // Writes all key values of the entity, one per line (without braces)
+    static void writeEntitySpawnargs(const Entity& entity, std::ostream& stream);
+
     void beginWriteMap(const scene::IMapRootNodePtr& root, std::ostream& stream) override;
     void endWriteMap(const scene::IMapRootNodePtr& root, std::ostream& stream) override;
 
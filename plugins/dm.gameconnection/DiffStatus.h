@@ -1,6 +1,9 @@
 #pragma once
 
 #include <map>
+#include <string>
+#include <cstdlib>
+#include <cassert>
 
 namespace gameconn
 {
@@ -2,6 +2,7 @@
 #include "DiffStatus.h"
 #include "DiffDoom3MapWriter.h"
 #include "AutomationEngine.h"
+#include "MapUpdater.h"
 
 #include "i18n.h"
 #include "igame.h"
@@ -14,7 +15,6 @@
 #include "ui/imenumanager.h"
 #include "ui/imainframe.h"
 
-#include "scene/Traverse.h"
 #include "wxutil/Bitmap.h"
 #include "util/ScopedBoolLock.h"
 #include "registry/registry.h"
@@ -26,7 +26,6 @@
 #include <wx/process.h>
 
 #include "GameConnectionControl.h"
-#include "messages/MapFileOperation.h"
 #include "messages/NotificationMessage.h"
 
 namespace gameconn
@@ -43,6 +42,11 @@ namespace
     constexpr int TAG_CAMERA = 6;
     //multistep procedure for TDM game start/restart
     constexpr int TAG_RESTART = 7;
+    //hot reload map diffs, sent asynchronously one after another
+    constexpr int TAG_MAPUPDATE = 8;
+
+    //entities of the map diff are split into requests of about this size
+    constexpr std::streamoff MAX_MAP_DIFF_REQUEST_SIZE = 64 * 1024;
 
     inline std::string messagePreamble(const std::string& type) {
         return fmt::format("message \"{}\"\n", type);
@@ -60,6 +64,7 @@ namespace
 GameConnection::GameConnection()
 {
     _engine.reset(new AutomationEngine());
+    _mapUpdater.reset(new MapUpdater(*_engine, _mapObserver, TAG_MAPUPDATE, MAX_MAP_DIFF_REQUEST_SIZE));
 }
 
 std::string GameConnection::executeGenericRequest(const std::string& request)
@@ -71,7 +76,6 @@ std::string GameConnection::executeGenericRequest(const std::string& request)
 bool GameConnection::sendAnyPendingAsync()
 {
     if (_mapObserver.getChanges().size() && _updateMapAlways) {
-        //note: this is blocking
         doUpdateMap();
         return true;
     }
@@ -719,84 +723,9 @@ bool GameConnection::isAlwaysUpdateMapEnabled() const
     return _updateMapAlways;
 }
 
-/**
- * stgatilov: Saves only entities with specified names to in-memory map patch.
- * This diff is intended to be consumed by TheDarkMod automation for HotReload purposes.
- * TODO: What about patches and brushes?
- */
-std::string saveMapDiff(const DiffEntityStatuses& entityStatuses)
-{
-    auto root = GlobalSceneGraph().root();
-
-    std::set<scene::INode*> subsetNodes;
-    root->foreachNode([&](const scene::INodePtr& node) {
-        if (entityStatuses.count(node->name()))
-            subsetNodes.insert(node.get());
-        return true;
-    });
-
-    std::ostringstream outStream;
-    outStream << "// diff " << entityStatuses.size() << std::endl;
-
-    DiffDoom3MapWriter writer(entityStatuses);
-
-    //write removal stubs (no actual spawnargs)
-    for (const auto& pNS : entityStatuses) {
-        const auto& name = pNS.first;
-        const auto& status = pNS.second;
-        assert(status.isModified());    //(don't put untouched entities into map)
-        if (status.isRemoved())
-            writer.writeRemoveEntityStub(name, outStream);
-    }
-
-    //write added/modified entities as usual
-    {
-        registry::ScopedKeyChanger progressDisabler(RKEY_MAP_SUPPRESS_LOAD_STATUS_DIALOG, true);
-
-        // Hack: disable recalculateBrushWindings for this export
-        registry::ScopedKeyChanger<std::string> guard("MapExporter_IgnoreBrushes", "yes");
-
-        // Get a scoped exporter class
-        auto exporter = GlobalMapModule().createMapExporter(writer, root, outStream);
-
-        try
-        {
-            // Pass the traversal function and the root of the subgraph to export
-            exporter->exportMap(root, scene::traverseSubset(subsetNodes));
-            // end the life of the exporter instance here to finish the scene
-            exporter.reset();
-        }
-        catch (map::FileOperation::OperationCancelled&)
-        {
-            radiant::NotificationMessage::SendInformation(_("Map export cancelled"));
-        }
-    }
-
-    return outStream.str();
-}
-
 void GameConnection::doUpdateMap()
 {
-    try {
-        if (!_engine->isAlive())
-            return; //no connection, don't even try
-
-        // Get map diff
-        std::string diff = saveMapDiff(_mapObserver.getChanges());
-        if (diff.empty()) {
-            return; //TODO: fail
-        }
-
-        std::string response = executeGenericRequest(actionPreamble("reloadmap-diff") + "content:\n" + diff);
-        if (response.find("HotReload: SUCCESS") != std::string::npos) {
-            //success: clear current diff, so that we don't reapply it next time
-            _mapObserver.clear();
-        }
-    }
-    catch (const DisconnectException&) {
-        //disconnected: will be handled during next think
-        return;
-    }
+    _mapUpdater->sendChanges();
 }
 
 //-------------------------------------------------------------
@@ -14,6 +14,7 @@ namespace gameconn
 
 class MessageTcp;
 class AutomationEngine;
+class MapUpdater;
 
 /**
  * stgatilov: This is TheDarkMod-only system for connecting to game process via socket.
@@ -71,6 +72,7 @@ public:
     // All changes a) since last successful call of this method,
     // or b) since the observer was enabled; are sent as a diff.
     // The game applies the diff on top of its current map state and hot reloads entities.
+    // Large diffs are sent as several requests, this method does not wait for the replies.
     void doUpdateMap();
     // Enable/disable mode: doUpdateMap after every entity change.
     // Note: the update is postponed to next think, so that mass changes go as one diff.
@@ -118,6 +120,8 @@ private:
 
     // Observes over changes to map data (mainly spawnargs of entities).
     MapObserver _mapObserver;
+    // Sends the changes collected by _mapObserver to game.
+    std::unique_ptr<MapUpdater> _mapUpdater;
     // True when "setAutoReloadMapEnabled" is enabled.
     bool _autoReloadMap = false;
     // True when "setAlwaysUpdateMapEnabled" is enabled.
@@ -2,6 +2,9 @@
 #include "inode.h"
 #include "scene/EntityNode.h"
 #include "scene/EntityKeyValue.h"
+#include "DiffDoom3MapWriter.h"
+
+#include <ostream>
 
 namespace gameconn
 {
@@ -39,14 +42,18 @@ static std::vector<EntityNodePtr> getEntitiesInSubgraph(const scene::INodePtr& n
 
 class MapObserver_EntityObserver : public Entity::Observer {
     MapObserver& _owner;
+    EntityNode* _node;
     std::string _entityName;
     bool _enabled = false;
 
 public:
-    MapObserver_EntityObserver(MapObserver& owner) : _owner(owner) {}
+    MapObserver_EntityObserver(MapObserver& owner, EntityNode* node) : _owner(owner), _node(node) {}
     void enable() {
         _enabled = true;
     }
+    const std::string& getEntityName() const {
+        return _entityName;
+    }
     virtual void onKeyInsert(const std::string& key, EntityKeyValue& value) override {
         if (key == "name")
             _entityName = value.get();      //happens when installing observer
@@ -59,6 +66,8 @@ public:
                 //renaming is equivalent to deleting old entity and adding new
                 _owner.entityUpdated(_entityName, DiffStatus::removed());
                 _owner.entityUpdated(val, DiffStatus::added());
+                _owner.entityRenamed(_node, _entityName, val);
+                _entityName = val;
             }
             else {
                 _owner.entityUpdated(_entityName, DiffStatus::modified());
@@ -102,9 +111,10 @@ void MapObserver::enableEntityObservers(const std::vector<EntityNodePtr>& entity
     {
         if (_entityObservers.count(entNode.get()))
             continue;   //already tracked
-        auto* observer = new MapObserver_EntityObserver(*this);
+        auto* observer = new MapObserver_EntityObserver(*this, entNode.get());
         entNode->getEntity().attachObserver(observer);
         _entityObservers[entNode.get()] = observer;
+        _entityNodes[observer->getEntityName()] = entNode.get();
         observer->enable();
     }
 }
@@ -115,7 +125,10 @@ void MapObserver::disableEntityObservers(const std::vector<EntityNodePtr>& entit
     {
         if (!_entityObservers.count(entNode.get()))
             continue;   //not tracked
-        Entity::Observer* observer = _entityObservers[entNode.get()];
+        auto* observer = static_cast<MapObserver_EntityObserver*>(_entityObservers[entNode.get()]);
+        auto named = _entityNodes.find(observer->getEntityName());
+        if (named != _entityNodes.end() && named->second == entNode.get())
+            _entityNodes.erase(named);
         entNode->getEntity().detachObserver(observer);
         delete observer;
         _entityObservers.erase(entNode.get());
@@ -160,8 +173,42 @@ void MapObserver::entityUpdated(const std::string& name, const DiffStatus& diff)
     status = status.combine(diff);
 }
 
+void MapObserver::entityRenamed(EntityNode* node, const std::string& oldName, const std::string& newName) {
+    auto named = _entityNodes.find(oldName);
+    if (named != _entityNodes.end() && named->second == node)
+        _entityNodes.erase(named);
+    _entityNodes[newName] = node;
+}
+
 const DiffEntityStatuses& MapObserver::getChanges() const {
     return _entityChanges;
 }
 
+DiffEntityStatuses MapObserver::takeChanges() {
+    DiffEntityStatuses changes;
+    changes.swap(_entityChanges);
+    return changes;
+}
+
+void MapObserver::restoreChanges(const DiffEntityStatuses& changes) {
+    for (const auto& pNS : changes) {
+        auto later = _entityChanges.find(pNS.first);
+        if (later == _entityChanges.end())
+            _entityChanges.insert(pNS);
+        else
+            later->second = pNS.second.combine(later->second);
+    }
+}
+
+bool MapObserver::writeEntityBlock(const std::string& name, std::ostream& stream) const {
+    auto named = _entityNodes.find(name);
+    if (named == _entityNodes.end())
+        return false;
+
+    stream << "{" << std::endl;
+    DiffDoom3MapWriter::writeEntitySpawnargs(named->second->getEntity(), stream);
+    stream << "}" << std::endl;
+    return true;
+}
+
 }
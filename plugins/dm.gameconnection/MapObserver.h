@@ -31,9 +31,22 @@ public:
     //returns pending entity change since last clear (or since enabled)
     const DiffEntityStatuses& getChanges() const;
 
+    //returns pending entity changes and clears them (like getChanges + clear)
+    DiffEntityStatuses takeChanges();
+
+    //puts changes returned by takeChanges back, e.g. if game failed to apply them
+    //(changes which happened in the meantime are combined with them)
+    void restoreChanges(const DiffEntityStatuses& changes);
+
+    //writes spawnargs of the entity with given name as "{ ... }" block
+    //returns false (writing nothing) if entity is not in scene
+    bool writeEntityBlock(const std::string& name, std::ostream& stream) const;
+
 private:
     //receives events about entity changes
     void entityUpdated(const std::string& name, const DiffStatus& diff);
+    //called when entity with an observer is renamed
+    void entityRenamed(EntityNode* node, const std::string& oldName, const std::string& newName);
     //add/remove entity observers on the set of entity nodes
     void enableEntityObservers(const std::vector<EntityNodePtr>& entityNodes);
     void disableEntityObservers(const std::vector<EntityNodePtr>& entityNodes);
@@ -42,6 +55,8 @@ private:
     std::unique_ptr<scene::Graph::Observer> _sceneObserver;
     //observers put on every entity on scene
     std::map<EntityNode*, Entity::Observer*> _entityObservers;		//note: values owned
+    //entity nodes with observers by their names
+    std::map<std::string, EntityNode*> _entityNodes;
     //set of entities with changes since last clear
     DiffEntityStatuses _entityChanges;
 
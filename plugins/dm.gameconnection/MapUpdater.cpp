@@ -0,0 +1,98 @@
+#include "MapUpdater.h"
+#include "MapObserver.h"
+#include "DiffDoom3MapWriter.h"
+#include "AutomationEngine.h"
+
+#include <cassert>
+#include <sstream>
+#include <fmt/format.h>
+
+namespace gameconn
+{
+
+MapUpdater::MapUpdater(AutomationEngine& engine, MapObserver& observer, int tag, std::streamoff maxRequestSize) :
+    _engine(engine),
+    _observer(observer),
+    _tag(tag),
+    _maxRequestSize(maxRequestSize)
+{}
+
+/**
+ * stgatilov: Writes the diff of one entity to in-memory map patch.
+ * This diff is intended to be consumed by TheDarkMod automation for HotReload purposes.
+ * TODO: What about patches and brushes?
+ */
+bool MapUpdater::writeEntityDiff(DiffDoom3MapWriter& writer, const std::string& name, const DiffStatus& status, std::ostream& stream)
+{
+    assert(status.isModified());    //(don't put untouched entities into map)
+
+    if (status.isRemoved()) {
+        //write removal stub (no actual spawnargs)
+        writer.writeRemoveEntityStub(name, stream);
+        return true;
+    }
+
+    //the preamble is only written if the entity is still there
+    std::ostringstream block;
+    if (!_observer.writeEntityBlock(name, block))
+        return false;
+
+    writer.writeEntityPreamble(name, stream);
+    stream << block.str();
+    return true;
+}
+
+void MapUpdater::sendMapDiff(const DiffEntityStatuses& statuses, const std::string& content)
+{
+    std::string request = fmt::format("message \"action\"\naction \"reloadmap-diff\"\ncontent:\n// diff {0}\n", statuses.size()) + content;
+
+    _engine.executeRequestAsync(_tag, request,
+        [this, statuses](int seqno) {
+            std::string response = _engine.getResponse(seqno);
+            if (response.find("HotReload: SUCCESS") == std::string::npos && _observer.isEnabled()) {
+                //failure: put these entities back, so that they are sent again next time
+                _observer.restoreChanges(statuses);
+            }
+        }
+    );
+}
+
+void MapUpdater::sendChanges()
+{
+    if (!_engine.isAlive())
+        return; //no connection, don't even try
+
+    //take the changes right away: entities changed while the requests
+    //are in flight will be collected for the next update
+    DiffEntityStatuses changes = _observer.takeChanges();
+    DiffDoom3MapWriter writer(changes);
+
+    try {
+        //send the entities in parts of limited size as soon as they are written,
+        //without waiting for the game to apply the previous parts
+        DiffEntityStatuses partStatuses;
+        std::ostringstream partStream;
+
+        for (const auto& pNS : changes) {
+            if (!writeEntityDiff(writer, pNS.first, pNS.second, partStream))
+                continue;
+
+            partStatuses.insert(pNS);
+
+            if (partStream.tellp() >= _maxRequestSize) {
+                sendMapDiff(partStatuses, partStream.str());
+                partStatuses.clear();
+                partStream.str(std::string());
+            }
+        }
+
+        if (!partStatuses.empty())
+            sendMapDiff(partStatuses, partStream.str());
+    }
+    catch (const DisconnectException&) {
+        //disconnected: will be handled during next think
+        _observer.restoreChanges(changes);
+    }
+}
+
+}
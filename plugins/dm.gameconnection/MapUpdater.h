@@ -0,0 +1,43 @@
+#pragma once
+
+#include "DiffStatus.h"
+
+#include <ios>
+#include <string>
+
+namespace gameconn
+{
+
+class AutomationEngine;
+class MapObserver;
+class DiffDoom3MapWriter;
+
+/**
+ * Private for GameConnection class: do not use directly!
+ * Sends the entity changes collected by MapObserver to the game as "reloadmap-diff" requests.
+ */
+class MapUpdater
+{
+public:
+    //requests are sent with the given tag, a new request is started after maxRequestSize bytes
+    MapUpdater(AutomationEngine& engine, MapObserver& observer, int tag, std::streamoff maxRequestSize);
+
+    //takes pending changes from the observer and sends them (async)
+    //every request is sent as soon as it is full, without waiting for the game to apply the previous ones
+    //the entities of requests which the game fails to apply are put back into the observer
+    //throws nothing: if connection is lost, all the changes are put back into the observer
+    void sendChanges();
+
+private:
+    //writes the diff of one entity, returns false if it is neither removed nor present in the scene
+    bool writeEntityDiff(DiffDoom3MapWriter& writer, const std::string& name, const DiffStatus& status, std::ostream& stream);
+    //sends diff of the given entities as one request
+    void sendMapDiff(const DiffEntityStatuses& statuses, const std::string& content);
+
+    AutomationEngine& _engine;
+    MapObserver& _observer;
+    int _tag;
+    std::streamoff _maxRequestSize;
+};
+
+}
@@ -1,17 +1,14 @@
 #pragma once
 
+#include <cstdint>
+#include <cstring>
 #include <vector>
 
-#ifdef __APPLE__
-#include <OpenAL/al.h>
-#else
-#include <AL/al.h>
-#endif
-
 #include <vorbis/vorbisfile.h>
 #include <fmt/format.h>
 
 #include "iarchive.h"
+#include "idatastream.h"
 #include "stream/ScopedArchiveBuffer.h"
 #include "OggFileStream.h"
 
@@ -19,11 +16,52 @@ namespace sound
 {
 
 /**
- * greebo: Loader class creating an AL buffer from an OGG file.
+ * greebo: Helper class determining the length of an OGG file.
+ * Playback is streamed through the OggStreamDecoder.
  */
 class OggFileLoader
 {
 private:
+    typedef StreamBase::byte_type byte_type;
+
+    // Fixed part of an Ogg page header, followed by the segment table
+    static constexpr std::size_t PAGE_HEADER_SIZE = 27;
+
+    // Packet type, "vorbis", version, channels and sample rate
+    static constexpr std::size_t VORBIS_ID_HEADER_SIZE = 16;
+
+    // Header plus 255 segments of 255 bytes each
+    static constexpr std::size_t MAX_PAGE_SIZE = PAGE_HEADER_SIZE + 255 + 255 * 255;
+
+    template<typename T>
+    static T ReadLittleEndian(const byte_type* bytes)
+    {
+        std::uint64_t value = 0;
+
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+        {
+            value |= static_cast<std::uint64_t>(bytes[i]) << (8 * i);
+        }
+
+        return static_cast<T>(value);
+    }
+
+    static std::size_t ReadFully(InputStream& stream, byte_type* buffer, std::size_t length)
+    {
+        std::size_t totalRead = 0;
+
+        while (totalRead < length)
+        {
+            auto bytesRead = stream.read(buffer + totalRead, length - totalRead);
+
+            if (bytesRead == 0) break;
+
+            totalRead += bytesRead;
+        }
+
+        return totalRead;
+    }
+
     class FileWrapper
     {
     private:
@@ -76,64 +114,89 @@ public:
     }
 
     /**
-     * greebo: Loads an OGG file from the given stream into OpenAL,
-     * returns the openAL buffer handle.
+     * Determines the OGG file length in seconds by inspecting the page headers only:
+     * the sample rate is taken from the identification header at the start of the file,
+     * the total sample count from the granule position of the last page.
+     * Only the beginning and the tail of the file are read if the stream is seekable,
+     * otherwise the file is scanned without buffering it entirely.
      *
-     * @throws: std::runtime_error if an error occurs.
+     * Returns false if the file doesn't look like a single Vorbis stream, the caller
+     * should fall back to GetDuration() in this case.
      */
-    static ALuint LoadFromFile(ArchiveFile& vfsFile)
+    static bool ProbeDuration(ArchiveFile& vfsFile, float& duration)
     {
-        FileWrapper file(vfsFile);
+        auto& stream = vfsFile.getInputStream();
+
+        // The first page carries the identification header in its first packet
+        byte_type header[PAGE_HEADER_SIZE + 255 + VORBIS_ID_HEADER_SIZE];
+        auto headerSize = stream.read(header, sizeof(header));
 
-        // Get some information about the OGG file
-        vorbis_info* vorbisInfo = ov_info(file.getHandle(), -1);
+        if (headerSize < PAGE_HEADER_SIZE || std::memcmp(header, "OggS", 4) != 0) return false;
 
-        // Check the number of channels
-        ALenum format = (vorbisInfo->channels == 1) ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+        auto dataOffset = PAGE_HEADER_SIZE + header[26];
+
+        if (headerSize < dataOffset + VORBIS_ID_HEADER_SIZE ||
+            header[dataOffset] != 1 || std::memcmp(header + dataOffset + 1, "vorbis", 6) != 0)
+        {
+            return false;
+        }
 
-        // Get the sample Rate
-        ALsizei freq = static_cast<ALsizei>(vorbisInfo->rate);
+        auto serial = ReadLittleEndian<std::uint32_t>(header + 14);
+        auto sampleRate = ReadLittleEndian<std::uint32_t>(header + dataOffset + 12);
 
-        long bytes;
-        char smallBuffer[4096];
+        if (sampleRate == 0) return false;
 
-        std::vector<char> largeBuffer;
-        largeBuffer.reserve(vfsFile.size() * 2);
+        // Collect the tail of the file, which is large enough to hold the last page header.
+        // When scanning, the buffer is slid by half of its size, keeping at least one page.
+        std::vector<byte_type> tail(MAX_PAGE_SIZE * 2);
+        std::size_t tailSize = 0;
+        auto fileSize = vfsFile.size();
 
-        do
+        if (auto* seekable = dynamic_cast<SeekableInputStream*>(&stream); seekable && fileSize > headerSize)
         {
-            int bitStream;
-            // Read a chunk of decoded data from the vorbis file
-            bytes = ov_read(file.getHandle(), smallBuffer, sizeof(smallBuffer), 0, 2, 1, &bitStream);
+            auto tailStart = fileSize > MAX_PAGE_SIZE ? fileSize - MAX_PAGE_SIZE : 0;
+            seekable->seek(tailStart);
+            tailSize = ReadFully(stream, tail.data(), fileSize - tailStart);
+        }
+        else
+        {
+            // Keep the header bytes in front, they might belong to the last page already
+            std::memcpy(tail.data(), header, headerSize);
+            tailSize = headerSize;
 
-            if (bytes == OV_HOLE)
+            // Slide the window over the rest of the file
+            while (true)
             {
-                rError() << "Error decoding OGG: OV_HOLE.\n";
-            }
-            else if (bytes == OV_EBADLINK)
-            {
-                rError() << "Error decoding OGG: OV_EBADLINK.\n";
-            }
-            else
-            {
-                // Stuff this into the variable-sized buffer
-                largeBuffer.insert(largeBuffer.end(), smallBuffer, smallBuffer + bytes);
+                if (tailSize == tail.size())
+                {
+                    std::memmove(tail.data(), tail.data() + tail.size() / 2, tail.size() - tail.size() / 2);
+                    tailSize -= tail.size() / 2;
+                }
+
+                auto bytesRead = stream.read(tail.data() + tailSize, tail.size() - tailSize);
+
+                if (bytesRead == 0) break;
+
+                tailSize += bytesRead;
             }
-        } 
-        while (bytes > 0);
+        }
 
-        ALuint bufferNum = 0;
-        // Allocate a new buffer
-        alGenBuffers(1, &bufferNum);
+        // Search backwards for the last page of our stream with a valid granule position
+        for (auto i = static_cast<std::ptrdiff_t>(tailSize) - static_cast<std::ptrdiff_t>(PAGE_HEADER_SIZE); i >= 0; --i)
+        {
+            const auto* page = tail.data() + i;
+
+            if (page[0] != 'O' || std::memcmp(page, "OggS", 4) != 0 || page[4] != 0) continue;
+
+            auto granulePosition = ReadLittleEndian<std::int64_t>(page + 6);
 
-        // Upload sound data to buffer
-        alBufferData(bufferNum,
-            format,
-            largeBuffer.data(),
-            static_cast<ALsizei>(largeBuffer.size()),
-            freq);
+            if (ReadLittleEndian<std::uint32_t>(page + 14) != serial || granulePosition < 0) continue;
+
+            duration = static_cast<float>(static_cast<double>(granulePosition) / sampleRate);
+            return true;
+        }
 
-        return bufferNum;
+        return false;
     }
 };
 
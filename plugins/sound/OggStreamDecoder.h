@@ -0,0 +1,123 @@
+#pragma once
+
+#include <stdexcept>
+#include <vorbis/vorbisfile.h>
+#include <fmt/format.h>
+
+#include "iarchive.h"
+#include "idatastream.h"
+#include "itextstream.h"
+
+namespace sound
+{
+
+/**
+ * Decodes an OGG file into signed 16 bit PCM samples, piece by piece.
+ *
+ * The compressed data is pulled from the input stream of the archive file
+ * as the decoding progresses, the file is never loaded into memory as a whole.
+ * This class doesn't know anything about OpenAL, it is used by the streamed
+ * playback as well as by the headless decoding to a PCM sink.
+ */
+class OggStreamDecoder final
+{
+private:
+    ArchiveFilePtr _file;
+    OggVorbis_File _oggFile;
+    int _numChannels;
+    int _sampleRate;
+
+public:
+    // Opens the given file and reads the stream headers
+    // @throws: std::runtime_error if the file is not a valid OGG Vorbis stream
+    OggStreamDecoder(const ArchiveFilePtr& file) :
+        _file(file)
+    {
+        ov_callbacks callbacks;
+        callbacks.read_func = ReadFunc;
+        callbacks.seek_func = nullptr; // the stream is read front to back only
+        callbacks.close_func = nullptr;
+        callbacks.tell_func = nullptr;
+
+        auto result = ov_open_callbacks(static_cast<void*>(this), &_oggFile, nullptr, 0, callbacks);
+
+        if (result != 0)
+        {
+            throw std::runtime_error(fmt::format("Error opening OGG file {0} (error code: {1})",
+                _file->getName(), result));
+        }
+
+        auto* vorbisInfo = ov_info(&_oggFile, -1);
+
+        _numChannels = vorbisInfo->channels;
+        _sampleRate = static_cast<int>(vorbisInfo->rate);
+    }
+
+    OggStreamDecoder(const OggStreamDecoder& other) = delete;
+    OggStreamDecoder& operator=(const OggStreamDecoder& other) = delete;
+
+    ~OggStreamDecoder()
+    {
+        ov_clear(&_oggFile);
+    }
+
+    int getNumChannels() const
+    {
+        return _numChannels;
+    }
+
+    int getSampleRate() const
+    {
+        return _sampleRate;
+    }
+
+    /**
+     * Decodes interleaved samples into the given buffer until it is full
+     * or the end of the stream is reached. Returns the number of bytes written,
+     * which is 0 once the stream is exhausted.
+     */
+    std::size_t decode(char* buffer, std::size_t size)
+    {
+        std::size_t totalBytes = 0;
+
+        while (totalBytes < size)
+        {
+            int bitStream;
+            auto bytes = ov_read(&_oggFile, buffer + totalBytes, static_cast<int>(size - totalBytes), 0, 2, 1, &bitStream);
+
+            if (bytes == 0) break; // end of stream
+
+            if (bytes == OV_HOLE)
+            {
+                // Interrupted data, the decoder recovers with the next page
+                rWarning() << "Error decoding OGG " << _file->getName() << ": OV_HOLE." << std::endl;
+                continue;
+            }
+
+            if (bytes < 0)
+            {
+                rError() << "Error decoding OGG " << _file->getName() << " (error code: " << bytes << ")" << std::endl;
+                break;
+            }
+
+            totalBytes += static_cast<std::size_t>(bytes);
+        }
+
+        return totalBytes;
+    }
+
+private:
+    static std::size_t ReadFunc(void* ptr, std::size_t byteSize, std::size_t sizeToRead, void* datasource)
+    {
+        auto* self = static_cast<OggStreamDecoder*>(datasource);
+
+        if (byteSize == 0) return 0;
+
+        auto bytesRead = self->_file->getInputStream().read(static_cast<StreamBase::byte_type*>(ptr), byteSize * sizeToRead);
+
+        // Return the number of elements like fread does
+        return bytesRead / byteSize;
+    }
+};
+
+}
@@ -0,0 +1,152 @@
+#include "SoundDurationIndex.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include "itextstream.h"
+#include "os/path.h"
+#include "string/case_conv.h"
+
+namespace sound
+{
+
+SoundDurationIndex::SoundDurationIndex(const std::string& indexFile) :
+    _indexFile(indexFile),
+    _changed(false),
+    _stopWorker(false)
+{
+    load();
+}
+
+SoundDurationIndex::~SoundDurationIndex()
+{
+    stopPopulating();
+}
+
+bool SoundDurationIndex::lookup(const std::string& vfsPath, const vfs::FileStamp& stamp, float& duration)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    auto found = _entries.find(vfsPath);
+
+    if (found == _entries.end() || found->second.stamp != stamp)
+    {
+        return false;
+    }
+
+    duration = found->second.duration;
+    return true;
+}
+
+void SoundDurationIndex::insert(const std::string& vfsPath, const vfs::FileStamp& stamp, float duration)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    _entries[vfsPath] = Entry{ stamp, duration };
+    _changed = true;
+}
+
+void SoundDurationIndex::populateInBackground(const std::string& folder, const ProbeFunction& probe)
+{
+    stopPopulating();
+
+    _stopWorker = false;
+    _worker = std::thread([this, folder, probe]()
+    {
+        std::vector<std::string> soundFiles;
+
+        GlobalFileSystem().forEachFile(folder, "*", [&](const vfs::FileInfo& fileInfo)
+        {
+            auto extension = string::to_lower_copy(os::getExtension(fileInfo.name));
+
+            if (extension == "ogg" || extension == "wav")
+            {
+                soundFiles.emplace_back(fileInfo.fullPath());
+            }
+        }, 99);
+
+        for (const auto& soundFile : soundFiles)
+        {
+            if (_stopWorker) return;
+
+            vfs::FileStamp stamp;
+            float duration;
+
+            if (!vfs::getFileStamp(soundFile, stamp) || lookup(soundFile, stamp, duration))
+            {
+                continue;
+            }
+
+            try
+            {
+                insert(soundFile, stamp, probe(soundFile));
+            }
+            catch (const std::runtime_error& ex)
+            {
+                rWarning() << "Could not determine duration of " << soundFile << ": " << ex.what() << std::endl;
+            }
+        }
+    });
+}
+
+void SoundDurationIndex::stopPopulating()
+{
+    if (_worker.joinable())
+    {
+        _stopWorker = true;
+        _worker.join();
+    }
+}
+
+void SoundDurationIndex::load()
+{
+    std::ifstream stream(_indexFile);
+
+    if (!stream) return;
+
+    std::string line;
+
+    // Each line: size, modification time, duration, path (which might contain spaces)
+    while (std::getline(stream, line))
+    {
+        std::istringstream lineStream(line);
+
+        Entry entry;
+        std::string path;
+
+        if (!(lineStream >> entry.stamp.size >> entry.stamp.modificationTime >> entry.duration >> std::ws) ||
+            !std::getline(lineStream, path) || path.empty())
+        {
+            continue;
+        }
+
+        _entries.emplace(path, entry);
+    }
+}
+
+void SoundDurationIndex::save()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    if (!_changed) return;
+
+    std::ofstream stream(_indexFile, std::ios::trunc);
+
+    if (!stream)
+    {
+        rWarning() << "Could not write the sound duration index to " << _indexFile << std::endl;
+        return;
+    }
+
+    stream << std::setprecision(9);
+
+    for (const auto& [path, entry] : _entries)
+    {
+        stream << entry.stamp.size << " " << entry.stamp.modificationTime << " " << entry.duration << " " << path << "\n";
+    }
+
+    _changed = false;
+}
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "vfs/FileStamp.h"
+
+namespace sound
+{
+
+/**
+ * Persistent map of sound file durations, keyed by VFS path. Each entry
+ * carries the size and modification time of the file it has been measured
+ * from, entries of changed files are ignored and replaced.
+ *
+ * The index is read from disk on construction and written back on save().
+ * A worker thread can be launched to measure all sound files which are not
+ * indexed yet, the lookup and insert methods can be used concurrently.
+ */
+class SoundDurationIndex final
+{
+public:
+    // Determines the duration of the given sound file, throws std::runtime_error on failure
+    using ProbeFunction = std::function<float(const std::string&)>;
+
+private:
+    struct Entry
+    {
+        vfs::FileStamp stamp;
+        float duration;
+    };
+
+    std::string _indexFile;
+
+    std::map<std::string, Entry> _entries;
+    std::mutex _lock;
+    bool _changed;
+
+    std::thread _worker;
+    std::atomic<bool> _stopWorker;
+
+public:
+    SoundDurationIndex(const std::string& indexFile);
+
+    // Stops the worker thread, the index is not saved automatically
+    ~SoundDurationIndex();
+
+    // Returns true and fills in the duration if the file is indexed with the given stamp
+    bool lookup(const std::string& vfsPath, const vfs::FileStamp& stamp, float& duration);
+
+    void insert(const std::string& vfsPath, const vfs::FileStamp& stamp, float duration);
+
+    // Measures all sound files in the given VFS folder which are missing
+    // in the index, on a worker thread. Only one worker can be active.
+    void populateInBackground(const std::string& folder, const ProbeFunction& probe);
+
+    // Stops the worker thread, leaving the remaining files unindexed
+    void stopPopulating();
+
+    // Writes the index file if it has been changed since it has been loaded
+    void save();
+
+private:
+    void load();
+};
+
+}
@@ -13,6 +13,8 @@
 
 #include "WavFileLoader.h"
 #include "OggFileLoader.h"
+#include "OggStreamDecoder.h"
+#include "SoundStream.h"
 #include "decl/DeclarationCreator.h"
 
 namespace sound
@@ -24,6 +26,7 @@ namespace
 /// Sound directory name
 constexpr const char* const SOUND_FOLDER = "sound/";
 constexpr const char* const SOUND_FILE_EXTENSION = ".sndshd";
+constexpr const char* const SOUND_DURATION_INDEX_FILE = "soundDurations.idx";
 
 // Load the given file, trying different extensions (first OGG, then WAV) as fallback
 ArchiveFilePtr openSoundFile(const std::string& fileName)
@@ -144,6 +147,24 @@ void SoundManager::initialiseModule(const IApplicationContext& ctx)
     GlobalDeclarationManager().signal_DeclsReloaded(decl::Type::SoundShader).connect(
         [this]() { _sigSoundShadersReloaded.emit(); }
     );
+
+    _durationIndex = std::make_unique<SoundDurationIndex>(ctx.getCacheDataPath() + SOUND_DURATION_INDEX_FILE);
+
+    // Measure the files the index doesn't know yet, once the VFS is up
+    module::GlobalModuleRegistry().signal_allModulesInitialised().connect([this]()
+    {
+        _durationIndex->populateInBackground(SOUND_FOLDER, ProbeSoundFileDuration);
+    });
+}
+
+void SoundManager::shutdownModule()
+{
+    if (_durationIndex)
+    {
+        _durationIndex->stopPopulating();
+        _durationIndex->save();
+        _durationIndex.reset();
+    }
 }
 
 float SoundManager::getSoundFileDuration(const std::string& vfsPath)
@@ -155,22 +176,93 @@ float SoundManager::getSoundFileDuration(const std::string& vfsPath)
         throw std::out_of_range("Could not resolve sound file " + vfsPath);
     }
 
-    auto extension = string::to_lower_copy(os::getExtension(file->getName()));
+    // The file name might carry a different extension than the requested path
+    auto resolvedPath = file->getName();
+    file.reset();
+
+    vfs::FileStamp stamp;
+    auto hasStamp = _durationIndex && vfs::getFileStamp(resolvedPath, stamp);
+
+    float duration = 0.0f;
+
+    if (hasStamp && _durationIndex->lookup(resolvedPath, stamp, duration))
+    {
+        return duration;
+    }
 
     try
     {
-        if (extension == "wav")
-        {
-            return WavFileLoader::GetDuration(file->getInputStream());
-        }
-        else if (extension == "ogg")
-        {
-            return OggFileLoader::GetDuration(*file);
-        }
+        duration = ProbeSoundFileDuration(resolvedPath);
     }
     catch (const std::runtime_error& ex)
     {
         rError() << "Error determining sound file duration " << ex.what() << std::endl;
+        return 0.0f;
+    }
+
+    if (hasStamp)
+    {
+        _durationIndex->insert(resolvedPath, stamp, duration);
+    }
+
+    return duration;
+}
+
+void SoundManager::decodeSoundFile(const std::string& vfsPath, IPcmSink& sink)
+{
+    auto file = openSoundFile(vfsPath);
+
+    if (!file)
+    {
+        throw std::out_of_range("Could not resolve sound file " + vfsPath);
+    }
+
+    if (string::to_lower_copy(os::getExtension(file->getName())) != "ogg")
+    {
+        throw std::runtime_error("Not an OGG file: " + file->getName());
+    }
+
+    OggStreamDecoder decoder(file);
+    sink.setFormat(decoder.getNumChannels(), decoder.getSampleRate());
+
+    // Deliver the samples in the same chunks the playback is using
+    std::vector<std::int16_t> samples(SoundStream::CHUNK_SIZE / sizeof(std::int16_t));
+
+    while (auto size = decoder.decode(reinterpret_cast<char*>(samples.data()), samples.size() * sizeof(std::int16_t)))
+    {
+        sink.writeSamples(samples.data(), size / sizeof(std::int16_t));
+    }
+}
+
+float SoundManager::ProbeSoundFileDuration(const std::string& vfsPath)
+{
+    auto file = GlobalFileSystem().openFile(vfsPath);
+
+    if (!file)
+    {
+        throw std::runtime_error("Could not open " + vfsPath);
+    }
+
+    auto extension = string::to_lower_copy(os::getExtension(vfsPath));
+
+    if (extension == "wav")
+    {
+        // The duration is calculated from the header alone
+        return WavFileLoader::GetDuration(file->getInputStream());
+    }
+
+    if (extension == "ogg")
+    {
+        float duration;
+
+        if (OggFileLoader::ProbeDuration(*file, duration))
+        {
+            return duration;
+        }
+
+        // Unusual stream layout, decode the file to get the exact length
+        file = GlobalFileSystem().openFile(vfsPath);
+        return OggFileLoader::GetDuration(*file);
     }
 
     return 0.0f;
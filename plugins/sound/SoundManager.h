@@ -2,6 +2,7 @@
 
 #include "SoundShader.h"
 #include "SoundPlayer.h"
+#include "SoundDurationIndex.h"
 #include "isound.h"
 
 namespace sound
@@ -19,6 +20,9 @@ private:
 
     sigc::signal<void> _sigSoundShadersReloaded;
 
+    // Durations of the sound files, persisted across sessions
+    std::unique_ptr<SoundDurationIndex> _durationIndex;
+
 public:
 	SoundManager();
 
@@ -30,11 +34,17 @@ public:
 	void stopSound() override;
     void reloadSounds() override;
     float getSoundFileDuration(const std::string& vfsPath) override;
+    void decodeSoundFile(const std::string& vfsPath, IPcmSink& sink) override;
 
 	// RegisterableModule implementation
 	std::string getName() const override;
 	StringSet getDependencies() const override;
 	void initialiseModule(const IApplicationContext& ctx) override;
+	void shutdownModule() override;
+
+private:
+    // Measures the duration of the given resolved VFS file
+    static float ProbeSoundFileDuration(const std::string& vfsPath);
 };
 
 }
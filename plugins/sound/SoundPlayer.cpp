@@ -18,16 +18,24 @@
 #endif
 
 #include "WavFileLoader.h"
-#include "OggFileLoader.h"
 
 namespace sound
 {
 
+namespace
+{
+	// Interval of the stream buffer refill, in milliseconds. Four queued chunks
+	// last about a second, which leaves plenty of room for a late timer event.
+	constexpr int STREAM_UPDATE_INTERVAL = 50;
+}
+
 // Constructor
 SoundPlayer::SoundPlayer() :
 	_initialised(false),
 	_context(NULL),
 	_buffer(0),
+	_streamBuffers{},
+	_streamFormat(AL_FORMAT_MONO16),
 	_source(0)
 {
 	// Disable the timer, to make sure
@@ -93,6 +101,12 @@ SoundPlayer::~SoundPlayer() {
 
 void SoundPlayer::onTimerIntervalReached(wxTimerEvent& ev)
 {
+	if (_stream)
+	{
+		updateStream();
+		return;
+	}
+
 	// Check for active source and buffer
 	if (_source != 0 && _buffer != 0)
 	{
@@ -115,8 +129,9 @@ void SoundPlayer::clearBuffer()
 {
 	// Check if there is an active buffer
 	if (_source != 0) {
-		// Stop playing
+		// Stop playing, this also detaches the queued stream buffers
 		alSourceStop(_source);
+		alSourcei(_source, AL_BUFFER, 0);
 		alDeleteSources(1, &_source);
 		_source = 0;
 
@@ -127,6 +142,15 @@ void SoundPlayer::clearBuffer()
 		}
 	}
 
+	if (_stream)
+	{
+		// Joins the decoder thread
+		_stream.reset();
+
+		alDeleteBuffers(static_cast<ALsizei>(NUM_STREAM_BUFFERS), _streamBuffers);
+		_freeStreamBuffers.clear();
+	}
+
 	_timer.Stop();
 }
 
@@ -151,7 +175,9 @@ void SoundPlayer::play(ArchiveFile& file, bool loopSound)
 
 	if (string::to_lower_copy(ext) == "ogg")
 	{
-		createBufferDataFromOgg(file);
+		// OGG files are decoded while playing
+		startStreaming(file, loopSound);
+		return;
 	}
 	else 
 	{
@@ -195,19 +221,81 @@ void SoundPlayer::createBufferDataFromWav(ArchiveFile& file)
 	}
 }
 
-void SoundPlayer::createBufferDataFromOgg(ArchiveFile& file)
+void SoundPlayer::startStreaming(ArchiveFile& file, bool loopSound)
 {
-    // Must be an OGG file
-    try
-    {
-        // Create an AL sound buffer directly from the buffer in memory
-        _buffer = OggFileLoader::LoadFromFile(file);
-    }
-    catch (std::runtime_error & e)
-    {
-        rError() << "SoundPlayer: Error opening OGG file: " << e.what() << std::endl;
-        _buffer = 0;
-    }
+	try
+	{
+		// Keep as many chunks ready as we have buffers to refill
+		_stream = std::make_unique<SoundStream>(file.getName(), loopSound, NUM_STREAM_BUFFERS);
+	}
+	catch (std::runtime_error& e)
+	{
+		rError() << "SoundPlayer: Error opening OGG file: " << e.what() << std::endl;
+		return;
+	}
+
+	_streamFormat = _stream->getNumChannels() == 1 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+
+	alGenBuffers(static_cast<ALsizei>(NUM_STREAM_BUFFERS), _streamBuffers);
+	_freeStreamBuffers.assign(std::begin(_streamBuffers), std::end(_streamBuffers));
+
+	// The source must not loop by itself, the stream starts over at the end of the file
+	alGenSources(1, &_source);
+	alSourcei(_source, AL_LOOPING, AL_FALSE);
+
+	queueStreamChunks(true);
+
+	alSourcePlay(_source);
+
+	_timer.Start(STREAM_UPDATE_INTERVAL);
+}
+
+void SoundPlayer::queueStreamChunks(bool waitForChunk)
+{
+	while (!_freeStreamBuffers.empty() && _stream->fetchChunk(_streamChunk, waitForChunk))
+	{
+		auto buffer = _freeStreamBuffers.back();
+		_freeStreamBuffers.pop_back();
+
+		alBufferData(buffer, _streamFormat, _streamChunk.data(),
+			static_cast<ALsizei>(_streamChunk.size()), _stream->getSampleRate());
+		alSourceQueueBuffers(_source, 1, &buffer);
+
+		// Only the first chunk is worth waiting for, take whatever else is ready
+		waitForChunk = false;
+	}
+}
+
+void SoundPlayer::updateStream()
+{
+	ALint processed = 0;
+	alGetSourcei(_source, AL_BUFFERS_PROCESSED, &processed);
+
+	for (ALint i = 0; i < processed; ++i)
+	{
+		ALuint buffer;
+		alSourceUnqueueBuffers(_source, 1, &buffer);
+		_freeStreamBuffers.push_back(buffer);
+	}
+
+	queueStreamChunks(false);
+
+	ALint state, queued;
+	alGetSourcei(_source, AL_SOURCE_STATE, &state);
+	alGetSourcei(_source, AL_BUFFERS_QUEUED, &queued);
+
+	if (state == AL_PLAYING) return;
+
+	if (queued > 0)
+	{
+		// The source ran dry before the decoder caught up, resume with what we have
+		alSourcePlay(_source);
+	}
+	else if (_stream->isFinished())
+	{
+		// Done playing, this also stops the timer
+		clearBuffer();
+	}
 }
 
 } // namespace sound
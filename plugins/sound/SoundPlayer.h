@@ -1,6 +1,8 @@
 #pragma once
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #ifdef __APPLE__
 #include <OpenAL/al.h>
@@ -11,6 +13,7 @@
 #endif
 
 #include <wx/timer.h>
+#include "SoundStream.h"
 
 class ArchiveFile;
 
@@ -28,11 +31,23 @@ protected:
 	// The buffer containing the currently played audio data
 	ALuint _buffer;
 
+	// Number of buffers queued on the source while streaming
+	static constexpr std::size_t NUM_STREAM_BUFFERS = 4;
+
+	// The decoder feeding the source while streaming an OGG file
+	std::unique_ptr<SoundStream> _stream;
+	ALuint _streamBuffers[NUM_STREAM_BUFFERS];
+	ALenum _streamFormat;
+
+	// Stream buffers which are not queued on the source
+	std::vector<ALuint> _freeStreamBuffers;
+	SoundStream::Chunk _streamChunk;
+
 	// The source playing the buffer
 	ALuint _source;
 
 	// The timer object to check whether the sound is done playing
-	// to destroy the buffer afterwards
+	// to destroy the buffer afterwards, also refills the stream buffers
 	wxTimer _timer;
 
 public:
@@ -63,8 +78,14 @@ protected:
 	// This is called periodically to check whether the buffer can be cleared
 	void onTimerIntervalReached(wxTimerEvent& ev);
 
-	void createBufferDataFromOgg(ArchiveFile& file);
 	void createBufferDataFromWav(ArchiveFile& file);
+
+	// Starts playback as soon as the first chunk of the OGG file is decoded
+	void startStreaming(ArchiveFile& file, bool loopSound);
+
+	// Recycles the processed buffers and queues the chunks decoded in the meantime
+	void updateStream();
+	void queueStreamChunks(bool waitForChunk);
 };
 
 } // namespace sound
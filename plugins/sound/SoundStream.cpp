@@ -0,0 +1,136 @@
+#include "SoundStream.h"
+
+#include "ifilesystem.h"
+#include "itextstream.h"
+
+namespace sound
+{
+
+namespace
+{
+    std::unique_ptr<OggStreamDecoder> openDecoder(const std::string& vfsPath)
+    {
+        auto file = GlobalFileSystem().openFile(vfsPath);
+
+        if (!file)
+        {
+            throw std::runtime_error("Could not open " + vfsPath);
+        }
+
+        return std::make_unique<OggStreamDecoder>(file);
+    }
+}
+
+SoundStream::SoundStream(const std::string& vfsPath, bool loop, std::size_t maxQueuedChunks) :
+    _vfsPath(vfsPath),
+    _loop(loop),
+    _maxQueuedChunks(maxQueuedChunks),
+    _decoder(openDecoder(vfsPath)),
+    _numChannels(_decoder->getNumChannels()),
+    _sampleRate(_decoder->getSampleRate()),
+    _endOfStream(false),
+    _stop(false)
+{
+    _worker = std::thread(&SoundStream::decodeChunks, this);
+}
+
+SoundStream::~SoundStream()
+{
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _stop = true;
+    }
+
+    _queueChanged.notify_all();
+    _worker.join();
+}
+
+int SoundStream::getNumChannels() const
+{
+    return _numChannels;
+}
+
+int SoundStream::getSampleRate() const
+{
+    return _sampleRate;
+}
+
+bool SoundStream::fetchChunk(Chunk& chunk, bool wait)
+{
+    std::unique_lock<std::mutex> lock(_lock);
+
+    if (wait)
+    {
+        _queueChanged.wait(lock, [this]() { return _endOfStream || !_queue.empty(); });
+    }
+
+    if (_queue.empty())
+    {
+        return false;
+    }
+
+    chunk.swap(_queue.front());
+    _queue.pop_front();
+
+    lock.unlock();
+
+    // Wake up the worker, there's room for another chunk
+    _queueChanged.notify_all();
+    return true;
+}
+
+bool SoundStream::isFinished()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _endOfStream && _queue.empty();
+}
+
+void SoundStream::decodeChunks()
+{
+    while (true)
+    {
+        Chunk chunk(CHUNK_SIZE);
+        std::size_t size = 0;
+
+        try
+        {
+            size = _decoder->decode(chunk.data(), chunk.size());
+
+            if (size == 0 && _loop)
+            {
+                // Start over, the channel count and rate are the same for the same file
+                _decoder = openDecoder(_vfsPath);
+                size = _decoder->decode(chunk.data(), chunk.size());
+            }
+        }
+        catch (const std::runtime_error& ex)
+        {
+            rError() << "SoundStream: " << ex.what() << std::endl;
+            size = 0;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+
+            if (size == 0)
+            {
+                _endOfStream = true;
+            }
+            else
+            {
+                _queueChanged.wait(lock, [this]() { return _stop || _queue.size() < _maxQueuedChunks; });
+
+                if (_stop) return;
+
+                chunk.resize(size);
+                _queue.emplace_back(std::move(chunk));
+            }
+        }
+
+        _queueChanged.notify_all();
+
+        if (size == 0) return;
+    }
+}
+
+}
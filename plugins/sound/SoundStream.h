@@ -0,0 +1,71 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "OggStreamDecoder.h"
+
+namespace sound
+{
+
+/**
+ * Decodes an OGG file on a worker thread, keeping a bounded number of
+ * decoded chunks ready for the player to pick up. The worker pauses as soon
+ * as the queue is full, such that the memory used by a stream stays the same
+ * regardless of the length of the file.
+ *
+ * Looping streams restart the decoder at the end of the file.
+ */
+class SoundStream final
+{
+public:
+    typedef std::vector<char> Chunk;
+
+    // Size of a decoded chunk in bytes, about 0.4 seconds of 44.1 kHz mono audio
+    static constexpr std::size_t CHUNK_SIZE = 32768;
+
+private:
+    std::string _vfsPath;
+    bool _loop;
+    std::size_t _maxQueuedChunks;
+
+    // Only accessed by the worker thread after construction
+    std::unique_ptr<OggStreamDecoder> _decoder;
+    int _numChannels;
+    int _sampleRate;
+
+    std::mutex _lock;
+    std::condition_variable _queueChanged;
+    std::deque<Chunk> _queue;
+    bool _endOfStream;
+    bool _stop;
+
+    std::thread _worker;
+
+public:
+    // Opens the given file and starts decoding in the background
+    // @throws: std::runtime_error if the file cannot be opened or decoded
+    SoundStream(const std::string& vfsPath, bool loop, std::size_t maxQueuedChunks);
+
+    // Stops the worker thread
+    ~SoundStream();
+
+    int getNumChannels() const;
+    int getSampleRate() const;
+
+    // Moves the next decoded chunk into the given one. If wait is true, this blocks
+    // until a chunk is available. Returns false if there is no chunk (yet).
+    bool fetchChunk(Chunk& chunk, bool wait);
+
+    // True if the decoder reached the end of the file and all chunks have been fetched
+    bool isFinished();
+
+private:
+    void decodeChunks();
+};
+
+}
@@ -18,6 +18,8 @@
 #include "ui/imainframe.h"
 #include "ishaders.h"
 #include "ieditstopwatch.h"
+#include "imodelcache.h"
+#include "ithumbnails.h"
 #include "icounter.h"
 #include "icameraview.h"
 
@@ -130,6 +132,8 @@ StringSet UserInterfaceModule::getDependencies() const
         MODULE_EDITING_STOPWATCH,
         MODULE_COUNTER,
         MODULE_CLIPPER,
+        MODULE_MODELCACHE,
+        MODULE_THUMBNAILMANAGER,
     };
 
 	return _dependencies;
@@ -255,6 +259,14 @@ void UserInterfaceModule::initialiseModule(const IApplicationContext& ctx)
     _reloadMaterialsConn = GlobalDeclarationManager().signal_DeclsReloaded(decl::Type::Material)
         .connect([this]() { dispatch([]() { GlobalMainFrame().updateAllWindows(); }); });
 
+    // Models finished by the background loaders are swapped in on the main thread
+    GlobalModelCache().setBackgroundLoadNotifier(
+        [this]() { dispatch([]() { GlobalModelCache().processFinishedModelLoads(); }); });
+
+    // Same for the material thumbnails decoded by the thumbnail workers
+    GlobalThumbnailManager().setThumbnailLoadNotifier(
+        [this]() { dispatch([]() { GlobalThumbnailManager().processFinishedThumbnails(); }); });
+
     registerControl(std::make_shared<ConsoleControl>());
     registerControl(std::make_shared<SurfaceInspectorControl>());
     registerControl(std::make_shared<LayerControl>());
@@ -326,6 +338,8 @@ void UserInterfaceModule::shutdownModule()
 	GlobalRadiantCore().getMessageBus().removeListener(_notificationListener);
 
     _reloadMaterialsConn.disconnect();
+    GlobalModelCache().setBackgroundLoadNotifier({});
+    GlobalThumbnailManager().setThumbnailLoadNotifier({});
 	_coloursUpdatedConn.disconnect();
 	_entitySettingsConn.disconnect();
     _mapEditModeChangedConn.disconnect();
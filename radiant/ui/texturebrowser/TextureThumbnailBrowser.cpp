@@ -9,6 +9,7 @@
 #include "ifavourites.h"
 #include "ishaderclipboard.h"
 #include "icommandsystem.h"
+#include "ithumbnails.h"
 
 #include "wxutil/menu/IconTextMenuItem.h"
 #include "wxutil/GLWidget.h"
@@ -21,6 +22,7 @@
 
 #include "string/split.h"
 #include "string/case_conv.h"
+#include <algorithm>
 #include <functional>
 
 #include <wx/panel.h>
@@ -49,6 +51,9 @@ namespace
 
     constexpr int VIEWPORT_BORDER = 12;
     constexpr int TILE_BORDER = 2;
+
+    // Image size assumed for tiles whose thumbnail has not been loaded yet
+    constexpr int PLACEHOLDER_IMAGE_SIZE = 256;
 }
 
 class TextureThumbnailBrowser::TextureTile
@@ -60,24 +65,65 @@ public:
     Vector2i position;
     MaterialPtr material;
 
+    // False while the tile is using the placeholder size
+    bool hasImageSize = false;
+
     TextureTile(TextureThumbnailBrowser& owner) :
         _owner(owner)
     {}
 
-    void render(bool drawName)
+    // Returns true if this tile overlaps the given vertical range of the virtual space
+    bool isWithin(int top, int bottom) const
     {
-        TexturePtr texture = material->getEditorImage();
-        if (!texture) return;
+        return position.y() - size.y() - FONT_HEIGHT() < top && position.y() > bottom;
+    }
 
+    void render(bool drawName)
+    {
         // Is this texture visible?
-        if ((position.y() - size.y() - FONT_HEIGHT() < _owner.getOriginY()) &&
-            (position.y() > _owner.getOriginY() - _owner.getViewportHeight()))
+        if (!isWithin(_owner.getOriginY(), _owner.getOriginY() - _owner.getViewportHeight()))
+        {
+            return;
+        }
+
+        shaders::Thumbnail thumbnail;
+
+        switch (GlobalThumbnailManager().getThumbnail(material->getName(), thumbnail))
+        {
+        case shaders::IThumbnailManager::Status::Ready:
         {
+            if (thumbnail.page >= _owner._atlasPageTextures.size()) return;
+
+            const auto& pageTexture = *_owner._atlasPageTextures[thumbnail.page].texture;
+            auto pageWidth = static_cast<double>(pageTexture.getWidth());
+            auto pageHeight = static_cast<double>(pageTexture.getHeight());
+
+            drawBorder();
+            drawTextureQuad(pageTexture.getGLTexNum(),
+                thumbnail.x / pageWidth, thumbnail.y / pageHeight,
+                (thumbnail.x + thumbnail.width) / pageWidth, (thumbnail.y + thumbnail.height) / pageHeight);
+            break;
+        }
+
+        case shaders::IThumbnailManager::Status::Unavailable:
+        {
+            // No thumbnail can be made from this image, draw the editor image itself
+            TexturePtr texture = material->getEditorImage();
+            if (!texture) return;
+
+            drawBorder();
+            drawTextureQuad(texture->getGLTexNum(), 0, 0, 1, 1);
+            break;
+        }
+
+        default:
+            // Thumbnail is still being loaded
             drawBorder();
-            drawTextureQuad(texture->getGLTexNum());
-            if (drawName)
-                drawTextureName();
+            break;
         }
+
+        if (drawName)
+            drawTextureName();
     }
 
 private:
@@ -153,20 +199,21 @@ private:
         }
     }
 
-    void drawTextureQuad(GLuint num)
+    // Draws the given texture rectangle (s0, t0) - (s1, t1) into the tile
+    void drawTextureQuad(GLuint num, double s0, double t0, double s1, double t1)
     {
         glBindTexture(GL_TEXTURE_2D, num);
         debug::assertNoGlErrors();
         glColor3f(1, 1, 1);
 
         glBegin(GL_QUADS);
-        glTexCoord2i(0, 0);
+        glTexCoord2d(s0, t0);
         glVertex2i(position.x(), position.y() - FONT_HEIGHT());
-        glTexCoord2i(1, 0);
+        glTexCoord2d(s1, t0);
         glVertex2i(position.x() + size.x(), position.y() - FONT_HEIGHT());
-        glTexCoord2i(1, 1);
+        glTexCoord2d(s1, t1);
         glVertex2i(position.x() + size.x(), position.y() - FONT_HEIGHT() - size.y());
-        glTexCoord2i(0, 1);
+        glTexCoord2d(s0, t1);
         glVertex2i(position.x(), position.y() - FONT_HEIGHT() - size.y());
         glEnd();
     }
@@ -228,6 +275,10 @@ TextureThumbnailBrowser::TextureThumbnailBrowser(wxWindow* parent, bool showTool
     observeKey(RKEY_TEXTURE_MAX_NAME_LENGTH);
     observeKey(RKEY_TEXTURES_SHOW_NAMES);
 
+    GlobalThumbnailManager().signal_thumbnailsChanged().connect(
+        sigc::mem_fun(this, &TextureThumbnailBrowser::onThumbnailsChanged)
+    );
+
     loadScaleFromRegistry();
 
     _shader = texdef_name_default();
@@ -420,14 +471,14 @@ void TextureThumbnailBrowser::keyChanged()
 }
 
 // Return the display width of a texture in the texture browser
-int TextureThumbnailBrowser::getTextureWidth(const Texture& tex) const
+int TextureThumbnailBrowser::getTextureWidth(const Vector2i& imageSize) const
 {
     if (!_useUniformScale)
     {
         // Don't use uniform scale
-        return static_cast<int>(tex.getWidth() * (static_cast<float>(_textureScale) / 100));
+        return static_cast<int>(imageSize.x() * (static_cast<float>(_textureScale) / 100));
     }
-    else if (tex.getWidth() >= tex.getHeight())
+    else if (imageSize.x() >= imageSize.y())
     {
         // Texture is square, or wider than it is tall
         return _uniformTextureSize;
@@ -436,19 +487,19 @@ int TextureThumbnailBrowser::getTextureWidth(const Texture& tex) const
     {
         // Otherwise, preserve the texture's aspect ratio
         return static_cast<int>(_uniformTextureSize *
-            (static_cast<float>(tex.getWidth()) / tex.getHeight())
+            (static_cast<float>(imageSize.x()) / imageSize.y())
         );
     }
 }
 
-int TextureThumbnailBrowser::getTextureHeight(const Texture& tex) const
+int TextureThumbnailBrowser::getTextureHeight(const Vector2i& imageSize) const
 {
     if (!_useUniformScale)
     {
         // Don't use uniform scale
-        return static_cast<int>(tex.getHeight() * (static_cast<float>(_textureScale) / 100));
+        return static_cast<int>(imageSize.y() * (static_cast<float>(_textureScale) / 100));
     }
-    else if (tex.getHeight() >= tex.getWidth())
+    else if (imageSize.y() >= imageSize.x())
     {
         // Texture is square, or taller than it is wide
         return _uniformTextureSize;
@@ -458,7 +509,7 @@ int TextureThumbnailBrowser::getTextureHeight(const Texture& tex) const
         // Otherwise, preserve the texture's aspect ratio
         return static_cast<int>(
             _uniformTextureSize
-            * (static_cast<float>(tex.getHeight()) / tex.getWidth())
+            * (static_cast<float>(imageSize.y()) / imageSize.x())
         );
     }
 }
@@ -519,12 +570,12 @@ TextureThumbnailBrowser::CurrentPosition::CurrentPosition()
 : origin(VIEWPORT_BORDER, -VIEWPORT_BORDER), rowAdvance(0)
 { }
 
-Vector2i TextureThumbnailBrowser::getNextPositionForTexture(const Texture& tex)
+Vector2i TextureThumbnailBrowser::getNextPositionForTexture(const Vector2i& displaySize)
 {
     auto& currentPos = *_currentPopulationPosition;
 
-    int nWidth = getTextureWidth(tex);
-    int nHeight = getTextureHeight(tex);
+    int nWidth = displaySize.x();
+    int nHeight = displaySize.y();
 
     // Wrap to the next row if there is not enough horizontal space for this
     // texture
@@ -606,11 +657,30 @@ void TextureThumbnailBrowser::createTileForMaterial(const MaterialPtr& material)
 
     tile.material = material;
 
-    Texture& texture = *tile.material->getEditorImage();
+    // The tiles are laid out without loading the images, the size is taken from
+    // the thumbnails (which might be on disk). Tiles of unknown size get a placeholder
+    // size and are arranged again as soon as their thumbnail is there.
+    Vector2i imageSize(PLACEHOLDER_IMAGE_SIZE, PLACEHOLDER_IMAGE_SIZE);
+    std::size_t width, height;
+    shaders::Thumbnail thumbnail;
+
+    if (GlobalThumbnailManager().getImageSize(material->getName(), width, height))
+    {
+        imageSize = Vector2i(static_cast<int>(width), static_cast<int>(height));
+        tile.hasImageSize = true;
+    }
+    else if (GlobalThumbnailManager().getThumbnail(material->getName(), thumbnail) ==
+        shaders::IThumbnailManager::Status::Unavailable)
+    {
+        // This one is rendered from the editor image anyway
+        auto texture = material->getEditorImage();
+        imageSize = Vector2i(static_cast<int>(texture->getWidth()), static_cast<int>(texture->getHeight()));
+        tile.hasImageSize = true;
+    }
 
-    tile.position = getNextPositionForTexture(texture);
-    tile.size.x() = getTextureWidth(texture);
-    tile.size.y() = getTextureHeight(texture);
+    tile.size.x() = getTextureWidth(imageSize);
+    tile.size.y() = getTextureHeight(imageSize);
+    tile.position = getNextPositionForTexture(tile.size);
 
     _entireSpaceHeight = std::max(
         _entireSpaceHeight,
@@ -734,6 +804,9 @@ void TextureThumbnailBrowser::draw()
     glEnable (GL_TEXTURE_2D);
 	glPolygonMode (GL_FRONT_AND_BACK, GL_FILL);
 
+    requestVisibleThumbnails();
+    updateAtlasPageTextures();
+
     for (const auto& tile : _tiles)
     {
         tile->render(_showNamesKey.get());
@@ -748,6 +821,107 @@ void TextureThumbnailBrowser::draw()
 	glPopAttrib();
 }
 
+void TextureThumbnailBrowser::requestVisibleThumbnails()
+{
+    auto top = getOriginY();
+    auto viewportHeight = getViewportHeight();
+
+    std::vector<std::string> materials;
+    std::vector<std::string> nextPage;
+
+    for (const auto& tile : _tiles)
+    {
+        if (tile->isWithin(top, top - viewportHeight))
+        {
+            materials.push_back(tile->material->getName());
+        }
+        else if (tile->isWithin(top - viewportHeight, top - 2 * viewportHeight))
+        {
+            nextPage.push_back(tile->material->getName());
+        }
+    }
+
+    // Prefetch the page below, after the visible ones
+    materials.insert(materials.end(), nextPage.begin(), nextPage.end());
+
+    auto& thumbnails = GlobalThumbnailManager();
+    shaders::Thumbnail thumbnail;
+
+    // Request again if another view took over the thumbnail queue in the meantime
+    auto isDropped = [&](const std::string& material)
+    {
+        return thumbnails.getThumbnail(material, thumbnail) == shaders::IThumbnailManager::Status::NotRequested;
+    };
+
+    if (materials == _requestedThumbnails && std::none_of(materials.begin(), materials.end(), isDropped))
+    {
+        return;
+    }
+
+    _requestedThumbnails.swap(materials);
+    thumbnails.requestThumbnails(_requestedThumbnails);
+}
+
+void TextureThumbnailBrowser::updateAtlasPageTextures()
+{
+    auto& thumbnails = GlobalThumbnailManager();
+    auto numPages = thumbnails.getNumPages();
+
+    _atlasPageTextures.resize(numPages);
+
+    for (std::size_t i = 0; i < numPages; ++i)
+    {
+        auto& pageTexture = _atlasPageTextures[i];
+        auto revision = thumbnails.getPageRevision(i);
+
+        if (pageTexture.texture && pageTexture.revision == revision) continue;
+
+        auto page = thumbnails.getPage(i);
+
+        if (!pageTexture.texture)
+        {
+            GLuint textureNum;
+            glGenTextures(1, &textureNum);
+
+            pageTexture.texture = std::make_shared<BasicTexture2D>(textureNum, "$thumbnails");
+            pageTexture.texture->setWidth(page->getWidth());
+            pageTexture.texture->setHeight(page->getHeight());
+        }
+
+        glBindTexture(GL_TEXTURE_2D, pageTexture.texture->getGLTexNum());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, static_cast<GLsizei>(page->getWidth()),
+            static_cast<GLsizei>(page->getHeight()), 0, GL_RGBA, GL_UNSIGNED_BYTE, page->getPixels());
+
+        pageTexture.revision = revision;
+    }
+
+    debug::assertNoGlErrors();
+}
+
+void TextureThumbnailBrowser::onThumbnailsChanged()
+{
+    // Tiles with placeholder size need to be arranged again once their image size is known
+    for (const auto& tile : _tiles)
+    {
+        if (tile->hasImageSize) continue;
+
+        std::size_t width, height;
+        shaders::Thumbnail thumbnail;
+
+        if (GlobalThumbnailManager().getImageSize(tile->material->getName(), width, height) ||
+            GlobalThumbnailManager().getThumbnail(tile->material->getName(), thumbnail) ==
+                shaders::IThumbnailManager::Status::Unavailable)
+        {
+            queueUpdate();
+            break;
+        }
+    }
+
+    queueDraw();
+}
+
 void TextureThumbnailBrowser::doMouseWheel(bool wheelUp)
 {
     int originy = getOriginY();
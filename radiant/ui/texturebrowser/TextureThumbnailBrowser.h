@@ -3,6 +3,7 @@
 #include "wxutil/FreezePointer.h"
 
 #include "texturelib.h"
+#include "BasicTexture2D.h"
 #include "wxutil/menu/PopupMenu.h"
 #include "registry/CachedKey.h"
 
@@ -102,6 +103,17 @@ class TextureThumbnailBrowser :
     // renderable items will be updated next round
     bool _updateNeeded;
 
+    // GL textures of the thumbnail atlas pages, with the page revision they have been uploaded from
+    struct AtlasPageTexture
+    {
+        BasicTexture2DPtr texture;
+        std::size_t revision = 0;
+    };
+    std::vector<AtlasPageTexture> _atlasPageTextures;
+
+    // The materials passed to the last thumbnail request, visible ones first
+    std::vector<std::string> _requestedThumbnails;
+
     // Data structure keeping track of the virtual position for the next texture to
     // be drawn in. Only the getNextPositionForTexture() method should access the values
     // in this structure.
@@ -160,13 +172,21 @@ private:
     // Repopulates the texture tiles
     void refreshTiles();
 
-    // Return the display width/height of a texture in the texture browser
-    int getTextureWidth(const Texture& tex) const;
-    int getTextureHeight(const Texture& tex) const;
+    // Return the display width/height of an image with the given size in the texture browser
+    int getTextureWidth(const Vector2i& imageSize) const;
+    int getTextureHeight(const Vector2i& imageSize) const;
 
-    // Get a new position for the given texture, and advance the CurrentPosition
+    // Get a new position for the given display size, and advance the CurrentPosition
     // state object.
-    Vector2i getNextPositionForTexture(const Texture& texture);
+    Vector2i getNextPositionForTexture(const Vector2i& displaySize);
+
+    // Requests the thumbnails of the tiles in the viewport and the page below it
+    void requestVisibleThumbnails();
+
+    // Uploads the thumbnail atlas pages which have been changed since the last draw
+    void updateAtlasPageTextures();
+
+    void onThumbnailsChanged();
 
     bool checkSeekInMediaBrowser(); // sensitivity check
     void onSeekInMediaBrowser();
@@ -407,6 +407,8 @@ void Brush::push_back(Faces::value_type face) {
         (*i)->push_back(*face);
         (*i)->DEBUG_verify();
     }
+
+    _owner.materialsChanged();
 }
 
 void Brush::pop_back()
@@ -421,6 +423,8 @@ void Brush::pop_back()
         (*i)->pop_back();
         (*i)->DEBUG_verify();
     }
+
+    _owner.materialsChanged();
 }
 
 void Brush::erase(std::size_t index)
@@ -435,6 +439,8 @@ void Brush::erase(std::size_t index)
         (*i)->erase(index);
         (*i)->DEBUG_verify();
     }
+
+    _owner.materialsChanged();
 }
 
 void Brush::onFacePlaneChanged()
@@ -450,6 +456,8 @@ void Brush::onFaceShaderChanged()
 
     // Queue an UI update of the texture tools if any of them is listening
 	signal_faceShaderChanged().emit();
+
+    _owner.materialsChanged();
 }
 
 void Brush::onFaceConnectivityChanged()
@@ -479,6 +487,8 @@ void Brush::clear()
         (*i)->clear();
         (*i)->DEBUG_verify();
     }
+
+    _owner.materialsChanged();
 }
 
 std::size_t Brush::getNumFaces() const
@@ -153,6 +153,12 @@ public:
 
 		virtual ~BrushUndoMemento() {}
 
+		std::size_t getMemoryUsage() const override
+		{
+			// The faces are shared with the brush, only the references are held here
+			return sizeof(*this) + _faces.capacity() * sizeof(FacePtr);
+		}
+
 		Faces _faces;
 		DetailFlag _detailFlag;
 	};
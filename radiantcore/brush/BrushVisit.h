@@ -1,6 +1,9 @@
 #pragma once
 
 #include "iselection.h"
+#include "imap.h"
+#include "imaterialusage.h"
+#include "string/predicate.h"
 #include "FaceInstance.h"
 #include "BrushNode.h"
 
@@ -61,4 +64,34 @@ inline void foreachVisibleFaceInstance(const FaceInstanceVisitFunc& functor)
 	GlobalSceneGraph().root()->traverseChildren(visitor);
 }
 
+// Visits each visible brush using the given material (case-insensitive) on at least one face
+inline void foreachVisibleBrushUsingMaterial(const std::string& material, const BrushVisitFunc& functor)
+{
+	GlobalSceneGraph().root()->getMaterialUsageIndex().foreachNodeUsingMaterial(material,
+		[&](const INodePtr& node)
+	{
+		if (!node->visible()) return;
+
+		if (auto* brush = Node_getBrush(node); brush != nullptr)
+		{
+			functor(*brush);
+		}
+	});
+}
+
+// Visits the visible face instances using the given material (case-insensitive)
+inline void foreachVisibleFaceInstanceUsingMaterial(const std::string& material, const FaceInstanceVisitFunc& functor)
+{
+	foreachVisibleBrushUsingMaterial(material, [&](Brush& brush)
+	{
+		brush.getBrushNode().forEachFaceInstance([&](FaceInstance& instance)
+		{
+			if (instance.getFace().isVisible() && string::iequals(instance.getFace().getShader(), material))
+			{
+				functor(instance);
+			}
+		});
+	});
+}
+
 } // namespace
@@ -8,6 +8,7 @@
 #include "math/Matrix3.h"
 #include "shaderlib.h"
 #include "texturelib.h"
+#include "DeltaUndoMemento.h"
 #include "Winding.h"
 #include "selection/algorithm/Texturing.h"
 
@@ -29,6 +30,59 @@ public:
         _texdefState(face.getProjection()),
         _materialName(face.getShader())
     {}
+
+    SavedState(const undo::StateBuffer& buffer) :
+        _planeState(Plane3())
+    {
+        undo::StateReader reader(buffer);
+
+        double normalX, normalY, normalZ, dist;
+        reader.read(normalX);
+        reader.read(normalY);
+        reader.read(normalZ);
+        reader.read(dist);
+        _planeState = FacePlane::SavedState(Plane3(normalX, normalY, normalZ, dist));
+
+        double xx, xy, yx, yy, zx, zy;
+        reader.read(xx);
+        reader.read(xy);
+        reader.read(yx);
+        reader.read(yy);
+        reader.read(zx);
+        reader.read(zy);
+        _texdefState = TextureProjection(TextureMatrix(Matrix3::byColumns(xx, xy, 0, yx, yy, 0, zx, zy, 1)));
+
+        reader.read(_materialName);
+    }
+
+    undo::StateBuffer serialise() const
+    {
+        undo::StateBuffer buffer;
+
+        // Fixed-size members first, to keep their offsets stable
+        const auto& plane = _planeState.m_plane;
+        undo::writeState(buffer, plane.normal().x());
+        undo::writeState(buffer, plane.normal().y());
+        undo::writeState(buffer, plane.normal().z());
+        undo::writeState(buffer, plane.dist());
+
+        auto matrix = _texdefState.getMatrix();
+        undo::writeState(buffer, matrix.xx());
+        undo::writeState(buffer, matrix.xy());
+        undo::writeState(buffer, matrix.yx());
+        undo::writeState(buffer, matrix.yy());
+        undo::writeState(buffer, matrix.zx());
+        undo::writeState(buffer, matrix.zy());
+
+        undo::writeState(buffer, _materialName);
+
+        return buffer;
+    }
+
+    std::size_t getMemoryUsage() const override
+    {
+        return sizeof(*this) + _materialName.capacity();
+    }
 };
 
 Face::Face(Brush& owner) :
@@ -204,11 +258,34 @@ IUndoMementoPtr Face::exportState() const
     return std::make_shared<SavedState>(*this);
 }
 
+IUndoMementoPtr Face::compactState(const IUndoMementoPtr& data) const
+{
+    auto state = std::dynamic_pointer_cast<SavedState>(data);
+
+    if (!state) return data; // already a delta
+
+    return undo::createDeltaMemento(data, state->serialise(), SavedState(*this).serialise());
+}
+
 void Face::importState(const IUndoMementoPtr& data)
 {
-    undoSave();
+    auto state = std::dynamic_pointer_cast<SavedState>(data);
 
-    auto state = std::static_pointer_cast<SavedState>(data);
+    if (!state)
+    {
+        try
+        {
+            auto delta = std::static_pointer_cast<undo::DeltaUndoMemento>(data);
+            state = std::make_shared<SavedState>(delta->apply(SavedState(*this).serialise()));
+        }
+        catch (const undo::InvalidStateError& ex)
+        {
+            rError() << "Cannot restore face state: " << ex.what() << std::endl;
+            return;
+        }
+    }
+
+    undoSave();
 
     state->_planeState.exportState(getPlane());
     setShader(state->_materialName);
@@ -99,6 +99,7 @@ public:
 	// undoable
 	IUndoMementoPtr exportState() const override;
 	void importState(const IUndoMementoPtr& data) override;
+	IUndoMementoPtr compactState(const IUndoMementoPtr& data) const override;
 
     /// Translate the face by the given vector
     void translate(const Vector3& translation);
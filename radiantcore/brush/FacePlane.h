@@ -21,6 +21,10 @@ public:
             m_plane(facePlane.m_plane)
         {}
 
+        SavedState(const Plane3& plane) :
+            m_plane(plane)
+        {}
+
         void exportState(FacePlane& facePlane) const
         {
             facePlane.m_plane = m_plane;
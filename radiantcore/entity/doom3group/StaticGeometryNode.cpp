@@ -212,6 +212,11 @@ void StaticGeometryNode::removeOriginFromChildren()
 	}
 }
 
+Vector3 StaticGeometryNode::getChildPrimitiveOffset() const
+{
+	return isModel() ? Vector3(0, 0, 0) : -m_origin;
+}
+
 void StaticGeometryNode::selectionChangedComponent(const ISelectable& selectable)
 {
 	GlobalSelectionSystem().onComponentSelection(Node::getSelf(), selectable);
@@ -131,6 +131,7 @@ public:
 	 */
 	void addOriginToChildren() override;
 	void removeOriginFromChildren() override;
+	Vector3 getChildPrimitiveOffset() const override;
 
 	// Renderable implementation
     void onPreRender(const VolumeTest& volume) override;
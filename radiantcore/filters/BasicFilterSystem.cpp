@@ -28,8 +28,22 @@ namespace
 
     // Registry key for persistent filter setting
     const std::string RKEY_USER_ACTIVE_FILTERS = RKEY_USER_FILTER_BASE + "//activeFilter";
+
+    bool masksIntersect(const std::vector<bool>& a, const std::vector<bool>& b)
+    {
+        for (std::size_t i = 0; i < a.size() && i < b.size(); ++i)
+        {
+            if (a[i] && b[i]) return true;
+        }
+
+        return false;
+    }
 }
 
+BasicFilterSystem::BasicFilterSystem() :
+    _materialsUpToDate(false)
+{}
+
 void BasicFilterSystem::setAllFilterStates(bool state)
 {
     if (state)
@@ -41,9 +55,7 @@ void BasicFilterSystem::setAllFilterStates(bool state)
         _activeFilters.clear();
     }
 
-    // Invalidate the visibility cache to force new values to be
-    // loaded from the filters themselves
-    _visibilityCache.clear();
+    updateActiveMask();
 
     // Update the scenegraph instances
     update();
@@ -114,6 +126,11 @@ void BasicFilterSystem::initialiseModule(const IApplicationContext& ctx)
     // user-defined filters
     addFiltersFromXML(userFilters, false);
 
+    updateFilterBits();
+
+    // Keep track of the scene nodes to update when a single filter is toggled
+    GlobalSceneGraph().addSceneObserver(&_nodeIndex);
+
     // Shortcuts to enable/disable all filters
     GlobalCommandSystem().addCommand(
         "ActivateAllFilters", [=](const cmd::ArgumentList&) { setAllFilterStates(true); }
@@ -200,10 +217,13 @@ void BasicFilterSystem::shutdownModule()
         }
     }
 
-    _visibilityCache.clear();
+    GlobalSceneGraph().removeSceneObserver(&_nodeIndex);
+    _nodeIndex.clear();
+
     _eventAdapters.clear();
     _activeFilters.clear();
     _availableFilters.clear();
+    updateFilterBits();
 
     _filterCollectionChangedSignal.clear();
     _filterConfigChangedSignal.clear();
@@ -254,10 +274,15 @@ void BasicFilterSystem::setFilterState(const std::string& filter, bool state)
 {
     assert(!_availableFilters.empty());
 
+    auto f = _availableFilters.find(filter);
+    assert(f != _availableFilters.end());
+
+    auto previousActiveMask = _activeMask;
+
     if (state)
     {
         // Copy the filter to the active filters list
-        _activeFilters.emplace(filter, _availableFilters.find(filter)->second);
+        _activeFilters.emplace(filter, f->second);
     }
     else
     {
@@ -265,12 +290,19 @@ void BasicFilterSystem::setFilterState(const std::string& filter, bool state)
         _activeFilters.erase(filter);
     }
 
-    // Invalidate the visibility cache to force new values to be
-    // loaded from the filters themselves
-    _visibilityCache.clear();
+    updateActiveMask();
 
-    // Update the scenegraph instances
-    update();
+    // Update the scenegraph instances, the cached hiding masks tell which
+    // items are affected by this filter. Without an evaluation of all
+    // materials to start from, fall back to a full update.
+    if (_materialsUpToDate)
+    {
+        updateSceneAfterToggle(*f->second, previousActiveMask);
+    }
+    else
+    {
+        update();
+    }
 
     _filterConfigChangedSignal.emit();
 
@@ -296,6 +328,8 @@ bool BasicFilterSystem::addFilter(const std::string& filterName, const FilterRul
     // Create the event adapter
     ensureEventAdapter(*filter);
 
+    updateFilterBits();
+
     _filterCollectionChangedSignal.emit();
 
     return true;
@@ -325,13 +359,12 @@ bool BasicFilterSystem::removeFilter(const std::string& filter)
     // Now remove the object from the available filters too
     _availableFilters.erase(f);
 
+    updateFilterBits();
+
     _filterCollectionChangedSignal.emit();
 
     if (wasActive)
     {
-        // Clear the cache, the rules have changed
-        _visibilityCache.clear();
-
         _filterConfigChangedSignal.emit();
 
         update();
@@ -398,6 +431,9 @@ bool BasicFilterSystem::renameFilter(const std::string& oldFilterName, const std
     // Remove the old filter from the filtertable
     _availableFilters.erase(oldFilterName);
 
+    // The bit positions follow the order of the names
+    updateFilterBits();
+
     _filterCollectionChangedSignal.emit();
 
     return true;
@@ -406,35 +442,31 @@ bool BasicFilterSystem::renameFilter(const std::string& oldFilterName, const std
 // Query whether an item is visible or filtered out
 bool BasicFilterSystem::isVisible(const FilterType type, const std::string& name)
 {
-    // Check if this item is in the visibility cache, returning
-    // its cached value if found
-    auto cacheIter = _visibilityCache.find(name);
+    // The item is visible if none of the filters hiding it is active
+    return !masksIntersect(getHidingMask(type, name), _activeMask);
+}
 
-    if (cacheIter != _visibilityCache.end())
+const BasicFilterSystem::FilterMask& BasicFilterSystem::getHidingMask(FilterType type, const std::string& name)
+{
+    auto& cache = _hidingMasks[type];
+
+    // Check if this item is in the cache, returning its cached value if found
+    auto cacheIter = cache.find(name);
+
+    if (cacheIter != cache.end())
     {
         return cacheIter->second;
     }
 
-    // Otherwise, walk the list of active filters to find a value for
-    // this item.
-    bool visFlag = true; // default if no filters modify it
+    // Otherwise, ask every filter whether it hides this item
+    FilterMask mask(_filterBits.size(), false);
 
-    for (const auto& active : _activeFilters)
+    for (const auto& [filterName, bit] : _filterBits)
     {
-        // Delegate the check to the filter object. If a filter returns
-        // false for the visibility check, then the item is filtered
-        // and we don't need any more checks.
-        if (!active.second->isVisible(type, name))
-        {
-            visFlag = false;
-            break;
-        }
+        mask[bit] = !_availableFilters[filterName]->isVisible(type, name);
     }
 
-    // Cache the result and return to caller
-    _visibilityCache.emplace(name, visFlag);
-
-    return visFlag;
+    return cache.emplace(name, std::move(mask)).first->second;
 }
 
 bool BasicFilterSystem::isEntityVisible(const Entity& entity) const
@@ -470,7 +502,7 @@ bool BasicFilterSystem::setFilterRules(const std::string& filter, const FilterRu
         f->second->setRules(ruleSet);
 
         // Clear the cache, the ruleset has changed
-        _visibilityCache.clear();
+        clearHidingMasks();
 
         _filterConfigChangedSignal.emit();
 
@@ -496,8 +528,7 @@ void BasicFilterSystem::popState()
     _activeFilters = _stateStack.back();
     _stateStack.pop_back();
 
-    // Clear cache and update
-    _visibilityCache.clear();
+    updateActiveMask();
     update();
     _filterConfigChangedSignal.emit();
 }
@@ -535,6 +566,108 @@ void BasicFilterSystem::updateShaders()
             isVisible(FilterType::TEXTURE, material->getName())
         );
     });
+
+    _materialsUpToDate = true;
+}
+
+void BasicFilterSystem::updateSceneAfterToggle(const SceneFilter& filter, const FilterMask& previousActiveMask)
+{
+    auto bit = _filterBits.at(filter.getName());
+
+    // Collect the materials changing their visibility. All materials are checked,
+    // the ones created after the last full update still carry their default flag.
+    std::set<std::string> changedMaterials;
+
+    GlobalMaterialManager().foreachMaterial([&](const MaterialPtr& material)
+    {
+        const auto& mask = getHidingMask(FilterType::TEXTURE, material->getName());
+
+        bool wasVisible = !masksIntersect(mask, previousActiveMask);
+        bool isVisible = !masksIntersect(mask, _activeMask);
+
+        if ((!mask[bit] || wasVisible == isVisible) && material->isVisible() == isVisible) return;
+
+        material->setVisible(isVisible);
+        changedMaterials.insert(material->getName());
+    });
+
+    if (!GlobalSceneGraph().root()) return;
+
+    InstanceUpdateWalker walker(*this);
+
+    // Entities first, a hidden entity hides its child primitives too.
+    // Spawnargs can change at any time, so entity results are not cached,
+    // but only entities whose state is actually changing get traversed.
+    if (filter.hasRulesOfType(FilterType::ECLASS) || filter.hasRulesOfType(FilterType::SPAWNARG))
+    {
+        _nodeIndex.foreachEntity([&](const scene::INodePtr& node)
+        {
+            if (isEntityVisible(*node->tryGetEntity()) == node->isFiltered())
+            {
+                node->traverse(walker);
+            }
+        });
+    }
+
+    auto updatePrimitive = [&](const scene::INodePtr& node)
+    {
+        auto parent = node->getParent();
+
+        // Primitives of hidden entities stay hidden
+        if (!parent || !parent->isFiltered())
+        {
+            walker.pre(node);
+        }
+    };
+
+    if (filter.hasRulesOfType(FilterType::OBJECT))
+    {
+        _nodeIndex.foreachPrimitive(updatePrimitive);
+    }
+    else if (!changedMaterials.empty())
+    {
+        _nodeIndex.foreachPrimitiveUsingMaterials(changedMaterials, updatePrimitive);
+    }
+
+    // Model surfaces might come into view or end up hidden
+    _nodeIndex.foreachOtherNode([](const scene::INodePtr& node)
+    {
+        node->onFiltersChanged();
+    });
+}
+
+void BasicFilterSystem::updateFilterBits()
+{
+    _filterBits.clear();
+
+    for (const auto& [name, filter] : _availableFilters)
+    {
+        _filterBits.emplace(name, _filterBits.size());
+    }
+
+    clearHidingMasks();
+    updateActiveMask();
+}
+
+void BasicFilterSystem::updateActiveMask()
+{
+    _activeMask.assign(_filterBits.size(), false);
+
+    for (const auto& [name, filter] : _activeFilters)
+    {
+        auto bit = _filterBits.find(name);
+
+        if (bit != _filterBits.end())
+        {
+            _activeMask[bit->second] = true;
+        }
+    }
+}
+
+void BasicFilterSystem::clearHidingMasks()
+{
+    _hidingMasks.clear();
+    _materialsUpToDate = false;
 }
 
 // RegisterableModule implementation
@@ -553,6 +686,7 @@ StringSet BasicFilterSystem::getDependencies() const
         _dependencies.insert(MODULE_XMLREGISTRY);
         _dependencies.insert(MODULE_GAMEMANAGER);
         _dependencies.insert(MODULE_COMMANDSYSTEM);
+        _dependencies.insert(MODULE_SCENEGRAPH);
     }
 
     return _dependencies;
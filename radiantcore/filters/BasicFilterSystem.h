@@ -11,6 +11,7 @@
 #include "xmlutil/Node.h"
 #include "scene/filters/SceneFilter.h"
 #include "XmlFilterEventAdapter.h"
+#include "FilterableNodeIndex.h"
 
 namespace filters
 {
@@ -25,10 +26,25 @@ class BasicFilterSystem: public IFilterSystem
     // Second table containing just the active filters
     FilterTable _activeFilters;
 
-    // Cache of visibility flags for item names, to avoid having to
-    // traverse the active filter list for each lookup
-    typedef std::map<std::string, bool> StringFlagCache;
-    StringFlagCache _visibilityCache;
+    // One flag per available filter, in the order of _availableFilters
+    typedef std::vector<bool> FilterMask;
+
+    // Bit position of each available filter in a FilterMask
+    std::map<std::string, std::size_t> _filterBits;
+
+    // The bits of the currently active filters
+    FilterMask _activeMask;
+
+    // Cache of the filters hiding an item, evaluated against all available
+    // filters, such that it stays valid when filters are toggled
+    typedef std::map<std::string, FilterMask> HidingMaskCache;
+    std::map<FilterType, HidingMaskCache> _hidingMasks;
+
+    // True if the materials have been evaluated since the cache was cleared
+    bool _materialsUpToDate;
+
+    // The nodes of the current scene, used to update a subset of them
+    FilterableNodeIndex _nodeIndex;
 
     sigc::signal<void> _filterConfigChangedSignal;
     sigc::signal<void> _filterCollectionChangedSignal;
@@ -46,6 +62,15 @@ private:
     void updateScene();
 
     void updateShaders();
+
+    // Updates the nodes that might be affected after toggling the given filter
+    void updateSceneAfterToggle(const SceneFilter& filter, const FilterMask& previousActiveMask);
+
+    // Assigns the bit positions of the available filters, clearing the cache
+    void updateFilterBits();
+    void updateActiveMask();
+    void clearHidingMasks();
+    const FilterMask& getHidingMask(FilterType type, const std::string& name);
     void addFiltersFromXML(const xml::NodeList& nodes, bool readOnly);
     XmlFilterEventAdapter::Ptr ensureEventAdapter(SceneFilter& filter);
     void selectObjectsByFilterCmd(const cmd::ArgumentList& args);
@@ -56,6 +81,8 @@ private:
     void setAllFilterStates(bool state);
 
 public:
+    BasicFilterSystem();
+
     // FilterSystem implementation
     sigc::signal<void> filterConfigChangedSignal() const override;
     sigc::signal<void> filterCollectionChangedSignal() const override;
@@ -0,0 +1,100 @@
+#include "FilterableNodeIndex.h"
+
+#include "imap.h"
+#include "imaterialusage.h"
+
+namespace filters
+{
+
+namespace
+{
+    void visitNodes(const std::map<scene::INode*, scene::INodeWeakPtr>& nodes,
+        const std::function<void(const scene::INodePtr&)>& func)
+    {
+        for (const auto& [_, weakNode] : nodes)
+        {
+            if (auto node = weakNode.lock())
+            {
+                func(node);
+            }
+        }
+    }
+}
+
+void FilterableNodeIndex::onSceneNodeInsert(const scene::INodePtr& node)
+{
+    switch (node->getNodeType())
+    {
+    case scene::INode::Type::Entity:
+        _entities.emplace(node.get(), node);
+        break;
+
+    case scene::INode::Type::Brush:
+    case scene::INode::Type::Patch:
+        _primitives.emplace(node.get(), node);
+        break;
+
+    case scene::INode::Type::MapRoot:
+        // The root would notify the whole tree
+        break;
+
+    default:
+        _otherNodes.emplace(node.get(), node);
+        break;
+    }
+}
+
+void FilterableNodeIndex::onSceneNodeErase(const scene::INodePtr& node)
+{
+    _entities.erase(node.get());
+    _primitives.erase(node.get());
+    _otherNodes.erase(node.get());
+}
+
+void FilterableNodeIndex::clear()
+{
+    _entities.clear();
+    _primitives.clear();
+    _otherNodes.clear();
+}
+
+void FilterableNodeIndex::foreachEntity(const std::function<void(const scene::INodePtr&)>& func) const
+{
+    visitNodes(_entities, func);
+}
+
+void FilterableNodeIndex::foreachPrimitive(const std::function<void(const scene::INodePtr&)>& func) const
+{
+    visitNodes(_primitives, func);
+}
+
+void FilterableNodeIndex::foreachPrimitiveUsingMaterials(const std::set<std::string>& materials,
+    const std::function<void(const scene::INodePtr&)>& func) const
+{
+    auto rootNode = GlobalSceneGraph().root();
+
+    if (!rootNode) return;
+
+    // Collect first, a primitive can use more than one of the materials
+    NodeMap primitives;
+
+    for (const auto& material : materials)
+    {
+        rootNode->getMaterialUsageIndex().foreachNodeUsingMaterial(material, [&](const scene::INodePtr& node)
+        {
+            if (_primitives.count(node.get()) > 0)
+            {
+                primitives.emplace(node.get(), node);
+            }
+        });
+    }
+
+    visitNodes(primitives, func);
+}
+
+void FilterableNodeIndex::foreachOtherNode(const std::function<void(const scene::INodePtr&)>& func) const
+{
+    visitNodes(_otherNodes, func);
+}
+
+}
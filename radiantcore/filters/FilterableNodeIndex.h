@@ -0,0 +1,50 @@
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <functional>
+
+#include "iscenegraph.h"
+
+namespace filters
+{
+
+/**
+ * Keeps track of the scene nodes the filter system is evaluating, such that
+ * toggling a single filter only needs to visit the nodes it can affect.
+ *
+ * This is internal to the filter module, the nodes are not notifying the
+ * filter system of any changes. Material changes are picked up by the material
+ * usage index of the map root, which is queried for the primitives using a
+ * certain material.
+ */
+class FilterableNodeIndex final :
+    public scene::Graph::Observer
+{
+private:
+    typedef std::map<scene::INode*, scene::INodeWeakPtr> NodeMap;
+
+    NodeMap _entities;
+    NodeMap _primitives;
+
+    // Models and all other nodes which might react to onFiltersChanged()
+    NodeMap _otherNodes;
+
+public:
+    // Graph::Observer implementation
+    void onSceneNodeInsert(const scene::INodePtr& node) override;
+    void onSceneNodeErase(const scene::INodePtr& node) override;
+
+    void clear();
+
+    void foreachEntity(const std::function<void(const scene::INodePtr&)>& func) const;
+    void foreachPrimitive(const std::function<void(const scene::INodePtr&)>& func) const;
+
+    // Visits each primitive using at least one of the given materials, once
+    void foreachPrimitiveUsingMaterials(const std::set<std::string>& materials,
+        const std::function<void(const scene::INodePtr&)>& func) const;
+    void foreachOtherNode(const std::function<void(const scene::INodePtr&)>& func) const;
+};
+
+}
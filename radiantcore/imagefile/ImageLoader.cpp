@@ -93,6 +93,28 @@ ImagePtr ImageLoader::imageFromVFS(const std::string& rawName) const
 	return ImagePtr();
 }
 
+std::string ImageLoader::findImageInVFS(const std::string& rawName) const
+{
+    auto name = os::standardPath(rawName).substr(0, rawName.rfind("."));
+
+    for (const auto& extension : _extensions)
+    {
+        auto loaderIter = _loadersByExtension.find(extension);
+
+        if (loaderIter == _loadersByExtension.end()) continue;
+
+        // Same candidates as in imageFromVFS
+        auto fullName = loaderIter->second->getPrefix() + name + "." + extension;
+
+        if (!GlobalFileSystem().getFileInfo(fullName).isEmpty())
+        {
+            return fullName;
+        }
+    }
+
+    return std::string();
+}
+
 ImagePtr ImageLoader::imageFromFile(const std::string& filename) const
 {
     ImagePtr image;
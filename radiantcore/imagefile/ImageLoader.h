@@ -30,6 +30,7 @@ public:
 
     // ImageLoader implementation
     ImagePtr imageFromVFS(const std::string& vfsPath) const override;
+    std::string findImageInVFS(const std::string& vfsPath) const override;
 	ImagePtr imageFromFile(const std::string& filename) const override;
 
     // RegisterableModule implementation
@@ -23,6 +23,25 @@ namespace
 	constexpr const char* const DEFAULT_LAYER_NAME = N_("Default");
 	constexpr int DEFAULT_LAYER = 0;
 	constexpr int NO_PARENT_ID = -1;
+
+	// Checks whether any direct child of a node is visible at the current layer settings
+	class VisibleChildFinder :
+		public NodeVisitor
+	{
+	public:
+		bool visibleChildFound = false;
+
+		bool pre(const INodePtr& node) override
+		{
+			if (!node->checkStateFlag(Node::eLayered))
+			{
+				visibleChildFound = true;
+			}
+
+			// The flags of the children already reflect their own children
+			return false;
+		}
+	};
 }
 
 LayerManager::LayerManager(INode& rootNode) :
@@ -62,6 +81,8 @@ int LayerManager::createLayer(const std::string& name, int layerID)
 	_layerVisibility[layerID] = true;
     _layerParentIds[layerID] = NO_PARENT_ID;
 
+	updateVisibleLayers();
+
 	// Layers have changed
 	onLayersChanged();
 
@@ -105,8 +126,10 @@ void LayerManager::deleteLayer(const std::string& name)
     }
 
 	// Remove all nodes from this layer first, but don't de-select them yet
-	RemoveFromLayerWalker walker(layerID);
-	_rootNode.traverse(walker);
+	for (const auto& node : getLayerMembers({ layerID }))
+	{
+		node->removeFromLayer(layerID);
+	}
 
 	// Remove the layer
 	_layers.erase(layerID);
@@ -115,6 +138,8 @@ void LayerManager::deleteLayer(const std::string& name)
 	_layerVisibility[layerID] = true;
 	_layerParentIds[layerID] = NO_PARENT_ID;
 
+	updateVisibleLayers();
+
 	if (layerID == _activeLayer)
 	{
 		// We have removed the active layer, fall back to default
@@ -150,6 +175,8 @@ void LayerManager::reset()
     _layerParentIds.resize(1);
     _layerParentIds[DEFAULT_LAYER] = NO_PARENT_ID;
 
+	updateVisibleLayers();
+
 	// Emit all changed signals
 	_layersChangedSignal.emit();
 	_layerVisibilityChangedSignal.emit();
@@ -224,7 +251,8 @@ bool LayerManager::layerIsVisible(int layerID)
 
 void LayerManager::setLayerVisibility(int layerId, bool visible)
 {
-    auto layerVisibilityChanged = setLayerVisibilityRecursively(layerId, visible);
+    std::vector<int> changedLayerIds;
+    setLayerVisibilityRecursively(layerId, visible, changedLayerIds);
 
 	if (!visible && !_layerVisibility.at(_activeLayer))
 	{
@@ -240,26 +268,62 @@ void LayerManager::setLayerVisibility(int layerId, bool visible)
         _activeLayer = layerId;
     }
 
-    if (layerVisibilityChanged)
+    if (!changedLayerIds.empty())
     {
 	    // Fire the visibility changed event
-	    onLayerVisibilityChanged();
+	    onLayerVisibilityChanged(changedLayerIds);
     }
 }
 
-bool LayerManager::setLayerVisibilityRecursively(int rootLayerId, bool visible)
+void LayerManager::setLayerVisibilityRecursively(int rootLayerId, bool visible, std::vector<int>& changedLayerIds)
 {
-    bool visibilityChange = false;
-
     foreachLayerInHierarchy(rootLayerId, [&](int layerId)
     {
         if (layerId < 0 || layerId >= _layerVisibility.size()) return;
 
-        visibilityChange |= _layerVisibility.at(layerId) != visible;
-        _layerVisibility.at(layerId) = visible;
+        if (_layerVisibility.at(layerId) != visible)
+        {
+            _layerVisibility.at(layerId) = visible;
+            changedLayerIds.push_back(layerId);
+        }
     });
 
-    return visibilityChange;
+    updateVisibleLayers();
+}
+
+void LayerManager::updateVisibleLayers()
+{
+    _visibleLayers.clear();
+
+    for (std::size_t layerId = 0; layerId < _layerVisibility.size(); ++layerId)
+    {
+        _visibleLayers.set(static_cast<int>(layerId), _layerVisibility[layerId]);
+    }
+}
+
+std::vector<INodePtr> LayerManager::getLayerMembers(const std::vector<int>& layerIds)
+{
+    std::vector<INodePtr> members;
+    std::unordered_set<INode*> visitedNodes;
+
+    for (int layerId : layerIds)
+    {
+        auto found = _layerMembers.find(layerId);
+
+        if (found == _layerMembers.end()) continue;
+
+        for (const auto& [node, weakNode] : found->second)
+        {
+            if (!visitedNodes.insert(node).second) continue;
+
+            if (auto member = weakNode.lock(); member)
+            {
+                members.push_back(member);
+            }
+        }
+    }
+
+    return members;
 }
 
 void LayerManager::updateSceneGraphVisibility()
@@ -271,6 +335,50 @@ void LayerManager::updateSceneGraphVisibility()
 	SceneChangeNotify();
 }
 
+void LayerManager::updateNodeAndAncestorVisibility(const std::vector<INodePtr>& nodes)
+{
+    for (const auto& node : nodes)
+    {
+        // Walk upwards as long as the visibility keeps changing,
+        // a parent stays visible as long as any of its children is
+        for (auto current = node; current && !current->isRoot(); current = current->getParent())
+        {
+            bool wasVisible = !current->checkStateFlag(Node::eLayered);
+
+            if (updateNodeVisibilityFromChildren(current) == wasVisible)
+            {
+                break;
+            }
+        }
+    }
+}
+
+bool LayerManager::updateNodeVisibilityFromChildren(const INodePtr& node)
+{
+    bool isVisible = updateNodeVisibility(node);
+
+    if (!isVisible)
+    {
+        // Show the node if any child is visible, like the UpdateNodeVisibilityWalker does
+        VisibleChildFinder finder;
+        node->traverseChildren(finder);
+
+        if (finder.visibleChildFound)
+        {
+            node->disable(Node::eLayered);
+            isVisible = true;
+        }
+    }
+
+    if (!isVisible)
+    {
+        // Node is hidden by layers after update, de-select
+        Node_setSelected(node, false);
+    }
+
+    return isVisible;
+}
+
 void LayerManager::onLayersChanged()
 {
 	_layersChangedSignal.emit();
@@ -283,10 +391,13 @@ void LayerManager::onNodeMembershipChanged()
 	updateSceneGraphVisibility();
 }
 
-void LayerManager::onLayerVisibilityChanged()
+void LayerManager::onLayerVisibilityChanged(const std::vector<int>& changedLayerIds)
 {
-	// Update all nodes and views
-	updateSceneGraphVisibility();
+	// Only the members of the changed layers (and their parents) need an update
+	updateNodeAndAncestorVisibility(getLayerMembers(changedLayerIds));
+
+	// Redraw
+	SceneChangeNotify();
 
 	// Update the UI
 	_layerVisibilityChangedSignal.emit();
@@ -335,23 +446,8 @@ bool LayerManager::updateNodeVisibility(const INodePtr& node)
         return true; // doesn't support layers, return true for visible
     }
 
-	// Get the list of layers the node is associated with
-	const auto& layers = node->getLayers();
-
-	// We start with the assumption that a node is hidden
-    bool isHidden = true;
-
-	// Cycle through the Node's layers, and show the node as soon as
-	// a visible layer is found.
-	for (int layerId : layers)
-	{
-		if (_layerVisibility[layerId])
-		{
-			// The layer is visible, set the visibility to true and quit
-            isHidden = false;
-			break;
-		}
-	}
+	// The node is hidden unless any of its layers is visible
+    bool isHidden = !node->getLayerBitset().intersects(_visibleLayers);
 
     if (isHidden)
     {
@@ -366,6 +462,37 @@ bool LayerManager::updateNodeVisibility(const INodePtr& node)
 	return !isHidden;
 }
 
+void LayerManager::onNodeLayersChanged(INode& node, const LayerBitset& oldLayers, const LayerBitset& newLayers)
+{
+    oldLayers.foreachLayer([&](int layerId)
+    {
+        if (newLayers.test(layerId)) return;
+
+        auto found = _layerMembers.find(layerId);
+
+        if (found == _layerMembers.end()) return;
+
+        found->second.erase(&node);
+
+        if (found->second.empty())
+        {
+            _layerMembers.erase(found);
+        }
+    });
+
+    if (newLayers.empty()) return; // node has been removed from the scene
+
+    auto self = node.getSelf();
+
+    newLayers.foreachLayer([&](int layerId)
+    {
+        if (!oldLayers.test(layerId))
+        {
+            _layerMembers[layerId].emplace(&node, self);
+        }
+    });
+}
+
 void LayerManager::foreachLayerInHierarchy(int rootLayerId, const std::function<void(int)>& functor)
 {
     if (rootLayerId == -1) return;
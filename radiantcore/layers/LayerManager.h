@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include "ilayer.h"
 
 namespace scene 
@@ -21,6 +22,15 @@ private:
 	// quickly check whether a layer is visible or not.
     std::vector<bool> _layerVisibility;
 
+    // The visible layers of the above array as bitset, to check a node's
+    // layers against. Since hiding or showing a layer affects its child layers
+    // too, this already reflects the layer hierarchy.
+    LayerBitset _visibleLayers;
+
+    // The nodes in the scene by layer ID, such that a visibility change
+    // only needs to visit the members of the affected layers
+    std::map<int, std::unordered_map<INode*, std::weak_ptr<INode>>> _layerMembers;
+
     // The parent IDs of each layer (-1 for no parent)
     std::vector<int> _layerParentIds;
 
@@ -109,6 +119,8 @@ public:
 
 	bool updateNodeVisibility(const scene::INodePtr& node) override;
 
+	void onNodeLayersChanged(INode& node, const LayerBitset& oldLayers, const LayerBitset& newLayers) override;
+
 	// Selects/unselects an entire layer
 	void setSelected(int layerID, bool selected) override;
 
@@ -124,8 +136,14 @@ public:
 private:
     // Recursively sets the visibility of the given layer and updates
     // the flags on the _layerVisibility vector.
-    // Returns true if any flag changed, false if nothing changed.
-    bool setLayerVisibilityRecursively(int layerID, bool visible);
+    // The IDs of the layers whose flag changed are added to the given vector.
+    void setLayerVisibilityRecursively(int layerID, bool visible, std::vector<int>& changedLayerIds);
+
+    // Rebuilds the _visibleLayers bitset from the _layerVisibility flags
+    void updateVisibleLayers();
+
+    // Returns the nodes of the given layers, each node only once
+    std::vector<INodePtr> getLayerMembers(const std::vector<int>& layerIds);
 
     // Invokes the function object with each layer ID in the hierarchy, including the given root
     void foreachLayerInHierarchy(int rootLayerId, const std::function<void(int)>& functor);
@@ -133,8 +151,8 @@ private:
 	// Internal event emitter
 	void onLayersChanged();
 
-	// Internal event, updates the scenegraph
-	void onLayerVisibilityChanged();
+	// Internal event, updates the members of the given layers
+	void onLayerVisibilityChanged(const std::vector<int>& changedLayerIds);
 
 	// Internal event emitter
 	void onNodeMembershipChanged();
@@ -142,6 +160,13 @@ private:
 	// Updates the visibility state of the entire scenegraph
 	void updateSceneGraphVisibility();
 
+	// Updates the visibility state of the given nodes and their ancestors
+	void updateNodeAndAncestorVisibility(const std::vector<INodePtr>& nodes);
+
+	// Updates the visibility of a single node, which is visible if its layers
+	// or any of its children are. Returns true if the node is visible.
+	bool updateNodeVisibilityFromChildren(const INodePtr& node);
+
 	// Returns the highest used layer Id
 	int getHighestLayerID() const;
 
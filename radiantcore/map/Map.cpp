@@ -26,6 +26,7 @@
 #include "gamelib.h"
 #include "os/path.h"
 #include "os/file.h"
+#include "string/format.h"
 #include "time/ScopeTimer.h"
 
 #include "brush/BrushModule.h"
@@ -1036,6 +1037,7 @@ void Map::registerCommands()
     // Add undo commands
     GlobalCommandSystem().addCommand("Undo", std::bind(&Map::undoCmd, this, std::placeholders::_1));
     GlobalCommandSystem().addCommand("Redo", std::bind(&Map::redoCmd, this, std::placeholders::_1));
+    GlobalCommandSystem().addCommand("PrintUndoMemoryUsage", std::bind(&Map::printUndoMemoryUsageCmd, this, std::placeholders::_1));
 }
 
 void Map::undoCmd(const cmd::ArgumentList& args)
@@ -1062,6 +1064,27 @@ void Map::redoCmd(const cmd::ArgumentList& args)
     }
 }
 
+void Map::printUndoMemoryUsageCmd(const cmd::ArgumentList& args)
+{
+    try
+    {
+        auto& undoSystem = getUndoSystem();
+
+        std::size_t level = 0;
+        undoSystem.foreachUndoOperation([&](const std::string& name, std::size_t bytes)
+        {
+            rMessage() << fmt::format("{0:>4}: {1:<40} {2}", ++level, name, string::getFormattedByteSize(bytes)) << std::endl;
+        });
+
+        rMessage() << "Total undo memory usage (including redo): " <<
+            string::getFormattedByteSize(undoSystem.getMemoryUsage()) << std::endl;
+    }
+    catch (const std::runtime_error& err)
+    {
+        throw cmd::ExecutionNotPossible(err.what());
+    }
+}
+
 // Static command targets
 void Map::newMap(const cmd::ArgumentList& args)
 {
@@ -305,6 +305,7 @@ private:
 
     void undoCmd(const cmd::ArgumentList& args);
     void redoCmd(const cmd::ArgumentList& args);
+    void printUndoMemoryUsageCmd(const cmd::ArgumentList& args);
 
     void assignRenderSystem(const scene::IMapRootNodePtr& root);
 };
@@ -5,6 +5,7 @@
 #include "scene/ChildPrimitives.h"
 #include "scenelib.h"
 #include "algorithm/MapImporter.h"
+#include "algorithm/ModelPrefetcher.h"
 #include "messages/MapFileOperation.h"
 
 namespace map
@@ -30,9 +31,14 @@ RootNodePtr MapResourceLoader::load()
 
         rMessage() << "Using " << _format.getMapFormatName() << " format to load the data." << std::endl;
 
+        // Let the workers parse the referenced models while the scene is being constructed
+        algorithm::ModelPrefetcher prefetcher(_stream);
+
         // Start parsing
         reader->readFromStream(_stream);
 
+        prefetcher.finish();
+
         // Prepare child primitives
         scene::addOriginToChildPrimitives(root);
 
@@ -73,6 +73,11 @@ scene::ILayerManager& RootNode::getLayerManager()
 	return *_layerManager;
 }
 
+scene::IMaterialUsageIndex& RootNode::getMaterialUsageIndex()
+{
+    return _materialUsageIndex;
+}
+
 IUndoSystem& RootNode::getUndoSystem()
 {
     return *_undoSystem;
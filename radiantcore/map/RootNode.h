@@ -11,6 +11,7 @@
 #include "transformlib.h"
 #include "KeyValueStore.h"
 #include "undo/UndoSystem.h"
+#include "scene/MaterialUsageIndex.h"
 #include <sigc++/connection.h>
 
 namespace map
@@ -50,6 +51,8 @@ private:
 
     IUndoSystem::Ptr _undoSystem;
 
+    scene::MaterialUsageIndex _materialUsageIndex;
+
 	AABB _emptyAABB;
 
     sigc::connection _undoEventHandler;
@@ -68,6 +71,7 @@ public:
     selection::ISelectionGroupManager& getSelectionGroupManager() override;
     selection::ISelectionSetManager& getSelectionSetManager() override;
     scene::ILayerManager& getLayerManager() override;
+    scene::IMaterialUsageIndex& getMaterialUsageIndex() override;
     IUndoSystem& getUndoSystem() override;
 
 	// Renderable implementation (empty)
@@ -0,0 +1,143 @@
+#include "ModelPrefetcher.h"
+
+#include <vector>
+#include "ieclass.h"
+#include "imd5anim.h"
+#include "imodelcache.h"
+#include "itextstream.h"
+#include "string/replace.h"
+#include "util/ParallelFor.h"
+
+namespace map
+{
+
+namespace algorithm
+{
+
+namespace
+{
+    constexpr const char* const MODEL_KEY = "\"model\"";
+
+    // Returns the first quoted string following the given position, or an empty string
+    std::string getQuotedValue(const std::string& line, std::size_t pos)
+    {
+        auto start = line.find('"', pos);
+
+        if (start == std::string::npos) return std::string();
+
+        auto end = line.find('"', start + 1);
+
+        return end != std::string::npos ? line.substr(start + 1, end - start - 1) : std::string();
+    }
+}
+
+ModelPrefetcher::ModelPrefetcher(std::istream& stream)
+{
+    auto modelSpawnargs = collectModelSpawnargs(stream);
+
+    // Rewind the stream for the map reader
+    stream.clear();
+    stream.seekg(0, std::ios::beg);
+
+    prefetch(modelSpawnargs);
+}
+
+ModelPrefetcher::~ModelPrefetcher()
+{
+    if (_animLoader.valid())
+    {
+        _animLoader.wait();
+    }
+}
+
+void ModelPrefetcher::finish()
+{
+    if (_animLoader.valid())
+    {
+        _animLoader.get();
+    }
+
+    GlobalModelCache().waitForPendingModelLoads();
+    GlobalModelCache().processFinishedModelLoads();
+}
+
+std::set<std::string> ModelPrefetcher::collectModelSpawnargs(std::istream& stream)
+{
+    std::set<std::string> result;
+    std::string line;
+
+    // All text map formats are storing the spawnargs as "key" "value" lines
+    while (std::getline(stream, line))
+    {
+        auto keyStart = line.find_first_not_of(" \t");
+
+        if (keyStart == std::string::npos || line.compare(keyStart, 7, MODEL_KEY) != 0)
+        {
+            continue;
+        }
+
+        // Same sanitisation as applied by the ModelKey
+        auto value = string::replace_all_copy(getQuotedValue(line, keyStart + 7), "\\", "/");
+
+        if (!value.empty())
+        {
+            result.insert(value);
+        }
+    }
+
+    return result;
+}
+
+void ModelPrefetcher::prefetch(const std::set<std::string>& modelSpawnargs)
+{
+    std::set<std::string> modelPaths;
+    std::set<std::string> animPaths;
+
+    // Resolve the modelDefs on this thread, the decl manager is not meant to be used concurrently
+    for (const auto& spawnarg : modelSpawnargs)
+    {
+        auto modelDef = GlobalEntityClassManager().findModel(spawnarg);
+
+        if (!modelDef)
+        {
+            modelPaths.insert(spawnarg);
+            continue;
+        }
+
+        modelPaths.insert(modelDef->getMesh());
+
+        // The idle pose is applied to the model as soon as it's attached to the entity
+        auto idleAnim = modelDef->getAnim("idle");
+
+        if (!idleAnim.empty())
+        {
+            animPaths.insert(idleAnim);
+        }
+    }
+
+    rMessage() << "Prefetching " << modelPaths.size() << " models and " <<
+        animPaths.size() << " anims" << std::endl;
+
+    GlobalModelCache().prefetchModels(modelPaths);
+
+    if (animPaths.empty()) return;
+
+    _animLoader = std::async(std::launch::async, [anims = std::vector<std::string>(animPaths.begin(), animPaths.end())]()
+    {
+        util::parallelFor(anims.size(), [&](std::size_t i)
+        {
+            try
+            {
+                GlobalAnimationCache().getAnim(anims[i]);
+            }
+            catch (const std::exception& ex)
+            {
+                rWarning() << "Failed to prefetch anim " << anims[i] << ": " << ex.what() << std::endl;
+            }
+        }, 4);
+    });
+}
+
+}
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <future>
+#include <istream>
+#include <set>
+#include <string>
+
+namespace map
+{
+
+namespace algorithm
+{
+
+/**
+ * Scans a text map stream for "model" spawnargs before the actual parsing
+ * starts, and lets the background workers parse the referenced models and
+ * idle anims while the map reader is busy constructing the scene.
+ * Requests for these models made by the entities during map construction
+ * are picking up the results instead of loading the files themselves.
+ */
+class ModelPrefetcher final
+{
+private:
+    std::future<void> _animLoader;
+
+public:
+    // Scans the given stream and rewinds it to the beginning afterwards
+    ModelPrefetcher(std::istream& stream);
+
+    // Blocks until the anims are loaded
+    ~ModelPrefetcher();
+
+    // Waits for all outstanding loads and moves the results into the model cache.
+    // Must be called from the main thread.
+    void finish();
+
+    // Returns the distinct values of all "model" key/value pairs found in the stream
+    static std::set<std::string> collectModelSpawnargs(std::istream& stream);
+
+private:
+    void prefetch(const std::set<std::string>& modelSpawnargs);
+};
+
+}
+
+}
@@ -10,6 +10,9 @@
 #include "igame.h"
 #include "ipreferencesystem.h"
 #include "icommandsystem.h"
+#include "imapformat.h"
+#include "imapresource.h"
+#include <sstream>
 
 #include "registry/registry.h"
 
@@ -23,6 +26,7 @@
 #include "module/StaticModule.h"
 #include "messages/NotificationMessage.h"
 #include "messages/AutomaticMapSaveRequest.h"
+#include "SnapshotStore.h"
 
 #include <fmt/format.h>
 
@@ -53,12 +57,14 @@ namespace
 
 AutoMapSaver::AutoMapSaver() :
 	_snapshotsEnabled(false),
+	_snapshotsDeduplicated(false),
     _savedChangeCount(0)
 {}
 
 void AutoMapSaver::registryKeyChanged()
 {
 	_snapshotsEnabled = registry::getValue<bool>(RKEY_AUTOSAVE_SNAPSHOTS_ENABLED);
+	_snapshotsDeduplicated = registry::getValue<bool>(RKEY_AUTOSAVE_SNAPSHOTS_DEDUPLICATED);
 }
 
 void AutoMapSaver::clearChanges()
@@ -95,6 +101,12 @@ void AutoMapSaver::saveSnapshot()
 	// Check if the folder exists and create it if necessary
 	if (os::fileOrDirExists(snapshotPath.string()) || os::makeDirectory(snapshotPath.string()))
 	{
+        // Formats which can't be written from a scene snapshot are saved as full copies
+        if (_snapshotsDeduplicated && saveDeduplicatedSnapshot(snapshotPath, mapName))
+        {
+            return;
+        }
+
         // Map existing snapshots (snapshot num => path)
         std::map<int, std::string> existingSnapshots;
 
@@ -107,9 +119,17 @@ void AutoMapSaver::saveSnapshot()
 		rMessage() << "Autosaving snapshot to " << filename << std::endl;
 
 		// Dump to map to the next available filename
-        GlobalCommandSystem().executeCommand("SaveAutomaticBackup", filename);
+        saveBackup(filename);
+
+		// Sum up the total folder size
+		std::size_t folderSize = 0;
 
-		handleSnapshotSizeLimit(existingSnapshots, snapshotPath, mapName);
+		for (const std::pair<int, std::string>& pair : existingSnapshots)
+		{
+			folderSize += os::getFileSize(pair.second);
+		}
+
+		handleSnapshotSizeLimit(folderSize, snapshotPath, mapName);
 	}
 	else
 	{
@@ -117,7 +137,117 @@ void AutoMapSaver::saveSnapshot()
 	}
 }
 
-void AutoMapSaver::handleSnapshotSizeLimit(const std::map<int, std::string>& existingSnapshots,
+bool AutoMapSaver::saveDeduplicatedSnapshot(const fs::path& snapshotPath, const std::string& mapName)
+{
+    auto format = getSnapshotFormat(mapName);
+
+    if (!format)
+    {
+        return false;
+    }
+
+    SnapshotStore store(snapshotPath);
+
+    // Measure the folder before adding the new snapshot, like it's done for the full copies
+    auto folderSize = store.getTotalSize(mapName);
+    auto num = store.getNextSnapshotNumber(mapName);
+
+    rMessage() << "Autosaving snapshot to " << store.getManifestPath(mapName, num).string() << std::endl;
+
+    writeInBackground(*format, [store, mapName, num](MapSnapshot& snapshot) mutable
+    {
+        std::ostringstream stream;
+        snapshot.writeMap(stream);
+
+        store.addSnapshot(mapName, num, stream.str(), snapshot.getInfoFileContents());
+    });
+
+    handleSnapshotSizeLimit(folderSize, snapshotPath, mapName);
+
+    return true;
+}
+
+void AutoMapSaver::saveBackup(const std::string& filename)
+{
+    auto format = getSnapshotFormat(filename);
+
+    if (!format)
+    {
+        // Let the map module take care of this one
+        GlobalCommandSystem().executeCommand("SaveAutomaticBackup", filename);
+        return;
+    }
+
+    writeInBackground(*format, [filename](MapSnapshot& snapshot)
+    {
+        snapshot.saveToFile(filename);
+    });
+}
+
+MapFormatPtr AutoMapSaver::getSnapshotFormat(const std::string& filename)
+{
+    auto format = GlobalMapFormatManager().getMapFormatForFilename(filename);
+
+    return format && MapSnapshot::SupportsFormat(*format) ? format : MapFormatPtr();
+}
+
+void AutoMapSaver::writeInBackground(const MapFormat& format, const std::function<void(MapSnapshot&)>& write)
+{
+    // Finish off the previous write before starting a new one
+    waitForPendingSave();
+
+    // Copying the scene data is all that's done on this thread, writing the file doesn't block the editor.
+    // The snapshot is plain data, the worker releases it once the file is written.
+    auto snapshot = std::make_shared<MapSnapshot>(GlobalSceneGraph().root(), format);
+
+    _pendingWrite = std::async(std::launch::async, [snapshot, write]()
+    {
+        try
+        {
+            write(*snapshot);
+        }
+        catch (const std::runtime_error& ex)
+        {
+            rError() << "Autosave failed: " << ex.what() << std::endl;
+        }
+    });
+}
+
+void AutoMapSaver::restoreSnapshotCmd(const cmd::ArgumentList& args)
+{
+    fs::path mapPath = args[1].getString();
+
+    fs::path infoFilePath = mapPath;
+    infoFilePath.replace_extension(game::current::getInfoFileExtension());
+
+    try
+    {
+        SnapshotStore::RestoreSnapshot(args[0].getString(), mapPath, infoFilePath);
+
+        rMessage() << "Restored snapshot " << args[0].getString() << " to " << mapPath.string() << std::endl;
+    }
+    catch (const std::runtime_error& ex)
+    {
+        radiant::NotificationMessage::SendError(
+            fmt::format(_("Failed to restore snapshot {0}:\n{1}"), args[0].getString(), ex.what()));
+    }
+}
+
+bool AutoMapSaver::writeIsPending()
+{
+    return _pendingWrite.valid() &&
+        _pendingWrite.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
+void AutoMapSaver::waitForPendingSave()
+{
+    if (_pendingWrite.valid())
+    {
+        _pendingWrite.get();
+    }
+}
+
+void AutoMapSaver::handleSnapshotSizeLimit(std::size_t folderSize,
 	const fs::path& snapshotPath, const std::string& mapName)
 {
 	std::size_t maxSnapshotFolderSize =
@@ -129,14 +259,6 @@ void AutoMapSaver::handleSnapshotSizeLimit(const std::map<int, std::string>& exi
 		maxSnapshotFolderSize = 100;
 	}
 
-	// Sum up the total folder size
-	std::size_t folderSize = 0;
-
-	for (const std::pair<int, std::string>& pair : existingSnapshots)
-	{
-		folderSize += os::getFileSize(pair.second);
-	}
-
 	std::size_t maxSize = maxSnapshotFolderSize * 1024 * 1024;
 
 	// The key containing the previously calculated size
@@ -216,6 +338,12 @@ bool AutoMapSaver::runAutosaveCheck()
 
 void AutoMapSaver::performAutosave()
 {
+    if (writeIsPending())
+    {
+        rMessage() << "Auto save skipped: the previous one is still being written" << std::endl;
+        return;
+    }
+
     // Remember the change tracking counter
     _savedChangeCount = GlobalSceneGraph().root()->getUndoChangeTracker().getCurrentChangeCount();
 
@@ -248,7 +376,7 @@ void AutoMapSaver::performAutosave()
             rMessage() << "Autosaving unnamed map to " << autoSaveFilename << std::endl;
 
             // Invoke the save call
-            GlobalCommandSystem().executeCommand("SaveAutomaticBackup", autoSaveFilename);
+            saveBackup(autoSaveFilename);
         }
         else
         {
@@ -264,7 +392,7 @@ void AutoMapSaver::performAutosave()
             rMessage() << "Autosaving map to " << filename << std::endl;
 
             // Invoke the save call
-            GlobalCommandSystem().executeCommand("SaveAutomaticBackup", filename);
+            saveBackup(filename);
         }
     }
 }
@@ -276,6 +404,7 @@ void AutoMapSaver::constructPreferences()
 
 	page.appendCheckBox(_("Save Snapshots"), RKEY_AUTOSAVE_SNAPSHOTS_ENABLED);
 	page.appendEntry(_("Snapshot Folder (absolute, or relative to Map Folder)"), RKEY_AUTOSAVE_SNAPSHOTS_FOLDER);
+	page.appendCheckBox(_("Share unchanged Entities between Snapshots"), RKEY_AUTOSAVE_SNAPSHOTS_DEDUPLICATED);
 	page.appendEntry(_("Max total Snapshot size per Map (MB)"), RKEY_AUTOSAVE_MAX_SNAPSHOT_FOLDER_SIZE);
 }
 
@@ -309,6 +438,9 @@ StringSet AutoMapSaver::getDependencies() const
 	if (_dependencies.empty())
 	{
 		_dependencies.insert(MODULE_MAP);
+		_dependencies.insert(MODULE_MAPFORMATMANAGER);
+		_dependencies.insert(MODULE_MAPRESOURCEMANAGER);
+		_dependencies.insert(MODULE_COMMANDSYSTEM);
 		_dependencies.insert(MODULE_PREFERENCESYSTEM);
 		_dependencies.insert(MODULE_XMLREGISTRY);
 	}
@@ -321,6 +453,14 @@ void AutoMapSaver::initialiseModule(const IApplicationContext& ctx)
 	_signalConnections.push_back(GlobalRegistry().signalForKey(RKEY_AUTOSAVE_SNAPSHOTS_ENABLED).connect(
 		sigc::mem_fun(this, &AutoMapSaver::registryKeyChanged)
 	));
+	_signalConnections.push_back(GlobalRegistry().signalForKey(RKEY_AUTOSAVE_SNAPSHOTS_DEDUPLICATED).connect(
+		sigc::mem_fun(this, &AutoMapSaver::registryKeyChanged)
+	));
+
+	// Reassembles a .map file from a deduplicated snapshot
+	GlobalCommandSystem().addCommand("RestoreMapSnapshot",
+		std::bind(&AutoMapSaver::restoreSnapshotCmd, this, std::placeholders::_1),
+		{ cmd::ARGTYPE_STRING, cmd::ARGTYPE_STRING });
 
 	// Get notified when the map is loaded afresh
 	_signalConnections.push_back(GlobalMapModule().signal_mapEvent().connect(
@@ -339,6 +479,8 @@ void AutoMapSaver::initialiseModule(const IApplicationContext& ctx)
 
 void AutoMapSaver::shutdownModule()
 {
+	waitForPendingSave();
+
 	// Unsubscribe from all connections
 	for (sigc::connection& connection : _signalConnections)
 	{
@@ -4,9 +4,13 @@
 
 #include "imap.h"
 #include "iautosaver.h"
+#include "icommandsystem.h"
 
 #include <vector>
+#include <future>
+#include <functional>
 #include <sigc++/connection.h>
+#include "MapSnapshot.h"
 
 namespace map
 {
@@ -22,10 +26,16 @@ private:
 	// TRUE, if the autosaver generates snapshots
 	bool _snapshotsEnabled;
 
+	// TRUE, if snapshots are stored in a SnapshotStore instead of full copies
+	bool _snapshotsDeduplicated;
+
 	std::size_t _savedChangeCount;
 
 	std::vector<sigc::connection> _signalConnections;
 
+	// The snapshot write currently running on the worker thread
+	std::future<void> _pendingWrite;
+
 public:
 	// Constructor
 	AutoMapSaver();
@@ -45,6 +55,8 @@ public:
 
     void performAutosave() override;
 
+    void waitForPendingSave() override;
+
 private:
 	void constructPreferences();
 
@@ -55,10 +67,26 @@ private:
 	// Saves a snapshot of the currently active map (only named maps)
 	void saveSnapshot();
 
+	// Adds a snapshot to the SnapshotStore in the given folder, returns false if the map format doesn't allow that
+	bool saveDeduplicatedSnapshot(const fs::path& snapshotPath, const std::string& mapName);
+
+	// Writes the current map to the given file, in the background if the format allows
+	void saveBackup(const std::string& filename);
+
+	// The format to use for the given file, if it can be written from a MapSnapshot
+	MapFormatPtr getSnapshotFormat(const std::string& filename);
+
+	// Captures the scene and passes it to the given function on a worker thread
+	void writeInBackground(const MapFormat& format, const std::function<void(MapSnapshot&)>& write);
+
+	void restoreSnapshotCmd(const cmd::ArgumentList& args);
+
+	bool writeIsPending();
+
 	void collectExistingSnapshots(std::map<int, std::string>& existingSnapshots,
 		const fs::path& snapshotPath, const std::string& mapName);
 
-	void handleSnapshotSizeLimit(const std::map<int, std::string>& existingSnapshots,
+	void handleSnapshotSizeLimit(std::size_t folderSize,
 		const fs::path& snapshotPath, const std::string& mapName);
 };
 
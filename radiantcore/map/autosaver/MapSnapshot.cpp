@@ -0,0 +1,305 @@
+#include "MapSnapshot.h"
+
+#include <fstream>
+#include <sstream>
+#include "ibrush.h"
+#include "ipatch.h"
+#include "igame.h"
+#include "igroupnode.h"
+#include "imapresource.h"
+#include "itextstream.h"
+#include "scene/EntityNode.h"
+
+#include "gamelib.h"
+#include "os/fs.h"
+#include "string/convert.h"
+
+#include "../infofile/InfoFileExporter.h"
+#include "../format/Doom3MapFormat.h"
+#include "../format/Doom3MapWriter.h"
+#include "../format/Quake4MapFormat.h"
+#include "../format/primitivewriters/PatchDefExporter.h"
+
+#include <fmt/format.h>
+
+namespace map
+{
+
+namespace
+{
+    const char* const RKEY_FLOAT_PRECISION = "/mapFormat/floatPrecision";
+
+    // Brushes without any contributing faces are not written, same as in the MapExporter
+    bool isExportedBrush(const scene::INodePtr& node)
+    {
+        auto brush = std::dynamic_pointer_cast<IBrushNode>(node);
+        return brush && brush->getIBrush().hasContributingFaces();
+    }
+
+    void evaluateBrushes(const scene::INodePtr& root)
+    {
+        root->foreachNode([](const scene::INodePtr& node)
+        {
+            if (auto brush = std::dynamic_pointer_cast<IBrushNode>(node); brush)
+            {
+                brush->getIBrush().evaluateBRep();
+            }
+
+            return true;
+        });
+    }
+
+    // Passes the live nodes to the info file modules, numbering them like the MapExporter does
+    class InfoFileCollector :
+        public scene::NodeVisitor
+    {
+    private:
+        InfoFileExporter& _exporter;
+        std::size_t _entityNum;
+        std::size_t _primitiveNum;
+
+    public:
+        InfoFileCollector(InfoFileExporter& exporter) :
+            _exporter(exporter),
+            _entityNum(0),
+            _primitiveNum(0)
+        {}
+
+        bool pre(const scene::INodePtr& node) override
+        {
+            if (std::dynamic_pointer_cast<EntityNode>(node))
+            {
+                _exporter.visitEntity(node, _entityNum);
+            }
+            else if (isExportedBrush(node) || std::dynamic_pointer_cast<IPatchNode>(node))
+            {
+                _exporter.visitPrimitive(node, _entityNum, _primitiveNum);
+            }
+
+            return true;
+        }
+
+        void post(const scene::INodePtr& node) override
+        {
+            if (std::dynamic_pointer_cast<EntityNode>(node))
+            {
+                _entityNum++;
+            }
+            else if (isExportedBrush(node) || std::dynamic_pointer_cast<IPatchNode>(node))
+            {
+                _primitiveNum++;
+            }
+        }
+    };
+}
+
+MapSnapshot::MapSnapshot(const scene::IMapRootNodePtr& root, const MapFormat& format) :
+    _mapVersion(format.getGameType() == "quake4" ? MAP_VERSION_Q4 : MAP_VERSION_D3),
+    _writeContentsFlags(format.getGameType() != "quake4"),
+    _floatPrecision(string::convert<int>(
+        GlobalGameManager().currentGame()->getLocalXPath(RKEY_FLOAT_PRECISION)[0].getAttributeValue("value")))
+{
+    // Give the subscribers a chance to prepare the scene, as if the map was exported
+    GlobalMapResourceManager().signal_onResourceExporting().emit(root);
+
+    // Needed to decide which brushes and faces are going to be written
+    evaluateBrushes(root);
+
+    captureScene(root);
+
+    if (format.allowInfoFileCreation())
+    {
+        _infoFileExtension = game::current::getInfoFileExtension();
+        collectInfoFile(root);
+    }
+
+    GlobalMapResourceManager().signal_onResourceExported().emit(root);
+}
+
+bool MapSnapshot::SupportsFormat(const MapFormat& format)
+{
+    return format.allowInfoFileCreation() &&
+        (format.getGameType() == "doom3" || format.getGameType() == "quake4");
+}
+
+void MapSnapshot::captureScene(const scene::IMapRootNodePtr& root)
+{
+    root->foreachNode([&](const scene::INodePtr& node)
+    {
+        auto entityNode = std::dynamic_pointer_cast<EntityNode>(node);
+
+        if (!entityNode)
+        {
+            return true;
+        }
+
+        auto& entity = _entities.emplace_back();
+        const auto& spawnargs = entityNode->getEntity();
+
+        spawnargs.forEachKeyValue([&](const std::string& key, const std::string& value)
+        {
+            entity.keyValues.emplace_back(key, value);
+        });
+
+        // The child primitives of func_* entities are written relative to their origin,
+        // this is the same translation removeOriginFromChildPrimitives() is applying
+        Vector3 offset(0, 0, 0);
+
+        if (auto groupNode = Node_getGroupNode(node); groupNode && !spawnargs.isWorldspawn())
+        {
+            offset = groupNode->getChildPrimitiveOffset();
+        }
+
+        node->foreachNode([&](const scene::INodePtr& child)
+        {
+            if (isExportedBrush(child))
+            {
+                const auto& brush = std::dynamic_pointer_cast<IBrushNode>(child)->getIBrush();
+
+                BrushData data{ brush.getDetailFlag(), {} };
+
+                for (std::size_t i = 0; i < brush.getNumFaces(); ++i)
+                {
+                    const auto& face = brush.getFace(i);
+
+                    // Faces with degenerate windings are not written, same as in the BrushDef3Exporter
+                    if (face.getWinding().size() <= 2) continue;
+
+                    // Translate the plane like FacePlane::translate() does
+                    auto plane = face.getPlane3();
+                    plane.dist() = -plane.dist();
+                    plane.translate(offset);
+                    plane.dist() = -plane.dist();
+
+                    data.faces.push_back({ plane, face.getProjectionMatrix(), face.getShader() });
+                }
+
+                entity.primitives.emplace_back(std::move(data));
+            }
+            else if (auto patchNode = std::dynamic_pointer_cast<IPatchNode>(child); patchNode)
+            {
+                const auto& patch = patchNode->getPatch();
+
+                PatchData data{ patch.getShader(), patch.getWidth(), patch.getHeight(),
+                    patch.subdivisionsFixed(), patch.getSubdivisions(), {} };
+
+                data.controls.reserve(data.width * data.height);
+
+                for (std::size_t row = 0; row < data.height; ++row)
+                {
+                    for (std::size_t col = 0; col < data.width; ++col)
+                    {
+                        const auto& control = patch.ctrlAt(row, col);
+                        data.controls.push_back({ control.vertex + offset, control.texcoord });
+                    }
+                }
+
+                entity.primitives.emplace_back(std::move(data));
+            }
+
+            return true;
+        });
+
+        return true;
+    });
+}
+
+void MapSnapshot::collectInfoFile(const scene::IMapRootNodePtr& root)
+{
+    std::ostringstream stream;
+
+    {
+        // The info file is written when the exporter goes out of scope
+        InfoFileExporter exporter(stream);
+
+        exporter.beginSaveMap(root);
+
+        InfoFileCollector collector(exporter);
+        root->traverseChildren(collector);
+
+        exporter.finishSaveMap(root);
+    }
+
+    _infoFileContents = stream.str();
+}
+
+void MapSnapshot::writeMap(std::ostream& stream)
+{
+    stream.precision(_floatPrecision);
+
+    // Same output as the Doom3MapWriter and Quake4MapWriter produce
+    stream << "Version " << _mapVersion << std::endl;
+
+    std::size_t entityNum = 0;
+
+    for (const auto& entity : _entities)
+    {
+        stream << "// entity " << entityNum++ << std::endl;
+        stream << "{" << std::endl;
+
+        for (const auto& [key, value] : entity.keyValues)
+        {
+            Doom3MapWriter::writeEntityKeyValue(key, value, stream);
+        }
+
+        std::size_t primitiveNum = 0;
+
+        for (const auto& primitive : entity.primitives)
+        {
+            stream << "// primitive " << primitiveNum++ << std::endl;
+
+            if (auto brush = std::get_if<BrushData>(&primitive); brush)
+            {
+                BrushDef3Exporter::exportBrush(stream, brush->faces, brush->detailFlag, _writeContentsFlags);
+            }
+            else
+            {
+                PatchDefExporter::exportPatch(stream, std::get<PatchData>(primitive));
+            }
+        }
+
+        stream << "}" << std::endl;
+    }
+}
+
+const std::string& MapSnapshot::getInfoFileContents() const
+{
+    return _infoFileContents;
+}
+
+void MapSnapshot::saveToFile(const std::string& filename)
+{
+    fs::path outFile = filename;
+
+    std::ofstream outFileStream(outFile.string());
+
+    if (!outFileStream.is_open())
+    {
+        throw IMapResource::OperationException(fmt::format("Could not open file for writing: {0}", outFile.string()));
+    }
+
+    writeMap(outFileStream);
+
+    if (outFileStream.fail())
+    {
+        throw IMapResource::OperationException(fmt::format("Failure writing to file {0}", outFile.string()));
+    }
+
+    if (_infoFileExtension.empty())
+    {
+        return;
+    }
+
+    fs::path auxFile = outFile;
+    auxFile.replace_extension(_infoFileExtension);
+
+    std::ofstream auxFileStream(auxFile.string());
+    auxFileStream << _infoFileContents;
+
+    if (auxFileStream.fail())
+    {
+        throw IMapResource::OperationException(fmt::format("Failure writing to file {0}", auxFile.string()));
+    }
+}
+
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "imapformat.h"
+#include "ibrush.h"
+#include "ipatch.h"
+
+#include "../format/primitivewriters/BrushDef3Exporter.h"
+
+namespace map
+{
+
+/**
+ * Plain data copy of a map, taken on the main thread such that it can be
+ * serialised and written to disk by a worker thread while editing goes on.
+ *
+ * Capturing copies the entity key values, the brush faces (planes, texture
+ * matrices and materials) and the patch control points, already moved into the
+ * coordinate space they're written in. The info file contents (layers, groups,
+ * selection sets, map properties) are assembled by passing the live nodes to the
+ * info file modules. No nodes are created or kept alive by the snapshot.
+ *
+ * Writing the snapshot doesn't touch the scene or any module, the snapshot
+ * can be written and destroyed on any thread.
+ */
+class MapSnapshot final
+{
+private:
+    struct BrushData
+    {
+        IBrush::DetailFlag detailFlag;
+
+        // The contributing faces only
+        std::vector<BrushDef3Exporter::FaceDefinition> faces;
+    };
+
+    // Offers the same accessors as IPatch, as used by the PatchDefExporter
+    struct PatchData
+    {
+        std::string shader;
+        std::size_t width;
+        std::size_t height;
+        bool fixedSubdivisions;
+        Subdivisions subdivisions;
+
+        // Row-major, like the control array of the patch itself
+        std::vector<PatchControl> controls;
+
+        const std::string& getShader() const { return shader; }
+        std::size_t getWidth() const { return width; }
+        std::size_t getHeight() const { return height; }
+        bool subdivisionsFixed() const { return fixedSubdivisions; }
+        const Subdivisions& getSubdivisions() const { return subdivisions; }
+
+        const PatchControl& ctrlAt(std::size_t row, std::size_t col) const
+        {
+            return controls[row * width + col];
+        }
+    };
+
+    struct EntityData
+    {
+        std::vector<std::pair<std::string, std::string>> keyValues;
+
+        // Brushes and patches in scene order
+        std::vector<std::variant<BrushData, PatchData>> primitives;
+    };
+
+    std::vector<EntityData> _entities;
+
+    // Quake 4 maps carry a different version number and no brush contents flags
+    float _mapVersion;
+    bool _writeContentsFlags;
+
+    int _floatPrecision;
+
+    // Info file contents and extension, empty if the format doesn't use one
+    std::string _infoFileExtension;
+    std::string _infoFileContents;
+
+public:
+    using Ptr = std::shared_ptr<MapSnapshot>;
+
+    MapSnapshot(const scene::IMapRootNodePtr& root, const MapFormat& format);
+
+    MapSnapshot(const MapSnapshot& other) = delete;
+    MapSnapshot& operator=(const MapSnapshot& other) = delete;
+
+    // Returns true if maps of the given format can be written from a snapshot.
+    // This applies to the brushDef3 map formats of Doom 3 and Quake 4. The portable
+    // format is storing layers, groups and selection sets per node, and the Quake 3
+    // brush formats need the face windings and the dimensions of the editor images.
+    static bool SupportsFormat(const MapFormat& format);
+
+    // Serialises the captured map to the given stream, can be called from any thread
+    void writeMap(std::ostream& stream);
+
+    // The info file contents, empty if the map format doesn't use an info file
+    const std::string& getInfoFileContents() const;
+
+    // Writes the map file (and the info file next to it, if the map format is using one).
+    // Can be called from any thread, throws IMapResource::OperationException on failure.
+    void saveToFile(const std::string& filename);
+
+private:
+    void captureScene(const scene::IMapRootNodePtr& root);
+    void collectInfoFile(const scene::IMapRootNodePtr& root);
+};
+
+}
@@ -0,0 +1,547 @@
+#include "SnapshotStore.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <zlib.h>
+
+#include "math/Hash.h"
+#include "string/convert.h"
+#include <fmt/format.h>
+
+namespace map
+{
+
+namespace
+{
+    constexpr const char* const MANIFEST_EXTENSION = ".snapshot";
+    constexpr const char* const MANIFEST_HEADER = "snapshot 1";
+
+    constexpr std::string_view ENTITY_COMMENT = "// entity";
+    constexpr std::string_view PRIMITIVE_COMMENT = "// primitive";
+
+    // Primitives of an entity are cut into runs of this size on average
+    constexpr std::size_t PRIMITIVES_PER_CHUNK = 64;
+
+    std::string_view getLine(std::string_view text, std::size_t start)
+    {
+        auto end = text.find('\n', start);
+        return text.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start + 1);
+    }
+
+    // The line without the trailing line break
+    std::string_view trimLineBreak(std::string_view line)
+    {
+        return !line.empty() && line.back() == '\n' ? line.substr(0, line.size() - 1) : line;
+    }
+
+    bool isNumberedComment(std::string_view line, std::string_view comment, std::size_t number)
+    {
+        line = trimLineBreak(line);
+
+        return line.size() > comment.size() + 1 && line.substr(0, comment.size()) == comment &&
+            line[comment.size()] == ' ' && line.substr(comment.size() + 1) == std::to_string(number);
+    }
+
+    bool startsWith(std::string_view line, std::string_view prefix)
+    {
+        return line.substr(0, prefix.size()) == prefix;
+    }
+
+    /**
+     * Replaces the numbered entity and primitive comments by unnumbered ones.
+     * Returns false if the numbering is not the one RenumberComments()
+     * is going to restore, the text is stored as it is in this case.
+     */
+    bool StripCommentNumbers(std::string_view text, std::string& result)
+    {
+        result.clear();
+        result.reserve(text.size());
+
+        std::size_t entityNum = 0;
+        std::size_t primitiveNum = 0;
+
+        for (std::size_t pos = 0; pos < text.size();)
+        {
+            auto line = getLine(text, pos);
+            pos += line.size();
+
+            if (isNumberedComment(line, ENTITY_COMMENT, entityNum))
+            {
+                result.append(ENTITY_COMMENT).append("\n");
+                entityNum++;
+                primitiveNum = 0;
+            }
+            else if (isNumberedComment(line, PRIMITIVE_COMMENT, primitiveNum))
+            {
+                result.append(PRIMITIVE_COMMENT).append("\n");
+                primitiveNum++;
+            }
+            else if (startsWith(line, ENTITY_COMMENT) || startsWith(line, PRIMITIVE_COMMENT))
+            {
+                return false;
+            }
+            else
+            {
+                result.append(line);
+            }
+        }
+
+        return true;
+    }
+
+    std::string RenumberComments(std::string_view text)
+    {
+        std::string result;
+        result.reserve(text.size() + text.size() / 32);
+
+        std::size_t entityNum = 0;
+        std::size_t primitiveNum = 0;
+
+        for (std::size_t pos = 0; pos < text.size();)
+        {
+            auto line = getLine(text, pos);
+            pos += line.size();
+
+            if (trimLineBreak(line) == ENTITY_COMMENT)
+            {
+                result.append(ENTITY_COMMENT).append(" ").append(std::to_string(entityNum++)).append("\n");
+                primitiveNum = 0;
+            }
+            else if (trimLineBreak(line) == PRIMITIVE_COMMENT)
+            {
+                result.append(PRIMITIVE_COMMENT).append(" ").append(std::to_string(primitiveNum++)).append("\n");
+            }
+            else
+            {
+                result.append(line);
+            }
+        }
+
+        return result;
+    }
+
+    // FNV-1a, used to pick the chunk boundaries between primitives
+    std::uint32_t getBoundaryHash(std::string_view text)
+    {
+        std::uint32_t hash = 2166136261u;
+
+        for (auto c : text)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 16777619u;
+        }
+
+        return hash;
+    }
+
+    /**
+     * Splits the text into pieces starting at the entity comments. Runs of
+     * primitives are cut off as separate piece after every primitive whose
+     * contents hash to a multiple of PRIMITIVES_PER_CHUNK. A primitive extends
+     * up to the next comment, the last one includes the entity's closing brace.
+     */
+    std::vector<std::string_view> SplitIntoChunks(std::string_view text, bool splitPrimitives)
+    {
+        std::vector<std::string_view> chunks;
+
+        std::size_t chunkStart = 0;
+        std::size_t primitiveStart = std::string_view::npos;
+
+        auto finishPrimitive = [&](std::size_t primitiveEnd)
+        {
+            if (primitiveStart == std::string_view::npos) return;
+
+            auto primitive = text.substr(primitiveStart, primitiveEnd - primitiveStart);
+            primitiveStart = std::string_view::npos;
+
+            if (getBoundaryHash(primitive) % PRIMITIVES_PER_CHUNK == 0)
+            {
+                chunks.push_back(text.substr(chunkStart, primitiveEnd - chunkStart));
+                chunkStart = primitiveEnd;
+            }
+        };
+
+        for (std::size_t pos = 0; pos < text.size();)
+        {
+            auto line = getLine(text, pos);
+
+            if (startsWith(line, ENTITY_COMMENT))
+            {
+                primitiveStart = std::string_view::npos;
+
+                if (pos > chunkStart)
+                {
+                    chunks.push_back(text.substr(chunkStart, pos - chunkStart));
+                    chunkStart = pos;
+                }
+            }
+            else if (splitPrimitives && startsWith(line, PRIMITIVE_COMMENT))
+            {
+                finishPrimitive(pos);
+                primitiveStart = pos;
+            }
+
+            pos += line.size();
+        }
+
+        if (chunkStart < text.size())
+        {
+            chunks.push_back(text.substr(chunkStart));
+        }
+
+        return chunks;
+    }
+
+    std::string Compress(std::string_view text)
+    {
+        auto compressedSize = compressBound(static_cast<uLong>(text.size()));
+        std::string compressed(compressedSize, '\0');
+
+        if (compress2(reinterpret_cast<Bytef*>(compressed.data()), &compressedSize,
+            reinterpret_cast<const Bytef*>(text.data()), static_cast<uLong>(text.size()), Z_DEFAULT_COMPRESSION) != Z_OK)
+        {
+            throw std::runtime_error("Failed to compress snapshot chunk");
+        }
+
+        compressed.resize(compressedSize);
+        return compressed;
+    }
+
+    std::string Decompress(const std::string& compressed, std::size_t size)
+    {
+        std::string text(size, '\0');
+        uLongf textSize = static_cast<uLongf>(size);
+
+        if (uncompress(reinterpret_cast<Bytef*>(text.data()), &textSize,
+            reinterpret_cast<const Bytef*>(compressed.data()), static_cast<uLong>(compressed.size())) != Z_OK ||
+            textSize != size)
+        {
+            throw std::runtime_error("Failed to decompress snapshot chunk");
+        }
+
+        return text;
+    }
+
+    // Writes to a temporary file first, such that a file is either complete or doesn't exist
+    void WriteFile(const fs::path& path, std::string_view contents, bool binary)
+    {
+        auto tempPath = path;
+        tempPath += ".tmp";
+
+        {
+            std::ofstream stream(tempPath.string(), binary ? std::ios::binary : std::ios::out);
+            stream.write(contents.data(), contents.size());
+
+            if (!stream.good())
+            {
+                throw std::runtime_error(fmt::format("Failure writing to file {0}", tempPath.string()));
+            }
+        }
+
+        fs::rename(tempPath, path);
+    }
+
+    std::string ReadChunk(const fs::path& chunkFolder, const std::string& hash, std::size_t size)
+    {
+        auto path = chunkFolder / hash;
+        std::ifstream stream(path.string(), std::ios::binary);
+
+        if (!stream)
+        {
+            throw std::runtime_error(fmt::format("Snapshot chunk {0} is missing", path.string()));
+        }
+
+        std::stringstream compressed;
+        compressed << stream.rdbuf();
+
+        return Decompress(compressed.str(), size);
+    }
+
+    bool isManifest(const fs::path& path)
+    {
+        return path.extension() == MANIFEST_EXTENSION;
+    }
+
+    struct ChunkReference
+    {
+        std::string hash;
+        std::size_t size;
+    };
+
+    struct Manifest
+    {
+        bool numbered = false;
+        std::vector<ChunkReference> chunks;
+
+        bool hasInfoFile = false;
+        ChunkReference infoFile;
+    };
+
+    Manifest ReadManifest(const fs::path& manifestPath)
+    {
+        std::ifstream stream(manifestPath.string());
+
+        std::string line;
+
+        if (!std::getline(stream, line) || line != MANIFEST_HEADER)
+        {
+            throw std::runtime_error(fmt::format("{0} is not a snapshot manifest", manifestPath.string()));
+        }
+
+        Manifest manifest;
+
+        while (std::getline(stream, line))
+        {
+            std::istringstream tokens(line);
+
+            std::string type;
+            tokens >> type;
+
+            if (type == "numbered")
+            {
+                tokens >> manifest.numbered;
+                continue;
+            }
+
+            ChunkReference chunk;
+
+            if (!(tokens >> chunk.hash >> chunk.size))
+            {
+                throw std::runtime_error(fmt::format("Invalid line in snapshot manifest {0}: {1}", manifestPath.string(), line));
+            }
+
+            if (type == "chunk")
+            {
+                manifest.chunks.push_back(chunk);
+            }
+            else if (type == "info")
+            {
+                manifest.infoFile = chunk;
+                manifest.hasInfoFile = true;
+            }
+        }
+
+        return manifest;
+    }
+
+    // Invokes the functor for each chunk referenced by the given manifest
+    void ForeachChunk(const Manifest& manifest, const std::function<void(const ChunkReference&)>& functor)
+    {
+        for (const auto& chunk : manifest.chunks)
+        {
+            functor(chunk);
+        }
+
+        if (manifest.hasInfoFile)
+        {
+            functor(manifest.infoFile);
+        }
+    }
+}
+
+SnapshotStore::SnapshotStore(const fs::path& folder) :
+    _folder(folder)
+{}
+
+fs::path SnapshotStore::getManifestPath(const std::string& mapName, int num) const
+{
+    auto stem = fs::path(mapName).stem().string();
+    return _folder / (stem + "." + std::to_string(num) + MANIFEST_EXTENSION);
+}
+
+std::vector<int> SnapshotStore::getSnapshotNumbers(const std::string& mapName) const
+{
+    std::vector<int> numbers;
+
+    if (!fs::is_directory(_folder))
+    {
+        return numbers;
+    }
+
+    auto prefix = fs::path(mapName).stem().string() + ".";
+
+    for (const auto& entry : fs::directory_iterator(_folder))
+    {
+        if (!isManifest(entry.path())) continue;
+
+        // altar.3.snapshot => altar.3
+        auto name = entry.path().stem().string();
+
+        if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0) continue;
+
+        auto number = name.substr(prefix.size());
+
+        if (std::all_of(number.begin(), number.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); }))
+        {
+            numbers.push_back(string::convert<int>(number));
+        }
+    }
+
+    std::sort(numbers.begin(), numbers.end());
+
+    return numbers;
+}
+
+int SnapshotStore::getNextSnapshotNumber(const std::string& mapName) const
+{
+    auto numbers = getSnapshotNumbers(mapName);
+    return numbers.empty() ? 0 : numbers.back() + 1;
+}
+
+fs::path SnapshotStore::getChunkFolder() const
+{
+    return _folder / "chunks";
+}
+
+std::string SnapshotStore::storeChunk(const std::string& text)
+{
+    math::Hash hash;
+    hash.addString(text);
+
+    std::string name = hash;
+    auto path = getChunkFolder() / name;
+
+    // Unchanged pieces are already there
+    if (!fs::exists(path))
+    {
+        WriteFile(path, Compress(text), true);
+    }
+
+    return name;
+}
+
+void SnapshotStore::addSnapshot(const std::string& mapName, int num, const std::string& mapText, const std::string& infoFileText)
+{
+    fs::create_directories(getChunkFolder());
+
+    std::string strippedText;
+    auto numbered = StripCommentNumbers(mapText, strippedText);
+
+    std::string_view text = numbered ? std::string_view(strippedText) : std::string_view(mapText);
+
+    std::ostringstream manifest;
+    manifest << MANIFEST_HEADER << "\n";
+    manifest << "numbered " << (numbered ? 1 : 0) << "\n";
+
+    for (const auto& chunk : SplitIntoChunks(text, numbered))
+    {
+        manifest << "chunk " << storeChunk(std::string(chunk)) << " " << chunk.size() << "\n";
+    }
+
+    if (!infoFileText.empty())
+    {
+        manifest << "info " << storeChunk(infoFileText) << " " << infoFileText.size() << "\n";
+    }
+
+    // The manifest is written last, it's only referring to chunks already on disk
+    WriteFile(getManifestPath(mapName, num), manifest.str(), false);
+
+    // Drop the chunks of the snapshots that have been deleted in the meantime
+    collectGarbage();
+}
+
+std::size_t SnapshotStore::getTotalSize(const std::string& mapName) const
+{
+    std::size_t size = 0;
+
+    // Chunks shared by several snapshots of this map are counted once
+    std::set<std::string> chunks;
+
+    for (auto num : getSnapshotNumbers(mapName))
+    {
+        auto manifestPath = getManifestPath(mapName, num);
+        size += fs::file_size(manifestPath);
+
+        try
+        {
+            ForeachChunk(ReadManifest(manifestPath), [&](const ChunkReference& chunk)
+            {
+                auto chunkPath = getChunkFolder() / chunk.hash;
+
+                if (chunks.insert(chunk.hash).second && fs::exists(chunkPath))
+                {
+                    size += fs::file_size(chunkPath);
+                }
+            });
+        }
+        catch (const std::runtime_error&)
+        {
+            // Unreadable manifests are only counted with their own size
+        }
+    }
+
+    return size;
+}
+
+void SnapshotStore::collectGarbage()
+{
+    if (!fs::is_directory(getChunkFolder()))
+    {
+        return;
+    }
+
+    // Count the references to each chunk by the manifests of all maps in this folder
+    std::map<std::string, std::size_t> referenceCounts;
+
+    for (const auto& entry : fs::directory_iterator(_folder))
+    {
+        if (!isManifest(entry.path())) continue;
+
+        try
+        {
+            ForeachChunk(ReadManifest(entry.path()), [&](const ChunkReference& chunk)
+            {
+                ++referenceCounts[chunk.hash];
+            });
+        }
+        catch (const std::runtime_error&)
+        {
+            // Don't delete anything the unreadable manifest might refer to
+            return;
+        }
+    }
+
+    std::vector<fs::path> unreferencedChunks;
+
+    for (const auto& entry : fs::directory_iterator(getChunkFolder()))
+    {
+        if (referenceCounts.count(entry.path().filename().string()) == 0)
+        {
+            unreferencedChunks.push_back(entry.path());
+        }
+    }
+
+    for (const auto& path : unreferencedChunks)
+    {
+        fs::remove(path);
+    }
+}
+
+void SnapshotStore::RestoreSnapshot(const fs::path& manifestPath, const fs::path& mapPath, const fs::path& infoFilePath)
+{
+    auto manifest = ReadManifest(manifestPath);
+    auto chunkFolder = manifestPath.parent_path() / "chunks";
+
+    std::string mapText;
+
+    for (const auto& chunk : manifest.chunks)
+    {
+        mapText += ReadChunk(chunkFolder, chunk.hash, chunk.size);
+    }
+
+    WriteFile(mapPath, manifest.numbered ? RenumberComments(mapText) : mapText, false);
+
+    if (manifest.hasInfoFile && !infoFilePath.empty())
+    {
+        WriteFile(infoFilePath, ReadChunk(chunkFolder, manifest.infoFile.hash, manifest.infoFile.size), false);
+    }
+}
+
+}
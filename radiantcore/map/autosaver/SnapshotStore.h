@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "os/fs.h"
+
+namespace map
+{
+
+/**
+ * Storage for autosave snapshots, keeping the history of a map at a fraction
+ * of the disk space full copies would take.
+ *
+ * The serialised map is split on entity boundaries. Large entities like the
+ * worldspawn are further split into runs of primitives, the run boundaries
+ * depend on the primitive contents only, such that a change to one primitive
+ * doesn't shift the remaining runs. The entity and primitive number comments
+ * are stripped before storing and re-generated when restoring.
+ *
+ * Each piece is stored once as zlib-compressed chunk below the "chunks" folder,
+ * named after the SHA-256 hash of its contents. A snapshot is a manifest file
+ * listing the chunks in the order they need to be concatenated. Unchanged
+ * entities are shared by all snapshots (of all maps) in the same folder.
+ * Chunks no longer referenced by any manifest are deleted whenever a new
+ * snapshot is added, such that removing old manifests frees their space.
+ *
+ * The store only touches files below its folder, it can be used from any thread.
+ */
+class SnapshotStore
+{
+private:
+    fs::path _folder;
+
+public:
+    SnapshotStore(const fs::path& folder);
+
+    // Path to the manifest of the given snapshot, e.g. <folder>/altar.3.snapshot
+    fs::path getManifestPath(const std::string& mapName, int num) const;
+
+    // Numbers of the existing snapshots of the given map, in ascending order
+    std::vector<int> getSnapshotNumbers(const std::string& mapName) const;
+
+    // The number to use for the next snapshot of the given map
+    int getNextSnapshotNumber(const std::string& mapName) const;
+
+    // Stores the given map and info file text as new snapshot, then removes unreferenced chunks.
+    // Throws std::runtime_error on failure.
+    void addSnapshot(const std::string& mapName, int num, const std::string& mapText, const std::string& infoFileText);
+
+    // Disk space taken by the manifests of the given map and the chunks they refer to
+    std::size_t getTotalSize(const std::string& mapName) const;
+
+    // Reassembles the map and info file of the given manifest. The info file is not
+    // written if the path is empty or the snapshot doesn't have one.
+    // Throws std::runtime_error on failure.
+    static void RestoreSnapshot(const fs::path& manifestPath, const fs::path& mapPath, const fs::path& infoFilePath);
+
+private:
+    fs::path getChunkFolder() const;
+
+    // Compresses the given text into a chunk file (unless it exists) and returns its hash
+    std::string storeChunk(const std::string& text);
+
+    // Deletes the chunk files which are not referenced by any manifest in this folder
+    void collectGarbage();
+};
+
+}
@@ -57,10 +57,15 @@ void Doom3MapWriter::writeEntityKeyValues(const EntityNodePtr& entity, std::ostr
 	// Export the entity key values
     entity->getEntity().forEachKeyValue([&](const std::string& key, const std::string& value)
     {
-        stream << "\"" << escapeEntityKeyValue(key) << "\" \"" << escapeEntityKeyValue(value) << "\"" << std::endl;
+        writeEntityKeyValue(key, value, stream);
     });
 }
 
+void Doom3MapWriter::writeEntityKeyValue(const std::string& key, const std::string& value, std::ostream& stream)
+{
+    stream << "\"" << escapeEntityKeyValue(key) << "\" \"" << escapeEntityKeyValue(value) << "\"" << std::endl;
+}
+
 void Doom3MapWriter::endWriteEntity(const EntityNodePtr& entity, std::ostream& stream)
 {
 	// Write the closing brace for the entity
@@ -37,6 +37,9 @@ public:
 	virtual void beginWritePatch(const IPatchNodePtr& patch, std::ostream& stream) override;
 	virtual void endWritePatch(const IPatchNodePtr& patch, std::ostream& stream) override;
 
+	// Writes a single "key" "value" line, escaping line breaks and quotes
+	static void writeEntityKeyValue(const std::string& key, const std::string& value, std::ostream& stream);
+
 protected:
 	void writeEntityKeyValues(const EntityNodePtr& entity, std::ostream& stream);
 };
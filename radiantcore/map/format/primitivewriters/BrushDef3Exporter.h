@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+#include <vector>
 #include "ibrush.h"
 #include "math/Plane3.h"
 #include "math/Matrix4.h"
@@ -32,6 +34,30 @@ public:
 		stream << "}" << std::endl << "}" << std::endl;
 	}
 
+	// Plain copy of the face properties written to a brushDef3 definition
+	struct FaceDefinition
+	{
+		Plane3 plane;
+		Matrix3 texdef;
+		std::string shader;
+	};
+
+	// Writes a brushDef3 definition from the given face data, all faces are written
+	static void exportBrush(std::ostream& stream, const std::vector<FaceDefinition>& faces,
+		IBrush::DetailFlag detailFlag, bool writeContentsFlags = true)
+	{
+		stream << "{" << std::endl;
+		stream << "brushDef3" << std::endl;
+		stream << "{" << std::endl;
+
+		for (const auto& face : faces)
+		{
+			writeFace(stream, face.plane, face.texdef, face.shader, writeContentsFlags, detailFlag);
+		}
+
+		stream << "}" << std::endl << "}" << std::endl;
+	}
+
 private:
 
 	static void writeFace(std::ostream& stream, const IFace& face, bool writeContentsFlags, IBrush::DetailFlag detailFlag)
@@ -42,9 +68,13 @@ private:
 			return;
 		}
 
-		// Write the plane equation
-		const Plane3& plane = face.getPlane3();
+		writeFace(stream, face.getPlane3(), face.getProjectionMatrix(), face.getShader(), writeContentsFlags, detailFlag);
+	}
 
+	static void writeFace(std::ostream& stream, const Plane3& plane, const Matrix3& texdef,
+		const std::string& shaderName, bool writeContentsFlags, IBrush::DetailFlag detailFlag)
+	{
+		// Write the plane equation
 		stream << "( ";
 		writeDoubleSafe(plane.normal().x(), stream);
 		stream << " ";
@@ -57,7 +87,6 @@ private:
 		stream << ") ";
 
 		// Write TexDef
-		auto texdef = face.getProjectionMatrix();
 		stream << "( ";
 
 		stream << "( ";
@@ -79,8 +108,6 @@ private:
 		stream << ") ";
 
 		// Write Shader
-		const std::string& shaderName = face.getShader();
-
 		if (shaderName.empty()) {
 			stream << "\"_default\" ";
 		}
@@ -16,8 +16,14 @@ public:
 	// Writes a patchDef2/3 definition from the given patch to the given stream
 	static void exportPatch(std::ostream& stream, const IPatchNodePtr& patchNode)
 	{
-		const IPatch& patch = patchNode->getPatch();
+		exportPatch(stream, patchNode->getPatch());
+	}
 
+	// Writes a patchDef2/3 definition from any object offering the same
+	// accessors as IPatch (shader, dimensions, subdivisions and ctrlAt)
+	template<typename PatchT>
+	static void exportPatch(std::ostream& stream, const PatchT& patch)
+	{
 		if (patch.subdivisionsFixed())
 		{
 			exportPatchDef3(stream, patch);
@@ -55,7 +61,8 @@ public:
 
 private:
 	// Export a patchDef3 declaration (fixed subdivisions)
-	static void exportPatchDef3(std::ostream& stream, const IPatch& patch)
+	template<typename PatchT>
+	static void exportPatchDef3(std::ostream& stream, const PatchT& patch)
 	{
 		// Export patch declaration
 		stream << "{\n";
@@ -84,7 +91,8 @@ private:
 	}
 
 	// Export a patchDef2 declaration, D3-style
-	static void exportPatchDef2(std::ostream& stream, const IPatch& patch)
+	template<typename PatchT>
+	static void exportPatchDef2(std::ostream& stream, const PatchT& patch)
 	{
 		// Export patch declaration
 		stream << "{\n";
@@ -106,7 +114,8 @@ private:
 		stream << "}\n}\n";
 	}
 
-	static void exportShader(std::ostream& stream, const IPatch& patch)
+	template<typename PatchT>
+	static void exportShader(std::ostream& stream, const PatchT& patch)
 	{
 		// Export shader
 		const std::string& shaderName = patch.getShader();
@@ -147,7 +156,8 @@ private:
 		stream << "\n";
 	}
 
-	static void exportPatchControlMatrix(std::ostream& stream, const IPatch& patch)
+	template<typename PatchT>
+	static void exportPatchControlMatrix(std::ostream& stream, const PatchT& patch)
 	{
 		// Export the control point matrix
 		stream << "(\n";
@@ -0,0 +1,169 @@
+#include "BackgroundModelLoader.h"
+
+#include <algorithm>
+#include "itextstream.h"
+
+namespace model
+{
+
+BackgroundModelLoader::BackgroundModelLoader(const LoadFunction& loadModel, const std::function<void()>& notifier) :
+    _loadModel(loadModel),
+    _notifier(notifier),
+    _shutdown(false)
+{}
+
+BackgroundModelLoader::~BackgroundModelLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        _shutdown = true;
+        _queue.clear();
+    }
+
+    _queueChanged.notify_all();
+
+    for (auto& worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+void BackgroundModelLoader::setNotifier(const std::function<void()>& notifier)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    _notifier = notifier;
+}
+
+bool BackgroundModelLoader::enqueue(const std::string& modelPath)
+{
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        // Models that are finished but not fetched yet don't need to be loaded again
+        auto alreadyFinished = std::any_of(_finished.begin(), _finished.end(),
+            [&](const auto& pair) { return pair.first == modelPath; });
+
+        if (alreadyFinished || !_pending.insert(modelPath).second)
+        {
+            return false;
+        }
+
+        _queue.push_back(modelPath);
+
+        if (_workers.empty())
+        {
+            startWorkers();
+        }
+    }
+
+    _queueChanged.notify_one();
+    return true;
+}
+
+bool BackgroundModelLoader::waitForModel(const std::string& modelPath, IModelPtr& model)
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    _idle.wait(lock, [&]() { return _pending.count(modelPath) == 0; });
+
+    auto found = std::find_if(_finished.begin(), _finished.end(),
+        [&](const auto& pair) { return pair.first == modelPath; });
+
+    if (found == _finished.end())
+    {
+        return false;
+    }
+
+    model = found->second;
+    return true;
+}
+
+BackgroundModelLoader::FinishedModels BackgroundModelLoader::fetchFinishedModels()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    FinishedModels result;
+    result.swap(_finished);
+
+    return result;
+}
+
+void BackgroundModelLoader::waitUntilIdle()
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    _idle.wait(lock, [this]() { return _pending.empty(); });
+}
+
+void BackgroundModelLoader::clearQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        for (const auto& path : _queue)
+        {
+            _pending.erase(path);
+        }
+
+        _queue.clear();
+    }
+
+    _idle.notify_all();
+}
+
+void BackgroundModelLoader::startWorkers()
+{
+    // Leave one core to the main thread
+    auto numWorkers = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+    for (unsigned int i = 0; i < numWorkers; ++i)
+    {
+        _workers.emplace_back(&BackgroundModelLoader::processQueue, this);
+    }
+}
+
+void BackgroundModelLoader::processQueue()
+{
+    while (true)
+    {
+        std::string modelPath;
+
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            _queueChanged.wait(lock, [this]() { return _shutdown || !_queue.empty(); });
+
+            if (_shutdown) return;
+
+            modelPath = _queue.front();
+            _queue.pop_front();
+        }
+
+        IModelPtr model;
+
+        try
+        {
+            model = _loadModel(modelPath);
+        }
+        catch (const std::exception& ex)
+        {
+            rError() << "Failed to load model " << modelPath << ": " << ex.what() << std::endl;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+
+            _finished.emplace_back(modelPath, model);
+            _pending.erase(modelPath);
+
+            // Only the first model of a batch needs to be announced, the
+            // owner is going to fetch all of them at once
+            if (_finished.size() == 1 && _notifier)
+            {
+                _notifier();
+            }
+        }
+
+        _idle.notify_all();
+    }
+}
+
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "imodel.h"
+
+namespace model
+{
+
+/**
+ * Pool of worker threads parsing model files off the main thread.
+ *
+ * Finished models are collected until the owner picks them up through
+ * fetchFinishedModels(). The notifier is invoked on the worker thread when
+ * the first model after the last fetch has been finished, it is up to the
+ * listener to marshal the call over to the main thread.
+ *
+ * The worker threads are launched when the first model is queued.
+ */
+class BackgroundModelLoader final
+{
+public:
+    using LoadFunction = std::function<IModelPtr(const std::string&)>;
+
+    // Pairs of model path and the loaded model (which is empty if the load failed)
+    using FinishedModels = std::vector<std::pair<std::string, IModelPtr>>;
+
+private:
+    LoadFunction _loadModel;
+
+    std::mutex _lock;
+    std::condition_variable _queueChanged;
+    std::condition_variable _idle;
+
+    std::deque<std::string> _queue;
+
+    // Paths that are either queued or currently being loaded
+    std::set<std::string> _pending;
+
+    FinishedModels _finished;
+
+    // Called with the lock held, such that it can be exchanged at any time
+    std::function<void()> _notifier;
+
+    std::vector<std::thread> _workers;
+    bool _shutdown;
+
+public:
+    BackgroundModelLoader(const LoadFunction& loadModel, const std::function<void()>& notifier);
+
+    // Discards all queued models and waits for the running loads to finish
+    ~BackgroundModelLoader();
+
+    // Replaces the function to call when models are ready to be fetched
+    void setNotifier(const std::function<void()>& notifier);
+
+    // Queues the given model for loading. Returns false if this path
+    // is already queued, currently being loaded or waiting to be fetched.
+    bool enqueue(const std::string& modelPath);
+
+    // Looks up the result of a queued model, blocking until the worker is done with it.
+    // The model stays in the finished list. Returns false if this path has not been queued.
+    bool waitForModel(const std::string& modelPath, IModelPtr& model);
+
+    // Returns all models finished since the last call, clearing the internal list
+    FinishedModels fetchFinishedModels();
+
+    // Blocks until the queue is empty and no model is being loaded anymore
+    void waitUntilIdle();
+
+    // Removes all models from the queue that have not been started yet
+    void clearQueue();
+
+private:
+    void startWorkers();
+    void processQueue();
+};
+
+}
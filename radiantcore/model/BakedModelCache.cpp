@@ -0,0 +1,311 @@
+#include "BakedModelCache.h"
+
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include "itextstream.h"
+#include "os/dir.h"
+#include "os/fs.h"
+#include "os/path.h"
+#include "string/replace.h"
+#include "vfs/FileStamp.h"
+#include "StaticModelSurface.h"
+
+namespace model
+{
+
+namespace
+{
+    constexpr char MAGIC[4] = { 'D', 'R', 'M', 'B' };
+
+    // Increase this whenever the layout below or the processing of imported models changes
+    constexpr std::uint32_t VERSION = 1;
+
+    // File layout (native byte order):
+    //   magic, version, source size, source modification time, path length, surface count, path
+    //   for each surface:
+    //     vertex count, index count, material length, material, bounds origin and extents,
+    //     vertices (as DOUBLES_PER_VERTEX values), indices
+    constexpr std::size_t DOUBLES_PER_VERTEX = 18;
+
+    class Writer
+    {
+    private:
+        std::vector<char> _buffer;
+
+    public:
+        template<typename T>
+        void write(const T& value)
+        {
+            static_assert(std::is_arithmetic_v<T>, "Only arithmetic types can be written");
+
+            auto offset = _buffer.size();
+            _buffer.resize(offset + sizeof(T));
+            std::memcpy(_buffer.data() + offset, &value, sizeof(T));
+        }
+
+        void writeString(const std::string& str)
+        {
+            write(static_cast<std::uint32_t>(str.size()));
+            _buffer.insert(_buffer.end(), str.begin(), str.end());
+        }
+
+        const std::vector<char>& getBuffer() const
+        {
+            return _buffer;
+        }
+    };
+
+    // Reads values from the buffer, returns false if the buffer is exhausted
+    class Reader
+    {
+    private:
+        const char* _pos;
+        const char* _end;
+
+    public:
+        Reader(const std::vector<char>& buffer) :
+            _pos(buffer.data()),
+            _end(buffer.data() + buffer.size())
+        {}
+
+        template<typename T>
+        bool read(T& value)
+        {
+            if (static_cast<std::size_t>(_end - _pos) < sizeof(T)) return false;
+
+            std::memcpy(&value, _pos, sizeof(T));
+            _pos += sizeof(T);
+            return true;
+        }
+
+        bool readString(std::string& str)
+        {
+            std::uint32_t length;
+
+            if (!read(length) || static_cast<std::size_t>(_end - _pos) < length) return false;
+
+            str.assign(_pos, length);
+            _pos += length;
+            return true;
+        }
+
+        bool readVertices(std::vector<MeshVertex>& vertices, std::size_t count)
+        {
+            if (static_cast<std::size_t>(_end - _pos) / (DOUBLES_PER_VERTEX * sizeof(double)) < count) return false;
+
+            vertices.resize(count);
+
+            for (auto& vertex : vertices)
+            {
+                double v[DOUBLES_PER_VERTEX];
+                std::memcpy(v, _pos, sizeof(v));
+                _pos += sizeof(v);
+
+                vertex.texcoord = TexCoord2f(v[0], v[1]);
+                vertex.normal = Normal3(v[2], v[3], v[4]);
+                vertex.vertex = Vertex3(v[5], v[6], v[7]);
+                vertex.tangent = Normal3(v[8], v[9], v[10]);
+                vertex.bitangent = Normal3(v[11], v[12], v[13]);
+                vertex.colour = Vector4(v[14], v[15], v[16], v[17]);
+            }
+
+            return true;
+        }
+
+        bool readIndices(std::vector<unsigned int>& indices, std::size_t count)
+        {
+            if (static_cast<std::size_t>(_end - _pos) / sizeof(std::uint32_t) < count) return false;
+
+            indices.resize(count);
+
+            for (auto& index : indices)
+            {
+                std::uint32_t value;
+                std::memcpy(&value, _pos, sizeof(value));
+                _pos += sizeof(value);
+
+                index = value;
+            }
+
+            return true;
+        }
+    };
+}
+
+BakedModelCache::BakedModelCache(const std::string& cacheFolder) :
+    _cacheFolder(os::standardPathWithSlash(cacheFolder))
+{
+    os::makeDirectory(_cacheFolder);
+}
+
+bool BakedModelCache::IsSupportedFormat(const std::string& extension)
+{
+    return extension == "ase" || extension == "lwo" || extension == "obj" || extension == "fbx";
+}
+
+std::string BakedModelCache::getCacheFilePath(const std::string& modelPath) const
+{
+    // Flatten the path, collisions are detected by the path stored in the file
+    auto fileName = string::replace_all_copy(modelPath, "/", "_");
+    string::replace_all(fileName, "\\", "_");
+
+    return _cacheFolder + fileName + ".bin";
+}
+
+StaticModelPtr BakedModelCache::load(const std::string& modelPath)
+{
+    std::ifstream stream(getCacheFilePath(modelPath), std::ios::binary | std::ios::ate);
+
+    if (!stream) return StaticModelPtr();
+
+    vfs::FileStamp sourceStamp;
+
+    if (!vfs::getFileStamp(modelPath, sourceStamp)) return StaticModelPtr();
+
+    std::vector<char> buffer(static_cast<std::size_t>(stream.tellg()));
+    stream.seekg(0);
+
+    if (!stream.read(buffer.data(), buffer.size())) return StaticModelPtr();
+
+    Reader reader(buffer);
+
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t size;
+    std::int64_t modificationTime;
+    std::string storedPath;
+    std::uint32_t surfaceCount;
+
+    if (!reader.read(magic) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        !reader.read(version) || version != VERSION ||
+        !reader.read(size) || size != sourceStamp.size ||
+        !reader.read(modificationTime) || modificationTime != sourceStamp.modificationTime ||
+        !reader.readString(storedPath) || storedPath != modelPath ||
+        !reader.read(surfaceCount))
+    {
+        return StaticModelPtr(); // outdated or foreign file, will be overwritten
+    }
+
+    std::vector<StaticModelSurfacePtr> surfaces;
+
+    for (std::uint32_t s = 0; s < surfaceCount; ++s)
+    {
+        std::uint32_t vertexCount, indexCount;
+        std::string material;
+        double bounds[6];
+
+        std::vector<MeshVertex> vertices;
+        std::vector<unsigned int> indices;
+
+        if (!reader.read(vertexCount) || !reader.read(indexCount) || !reader.readString(material) ||
+            !reader.read(bounds) || !reader.readVertices(vertices, vertexCount) ||
+            !reader.readIndices(indices, indexCount))
+        {
+            rWarning() << "Baked model " << modelPath << " is truncated" << std::endl;
+            return StaticModelPtr();
+        }
+
+        for (auto index : indices)
+        {
+            if (index >= vertexCount)
+            {
+                rWarning() << "Baked model " << modelPath << " has invalid indices" << std::endl;
+                return StaticModelPtr();
+            }
+        }
+
+        auto& surface = surfaces.emplace_back(std::make_shared<StaticModelSurface>(std::move(vertices),
+            std::move(indices), AABB({ bounds[0], bounds[1], bounds[2] }, { bounds[3], bounds[4], bounds[5] })));
+
+        surface->setDefaultMaterial(material);
+    }
+
+    auto model = std::make_shared<StaticModel>(surfaces);
+
+    model->setFilename(os::getFilename(modelPath));
+    model->setModelPath(modelPath);
+
+    return model;
+}
+
+void BakedModelCache::store(const std::string& modelPath, const StaticModel& model)
+{
+    vfs::FileStamp sourceStamp;
+
+    if (!vfs::getFileStamp(modelPath, sourceStamp)) return;
+
+    Writer writer;
+
+    for (auto c : MAGIC)
+    {
+        writer.write(c);
+    }
+
+    writer.write(VERSION);
+    writer.write(sourceStamp.size);
+    writer.write(sourceStamp.modificationTime);
+    writer.writeString(modelPath);
+    writer.write(static_cast<std::uint32_t>(model.getSurfaceCount()));
+
+    model.foreachSurface([&](const StaticModelSurface& surface)
+    {
+        const auto& vertices = surface.getVertexArray();
+        const auto& indices = surface.getIndexArray();
+        const auto& bounds = surface.getAABB();
+
+        writer.write(static_cast<std::uint32_t>(vertices.size()));
+        writer.write(static_cast<std::uint32_t>(indices.size()));
+        writer.writeString(surface.getDefaultMaterial());
+
+        for (auto value : { bounds.origin.x(), bounds.origin.y(), bounds.origin.z(),
+            bounds.extents.x(), bounds.extents.y(), bounds.extents.z() })
+        {
+            writer.write(value);
+        }
+
+        for (const auto& v : vertices)
+        {
+            for (double value : { v.texcoord.x(), v.texcoord.y(), v.normal.x(), v.normal.y(), v.normal.z(),
+                v.vertex.x(), v.vertex.y(), v.vertex.z(), v.tangent.x(), v.tangent.y(), v.tangent.z(),
+                v.bitangent.x(), v.bitangent.y(), v.bitangent.z(),
+                v.colour.x(), v.colour.y(), v.colour.z(), v.colour.w() })
+            {
+                writer.write(value);
+            }
+        }
+
+        for (auto index : indices)
+        {
+            writer.write(static_cast<std::uint32_t>(index));
+        }
+    });
+
+    // Write to a temporary file first, other threads might be reading the previous version
+    auto cacheFilePath = getCacheFilePath(modelPath);
+    auto tempPath = cacheFilePath + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+    {
+        std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+
+        const auto& buffer = writer.getBuffer();
+
+        if (!stream || !stream.write(buffer.data(), buffer.size()))
+        {
+            rWarning() << "Failed to write baked model " << cacheFilePath << std::endl;
+            return;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tempPath, cacheFilePath, ec);
+
+    if (ec)
+    {
+        rWarning() << "Failed to write baked model " << cacheFilePath << ": " << ec.message() << std::endl;
+        fs::remove(tempPath, ec);
+    }
+}
+
+}
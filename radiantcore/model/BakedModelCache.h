@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include "StaticModel.h"
+
+namespace model
+{
+
+/**
+ * On-disk cache of imported static models (ASE, LWO, OBJ, FBX).
+ *
+ * The surfaces of a model are stored after the import has been processed,
+ * including the calculated tangents, the indices, the material names and
+ * the bounds. Loading a baked model is a single read of the cache file,
+ * followed by the validation of the header and copying the vertex data
+ * into the surfaces.
+ *
+ * Each cache file is tagged with the VFS path, size and modification time
+ * of the source file (or the containing archive), a mismatch in any of these
+ * causes the model to be imported from its source file again.
+ *
+ * Instances of this class can be used from several threads concurrently.
+ */
+class BakedModelCache final
+{
+private:
+    std::string _cacheFolder;
+
+public:
+    // Cache files are stored in the given folder, which is created if necessary
+    BakedModelCache(const std::string& cacheFolder);
+
+    // Returns true if models of the given (lowercase) file extension can be baked
+    static bool IsSupportedFormat(const std::string& extension);
+
+    // Returns the baked model for the given VFS path, or an empty pointer
+    // if there is no baked model or the source file has been changed since.
+    StaticModelPtr load(const std::string& modelPath);
+
+    // Writes the surfaces of the given model to the cache
+    void store(const std::string& modelPath, const StaticModel& model);
+
+    // Returns the path of the cache file belonging to the given model path
+    std::string getCacheFilePath(const std::string& modelPath) const;
+};
+
+}
@@ -3,20 +3,37 @@
 #include "imodel.h"
 #include "iparticlenode.h"
 #include "iparticles.h"
+#include "ipreferencesystem.h"
+#include "iscenegraph.h"
+#include "itextstream.h"
+#include "i18n.h"
 
 #include "os/path.h"
 #include "os/file.h"
+#include "string/case_conv.h"
 
 #include "module/StaticModule.h"
+#include "registry/registry.h"
+#include <algorithm>
 #include <functional>
 
 #include "map/algorithm/Models.h"
+#include "NullModelNode.h"
 
 namespace model
 {
 
+namespace
+{
+	constexpr const char* const RKEY_LOAD_MODELS_IN_BACKGROUND = "user/ui/models/loadInBackground";
+	constexpr const char* const RKEY_MODEL_CACHE_MEMORY_LIMIT = "user/ui/models/cacheMemoryLimit";
+}
+
 ModelCache::ModelCache() :
-	_enabled(true)
+	_useCounter(0),
+	_memoryUsage(0),
+	_enabled(true),
+	_loadInBackground(false)
 {}
 
 scene::INodePtr ModelCache::getModelNode(const std::string& modelPath)
@@ -40,6 +57,78 @@ scene::INodePtr ModelCache::getModelNode(const std::string& modelPath)
     return node ? node : loadNullModel(modelPath);
 }
 
+scene::INodePtr ModelCache::getModelNodeAsync(const std::string& modelPath,
+	const AABB& placeholderBounds, const sigc::slot<void>& onLoaded)
+{
+	// Particles are not handled by the model loaders, and absolute paths
+	// are not cached under their own name: these are created right away
+	if (!_loadInBackground || !_enabled || os::getExtension(modelPath) == "prt" ||
+		path_is_absolute(modelPath.c_str()) || _modelMap.count(modelPath) > 0)
+	{
+		return getModelNode(modelPath);
+	}
+
+	getBackgroundLoader().enqueue(modelPath);
+	_loadCallbacks[modelPath].push_back(onLoaded);
+
+	return createPlaceholderNode(modelPath, placeholderBounds);
+}
+
+void ModelCache::prefetchModels(const std::set<std::string>& modelPaths)
+{
+	if (!_enabled) return;
+
+	for (const auto& modelPath : modelPaths)
+	{
+		auto extension = os::getExtension(modelPath);
+
+		// Skip particles and paths the model loaders can't handle anyway
+		if (extension.empty() || extension == "prt" || path_is_absolute(modelPath.c_str()) ||
+			_modelMap.count(modelPath) > 0)
+		{
+			continue;
+		}
+
+		getBackgroundLoader().enqueue(modelPath);
+	}
+}
+
+void ModelCache::processFinishedModelLoads()
+{
+	if (!_backgroundLoader) return;
+
+	for (const auto& [modelPath, model] : _backgroundLoader->fetchFinishedModels())
+	{
+		// Failed loads are not cached, the requesters will end up with a NullModel
+		if (model && _enabled && _modelMap.count(modelPath) == 0)
+		{
+			insertModel(modelPath, model);
+		}
+
+		auto callbacks = _loadCallbacks.find(modelPath);
+
+		if (callbacks == _loadCallbacks.end()) continue;
+
+		// The callbacks might request further models, so move them out of the map first
+		auto slots = std::move(callbacks->second);
+		_loadCallbacks.erase(callbacks);
+
+		// Slots of destroyed requesters have been invalidated and are doing nothing
+		for (const auto& slot : slots)
+		{
+			slot();
+		}
+	}
+}
+
+void ModelCache::waitForPendingModelLoads()
+{
+	if (_backgroundLoader)
+	{
+		_backgroundLoader->waitUntilIdle();
+	}
+}
+
 IModelPtr ModelCache::getModel(const std::string& modelPath)
 {
 	// Try to lookup the existing model
@@ -47,23 +136,24 @@ IModelPtr ModelCache::getModel(const std::string& modelPath)
 
 	if (_enabled && found != _modelMap.end())
 	{
-		return found->second;
+		found->second.lastUse = ++_useCounter;
+		return found->second.model;
 	}
 
-	// The model is not cached or the cache is disabled, load afresh
-
-	// Get the extension of this model
-	std::string type = os::getExtension(modelPath);
-
-	// Find a suitable model loader
-	IModelImporterPtr modelLoader = GlobalModelFormatManager().getImporter(type);
+	IModelPtr model;
 
-	IModelPtr model = modelLoader->loadModelFromPath(modelPath);
+	// The model might be parsed by the background workers already, pick up that result
+	// to not load it twice. Failed background loads are not attempted again.
+	if (!_enabled || !_backgroundLoader || !_backgroundLoader->waitForModel(modelPath, model))
+	{
+		// The model is not cached or the cache is disabled, load afresh
+		model = loadModelFromPath(modelPath);
+	}
 
-	if (model)
+	if (model && found == _modelMap.end())
 	{
 		// Model successfully loaded, insert a reference into the map
-		_modelMap.emplace(modelPath, model);
+		insertModel(modelPath, model);
 	}
 
 	return model;
@@ -92,6 +182,65 @@ scene::INodePtr ModelCache::loadNullModel(const std::string& modelPath)
     return nullModelLoader->loadModel(modelPath);
 }
 
+BackgroundModelLoader& ModelCache::getBackgroundLoader()
+{
+    if (!_backgroundLoader)
+    {
+        _backgroundLoader = std::make_unique<BackgroundModelLoader>(
+            [this](const std::string& path) { return loadModelFromPath(path); },
+            _backgroundLoadNotifier
+        );
+    }
+
+    return *_backgroundLoader;
+}
+
+scene::INodePtr ModelCache::createPlaceholderNode(const std::string& modelPath, const AABB& bounds)
+{
+    auto placeholder = std::make_shared<NullModel>();
+
+    placeholder->setModelPath(modelPath);
+    placeholder->setFilename(os::getFilename(modelPath));
+
+    if (bounds.isValid())
+    {
+        placeholder->setLocalAABB(bounds);
+    }
+
+    return std::make_shared<NullModelNode>(placeholder);
+}
+
+IModelPtr ModelCache::loadModelFromPath(const std::string& modelPath)
+{
+    auto extension = os::getExtension(modelPath);
+
+    auto useBakedModels = _bakedModels && !path_is_absolute(modelPath.c_str()) &&
+        BakedModelCache::IsSupportedFormat(string::to_lower_copy(extension));
+
+    if (useBakedModels)
+    {
+        if (auto bakedModel = _bakedModels->load(modelPath); bakedModel)
+        {
+            return bakedModel;
+        }
+    }
+
+    // Find a suitable model loader for this extension
+    auto modelLoader = GlobalModelFormatManager().getImporter(extension);
+
+    auto model = modelLoader->loadModelFromPath(modelPath);
+
+    if (useBakedModels)
+    {
+        if (auto staticModel = std::dynamic_pointer_cast<StaticModel>(model); staticModel)
+        {
+            _bakedModels->store(modelPath, *staticModel);
+        }
+    }
+
+    return model;
+}
+
 void ModelCache::removeModel(const std::string& modelPath)
 {
 	// greebo: Disable the modelcache. During map::clear(), the nodes
@@ -102,7 +251,7 @@ void ModelCache::removeModel(const std::string& modelPath)
 
 	if (found != _modelMap.end())
 	{
-		_modelMap.erase(found);
+		eraseModel(found);
 	}
 
 	// Allow usage of the modelnodemap again.
@@ -116,6 +265,7 @@ void ModelCache::clear()
 	_enabled = false;
 
 	_modelMap.clear();
+	_memoryUsage = 0;
 
 	// Allow usage of the modelnodemap again.
 	_enabled = true;
@@ -126,6 +276,16 @@ sigc::signal<void> ModelCache::signal_modelsReloaded()
 	return _sigModelsReloaded;
 }
 
+void ModelCache::setBackgroundLoadNotifier(const std::function<void()>& notifier)
+{
+	_backgroundLoadNotifier = notifier;
+
+	if (_backgroundLoader)
+	{
+		_backgroundLoader->setNotifier(_backgroundLoadNotifier);
+	}
+}
+
 // RegisterableModule implementation
 std::string ModelCache::getName() const
 {
@@ -141,6 +301,9 @@ StringSet ModelCache::getDependencies() const
 	{
 		_dependencies.insert(MODULE_MODELFORMATMANAGER);
 		_dependencies.insert(MODULE_COMMANDSYSTEM);
+		_dependencies.insert(MODULE_XMLREGISTRY);
+		_dependencies.insert(MODULE_PREFERENCESYSTEM);
+		_dependencies.insert(MODULE_SCENEGRAPH);
 	}
 
 	return _dependencies;
@@ -152,13 +315,113 @@ void ModelCache::initialiseModule(const IApplicationContext& ctx)
 		std::bind(&ModelCache::refreshModelsCmd, this, std::placeholders::_1));
 	GlobalCommandSystem().addCommand("RefreshSelectedModels",
 		std::bind(&ModelCache::refreshSelectedModelsCmd, this, std::placeholders::_1));
+	GlobalCommandSystem().addCommand("PrintModelCacheStats",
+		std::bind(&ModelCache::printCacheStatsCmd, this, std::placeholders::_1));
+
+	_bakedModels = std::make_unique<BakedModelCache>(ctx.getCacheDataPath() + "bakedmodels/");
+
+	IPreferencePage& page = GlobalPreferenceSystem().getPage(_("Models"));
+	page.appendCheckBox(_("Load models in the background"), RKEY_LOAD_MODELS_IN_BACKGROUND);
+	page.appendSpinner(_("Model Cache Memory Limit (MB, 0 = unlimited)"), RKEY_MODEL_CACHE_MEMORY_LIMIT, 0, 65536, 0);
+
+	_memoryLimit = std::make_unique<registry::CachedKey<double>>(RKEY_MODEL_CACHE_MEMORY_LIMIT);
+	GlobalSceneGraph().addSceneObserver(this);
+
+	GlobalRegistry().signalForKey(RKEY_LOAD_MODELS_IN_BACKGROUND).connect(
+		sigc::mem_fun(this, &ModelCache::onLoadInBackgroundChanged)
+	);
+	onLoadInBackgroundChanged();
 }
 
 void ModelCache::shutdownModule()
 {
+	GlobalSceneGraph().removeSceneObserver(this);
+	_sceneReferences.clear();
+
+	// Stop the workers before the model loaders are going away
+	_backgroundLoader.reset();
+	_loadCallbacks.clear();
+	_bakedModels.reset();
+
 	clear();
 }
 
+void ModelCache::onLoadInBackgroundChanged()
+{
+	_loadInBackground = registry::getValue<bool>(RKEY_LOAD_MODELS_IN_BACKGROUND);
+}
+
+void ModelCache::insertModel(const std::string& modelPath, const IModelPtr& model)
+{
+	auto memoryUsage = model->getMemoryUsage();
+
+	_modelMap.emplace(modelPath, CachedModel{ model, memoryUsage, ++_useCounter });
+	_memoryUsage += memoryUsage;
+
+	enforceMemoryLimit(modelPath);
+}
+
+void ModelCache::eraseModel(ModelMap::iterator found)
+{
+	_memoryUsage -= found->second.memoryUsage;
+	_modelMap.erase(found);
+}
+
+void ModelCache::enforceMemoryLimit(const std::string& modelPathToKeep)
+{
+	// The limit is given in MB, fractions are allowed
+	auto limit = static_cast<std::size_t>(_memoryLimit->get() * 1024 * 1024);
+
+	if (limit == 0 || _memoryUsage <= limit) return;
+
+	// Models used by the scene are staying in the cache, evicting them wouldn't free any memory
+	// since the nodes are sharing the geometry, and the next model change would reload them.
+	std::vector<ModelMap::iterator> candidates;
+
+	for (auto i = _modelMap.begin(); i != _modelMap.end(); ++i)
+	{
+		if (i->first != modelPathToKeep && _sceneReferences.count(i->first) == 0)
+		{
+			candidates.push_back(i);
+		}
+	}
+
+	// Evict the least recently used models first
+	std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b)
+	{
+		return a->second.lastUse < b->second.lastUse;
+	});
+
+	for (auto candidate : candidates)
+	{
+		if (_memoryUsage <= limit) break;
+
+		eraseModel(candidate);
+	}
+}
+
+void ModelCache::onSceneNodeInsert(const scene::INodePtr& node)
+{
+	if (auto modelNode = Node_getModel(node); modelNode)
+	{
+		++_sceneReferences[modelNode->getIModel().getModelPath()];
+	}
+}
+
+void ModelCache::onSceneNodeErase(const scene::INodePtr& node)
+{
+	auto modelNode = Node_getModel(node);
+
+	if (!modelNode) return;
+
+	auto found = _sceneReferences.find(modelNode->getIModel().getModelPath());
+
+	if (found != _sceneReferences.end() && --found->second == 0)
+	{
+		_sceneReferences.erase(found);
+	}
+}
+
 void ModelCache::refreshModels(bool blockScreenUpdates)
 {
 	map::algorithm::refreshModels(blockScreenUpdates);
@@ -179,6 +442,29 @@ void ModelCache::refreshSelectedModelsCmd(const cmd::ArgumentList& args)
 	map::algorithm::refreshSelectedModels(true);
 }
 
+void ModelCache::printCacheStatsCmd(const cmd::ArgumentList& args)
+{
+	// Number of models and memory usage per file extension
+	std::map<std::string, std::pair<std::size_t, std::size_t>> formats;
+
+	for (const auto& [modelPath, cached] : _modelMap)
+	{
+		auto& format = formats[string::to_lower_copy(os::getExtension(modelPath))];
+
+		format.first++;
+		format.second += cached.memoryUsage;
+	}
+
+	rMessage() << "Model cache: " << _modelMap.size() << " models, " <<
+		(_memoryUsage / 1024) << " KB" << std::endl;
+
+	for (const auto& [extension, stats] : formats)
+	{
+		rMessage() << "  " << extension << ": " << stats.first << " models, " <<
+			(stats.second / 1024) << " KB" << std::endl;
+	}
+}
+
 // The static module
 module::StaticModuleRegistration<ModelCache> modelCacheModule;
 
@@ -1,25 +1,69 @@
 #pragma once
 
 #include <map>
+#include <set>
+#include <memory>
 #include <string>
+#include <vector>
 #include "imodelcache.h"
 #include "icommandsystem.h"
+#include "iscenegraph.h"
+#include "registry/CachedKey.h"
+#include "BackgroundModelLoader.h"
+#include "BakedModelCache.h"
 
 namespace model
 {
 
 class ModelCache :
-	public IModelCache
+	public IModelCache,
+	public scene::Graph::Observer
 {
 private:
+	struct CachedModel
+	{
+		IModelPtr model;
+
+		// The estimated memory occupied by this model
+		std::size_t memoryUsage;
+
+		// The value of the use counter when this model was last requested
+		std::size_t lastUse;
+	};
+
 	// The container maps model names to instances
-	typedef std::map<std::string, IModelPtr> ModelMap;
+	typedef std::map<std::string, CachedModel> ModelMap;
 	ModelMap _modelMap;
 
+	// Incremented on every request, used to find the least recently used models
+	std::size_t _useCounter;
+
+	// The sum of the memory usage of all cached models
+	std::size_t _memoryUsage;
+
+	// The configured memory limit in MB, fractions are allowed
+	std::unique_ptr<registry::CachedKey<double>> _memoryLimit;
+
+	// Number of model nodes in the scene referring to each model path,
+	// these models are never evicted from the cache
+	std::map<std::string, std::size_t> _sceneReferences;
+
 	// Flag to disable the cache on demand (used during clear())
 	bool _enabled;
 
+	// Whether getModelNodeAsync() should load the models in the background
+	bool _loadInBackground;
+
+	std::unique_ptr<BackgroundModelLoader> _backgroundLoader;
+
+	// Processed static models stored on disk, to skip parsing them in subsequent sessions
+	std::unique_ptr<BakedModelCache> _bakedModels;
+
+	// Callbacks to invoke once the model with the given path is available
+	std::map<std::string, std::vector<sigc::slot<void>>> _loadCallbacks;
+
 	sigc::signal<void> _sigModelsReloaded;
+	std::function<void()> _backgroundLoadNotifier;
 
 public:
 	ModelCache();
@@ -27,6 +71,13 @@ public:
 	// greebo: For documentation, see the abstract base class.
 	scene::INodePtr getModelNode(const std::string& modelPath) override;
 
+	scene::INodePtr getModelNodeAsync(const std::string& modelPath,
+		const AABB& placeholderBounds, const sigc::slot<void>& onLoaded) override;
+
+	void prefetchModels(const std::set<std::string>& modelPaths) override;
+	void processFinishedModelLoads() override;
+	void waitForPendingModelLoads() override;
+
 	// greebo: For documentation, see the abstract base class.
 	IModelPtr getModel(const std::string& modelPath) override;
 
@@ -41,6 +92,11 @@ public:
 
 	// Public events
 	sigc::signal<void> signal_modelsReloaded() override;
+	void setBackgroundLoadNotifier(const std::function<void()>& notifier) override;
+
+	// Graph::Observer implementation, keeping track of the models in use
+	void onSceneNodeInsert(const scene::INodePtr& node) override;
+	void onSceneNodeErase(const scene::INodePtr& node) override;
 
 	// RegisterableModule implementation
 	std::string getName() const override;
@@ -50,10 +106,23 @@ public:
 
 private:
     scene::INodePtr loadNullModel(const std::string& modelPath);
+    BackgroundModelLoader& getBackgroundLoader();
+    scene::INodePtr createPlaceholderNode(const std::string& modelPath, const AABB& bounds);
+
+    // Parses the model file, this is invoked by the background workers
+    IModelPtr loadModelFromPath(const std::string& modelPath);
+
+    void onLoadInBackgroundChanged();
+
+    // Adds the model to the cache, then evicts unreferenced models if the memory limit is exceeded
+    void insertModel(const std::string& modelPath, const IModelPtr& model);
+    void enforceMemoryLimit(const std::string& modelPathToKeep);
+    void eraseModel(ModelMap::iterator found);
 
 	// Command targets
 	void refreshModelsCmd(const cmd::ArgumentList& args);
 	void refreshSelectedModelsCmd(const cmd::ArgumentList& args);
+	void printCacheStatsCmd(const cmd::ArgumentList& args);
 };
 
 } // namespace model
@@ -14,6 +14,11 @@ AABB NullModel::localAABB() const
 	return _aabbLocal;
 }
 
+void NullModel::setLocalAABB(const AABB& aabb)
+{
+	_aabbLocal = aabb;
+}
+
 std::string NullModel::getFilename() const
 {
 	return _filename;
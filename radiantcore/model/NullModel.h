@@ -17,6 +17,7 @@ public:
 	NullModel();
 
 	AABB localAABB() const override;
+	void setLocalAABB(const AABB& aabb);
 
 	// IModel implementation
 	std::string getFilename() const override;
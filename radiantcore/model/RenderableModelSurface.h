@@ -2,6 +2,7 @@
 
 #include "imodelsurface.h"
 #include "render/RenderableSurface.h"
+#include "StaticModelSurface.h"
 
 namespace model
 {
@@ -65,6 +66,17 @@ public:
         return _surface.getIndexArray();
     }
 
+    std::shared_ptr<const void> getSharedGeometry() override
+    {
+        // Instances of the same static model are sharing their vertex data
+        if (auto staticSurface = dynamic_cast<const StaticModelSurface*>(&_surface); staticSurface)
+        {
+            return staticSurface->getSharedGeometry();
+        }
+
+        return {};
+    }
+
     bool isOriented() override
     {
         return true;
@@ -117,6 +117,9 @@ void StaticModelNode::skinChanged(const std::string& newSkinName)
     // Applying the skin might trigger onModelShadersChanged()
     _model->applySkin(GlobalModelSkinCache().findSkin(getSkin()));
 
+    // The skin is replacing the active materials
+    materialsChanged();
+
     // Refresh the scene (TODO: get rid of that)
     GlobalSceneGraph().sceneChanged();
 }
@@ -14,11 +14,11 @@ namespace model
 {
 
 StaticModelSurface::StaticModelSurface(std::vector<MeshVertex>&& vertices, std::vector<unsigned int>&& indices) :
-    _vertices(vertices),
-    _indices(indices)
+    _vertices(std::make_shared<VertexVector>(std::move(vertices))),
+    _indices(std::make_shared<Indices>(std::move(indices)))
 {
     // Expand the local AABB to include all vertices
-    for (const auto& vertex : _vertices)
+    for (const auto& vertex : *_vertices)
     {
         _localAABB.includePoint(vertex.vertex);
     }
@@ -26,6 +26,12 @@ StaticModelSurface::StaticModelSurface(std::vector<MeshVertex>&& vertices, std::
     calculateTangents();
 }
 
+StaticModelSurface::StaticModelSurface(std::vector<MeshVertex>&& vertices, std::vector<unsigned int>&& indices, const AABB& bounds) :
+    _vertices(std::make_shared<VertexVector>(std::move(vertices))),
+    _indices(std::make_shared<Indices>(std::move(indices))),
+    _localAABB(bounds)
+{}
+
 StaticModelSurface::StaticModelSurface(const StaticModelSurface& other) :
     _defaultMaterial(other._defaultMaterial),
     _vertices(other._vertices),
@@ -37,20 +43,22 @@ void StaticModelSurface::calculateTangents()
 {
 	// Calculate the tangents and bitangents using the indices into the vertex
 	// array.
-	for (Indices::iterator i = _indices.begin();
-		 i != _indices.end();
+	auto& vertices = *_vertices;
+
+	for (Indices::const_iterator i = _indices->begin();
+		 i != _indices->end();
 		 i += 3)
 	{
-		auto& a = _vertices[*i];
-		auto& b = _vertices[*(i + 1)];
-		auto& c = _vertices[*(i + 2)];
+		auto& a = vertices[*i];
+		auto& b = vertices[*(i + 1)];
+		auto& c = vertices[*(i + 2)];
 
 		// Call the tangent calculation function
 		MeshTriangle_sumTangents(a, b, c);
 	}
 
 	// Normalise all of the tangent and bitangent vectors
-	for (auto& vertex : _vertices)
+	for (auto& vertex : vertices)
 	{
 		vertex.tangent.normalise();
 		vertex.bitangent.normalise();
@@ -61,16 +69,16 @@ void StaticModelSurface::calculateTangents()
 void StaticModelSurface::testSelect(Selector& selector, SelectionTest& test,
     const Matrix4& localToWorld, bool twoSided) const
 {
-	if (!_vertices.empty() && !_indices.empty())
+	if (!_vertices->empty() && !_indices->empty())
 	{
 		// Test for triangle selection
 		test.BeginMesh(localToWorld, twoSided);
 		SelectionIntersection result;
 
 		test.TestTriangles(
-			VertexPointer(&_vertices[0].vertex, sizeof(MeshVertex)),
-      		IndexPointer(&_indices[0],
-      					 IndexPointer::index_type(_indices.size())),
+			VertexPointer(&(*_vertices)[0].vertex, sizeof(MeshVertex)),
+      		IndexPointer(&(*_indices)[0],
+      					 IndexPointer::index_type(_indices->size())),
 			result
 		);
 
@@ -83,23 +91,23 @@ void StaticModelSurface::testSelect(Selector& selector, SelectionTest& test,
 
 int StaticModelSurface::getNumVertices() const
 {
-	return static_cast<int>(_vertices.size());
+	return static_cast<int>(_vertices->size());
 }
 
 int StaticModelSurface::getNumTriangles() const
 {
-	return static_cast<int>(_indices.size() / 3); // 3 indices per triangle
+	return static_cast<int>(_indices->size() / 3); // 3 indices per triangle
 }
 
 const MeshVertex& StaticModelSurface::getVertex(int vertexIndex) const
 {
-	assert(vertexIndex >= 0 && vertexIndex < static_cast<int>(_vertices.size()));
-	return _vertices[vertexIndex];
+	assert(vertexIndex >= 0 && vertexIndex < static_cast<int>(_vertices->size()));
+	return (*_vertices)[vertexIndex];
 }
 
 ModelPolygon StaticModelSurface::getPolygon(int polygonIndex) const
 {
-	assert(polygonIndex >= 0 && polygonIndex*3 < static_cast<int>(_indices.size()));
+	assert(polygonIndex >= 0 && polygonIndex*3 < static_cast<int>(_indices->size()));
 
 	ModelPolygon poly;
 
@@ -107,21 +115,30 @@ ModelPolygon StaticModelSurface::getPolygon(int polygonIndex) const
 	// The common convention is to use CCW winding direction, so reverse the index order
 	// ASE models define tris in the usual CCW order, but it appears that the pm_ase.c file
 	// reverses the vertex indices during parsing.
-	poly.c = _vertices[_indices[polygonIndex*3]];
-	poly.b = _vertices[_indices[polygonIndex*3 + 1]];
-	poly.a = _vertices[_indices[polygonIndex*3 + 2]];
+	const auto& vertices = *_vertices;
+	const auto& indices = *_indices;
+
+	poly.c = vertices[indices[polygonIndex*3]];
+	poly.b = vertices[indices[polygonIndex*3 + 1]];
+	poly.a = vertices[indices[polygonIndex*3 + 2]];
 
 	return poly;
 }
 
 const std::vector<MeshVertex>& StaticModelSurface::getVertexArray() const
 {
-	return _vertices;
+	return *_vertices;
 }
 
 const std::vector<unsigned int>& StaticModelSurface::getIndexArray() const
 {
-	return _indices;
+	return *_indices;
+}
+
+std::shared_ptr<const void> StaticModelSurface::getSharedGeometry() const
+{
+	// The indices are shared by all copies anyway, so the vertices are identifying the geometry
+	return _vertices;
 }
 
 const std::string& StaticModelSurface::getDefaultMaterial() const
@@ -154,14 +171,16 @@ bool StaticModelSurface::getIntersection(const Ray& ray, Vector3& intersection,
 	Vector3 bestIntersection = ray.origin;
 	Vector3 triIntersection;
 
-	for (Indices::const_iterator i = _indices.begin();
-		 i != _indices.end();
+	const auto& vertices = *_vertices;
+
+	for (Indices::const_iterator i = _indices->begin();
+		 i != _indices->end();
 		 i += 3)
 	{
 		// Get the vertices for this triangle
-		const MeshVertex& p1 = _vertices[*(i)];
-		const MeshVertex& p2 = _vertices[*(i+1)];
-		const MeshVertex& p3 = _vertices[*(i+2)];
+		const MeshVertex& p1 = vertices[*(i)];
+		const MeshVertex& p2 = vertices[*(i+1)];
+		const MeshVertex& p3 = vertices[*(i+2)];
 
 		if (ray.intersectTriangle(localToWorld.transformPoint(p1.vertex), 
 			localToWorld.transformPoint(p2.vertex), localToWorld.transformPoint(p3.vertex), triIntersection))
@@ -205,13 +224,23 @@ void StaticModelSurface::applyScale(const Vector3& scale, const StaticModelSurfa
 
 	assert(originalSurface.getNumVertices() == getNumVertices());
 
-	for (std::size_t i = 0; i < _vertices.size(); ++i)
+	// Never modify vertices that are still referenced by other surfaces
+	// (or the renderer), acquire a private copy first
+	if (_vertices.use_count() > 1)
+	{
+		_vertices = std::make_shared<VertexVector>(*_vertices);
+	}
+
+	auto& vertices = *_vertices;
+	const auto& originalVertices = *originalSurface._vertices;
+
+	for (std::size_t i = 0; i < vertices.size(); ++i)
 	{
-		_vertices[i].vertex = scaleMatrix.transformPoint(originalSurface._vertices[i].vertex);
-		_vertices[i].normal = invTranspScale.transformPoint(originalSurface._vertices[i].normal).getNormalised();
+		vertices[i].vertex = scaleMatrix.transformPoint(originalVertices[i].vertex);
+		vertices[i].normal = invTranspScale.transformPoint(originalVertices[i].normal).getNormalised();
 
 		// Expand the AABB to include this new vertex
-		_localAABB.includePoint(_vertices[i].vertex);
+		_localAABB.includePoint(vertices[i].vertex);
 	}
 
 	calculateTangents();
@@ -35,14 +35,15 @@ private:
 	std::string _activeMaterial;
 
 	// Vector of MeshVertex structures, containing the coordinates,
-	// normals, tangents and texture coordinates of the component vertices
+	// normals, tangents and texture coordinates of the component vertices.
+	// Copies of this surface are sharing the vertices until they get scaled.
 	typedef std::vector<MeshVertex> VertexVector;
-	VertexVector _vertices;
+	std::shared_ptr<VertexVector> _vertices;
 
 	// Vector of render indices, representing the groups of vertices to be
-	// used to create triangles
+	// used to create triangles. These never change, all copies are sharing them.
 	typedef std::vector<unsigned int> Indices;
-	Indices _indices;
+	std::shared_ptr<const Indices> _indices;
 
 	// The AABB containing this surface, in local object space.
 	AABB _localAABB;
@@ -55,7 +56,12 @@ public:
     // Move-construct this static model surface from the given vertex- and index array
 	StaticModelSurface(std::vector<MeshVertex>&& vertices, std::vector<unsigned int>&& indices);
 
-	// Copy-constructor. All vertices and indices will be copied from 'other'.
+	// Move-construct a surface from vertices which already carry their tangents,
+	// the bounds have been calculated in advance too (used by the baked model cache)
+	StaticModelSurface(std::vector<MeshVertex>&& vertices, std::vector<unsigned int>&& indices, const AABB& bounds);
+
+	// Copy-constructor. The vertices and indices are shared with 'other',
+	// the vertices are copied as soon as either surface is scaled.
 	StaticModelSurface(const StaticModelSurface& other);
 
 	/** Get the containing AABB for this surface.
@@ -80,6 +86,10 @@ public:
 	const std::vector<MeshVertex>& getVertexArray() const override;
 	const std::vector<unsigned int>& getIndexArray() const override;
 
+	// Returns the handle identifying the vertex data of this surface.
+	// Surfaces returning the same handle are referring to identical geometry.
+	std::shared_ptr<const void> getSharedGeometry() const;
+
 	const std::string& getDefaultMaterial() const override;
 	void setDefaultMaterial(const std::string& defaultMaterial);
 
@@ -1,17 +1,133 @@
 #include "MD5Anim.h"
 
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
 #include "itextstream.h"
+#include "parser/ParseException.h"
 #include "string/convert.h"
 
 namespace md5
 {
 
+/**
+ * Minimal tokeniser working on the in-memory text of an md5anim file.
+ * The frame blocks are consisting of thousands of plain numbers, these are
+ * converted right from the buffer without constructing any token strings.
+ */
+class MD5AnimTokeniser
+{
+private:
+	std::string _buffer;
+	const char* _pos;
+	const char* _end;
+
+public:
+	MD5AnimTokeniser(std::istream& stream) :
+		_buffer(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()),
+		_pos(_buffer.c_str()),
+		_end(_buffer.c_str() + _buffer.size())
+	{}
+
+	std::string nextToken()
+	{
+		skipWhitespaceAndComments();
+
+		if (_pos == _end)
+		{
+			throw parser::ParseException("Unexpected end of file");
+		}
+
+		// Brackets are tokens of their own
+		if (std::strchr("(){}", *_pos) != nullptr)
+		{
+			return std::string(1, *_pos++);
+		}
+
+		if (*_pos == '"')
+		{
+			auto start = ++_pos;
+
+			while (_pos < _end && *_pos != '"') ++_pos;
+
+			std::string token(start, _pos);
+
+			if (_pos < _end) ++_pos; // skip the closing quote
+
+			return token;
+		}
+
+		auto start = _pos;
+
+		while (_pos < _end && !isDelimiter(*_pos)) ++_pos;
+
+		return std::string(start, _pos);
+	}
+
+	void assertNextToken(const char* expected)
+	{
+		auto token = nextToken();
+
+		if (token != expected)
+		{
+			throw parser::ParseException("Expected " + std::string(expected) + ", found " + token);
+		}
+	}
+
+	float nextFloat()
+	{
+		skipWhitespaceAndComments();
+
+		char* numberEnd = nullptr;
+		auto value = std::strtof(_pos, &numberEnd);
+
+		if (numberEnd == _pos)
+		{
+			throw parser::ParseException("Expected a number, found " + nextToken());
+		}
+
+		_pos = numberEnd;
+		return value;
+	}
+
+private:
+	static bool isDelimiter(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '"' || std::strchr("(){}", c) != nullptr;
+	}
+
+	void skipWhitespaceAndComments()
+	{
+		while (_pos < _end)
+		{
+			if (*_pos == ' ' || *_pos == '\t' || *_pos == '\r' || *_pos == '\n')
+			{
+				++_pos;
+			}
+			else if (*_pos == '/' && _pos + 1 < _end && _pos[1] == '/')
+			{
+				while (_pos < _end && *_pos != '\n') ++_pos;
+			}
+			else if (*_pos == '/' && _pos + 1 < _end && _pos[1] == '*')
+			{
+				auto commentEnd = std::strstr(_pos + 2, "*/");
+				_pos = commentEnd != nullptr ? commentEnd + 2 : _end;
+			}
+			else
+			{
+				return;
+			}
+		}
+	}
+};
+
 MD5Anim::MD5Anim() :
 	_frameRate(0),
-	_numAnimatedComponents(0)
+	_numAnimatedComponents(0),
+	_numFrames(0)
 {}
 
-void MD5Anim::parseJointHierarchy(parser::DefTokeniser& tok)
+void MD5Anim::parseJointHierarchy(MD5AnimTokeniser& tok)
 {
 	tok.assertNextToken("hierarchy");
 	tok.assertNextToken("{");
@@ -45,26 +161,26 @@ void MD5Anim::parseJointHierarchy(parser::DefTokeniser& tok)
 	tok.assertNextToken("}");
 }
 
-void MD5Anim::parseFrameBounds(parser::DefTokeniser& tok)
+void MD5Anim::parseFrameBounds(MD5AnimTokeniser& tok)
 {
 	tok.assertNextToken("bounds");
 	tok.assertNextToken("{");
 		
-	for (std::size_t i = 0; i < _frames.size(); ++i)
+	for (std::size_t i = 0; i < _numFrames; ++i)
 	{
 		tok.assertNextToken("(");
 
-		_bounds[i].origin.x() = string::convert<float>(tok.nextToken());
-		_bounds[i].origin.y() = string::convert<float>(tok.nextToken());
-		_bounds[i].origin.z() = string::convert<float>(tok.nextToken());
+		_bounds[i].origin.x() = tok.nextFloat();
+		_bounds[i].origin.y() = tok.nextFloat();
+		_bounds[i].origin.z() = tok.nextFloat();
 
 		tok.assertNextToken(")");
 
 		tok.assertNextToken("(");
 
-		_bounds[i].extents.x() = string::convert<float>(tok.nextToken());
-		_bounds[i].extents.y() = string::convert<float>(tok.nextToken());
-		_bounds[i].extents.z() = string::convert<float>(tok.nextToken());
+		_bounds[i].extents.x() = tok.nextFloat();
+		_bounds[i].extents.y() = tok.nextFloat();
+		_bounds[i].extents.z() = tok.nextFloat();
 
 		tok.assertNextToken(")");
 	}
@@ -72,7 +188,7 @@ void MD5Anim::parseFrameBounds(parser::DefTokeniser& tok)
 	tok.assertNextToken("}");
 }
 
-void MD5Anim::parseBaseFrame(parser::DefTokeniser& tok)
+void MD5Anim::parseBaseFrame(MD5AnimTokeniser& tok)
 {
 	tok.assertNextToken("baseframe");
 	tok.assertNextToken("{");
@@ -81,18 +197,18 @@ void MD5Anim::parseBaseFrame(parser::DefTokeniser& tok)
 	{
 		tok.assertNextToken("(");
 		
-		_baseFrame[i].origin.x() = string::convert<float>(tok.nextToken());
-		_baseFrame[i].origin.y() = string::convert<float>(tok.nextToken());
-		_baseFrame[i].origin.z() = string::convert<float>(tok.nextToken());
+		_baseFrame[i].origin.x() = tok.nextFloat();
+		_baseFrame[i].origin.y() = tok.nextFloat();
+		_baseFrame[i].origin.z() = tok.nextFloat();
 
 		tok.assertNextToken(")");
 
 		tok.assertNextToken("(");
 
 		Vector3 rawRotation;
-		rawRotation.x() = string::convert<float>(tok.nextToken());
-		rawRotation.y() = string::convert<float>(tok.nextToken());
-		rawRotation.z() = string::convert<float>(tok.nextToken());
+		rawRotation.x() = tok.nextFloat();
+		rawRotation.y() = tok.nextFloat();
+		rawRotation.z() = tok.nextFloat();
 
 		// Calculate the fourth component of the quaternion
 		auto lSq = rawRotation.getLengthSquared();
@@ -111,7 +227,7 @@ void MD5Anim::parseBaseFrame(parser::DefTokeniser& tok)
 	tok.assertNextToken("}");
 }
 
-void MD5Anim::parseFrame(std::size_t frame, parser::DefTokeniser& tok)
+void MD5Anim::parseFrame(std::size_t frame, MD5AnimTokeniser& tok)
 {
 	tok.assertNextToken("frame");
 
@@ -121,13 +237,17 @@ void MD5Anim::parseFrame(std::size_t frame, parser::DefTokeniser& tok)
 
 	tok.assertNextToken("{");
 
-	// Reserve space for the floats
-	_frames[parsedFrameNum].resize(_numAnimatedComponents);
+	if (parsedFrameNum >= _numFrames)
+	{
+		throw parser::ParseException("Frame number out of bounds: " + string::to_string(parsedFrameNum));
+	}
 
 	// Each frame block has <numAnimatedComponents> float values
+	auto* values = _frameData.data() + parsedFrameNum * _numAnimatedComponents;
+
 	for (std::size_t i = 0; i < _numAnimatedComponents; ++i)
 	{
-		_frames[parsedFrameNum][i] = string::convert<float>(tok.nextToken());
+		values[i] = tok.nextFloat();
 	}
 
 	tok.assertNextToken("}");
@@ -135,11 +255,11 @@ void MD5Anim::parseFrame(std::size_t frame, parser::DefTokeniser& tok)
 
 void MD5Anim::parseFromStream(std::istream& stream)
 {
-	parser::BasicDefTokeniser<std::istream> tokeniser(stream);
+	MD5AnimTokeniser tokeniser(stream);
 	parseFromTokens(tokeniser);
 }
 
-void MD5Anim::parseFromTokens(parser::DefTokeniser& tok)
+void MD5Anim::parseFromTokens(MD5AnimTokeniser& tok)
 {
 	try
 	{
@@ -166,7 +286,7 @@ void MD5Anim::parseFromTokens(parser::DefTokeniser& tok)
 		_joints.resize(numJoints);
 		_bounds.resize(numFrames);
 		_baseFrame.resize(numJoints);
-		_frames.resize(numFrames);
+		_numFrames = numFrames;
 
 		tok.assertNextToken("frameRate");
 		_frameRate = string::convert<int>(tok.nextToken());
@@ -174,6 +294,8 @@ void MD5Anim::parseFromTokens(parser::DefTokeniser& tok)
 		tok.assertNextToken("numAnimatedComponents");
 		_numAnimatedComponents = string::convert<std::size_t>(tok.nextToken());
 
+		_frameData.resize(_numFrames * _numAnimatedComponents);
+
 		// Parse hierarchy block
 		parseJointHierarchy(tok);
 		
@@ -184,7 +306,7 @@ void MD5Anim::parseFromTokens(parser::DefTokeniser& tok)
 		parseBaseFrame(tok);
 
 		// Parse each actual frame
-		for (std::size_t i = 0; i < _frames.size(); ++i)
+		for (std::size_t i = 0; i < _numFrames; ++i)
 		{
 			parseFrame(i, tok);
 		}
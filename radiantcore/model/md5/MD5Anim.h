@@ -2,7 +2,6 @@
 
 #include "imd5anim.h"
 #include <vector>
-#include "parser/DefTokeniser.h"
 #include "math/AABB.h"
 #include "math/Vector3.h"
 #include "math/Quaternion.h"
@@ -31,8 +30,11 @@ private:
 
 	Keys _baseFrame;
 
-	// Each frame has <numAnimatedComponents> float values
-	std::vector<FrameKeys> _frames;
+	std::size_t _numFrames;
+
+	// Each frame has <numAnimatedComponents> float values,
+	// the values of all frames are stored in one contiguous block
+	std::vector<float> _frameData;
 
 public:
 	MD5Anim();
@@ -64,22 +66,27 @@ public:
 
 	std::size_t getNumFrames() const
 	{
-		return _frames.size();
+		return _numFrames;
+	}
+
+	std::size_t getNumAnimatedComponents() const
+	{
+		return _numAnimatedComponents;
 	}
 
-	const FrameKeys& getFrameKeys(std::size_t index) const
+	FrameKeys getFrameKeys(std::size_t index) const
 	{
-		return _frames[index];
+		return _frameData.data() + index * _numAnimatedComponents;
 	}
 
 	void parseFromStream(std::istream& stream);
 
 private:
-	void parseFromTokens(parser::DefTokeniser& tok);
-	void parseJointHierarchy(parser::DefTokeniser& tok);
-	void parseFrameBounds(parser::DefTokeniser& tok);
-	void parseBaseFrame(parser::DefTokeniser& tok);
-	void parseFrame(std::size_t frame, parser::DefTokeniser& tok);
+	void parseFromTokens(MD5AnimTokeniser& tok);
+	void parseJointHierarchy(MD5AnimTokeniser& tok);
+	void parseFrameBounds(MD5AnimTokeniser& tok);
+	void parseBaseFrame(MD5AnimTokeniser& tok);
+	void parseFrame(std::size_t frame, MD5AnimTokeniser& tok);
 };
 typedef std::shared_ptr<MD5Anim> MD5AnimPtr;
 
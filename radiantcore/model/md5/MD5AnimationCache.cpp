@@ -3,18 +3,29 @@
 #include "iarchive.h"
 #include "ifilesystem.h"
 #include "itextstream.h"
+#include "MD5Skeleton.h"
 
 namespace md5
 {
 
-IMD5AnimPtr MD5AnimationCache::getAnim(const std::string& vfsPath)
+namespace
 {
-	// Check the cache first
-	AnimationMap::iterator found = _animations.find(vfsPath);
+	// Enough for a few hundred animated models playing different anims
+	const std::size_t MAX_CACHED_POSES = 512;
+}
 
-	if (found != _animations.end())
+IMD5AnimPtr MD5AnimationCache::getAnim(const std::string& vfsPath)
+{
 	{
-		return found->second;
+		std::lock_guard<std::mutex> lock(_lock);
+
+		// Check the cache first
+		AnimationMap::iterator found = _animations.find(vfsPath);
+
+		if (found != _animations.end())
+		{
+			return found->second;
+		}
 	}
 
 	// Not found, construct new animation with the given path
@@ -32,10 +43,63 @@ IMD5AnimPtr MD5AnimationCache::getAnim(const std::string& vfsPath)
 	MD5AnimPtr anim(new MD5Anim);
 	anim->parseFromStream(inputStream);
 
-	// Store the anim in our cache
-	_animations.insert(AnimationMap::value_type(vfsPath, anim));
+	std::lock_guard<std::mutex> lock(_lock);
 
-	return anim;
+	// Store the anim in our cache, another thread might have been faster
+	return _animations.insert(AnimationMap::value_type(vfsPath, anim)).first->second;
+}
+
+IAnimationCache::PosePtr MD5AnimationCache::getPose(const IMD5AnimPtr& anim, std::size_t time)
+{
+	if (!anim) return PosePtr();
+
+	auto key = std::make_pair(static_cast<const IMD5Anim*>(anim.get()), time);
+
+	{
+		std::lock_guard<std::mutex> lock(_poseLock);
+
+		auto found = _poseLookup.find(key);
+
+		if (found != _poseLookup.end())
+		{
+			if (found->second->owner.lock() == anim)
+			{
+				// Move the pose to the front of the list
+				_poses.splice(_poses.begin(), _poses, found->second);
+				return found->second->pose;
+			}
+
+			// Stale entry, the anim has been destroyed in the meantime
+			_poses.erase(found->second);
+			_poseLookup.erase(found);
+		}
+	}
+
+	// Evaluate the pose outside the lock
+	auto pose = std::make_shared<Pose>();
+	MD5Skeleton::evaluatePose(*anim, time, *pose);
+
+	std::lock_guard<std::mutex> lock(_poseLock);
+
+	// Another thread might have stored the same pose in the meantime
+	auto existing = _poseLookup.find(key);
+
+	if (existing != _poseLookup.end())
+	{
+		return existing->second->pose;
+	}
+
+	_poses.push_front(CachedPose{ key.first, time, anim, pose });
+	_poseLookup.emplace(key, _poses.begin());
+
+	// Drop the least recently used poses
+	while (_poses.size() > MAX_CACHED_POSES)
+	{
+		_poseLookup.erase(std::make_pair(_poses.back().anim, _poses.back().time));
+		_poses.pop_back();
+	}
+
+	return pose;
 }
 
 std::string MD5AnimationCache::getName() const
@@ -58,6 +122,13 @@ StringSet MD5AnimationCache::getDependencies() const
 
 void MD5AnimationCache::shutdownModule()
 {
+	{
+		std::lock_guard<std::mutex> lock(_poseLock);
+		_poseLookup.clear();
+		_poses.clear();
+	}
+
+	std::lock_guard<std::mutex> lock(_lock);
 	_animations.clear();
 }
 
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "imd5anim.h"
+#include <list>
 #include <map>
+#include <mutex>
 
 #include "MD5Anim.h"
 
@@ -16,9 +18,31 @@ private:
 	typedef std::map<std::string, MD5AnimPtr> AnimationMap;
 	AnimationMap _animations;
 
+	// Anims might be requested from worker threads while a map is loading
+	std::mutex _lock;
+
+	// Recently evaluated poses, the most recently used one is at the front
+	struct CachedPose
+	{
+		const IMD5Anim* anim;
+		std::size_t time;
+
+		// To detect anims that have been destroyed and their address re-used
+		std::weak_ptr<IMD5Anim> owner;
+		PosePtr pose;
+	};
+	typedef std::list<CachedPose> PoseList;
+	PoseList _poses;
+
+	typedef std::map<std::pair<const IMD5Anim*, std::size_t>, PoseList::iterator> PoseMap;
+	PoseMap _poseLookup;
+
+	std::mutex _poseLock;
+
 public:
 	// IAnimationCache implementation
 	IMD5AnimPtr getAnim(const std::string& vfsPath);
+	PosePtr getPose(const IMD5AnimPtr& anim, std::size_t time);
 
 	// RegisterableModule implementation
 	std::string getName() const;
@@ -3,6 +3,7 @@
 #include <vector>
 #include "math/Vector3.h"
 #include "math/Quaternion.h"
+#include "render/MeshSkinning.h"
 
 /** greebo: Some data structures used in MD5 model code
  */
@@ -85,6 +86,9 @@ struct MD5Mesh
 	MD5Verts	vertices;
 	MD5Tris		triangles;
 	MD5Weights	weights;
+
+	// The weights and triangles above, prepared for the skinning kernel
+	render::SkinningData skinning;
 };
 typedef std::shared_ptr<MD5Mesh> MD5MeshPtr;
 
@@ -198,6 +198,18 @@ const model::IIndexedModelSurface& MD5Model::getSurface(unsigned surfaceNum) con
 	return *_surfaces[surfaceNum];
 }
 
+std::size_t MD5Model::getMemoryUsage() const
+{
+	std::size_t usage = _joints.size() * sizeof(MD5Joint);
+
+	for (const auto& surface : _surfaces)
+	{
+		usage += surface->getMemoryUsage();
+	}
+
+	return usage;
+}
+
 void MD5Model::parseFromTokens(parser::DefTokeniser& tok)
 {
 	_vertexCount = 0;
@@ -115,6 +115,9 @@ public:
 
 	const model::IIndexedModelSurface& getSurface(unsigned surfaceNum) const override;
 
+	// Includes the weights and skinning tables of the meshes
+	std::size_t getMemoryUsage() const override;
+
 	// IMD5Model implementation
 	virtual void setAnim(const IMD5AnimPtr& anim) override;
 	virtual const IMD5AnimPtr& getAnim() const override;
@@ -121,6 +121,9 @@ void MD5ModelNode::skinChanged(const std::string& newSkinName)
     // Applying the skin might trigger onModelShadersChanged()
     _model->applySkin(GlobalModelSkinCache().findSkin(getSkin()));
 
+    // The skin is replacing the active materials
+    materialsChanged();
+
     // Refresh the scene
     GlobalSceneGraph().sceneChanged();
 }
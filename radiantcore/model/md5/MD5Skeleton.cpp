@@ -69,18 +69,29 @@ void MD5Skeleton::update(const IMD5AnimPtr& anim, std::size_t time)
 {
 	_anim = anim;
 
-	// Update the joint positions, recursively, starting from the first
-	// Only root nodes need to be processed, the children are reached through them
-	std::size_t numJoints = _anim ? _anim->getNumJoints() : 0;
+	// Poses are shared through the cache, many models are playing the same (idle) anims
+	_pose = _anim ? GlobalAnimationCache().getPose(_anim, time) : IAnimationCache::PosePtr();
 
-	// Ensure the correct size
-	if (_skeleton.size() != numJoints)
+	auto numJoints = size();
+	_jointMatrices.resize(numJoints);
+
+	for (std::size_t i = 0; i < numJoints; ++i)
 	{
-		_skeleton.resize(numJoints);
+		_jointMatrices[i] = render::JointMatrix::fromRotationAndOrigin((*_pose)[i].orientation, (*_pose)[i].origin);
 	}
+}
+
+void MD5Skeleton::evaluatePose(const IMD5Anim& anim, std::size_t time, Pose& pose)
+{
+	std::size_t numJoints = anim.getNumJoints();
+
+	// Ensure the correct size
+	pose.resize(numJoints);
+
+	if (anim.getNumFrames() == 0) return;
 
 	// Calculate the current frame number
-	float timePerFrameMsec = 1000 / static_cast<float>(_anim->getFrameRate());
+	float timePerFrameMsec = 1000 / static_cast<float>(anim.getFrameRate());
 	
 	float frameTime = time / timePerFrameMsec;
 
@@ -88,47 +99,46 @@ void MD5Skeleton::update(const IMD5AnimPtr& anim, std::size_t time)
 	float nextFrameFrac = float_mod(frameTime, 1.0f);
 	float curFrameFrac = 1.0f - nextFrameFrac;
 
-	std::size_t curFrame = static_cast<std::size_t>(std::floor(frameTime)) % _anim->getNumFrames();
-	std::size_t nextFrame = curFrame == _anim->getNumFrames() -1 ? curFrame : (curFrame + 1) % _anim->getNumFrames();
+	std::size_t curFrame = static_cast<std::size_t>(std::floor(frameTime)) % anim.getNumFrames();
+	std::size_t nextFrame = curFrame == anim.getNumFrames() -1 ? curFrame : (curFrame + 1) % anim.getNumFrames();
+
+	auto cur = anim.getFrameKeys(curFrame);
+	auto next = anim.getFrameKeys(nextFrame);
 
 	// Apply the current frame keys to the base frame
 	for (std::size_t i = 0; i < numJoints; ++i)
 	{
-		const Joint& joint = _anim->getJoint(i);
-		const IMD5Anim::Key& baseKey = _anim->getBaseFrameKey(joint.id);
+		const Joint& joint = anim.getJoint(i);
+		const IMD5Anim::Key& baseKey = anim.getBaseFrameKey(joint.id);
 
 		// Apply base frame
-		_skeleton[i].origin = baseKey.origin;
-		_skeleton[i].orientation = baseKey.orientation;
-		
-		// Apply actual frame data
-		const IMD5Anim::FrameKeys& cur = _anim->getFrameKeys(curFrame);
-		const IMD5Anim::FrameKeys& next = _anim->getFrameKeys(nextFrame);
+		pose[i].origin = baseKey.origin;
+		pose[i].orientation = baseKey.orientation;
 
 		// The joint.firstKey member holds the offset into the frame data array
 		std::size_t key = joint.firstKey;
 
 		// Shortcuts for handling the rotations
-		Quaternion& orientation = _skeleton[i].orientation;
+		Quaternion& orientation = pose[i].orientation;
 		Quaternion nextOrientation = baseKey.orientation;
 
 		// Animate each vector component, interpolating values in between frames
 
 		if (joint.animComponents & Joint::X)
 		{
-			_skeleton[i].origin.x() = cur[key]*curFrameFrac + next[key]*nextFrameFrac;
+			pose[i].origin.x() = cur[key]*curFrameFrac + next[key]*nextFrameFrac;
 			key++;
 		}
 
 		if (joint.animComponents & Joint::Y)
 		{
-			_skeleton[i].origin.y() = cur[key]*curFrameFrac + next[key]*nextFrameFrac;
+			pose[i].origin.y() = cur[key]*curFrameFrac + next[key]*nextFrameFrac;
 			key++;
 		}
 
 		if (joint.animComponents & Joint::Z)
 		{
-			_skeleton[i].origin.z() = cur[key]*curFrameFrac + next[key]*nextFrameFrac;
+			pose[i].origin.z() = cur[key]*curFrameFrac + next[key]*nextFrameFrac;
 			key++;
 		}
 
@@ -169,38 +179,38 @@ void MD5Skeleton::update(const IMD5AnimPtr& anim, std::size_t time)
 		}
 	}
 
+	// Apply the parent transforms, walking the hierarchy top-down starting at the root joints.
+	// Every joint is processed after its parent, children are reached through an explicit stack.
+	std::vector<int> pending;
+	pending.reserve(numJoints);
+
 	for (std::size_t i = 0; i < numJoints; ++i)
 	{
-		const Joint& joint = _anim->getJoint(i);
-
-		if (joint.parentId == -1)
+		if (anim.getJoint(i).parentId == -1)
 		{
-			updateJointRecursively(i);
+			pending.push_back(static_cast<int>(i));
 		}
 	}
-}
-
-void MD5Skeleton::updateJointRecursively(std::size_t jointId)
-{
-	// Reset info to base first
-	const Joint& joint = _anim->getJoint(jointId);
 
-	if (joint.parentId >= 0)
+	while (!pending.empty())
 	{
-		// Joint has a parent, update this position and rotation
-		_skeleton[joint.id].orientation.preMultiplyBy(_skeleton[joint.parentId].orientation);
-
-		// Transform the origin of this joint using the rotation of the parent joint
-		_skeleton[joint.id].origin = _skeleton[joint.parentId].orientation.transformPoint(_skeleton[joint.id].origin);
-			
-		// Apply the parent joint's translation to this child bone
-		_skeleton[joint.id].origin += _skeleton[joint.parentId].origin;
-	}
+		const Joint& joint = anim.getJoint(pending.back());
+		pending.pop_back();
 
-	// Update all children as well
-	for (std::vector<int>::const_iterator i = joint.children.begin(); i != joint.children.end(); ++i)
-	{
-		updateJointRecursively(*i);
+		if (joint.parentId >= 0)
+		{
+			const auto& parent = pose[joint.parentId];
+			auto& key = pose[joint.id];
+
+			// Joint has a parent, update this position and rotation
+			key.orientation.preMultiplyBy(parent.orientation);
+
+			// Transform the origin of this joint using the rotation of the parent joint,
+			// then apply the parent joint's translation to this child bone
+			key.origin = parent.orientation.transformPoint(key.origin) + parent.origin;
+		}
+
+		pending.insert(pending.end(), joint.children.begin(), joint.children.end());
 	}
 }
 
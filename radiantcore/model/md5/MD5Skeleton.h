@@ -2,6 +2,7 @@
 
 #include <vector>
 #include "imd5anim.h"
+#include "render/MeshSkinning.h"
 
 namespace md5
 {
@@ -13,9 +14,16 @@ namespace md5
  */
 class MD5Skeleton
 {
+public:
+	using Pose = IAnimationCache::Pose;
+
 protected:
-	// The position and orientation of the animated joints at the current time
-	std::vector<IMD5Anim::Key> _skeleton;
+	// The position and orientation of the animated joints at the current time,
+	// this instance is shared with all skeletons playing the same anim at the same time
+	IAnimationCache::PosePtr _pose;
+
+	// The joint keys converted to single precision matrices used for skinning
+	std::vector<render::JointMatrix> _jointMatrices;
 
 	// The current animation, needed to get joint information etc.
 	IMD5AnimPtr _anim;
@@ -26,12 +34,17 @@ public:
 
 	std::size_t size() const
 	{
-		return _skeleton.size();
+		return _pose ? _pose->size() : 0;
 	}
 
 	const IMD5Anim::Key& getKey(std::size_t jointIndex) const
 	{
-		return _skeleton[jointIndex];
+		return (*_pose)[jointIndex];
+	}
+
+	const std::vector<render::JointMatrix>& getJointMatrices() const
+	{
+		return _jointMatrices;
 	}
 
 	const Joint& getJoint(std::size_t index) const
@@ -39,8 +52,9 @@ public:
 		return _anim->getJoint(index);
 	}
 
-private:
-	void updateJointRecursively(std::size_t jointId);
+	// Calculates the joint keys of the given anim at the given time (in msec),
+	// with the transforms of the parent joints applied
+	static void evaluatePose(const IMD5Anim& anim, std::size_t time, Pose& pose);
 };
 
 } // namespace
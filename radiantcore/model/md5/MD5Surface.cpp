@@ -182,105 +182,49 @@ const AABB& MD5Surface::getSurfaceBounds() const
 
 void MD5Surface::updateToDefaultPose(const MD5Joints& joints)
 {
-	if (_vertices.size() != _mesh->vertices.size())
-	{
-		_vertices.resize(_mesh->vertices.size());
-	}
-
-	for (std::size_t j = 0; j < _mesh->vertices.size(); ++j)
-	{
-		MD5Vert& vert = _mesh->vertices[j];
-
-		Vector3 skinned(0, 0, 0);
-
-		for (std::size_t k = 0; k != vert.weight_count; ++k)
-		{
-			MD5Weight& weight = _mesh->weights[vert.weight_index + k];
-			const MD5Joint& joint = joints[weight.joint];
-
-			Vector3 rotatedPoint = joint.rotation.transformPoint(weight.v);
-			skinned += (rotatedPoint + joint.position) * weight.t;
-		}
-
-		_vertices[j].vertex = skinned;
-		_vertices[j].texcoord = TexCoord2f(vert.u, vert.v);
-		_vertices[j].normal = Normal3(0,0,0);
-	}
+	std::vector<render::JointMatrix> jointMatrices;
+	jointMatrices.reserve(joints.size());
 
-	// Ensure the index array is ok
-	if (_indices.empty())
+	for (const auto& joint : joints)
 	{
-		buildIndexArray();
+		jointMatrices.emplace_back(render::JointMatrix::fromRotationAndOrigin(joint.rotation, joint.position));
 	}
 
-	buildVertexNormals();
-
-	updateGeometry();
+	updateToJointMatrices(jointMatrices);
 }
 
 void MD5Surface::updateToSkeleton(const MD5Skeleton& skeleton)
 {
-	// Ensure we have all vertices allocated
+	updateToJointMatrices(skeleton.getJointMatrices());
+}
+
+void MD5Surface::updateToJointMatrices(const std::vector<render::JointMatrix>& jointMatrices)
+{
+	// Ensure we have all vertices allocated, the texcoords never change
 	if (_vertices.size() != _mesh->vertices.size())
 	{
 		_vertices.resize(_mesh->vertices.size());
-	}
-
-	// Deform vertices to fit the skeleton
-	for (std::size_t j = 0; j < _mesh->vertices.size(); ++j)
-	{
-		MD5Vert& vert = _mesh->vertices[j];
-
-		Vector3 skinned(0, 0, 0);
 
-		for (std::size_t k = 0; k != vert.weight_count; ++k)
+		for (std::size_t j = 0; j < _mesh->vertices.size(); ++j)
 		{
-			MD5Weight& weight = _mesh->weights[vert.weight_index + k];
-			const IMD5Anim::Key& key = skeleton.getKey(weight.joint);
-			//const Joint& joint = skeleton.getJoint(weight.joint);
-
-			Vector3 rotatedPoint = key.orientation.transformPoint(weight.v);
-			skinned += (rotatedPoint + key.origin) * weight.t;
+			_vertices[j].texcoord = TexCoord2f(_mesh->vertices[j].u, _mesh->vertices[j].v);
 		}
-
-		_vertices[j].vertex = skinned;
-		_vertices[j].texcoord = TexCoord2f(vert.u, vert.v);
-		_vertices[j].normal = Normal3(0,0,0);
 	}
 
+	// Deform vertices to fit the skeleton
+	render::skinVertices(_mesh->skinning, jointMatrices, _vertices);
+
 	// Ensure the index array is ok
 	if (_indices.empty())
 	{
 		buildIndexArray();
 	}
 
-	buildVertexNormals();
+	render::calculateVertexNormals(_mesh->skinning, _indices, _vertices, _triangleNormals);
 
 	updateGeometry();
 }
 
-void MD5Surface::buildVertexNormals()
-{
-	for (Indices::iterator j = _indices.begin(); j != _indices.end(); j += 3)
-	{
-		auto& a = _vertices[*(j + 0)];
-		auto& b = _vertices[*(j + 1)];
-		auto& c = _vertices[*(j + 2)];
-
-		Vector3 weightedNormal((c.vertex - a.vertex).cross(b.vertex - a.vertex));
-
-		a.normal += weightedNormal;
-		b.normal += weightedNormal;
-		c.normal += weightedNormal;
-	}
-
-	// Normalise all normal vectors
-	for (auto& vertex : _vertices)
-	{
-        vertex.normal.normalise();
-	}
-}
-
 void MD5Surface::buildIndexArray()
 {
 	_indices.clear();
@@ -294,6 +238,19 @@ void MD5Surface::buildIndexArray()
 	}
 }
 
+std::size_t MD5Surface::getMemoryUsage() const
+{
+	const auto& skinning = _mesh->skinning;
+
+	return _vertices.size() * sizeof(MeshVertex) + _indices.size() * sizeof(RenderIndex) +
+		_mesh->vertices.size() * sizeof(MD5Vert) + _mesh->triangles.size() * sizeof(MD5Tri) +
+		_mesh->weights.size() * sizeof(MD5Weight) +
+		(skinning.weightOffsets.size() + skinning.joints.size() + skinning.triangleOffsets.size() +
+			skinning.adjacentTriangles.size()) * sizeof(std::uint32_t) +
+		(skinning.weights.size() + skinning.offsetsX.size() + skinning.offsetsY.size() +
+			skinning.offsetsZ.size()) * sizeof(float);
+}
+
 void MD5Surface::parseFromTokens(parser::DefTokeniser& tok)
 {
 	// Start of datablock
@@ -388,6 +345,23 @@ void MD5Surface::parseFromTokens(parser::DefTokeniser& tok)
 	// ----- END OF MESH DECL -----
 
 	tok.assertNextToken("}");
+
+	// Flatten the weights of each vertex for the skinning kernel
+	mesh.skinning = render::SkinningData();
+
+	for (const auto& vert : verts)
+	{
+		for (std::size_t k = 0; k < vert.weight_count; ++k)
+		{
+			const auto& weight = weights[vert.weight_index + k];
+			mesh.skinning.addWeight(weight.joint, weight.t, weight.v);
+		}
+
+		mesh.skinning.finishVertex();
+	}
+
+	buildIndexArray();
+	mesh.skinning.buildAdjacency(_indices);
 }
 
 } // namespace
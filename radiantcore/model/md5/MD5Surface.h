@@ -42,6 +42,9 @@ private:
 	Vertices _vertices;
 	Indices _indices;
 
+	// Buffer holding the triangle normals during normal calculation
+	std::vector<Vector3> _triangleNormals;
+
 public:
 
 	MD5Surface();
@@ -94,9 +97,12 @@ public:
 	// Rebuild the render index array - usually needs to be called only once
 	void buildIndexArray();
 
+	// Returns the approximate number of bytes occupied by the render data and the mesh
+	std::size_t getMemoryUsage() const;
+
 private:
-    // Re-calculate the normal vectors
-    void buildVertexNormals();
+    // Skins the mesh using the given joint transforms and re-calculates the normals
+    void updateToJointMatrices(const std::vector<render::JointMatrix>& jointMatrices);
 };
 typedef std::shared_ptr<MD5Surface> MD5SurfacePtr;
 
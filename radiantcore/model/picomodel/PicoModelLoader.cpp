@@ -10,6 +10,7 @@
 
 #include "os/path.h"
 
+#include <mutex>
 #include "idatastream.h"
 #include "string/case_conv.h"
 #include "../StaticModel.h"
@@ -34,6 +35,10 @@ namespace
 
         return Vector4(1.0, 1.0, 1.0, 1.0); // white
     }
+
+    // The picomodel library keeps global parser state (e.g. in the LWO reader),
+    // models are loaded by several threads when background loading is active
+    std::mutex _picoLibraryLock;
 } // namespace
 
 PicoModelLoader::PicoModelLoader(const picoModule_t* module, const std::string& extension) :
@@ -60,6 +65,8 @@ IModelPtr PicoModelLoader::loadModelFromPath(const std::string& path)
 	string::to_lower(fName);
 	std::string fExt = fName.substr(fName.size() - 3, 3);
 
+	std::lock_guard<std::mutex> lock(_picoLibraryLock);
+
 	picoModel_t* model = PicoModuleLoadModelStream(
 		_module,
 		&file->getInputStream(),
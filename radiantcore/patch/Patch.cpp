@@ -386,12 +386,43 @@ IUndoMementoPtr Patch::exportState() const
     return IUndoMementoPtr(new SavedState(_width, _height, _ctrl, _patchDef3, _subDivisions.x(), _subDivisions.y(), _shader.getMaterialName()));
 }
 
+SavedState Patch::getCurrentState() const
+{
+    return SavedState(_width, _height, _ctrl, _patchDef3, _subDivisions.x(), _subDivisions.y(), _shader.getMaterialName());
+}
+
+IUndoMementoPtr Patch::compactState(const IUndoMementoPtr& state) const
+{
+    auto fullState = std::dynamic_pointer_cast<SavedState>(state);
+
+    if (!fullState) return state; // already a delta
+
+    return undo::createDeltaMemento(state, fullState->serialise(), getCurrentState().serialise());
+}
+
 // Revert the state of this patch to the one that has been saved in the UndoMemento
 void Patch::importState(const IUndoMementoPtr& state)
 {
+    auto fullState = std::dynamic_pointer_cast<SavedState>(state);
+
+    if (!fullState)
+    {
+        // Deltas are relative to the state this patch is in right now
+        try
+        {
+            auto delta = std::static_pointer_cast<undo::DeltaUndoMemento>(state);
+            fullState = std::make_shared<SavedState>(delta->apply(getCurrentState().serialise()));
+        }
+        catch (const undo::InvalidStateError& ex)
+        {
+            rError() << "Cannot restore patch state: " << ex.what() << std::endl;
+            return;
+        }
+    }
+
     undoSave();
 
-    const SavedState& other = *(std::static_pointer_cast<SavedState>(state));
+    const SavedState& other = *fullState;
 
     // begin duplicate of SavedState copy constructor, needs refactoring
 
@@ -18,6 +18,7 @@
 
 class PatchNode;
 class Ray;
+class SavedState;
 
 /* greebo: The patch class itself, represented by control vertices. The basic rendering of the patch
  * is handled here (unselected control points, tesselation lines, shader).
@@ -303,6 +304,9 @@ public:
 	// Revert the state of this patch to the one that has been saved in the UndoMemento
 	void importState(const IUndoMementoPtr& state) override;
 
+	// Replaces the given full state by a delta against the current patch state
+	IUndoMementoPtr compactState(const IUndoMementoPtr& state) const override;
+
 	/** greebo: Gets whether this patch is a patchDef3 (fixed tesselation)
 	 */
 	bool subdivisionsFixed() const override;
@@ -336,4 +340,7 @@ private:
 	void check_shader();
 
 	void updateAABB();
+
+	// Returns a memento of the current state, used to encode and decode delta states
+	SavedState getCurrentState() const;
 };
@@ -517,6 +517,8 @@ void PatchNode::onMaterialChanged()
 {
     _renderableSurfaceSolid.queueUpdate();
     _renderableSurfaceWireframe.queueUpdate();
+
+    materialsChanged();
 }
 
 void PatchNode::onVisibilityChanged(bool visible)
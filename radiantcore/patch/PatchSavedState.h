@@ -1,6 +1,7 @@
 #pragma once
 
 #include "PatchControl.h"
+#include "DeltaUndoMemento.h"
 
 /* greebo: This is a structure that is allocated on the heap and contains all the state
  * information of a patch. This information is used by the UndoSystem to save the current
@@ -36,4 +37,62 @@ public:
 		m_subdivisions_y(subdivisions_y),
         _materialName(materialName)
     {}
+
+    SavedState(const undo::StateBuffer& buffer)
+    {
+        undo::StateReader reader(buffer);
+
+        reader.read(m_width);
+        reader.read(m_height);
+        reader.read(m_patchDef3);
+        reader.read(m_subdivisions_x);
+        reader.read(m_subdivisions_y);
+
+        std::uint64_t numControls;
+        reader.read(numControls);
+        m_ctrl.resize(static_cast<std::size_t>(numControls));
+
+        for (auto& control : m_ctrl)
+        {
+            reader.read(control.vertex.x());
+            reader.read(control.vertex.y());
+            reader.read(control.vertex.z());
+            reader.read(control.texcoord.x());
+            reader.read(control.texcoord.y());
+        }
+
+        reader.read(_materialName);
+    }
+
+    undo::StateBuffer serialise() const
+    {
+        undo::StateBuffer buffer;
+        buffer.reserve(m_ctrl.size() * 5 * sizeof(double) + 64);
+
+        undo::writeState(buffer, m_width);
+        undo::writeState(buffer, m_height);
+        undo::writeState(buffer, m_patchDef3);
+        undo::writeState(buffer, m_subdivisions_x);
+        undo::writeState(buffer, m_subdivisions_y);
+
+        undo::writeState(buffer, static_cast<std::uint64_t>(m_ctrl.size()));
+
+        for (const auto& control : m_ctrl)
+        {
+            undo::writeState(buffer, control.vertex.x());
+            undo::writeState(buffer, control.vertex.y());
+            undo::writeState(buffer, control.vertex.z());
+            undo::writeState(buffer, control.texcoord.x());
+            undo::writeState(buffer, control.texcoord.y());
+        }
+
+        undo::writeState(buffer, _materialName);
+
+        return buffer;
+    }
+
+    std::size_t getMemoryUsage() const override
+    {
+        return sizeof(*this) + m_ctrl.capacity() * sizeof(PatchControl) + _materialName.capacity();
+    }
 };
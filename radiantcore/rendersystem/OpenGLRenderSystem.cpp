@@ -72,6 +72,7 @@ OpenGLRenderSystem::~OpenGLRenderSystem()
 
     // Destruct the shaders before the geometry store is destroyed
     _shaders.clear();
+    _interactionIndex.clear();
     _entities.clear();
     _lights.clear();
     _state_sorted.clear();
@@ -224,7 +225,7 @@ void OpenGLRenderSystem::realise()
 
     _orthoRenderer = std::make_unique<FullBrightRenderer>(RenderViewType::OrthoView, _state_sorted, _geometryStore, _objectRenderer);
     _editorPreviewRenderer = std::make_unique<FullBrightRenderer>(RenderViewType::Camera, _state_sorted, _geometryStore, _objectRenderer);
-    _lightingModeRenderer = std::make_unique<LightingModeRenderer>(*_glProgramFactory, _geometryStore, _objectRenderer, _lights, _entities);
+    _lightingModeRenderer = std::make_unique<LightingModeRenderer>(*_glProgramFactory, _geometryStore, _objectRenderer, _lights, _entities, _interactionIndex);
 }
 
 void OpenGLRenderSystem::unrealise()
@@ -412,6 +413,7 @@ void OpenGLRenderSystem::shutdownModule()
     _editorPreviewRenderer.reset();
     _lightingModeRenderer.reset();
 
+    _interactionIndex.clear();
     _entities.clear();
     _lights.clear();
 
@@ -431,6 +433,8 @@ void OpenGLRenderSystem::addEntity(const IRenderEntityPtr& renderEntity)
         throw std::logic_error("Duplicate entity registration.");
     }
 
+    _interactionIndex.addEntity(renderEntity);
+
     auto light = std::dynamic_pointer_cast<RendererLight>(renderEntity);
 
     if (!light) return;
@@ -448,6 +452,8 @@ void OpenGLRenderSystem::removeEntity(const IRenderEntityPtr& renderEntity)
         throw std::logic_error("Entity has not been registered.");
     }
 
+    _interactionIndex.removeEntity(renderEntity);
+
     auto light = std::dynamic_pointer_cast<RendererLight>(renderEntity);
 
     if (!light) return;
@@ -12,6 +12,7 @@
 #include "backend/FenceSyncProvider.h"
 #include "backend/BufferObjectProvider.h"
 #include "backend/ObjectRenderer.h"
+#include "scene/LightInteractionIndex.h"
 #include "render/GeometryStore.h"
 
 namespace render
@@ -64,6 +65,7 @@ class OpenGLRenderSystem final
     BufferObjectProvider _bufferObjectProvider;
     GeometryStore _geometryStore;
     ObjectRenderer _objectRenderer;
+    LightInteractionIndex _interactionIndex;
 
     // Renderer implementations, one for each view type/purpose
 
@@ -19,9 +19,9 @@ bool BlendLight::isInView(const IRenderView& view)
     return view.TestAABB(_lightBounds) != VOLUME_OUTSIDE;
 }
 
-void BlendLight::collectSurfaces(const IRenderView& view, const std::set<IRenderEntityPtr>& entities)
+void BlendLight::collectSurfaces(const IRenderView& view, const std::vector<IRenderEntity*>& entities)
 {
-    // Now check all the entities intersecting with this light
+    // Now check all the entities near this light
     for (const auto& entity : entities)
     {
         entity->foreachRenderableTouchingBounds(_lightBounds,
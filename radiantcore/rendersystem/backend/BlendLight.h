@@ -37,7 +37,7 @@ public:
     BlendLight(BlendLight&& other) = default;
 
     bool isInView(const IRenderView& view);
-    void collectSurfaces(const IRenderView& view, const std::set<IRenderEntityPtr>& entities);
+    void collectSurfaces(const IRenderView& view, const std::vector<IRenderEntity*>& entities);
 
     std::size_t getObjectCount() const
     {
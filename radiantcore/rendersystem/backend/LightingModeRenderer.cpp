@@ -17,13 +17,15 @@ namespace render
 LightingModeRenderer::LightingModeRenderer(GLProgramFactory& programFactory,
         IGeometryStore& store, IObjectRenderer& objectRenderer, 
         const std::set<RendererLightPtr>& lights,
-        const std::set<IRenderEntityPtr>& entities) :
+        const std::set<IRenderEntityPtr>& entities,
+        LightInteractionIndex& interactionIndex) :
     SceneRenderer(RenderViewType::Camera),
     _programFactory(programFactory),
     _geometryStore(store),
     _objectRenderer(objectRenderer),
     _lights(lights),
     _entities(entities),
+    _interactionIndex(interactionIndex),
     _shadowMapProgram(nullptr),
     _blendLightProgram(nullptr),
     _shadowMappingEnabled(RKEY_ENABLE_SHADOW_MAPPING)
@@ -151,7 +153,7 @@ void LightingModeRenderer::collectRegularLight(RendererLight& light, const IRend
     }
 
     // Check all the surfaces that are touching this light
-    interaction.collectSurfaces(view, _entities);
+    interaction.collectSurfaces(view, _interactionIndex.getInteractingEntities(light, light.lightAABB()));
 
     _result->visibleLights++;
     _result->objects += interaction.getObjectCount();
@@ -178,7 +180,7 @@ void LightingModeRenderer::collectBlendLight(RendererLight& light, const IRender
     }
 
     // Check all the surfaces that are touching this light
-    blendLight.collectSurfaces(view, _entities);
+    blendLight.collectSurfaces(view, _interactionIndex.getInteractingEntities(light, light.lightAABB()));
 
     _result->visibleLights++;
     _result->objects += blendLight.getObjectCount();
@@ -370,7 +372,8 @@ void LightingModeRenderer::drawDepthFillPass(OpenGLState& current, RenderStateFl
 
     for (auto& interactionList : _regularLights)
     {
-        interactionList.fillDepthBuffer(current, *depthFillProgram, renderTime, _untransformedObjectsWithoutAlphaTest);
+        interactionList.fillDepthBuffer(current, *depthFillProgram, renderTime,
+            _untransformedObjectsWithoutAlphaTest, _orientedObjectsWithoutAlphaTest);
         _result->depthDrawCalls += interactionList.getDepthDrawCalls();
     }
 
@@ -388,6 +391,23 @@ void LightingModeRenderer::drawDepthFillPass(OpenGLState& current, RenderStateFl
 
         _untransformedObjectsWithoutAlphaTest.clear();
     }
+
+    // Oriented objects without alpha test are drawn instanced, one call per geometry slot
+    if (!_orientedObjectsWithoutAlphaTest.empty())
+    {
+        depthFillProgram->setAlphaTest(-1);
+
+        _orientedObjectsWithoutAlphaTest.foreachDrawCall(
+            [&](IGeometryStore::Slot slot, const Matrix4* transforms, std::size_t count)
+        {
+            depthFillProgram->setObjectTransforms(transforms, count);
+
+            _objectRenderer.submitInstancedGeometry(slot, static_cast<int>(count), GL_TRIANGLES);
+            _result->depthDrawCalls++;
+        });
+
+        _orientedObjectsWithoutAlphaTest.clear();
+    }
 }
 
 void LightingModeRenderer::drawNonInteractionPasses(OpenGLState& current, RenderStateFlags globalFlagsMask, 
@@ -11,6 +11,7 @@
 #include "glprogram/BlendLightProgram.h"
 #include "RegularLight.h"
 #include "BlendLight.h"
+#include "scene/LightInteractionIndex.h"
 #include "registry/CachedKey.h"
 
 namespace render
@@ -34,7 +35,11 @@ private:
     // The set of registered render entities
     const std::set<IRenderEntityPtr>& _entities;
 
+    // Spatial index providing the entities near each light
+    LightInteractionIndex& _interactionIndex;
+
     std::vector<IGeometryStore::Slot> _untransformedObjectsWithoutAlphaTest;
+    InstancedObjects _orientedObjectsWithoutAlphaTest;
 
     FrameBuffer::Ptr _shadowMapFbo;
     std::vector<Rectangle> _shadowMapAtlas;
@@ -58,7 +63,8 @@ public:
         IGeometryStore& store,
         IObjectRenderer& objectRenderer,
         const std::set<RendererLightPtr>& lights,
-        const std::set<IRenderEntityPtr>& entities);
+        const std::set<IRenderEntityPtr>& entities,
+        LightInteractionIndex& interactionIndex);
 
     IRenderResult::Ptr render(RenderStateFlags globalFlagsMask, const IRenderView& view, std::size_t time) override;
 
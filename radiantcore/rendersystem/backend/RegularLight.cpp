@@ -9,6 +9,22 @@
 namespace render
 {
 
+namespace
+{
+    // Returns the parm0..parm11 values of the given entity
+    RegularLight::ShaderParmValues getShaderParmValues(const IRenderEntity& entity)
+    {
+        RegularLight::ShaderParmValues values;
+
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            values[i] = entity.getShaderParm(static_cast<int>(i));
+        }
+
+        return values;
+    }
+}
+
 RegularLight::RegularLight(RendererLight& light, IGeometryStore& store, IObjectRenderer& objectRenderer) :
     _light(light),
     _store(store),
@@ -48,11 +64,11 @@ bool RegularLight::isShadowCasting() const
     return _isShadowCasting;
 }
 
-void RegularLight::collectSurfaces(const IRenderView& view, const std::set<IRenderEntityPtr>& entities)
+void RegularLight::collectSurfaces(const IRenderView& view, const std::vector<IRenderEntity*>& entities)
 {
     bool shadowCasting = isShadowCasting();
 
-    // Now check all the entities intersecting with this light
+    // Now check all the entities near this light
     for (const auto& entity : entities)
     {
         entity->foreachRenderableTouchingBounds(_lightBounds,
@@ -99,12 +115,15 @@ void RegularLight::collectSurfaces(const IRenderView& view, const std::set<IRend
     }
 }
 
-void RegularLight::fillDepthBuffer(OpenGLState& state, DepthFillAlphaProgram& program,
-    std::size_t renderTime, std::vector<IGeometryStore::Slot>& untransformedObjectsWithoutAlphaTest)
+void RegularLight::fillDepthBuffer(OpenGLState& state, DepthFillAlphaProgram& program, std::size_t renderTime,
+    std::vector<IGeometryStore::Slot>& untransformedObjectsWithoutAlphaTest,
+    InstancedObjects& orientedObjectsWithoutAlphaTest)
 {
     std::vector<IGeometryStore::Slot> untransformedObjects;
     untransformedObjects.reserve(1000);
 
+    InstancedObjects orientedObjects;
+
     for (const auto& [entity, objectsByShader] : _objectsByEntity)
     {
         for (const auto& [shader, objects] : objectsByShader)
@@ -113,33 +132,50 @@ void RegularLight::fillDepthBuffer(OpenGLState& state, DepthFillAlphaProgram& pr
 
             if (!depthFillPass) continue;
 
-            setupAlphaTest(state, shader, depthFillPass, program, renderTime, entity);
-
-            for (const auto& object : objects)
+            // Materials without alpha test don't depend on the entity,
+            // put them on the huge piles of non-alphatest objects
+            if (shader->getMaterial()->getCoverage() != Material::MC_PERFORATED)
             {
-                // We submit all objects with an identity matrix in a single multi draw call
-                if (!object.get().isOriented())
+                for (const auto& object : objects)
                 {
-                    if (shader->getMaterial()->getCoverage() == Material::MC_PERFORATED)
+                    if (object.get().isOriented())
                     {
-                        untransformedObjects.push_back(object.get().getStorageLocation());
+                        orientedObjectsWithoutAlphaTest.add(object.get().getStorageLocation(), object.get().getObjectTransform());
                     }
                     else
                     {
-                        // Put it on the huge pile of non-alphatest materials
                         untransformedObjectsWithoutAlphaTest.push_back(object.get().getStorageLocation());
                     }
+                }
+
+                continue;
+            }
 
+            setupAlphaTest(state, shader, depthFillPass, program, renderTime, entity);
+
+            for (const auto& object : objects)
+            {
+                // We submit all objects with an identity matrix in a single multi draw call
+                if (!object.get().isOriented())
+                {
+                    untransformedObjects.push_back(object.get().getStorageLocation());
                     continue;
                 }
 
-                program.setObjectTransform(object.get().getObjectTransform());
+                orientedObjects.add(object.get().getStorageLocation(), object.get().getObjectTransform());
+            }
+
+            // All alpha-tested materials need to be submitted now, instances sharing their geometry in one call
+            orientedObjects.foreachDrawCall([&](IGeometryStore::Slot slot, const Matrix4* transforms, std::size_t count)
+            {
+                program.setObjectTransforms(transforms, count);
 
-                _objectRenderer.submitGeometry(object.get().getStorageLocation(), GL_TRIANGLES);
+                _objectRenderer.submitInstancedGeometry(slot, static_cast<int>(count), GL_TRIANGLES);
                 ++_depthDrawCalls;
-            }
+            });
+
+            orientedObjects.clear();
 
-            // All alpha-tested materials without transform need to be submitted now
             if (!untransformedObjects.empty())
             {
                 program.setObjectTransform(Matrix4::getIdentity());
@@ -162,6 +198,11 @@ void RegularLight::drawShadowMap(OpenGLState& state, const Rectangle& rectangle,
     std::vector<IGeometryStore::Slot> untransformedObjects;
     untransformedObjects.reserve(1000);
 
+    // Oriented objects are drawn instanced, the ones without alpha test
+    // are collected across all entities, since they don't depend on them
+    InstancedObjects orientedObjects;
+    InstancedObjects orientedObjectsWithoutAlphaTest;
+
     program.setLightOrigin(_light.getLightOrigin());
 
     // Set evaluated stage texture transformation matrix to the GLSL uniform
@@ -183,6 +224,9 @@ void RegularLight::drawShadowMap(OpenGLState& state, const Rectangle& rectangle,
             // Set up alphatest (it's ok to pass a nullptr as depth fill pass)
             setupAlphaTest(state, shader, shader->getDepthFillPass(), program, renderTime, entity);
 
+            auto& orientedObjectsOfMaterial = material->getCoverage() == Material::MC_PERFORATED ?
+                orientedObjects : orientedObjectsWithoutAlphaTest;
+
             for (const auto& object : objects)
             {
                 // Skip models with "noshadows" set (this might be redundant to the entity check above)
@@ -195,12 +239,11 @@ void RegularLight::drawShadowMap(OpenGLState& state, const Rectangle& rectangle,
                     continue;
                 }
 
-                program.setObjectTransform(object.get().getObjectTransform());
-
-                _objectRenderer.submitInstancedGeometry(object.get().getStorageLocation(), 6, GL_TRIANGLES);
-                ++_shadowMapDrawCalls;
+                orientedObjectsOfMaterial.add(object.get().getStorageLocation(), object.get().getObjectTransform());
             }
 
+            submitShadowMapInstances(orientedObjects, program);
+
             if (!untransformedObjects.empty())
             {
                 program.setObjectTransform(Matrix4::getIdentity());
@@ -213,16 +256,34 @@ void RegularLight::drawShadowMap(OpenGLState& state, const Rectangle& rectangle,
         }
     }
 
+    if (!orientedObjectsWithoutAlphaTest.empty())
+    {
+        program.setAlphaTest(-1);
+        submitShadowMapInstances(orientedObjectsWithoutAlphaTest, program);
+    }
+
     debug::assertNoGlErrors();
 }
 
+void RegularLight::submitShadowMapInstances(InstancedObjects& objects, ShadowMapProgram& program)
+{
+    objects.foreachDrawCall([&](IGeometryStore::Slot slot, const Matrix4* transforms, std::size_t count)
+    {
+        program.setObjectTransforms(transforms, count);
+
+        // Every object is rendered 6 times, once for each cube map face
+        _objectRenderer.submitInstancedGeometry(slot, static_cast<int>(6 * count), GL_TRIANGLES);
+        ++_shadowMapDrawCalls;
+    });
+
+    objects.clear();
+}
+
 RegularLight::InteractionDrawCall::InteractionDrawCall(OpenGLState& state, InteractionProgram& program,
-    IObjectRenderer& objectRenderer, const Vector3& worldLightOrigin, const Vector3& viewer) :
+    IObjectRenderer& objectRenderer) :
     _state(state),
     _program(program),
     _objectRenderer(objectRenderer),
-    _worldLightOrigin(worldLightOrigin),
-    _viewer(viewer),
     _bump(nullptr),
     _diffuse(nullptr),
     _specular(nullptr),
@@ -294,16 +355,22 @@ void RegularLight::InteractionDrawCall::submit(const ObjectList& objects)
             continue;
         }
 
-        _program.setUpObjectLighting(_worldLightOrigin, _viewer, object.get().getObjectTransform().getInverse());
-        _program.setObjectTransform(object.get().getObjectTransform());
+        _orientedObjects.add(object.get().getStorageLocation(), object.get().getObjectTransform());
+    }
+
+    // Objects sharing their geometry are drawn using a single instanced call
+    _orientedObjects.foreachDrawCall([&](IGeometryStore::Slot slot, const Matrix4* transforms, std::size_t count)
+    {
+        _program.setObjectTransforms(transforms, count);
 
-        _objectRenderer.submitGeometry(object.get().getStorageLocation(), GL_TRIANGLES);
+        _objectRenderer.submitInstancedGeometry(slot, static_cast<int>(count), GL_TRIANGLES);
         ++_interactionDrawCalls;
-    }
+    });
+
+    _orientedObjects.clear();
 
     if (!_untransformedObjects.empty())
     {
-        _program.setUpObjectLighting(_worldLightOrigin, _viewer, Matrix4::getIdentity());
         _program.setObjectTransform(Matrix4::getIdentity());
 
         _objectRenderer.submitGeometry(_untransformedObjects, GL_TRIANGLES);
@@ -336,70 +403,87 @@ void RegularLight::drawInteractions(OpenGLState& state, InteractionProgram& prog
         return;
     }
 
-    auto worldLightOrigin = _light.getLightOrigin();
-
-    InteractionDrawCall draw(state, program, _objectRenderer, worldLightOrigin, view.getViewer());
+    InteractionDrawCall draw(state, program, _objectRenderer);
 
     // Set up textures used by this light
     program.setupLightParameters(state, _light, renderTime);
+    program.setUpLighting(_light.getLightOrigin(), view.getViewer());
+
+    // The material stages are evaluated per entity, but their values only depend on the
+    // entity's shader parms. Objects of entities sharing the same parms are submitted together,
+    // such that the instances of a model are drawn using a single instanced draw call.
+    std::map<std::pair<OpenGLShader*, ShaderParmValues>, InteractingObjects> objectsByShaderParms;
 
     for (const auto& [entity, objectsByShader] : _objectsByEntity)
     {
+        auto shaderParms = getShaderParmValues(*entity);
+
         for (const auto& [shader, objects] : objectsByShader)
         {
-            const auto pass = shader->getInteractionPass();
+            if (!shader->getInteractionPass()) continue;
+
+            auto& interactingObjects = objectsByShaderParms.try_emplace(
+                std::make_pair(shader, shaderParms), InteractingObjects{ entity, {} }).first->second;
 
-            if (!pass) continue;
+            interactingObjects.objects.insert(interactingObjects.objects.end(), objects.begin(), objects.end());
+        }
+    }
+
+    for (const auto& [key, interactingObjects] : objectsByShaderParms)
+    {
+        auto shader = key.first;
+        const auto& [entity, objects] = interactingObjects;
+
+        const auto pass = shader->getInteractionPass();
 
-            draw.prepare(*pass);
+        draw.prepare(*pass);
 
-            for (const auto& interactionStage : pass->getInteractionStages())
+        for (const auto& interactionStage : pass->getInteractionStages())
+        {
+            interactionStage.stage->evaluateExpressions(renderTime, *entity);
+
+            if (!interactionStage.stage->isVisible()) continue; // ignore inactive stages
+
+            // Assemble diffuse, bump and specular stages into interaction passes, each
+            // of which consumes a single map of each type (with defaults black or _flat
+            // used if the respective stage is not declared). Bump maps are treated
+            // specially, in that they delimit separate interaction passes, whereas
+            // diffuse or specular maps can be shared from one pass to the next.
+            //
+            // This allows the material to list {B1, D1, B2, D2} to blend between two
+            // completely different textures (typically using vertexColor), or {B1, D1,
+            // D2} to use a single bumpmap but blend between two different diffusemaps.
+            switch (interactionStage.stage->getType())
             {
-                interactionStage.stage->evaluateExpressions(renderTime, *entity);
-
-                if (!interactionStage.stage->isVisible()) continue; // ignore inactive stages
-
-                // Assemble diffuse, bump and specular stages into interaction passes, each
-                // of which consumes a single map of each type (with defaults black or _flat
-                // used if the respective stage is not declared). Bump maps are treated
-                // specially, in that they delimit separate interaction passes, whereas
-                // diffuse or specular maps can be shared from one pass to the next.
-                //
-                // This allows the material to list {B1, D1, B2, D2} to blend between two
-                // completely different textures (typically using vertexColor), or {B1, D1,
-                // D2} to use a single bumpmap but blend between two different diffusemaps.
-                switch (interactionStage.stage->getType())
+            case IShaderLayer::BUMP:
+                if (draw.hasBump())
                 {
-                case IShaderLayer::BUMP:
-                    if (draw.hasBump())
-                    {
-                        draw.submit(objects); // submit pending draws when changing bump maps
-                        draw.clear(); // bump map starts a new interaction pass
-                    }
-                    draw.setBump(&interactionStage);
-                    break;
-                case IShaderLayer::DIFFUSE:
-                    if (draw.hasDiffuse())
-                    {
-                        draw.submit(objects); // submit pending draws when changing diffuse maps
-                    }
-                    draw.setDiffuse(&interactionStage);
-                    break;
-                case IShaderLayer::SPECULAR:
-                    if (draw.hasSpecular())
-                    {
-                        draw.submit(objects); // submit pending draws when changing specular maps
-                    }
-                    draw.setSpecular(&interactionStage);
-                    break;
-                default:
-                    throw std::logic_error("Non-interaction stage encountered in interaction pass");
+                    draw.submit(objects); // submit pending draws when changing bump maps
+                    draw.clear(); // bump map starts a new interaction pass
+                }
+                draw.setBump(&interactionStage);
+                break;
+            case IShaderLayer::DIFFUSE:
+                if (draw.hasDiffuse())
+                {
+                    draw.submit(objects); // submit pending draws when changing diffuse maps
                 }
+                draw.setDiffuse(&interactionStage);
+                break;
+            case IShaderLayer::SPECULAR:
+                if (draw.hasSpecular())
+                {
+                    draw.submit(objects); // submit pending draws when changing specular maps
+                }
+                draw.setSpecular(&interactionStage);
+                break;
+            default:
+                throw std::logic_error("Non-interaction stage encountered in interaction pass");
             }
-
-            // Submit the pending draw call
-            draw.submit(objects);
         }
+
+        // Submit the pending draw call
+        draw.submit(objects);
     }
 
     _interactionDrawCalls += draw.getInteractionDrawCalls();
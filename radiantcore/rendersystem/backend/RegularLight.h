@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <map>
 #include <vector>
 #include <set>
@@ -8,6 +9,7 @@
 #include "iobjectrenderer.h"
 #include "irenderview.h"
 #include "render/Rectangle.h"
+#include "render/InstancedObjects.h"
 #include "InteractionPass.h"
 
 namespace render
@@ -34,6 +36,9 @@ public:
     // A flat list of renderables
     using ObjectList = std::vector<std::reference_wrapper<IRenderableObject>>;
 
+    // The parm0..parm11 values of an entity, all that material stages can depend on
+    using ShaderParmValues = std::array<float, 12>;
+
 private:
     RendererLight& _light;
     IGeometryStore& _store;
@@ -46,6 +51,14 @@ private:
     // object mappings, grouped by entity
     std::map<IRenderEntity*, ObjectsByMaterial> _objectsByEntity;
 
+    // Objects of one or more entities with the same shader parms, sharing
+    // their interaction draw calls (stages are evaluated using the first entity)
+    struct InteractingObjects
+    {
+        IRenderEntity* entity;
+        ObjectList objects;
+    };
+
     std::size_t _interactionDrawCalls;
     std::size_t _depthDrawCalls;
     std::size_t _objectCount;
@@ -62,14 +75,13 @@ private:
         InteractionProgram& _program;
 
         IObjectRenderer& _objectRenderer;
-        const Vector3& _worldLightOrigin;
-        const Vector3& _viewer;
 
         const InteractionPass::Stage* _bump;
         const InteractionPass::Stage* _diffuse;
         const InteractionPass::Stage* _specular;
 
         std::vector<IGeometryStore::Slot> _untransformedObjects;
+        InstancedObjects _orientedObjects;
 
         InteractionPass::Stage _defaultBumpStage;
         InteractionPass::Stage _defaultDiffuseStage;
@@ -78,8 +90,7 @@ private:
         std::size_t _interactionDrawCalls;
 
     public:
-        InteractionDrawCall(OpenGLState& state, InteractionProgram& program,
-            IObjectRenderer& objectRenderer, const Vector3& worldLightOrigin, const Vector3& viewer);
+        InteractionDrawCall(OpenGLState& state, InteractionProgram& program, IObjectRenderer& objectRenderer);
 
         std::size_t getInteractionDrawCalls() const
         {
@@ -179,10 +190,13 @@ public:
 
     bool isShadowCasting() const;
 
-    void collectSurfaces(const IRenderView& view, const std::set<IRenderEntityPtr>& entities);
+    void collectSurfaces(const IRenderView& view, const std::vector<IRenderEntity*>& entities);
 
-    void fillDepthBuffer(OpenGLState& state, DepthFillAlphaProgram& program,
-        std::size_t renderTime, std::vector<IGeometryStore::Slot>& untransformedObjectsWithoutAlphaTest);
+    // Draws the alpha-tested objects, all others are added to the given collections,
+    // to be drawn by the caller in as few draw calls as possible
+    void fillDepthBuffer(OpenGLState& state, DepthFillAlphaProgram& program, std::size_t renderTime,
+        std::vector<IGeometryStore::Slot>& untransformedObjectsWithoutAlphaTest,
+        InstancedObjects& orientedObjectsWithoutAlphaTest);
 
     void drawShadowMap(OpenGLState& state, const Rectangle& rectangle, ShadowMapProgram& program, std::size_t renderTime);
 
@@ -190,6 +204,10 @@ public:
 
     void setupAlphaTest(OpenGLState& state, OpenGLShader* shader, DepthFillPass* depthFillPass,
         ISupportsAlphaTest& alphaTestProgram, std::size_t renderTime, IRenderEntity* entity);
+
+private:
+    // Draws the collected objects into all 6 cube map faces, then clears the collection
+    void submitShadowMapInstances(InstancedObjects& objects, ShadowMapProgram& program);
 };
 
 }
@@ -23,14 +23,26 @@ private:
         bool surfaceDataChanged;
         IGeometryStore::Slot storageHandle;
 
-        SurfaceInfo(IRenderableSurface& surface_, IGeometryStore::Slot slot) :
+        // The handle of the geometry this surface is sharing with others (might be empty)
+        std::shared_ptr<const void> sharedGeometry;
+
+        SurfaceInfo(IRenderableSurface& surface_, IGeometryStore::Slot slot, const std::shared_ptr<const void>& sharedGeometry_) :
             surface(surface_),
             surfaceDataChanged(false),
-            storageHandle(slot)
+            storageHandle(slot),
+            sharedGeometry(sharedGeometry_)
         {}
     };
     std::map<Slot, SurfaceInfo> _surfaces;
 
+    // Storage of the geometry shared by several surfaces (like instances of the same model)
+    struct SharedGeometryInfo
+    {
+        IGeometryStore::Slot storageHandle;
+        std::size_t refCount;
+    };
+    std::map<const void*, SharedGeometryInfo> _sharedGeometry;
+
     Slot _freeSlotMappingHint;
 
     std::vector<Slot> _surfacesNeedingUpdate;
@@ -54,15 +66,10 @@ public:
         // Find a free slot
         auto newSlotIndex = getNextFreeSlotIndex();
 
-        const auto& vertices = surface.getVertices();
-        const auto& indices = surface.getIndices();
-
-        auto slot = _store.allocateSlot(vertices.size(), indices.size());
-
-        // Transform the vertices to single precision
-        _store.updateData(slot, ConvertToRenderVertices(vertices), indices);
+        auto sharedGeometry = surface.getSharedGeometry();
+        auto slot = acquireStorage(surface, sharedGeometry);
 
-        _surfaces.emplace(newSlotIndex, SurfaceInfo(surface, slot));
+        _surfaces.emplace(newSlotIndex, SurfaceInfo(surface, slot, sharedGeometry));
 
         return newSlotIndex;
     }
@@ -72,8 +79,8 @@ public:
         auto surface = _surfaces.find(slot);
         assert(surface != _surfaces.end());
 
-        // Deallocate the storage
-        _store.deallocateSlot(surface->second.storageHandle);
+        // Deallocate the storage (unless it's still used by other surfaces)
+        releaseStorage(surface->second);
         _surfaces.erase(surface);
 
         if (slot < _freeSlotMappingHint)
@@ -127,7 +134,25 @@ public:
                 surfaceInfo.surfaceDataChanged = false;
 
                 auto& surface = surfaceInfo.surface.get();
-                _store.updateData(surfaceInfo.storageHandle, ConvertToRenderVertices(surface.getVertices()), surface.getIndices());
+                auto sharedGeometry = surface.getSharedGeometry();
+
+                if (!sharedGeometry && !surfaceInfo.sharedGeometry)
+                {
+                    _store.updateData(surfaceInfo.storageHandle, ConvertToRenderVertices(surface.getVertices()), surface.getIndices());
+                }
+                else if (sharedGeometry != surfaceInfo.sharedGeometry)
+                {
+                    // The surface switched to different geometry, move it to the new storage
+                    auto newStorageHandle = acquireStorage(surface, sharedGeometry);
+                    releaseStorage(surfaceInfo);
+
+                    surfaceInfo.storageHandle = newStorageHandle;
+                    surfaceInfo.sharedGeometry = sharedGeometry;
+
+                    surface.onStorageLocationChanged();
+                }
+
+                // Shared geometry with an unchanged handle is guaranteed to be unchanged
             }
         }
 
@@ -135,6 +160,53 @@ public:
     }
 
 private:
+    IGeometryStore::Slot acquireStorage(IRenderableSurface& surface, const std::shared_ptr<const void>& sharedGeometry)
+    {
+        if (sharedGeometry)
+        {
+            auto existing = _sharedGeometry.find(sharedGeometry.get());
+
+            if (existing != _sharedGeometry.end())
+            {
+                ++existing->second.refCount;
+                return existing->second.storageHandle;
+            }
+        }
+
+        const auto& vertices = surface.getVertices();
+        const auto& indices = surface.getIndices();
+
+        auto slot = _store.allocateSlot(vertices.size(), indices.size());
+
+        // Transform the vertices to single precision
+        _store.updateData(slot, ConvertToRenderVertices(vertices), indices);
+
+        if (sharedGeometry)
+        {
+            _sharedGeometry.emplace(sharedGeometry.get(), SharedGeometryInfo{ slot, 1 });
+        }
+
+        return slot;
+    }
+
+    void releaseStorage(const SurfaceInfo& info)
+    {
+        if (info.sharedGeometry)
+        {
+            auto existing = _sharedGeometry.find(info.sharedGeometry.get());
+            assert(existing != _sharedGeometry.end());
+
+            if (--existing->second.refCount > 0)
+            {
+                return; // still in use by other surfaces
+            }
+
+            _sharedGeometry.erase(existing);
+        }
+
+        _store.deallocateSlot(info.storageHandle);
+    }
+
     static std::vector<RenderVertex> ConvertToRenderVertices(const std::vector<MeshVertex>& vertices)
     {
         std::vector<RenderVertex> transformedVertices;
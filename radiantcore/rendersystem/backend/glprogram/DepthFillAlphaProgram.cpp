@@ -32,7 +32,7 @@ DepthFillAlphaProgram::DepthFillAlphaProgram()
     debug::assertNoGlErrors();
 
     _locAlphaTest = glGetUniformLocation(_programObj, "u_AlphaTest");
-    _locObjectTransform = glGetUniformLocation(_programObj, "u_ObjectTransform");
+    _locObjectTransforms = glGetUniformLocation(_programObj, "u_ObjectTransforms");
     _locModelViewProjection = glGetUniformLocation(_programObj, "u_ModelViewProjection");
     _locDiffuseTextureMatrix = glGetUniformLocation(_programObj, "u_DiffuseTextureMatrix");
 
@@ -73,7 +73,12 @@ void DepthFillAlphaProgram::setModelViewProjection(const Matrix4& modelViewProje
 
 void DepthFillAlphaProgram::setObjectTransform(const Matrix4& transform)
 {
-    loadMatrixUniform(_locObjectTransform, transform);
+    loadMatrixUniform(_locObjectTransforms, transform);
+}
+
+void DepthFillAlphaProgram::setObjectTransforms(const Matrix4* transforms, std::size_t count)
+{
+    loadMatrixArrayUniform(_locObjectTransforms, transforms, count);
 }
 
 void DepthFillAlphaProgram::setDiffuseTextureTransform(const Matrix4& transform)
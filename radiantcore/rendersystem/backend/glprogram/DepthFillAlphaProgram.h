@@ -10,7 +10,7 @@ class DepthFillAlphaProgram :
     public ISupportsAlphaTest
 {
     GLint _locAlphaTest = -1;
-    GLint _locObjectTransform = -1;
+    GLint _locObjectTransforms = -1;
     GLint _locModelViewProjection = -1;
     GLint _locDiffuseTextureMatrix = -1;
 
@@ -23,6 +23,10 @@ public:
     void setModelViewProjection(const Matrix4& modelViewProjection);
     void setObjectTransform(const Matrix4& transform);
 
+    // Loads the transforms of the objects drawn by the next instanced draw call
+    // (count must not exceed InstancedObjects::MaxInstancesPerDraw)
+    void setObjectTransforms(const Matrix4* transforms, std::size_t count);
+
     void setAlphaTest(float alphaTest) override;
     void setDiffuseTextureTransform(const Matrix4& transform) override;
 };
@@ -1,6 +1,7 @@
 #include "GLSLProgramBase.h"
 
 #include "debugging/gl.h"
+#include "render/InstancedObjects.h"
 
 namespace render
 {
@@ -44,6 +45,25 @@ void GLSLProgramBase::loadMatrixUniform(GLuint location, const Matrix4& matrix)
     debug::assertNoGlErrors();
 }
 
+void GLSLProgramBase::loadMatrixArrayUniform(GLuint location, const Matrix4* matrices, std::size_t count)
+{
+    assert(count <= InstancedObjects::MaxInstancesPerDraw);
+
+    float values[16 * InstancedObjects::MaxInstancesPerDraw];
+
+    for (std::size_t m = 0; m < count; ++m)
+    {
+        for (auto i = 0; i < 16; ++i)
+        {
+            values[m * 16 + i] = static_cast<float>(matrices[m][i]);
+        }
+    }
+
+    glUniformMatrix4fv(location, static_cast<GLsizei>(count), GL_FALSE, values);
+
+    debug::assertNoGlErrors();
+}
+
 void GLSLProgramBase::loadTextureMatrixUniform(GLuint location, const Matrix4& matrix)
 {
     /* Extract the 6 components that are relevant to texture transforms.
@@ -15,6 +15,7 @@ protected:
     GLuint _programObj = 0;
 
     void loadMatrixUniform(GLuint location, const Matrix4& matrix);
+    void loadMatrixArrayUniform(GLuint location, const Matrix4* matrices, std::size_t count);
     void loadTextureMatrixUniform(GLuint location, const Matrix4& matrix);
 
 public:
@@ -10,6 +10,7 @@
 #include "math/Matrix4.h"
 #include "../OpenGLState.h"
 #include "render/Rectangle.h"
+#include "render/InstancedObjects.h"
 #include "rendersystem/backend/FrameBuffer.h"
 
 namespace render
@@ -52,17 +53,16 @@ InteractionProgram::InteractionProgram()
     debug::assertNoGlErrors();
 
     // Set the uniform locations to the correct bound values
-    _locLocalLightOrigin = glGetUniformLocation(_programObj, "u_LocalLightOrigin");
     _locWorldLightOrigin = glGetUniformLocation(_programObj, "u_WorldLightOrigin");
-    _locWorldUpLocal = glGetUniformLocation(_programObj, "u_WorldUpLocal");
     _locLightColour = glGetUniformLocation(_programObj, "u_LightColour");
-    _locViewOrigin = glGetUniformLocation(_programObj, "u_LocalViewOrigin");
+    _locViewOrigin = glGetUniformLocation(_programObj, "u_WorldViewOrigin");
     _locLightScale = glGetUniformLocation(_programObj, "u_LightScale");
     _locAmbientLight = glGetUniformLocation(_programObj, "u_IsAmbientLight");
     _locColourModulation = glGetUniformLocation(_programObj, "u_ColourModulation");
     _locColourAddition = glGetUniformLocation(_programObj, "u_ColourAddition");
     _locModelViewProjection = glGetUniformLocation(_programObj, "u_ModelViewProjection");
-    _locObjectTransform = glGetUniformLocation(_programObj, "u_ObjectTransform");
+    _locObjectTransforms = glGetUniformLocation(_programObj, "u_ObjectTransforms");
+    _locInverseObjectTransforms = glGetUniformLocation(_programObj, "u_InverseObjectTransforms");
 
     _locDiffuseTextureMatrix = glGetUniformLocation(_programObj, "u_DiffuseTextureMatrix");
     _locBumpTextureMatrix = glGetUniformLocation(_programObj, "u_BumpTextureMatrix");
@@ -178,7 +178,24 @@ void InteractionProgram::setModelViewProjection(const Matrix4& modelViewProjecti
 
 void InteractionProgram::setObjectTransform(const Matrix4& transform)
 {
-    loadMatrixUniform(_locObjectTransform, transform);
+    loadMatrixUniform(_locObjectTransforms, transform);
+    loadMatrixUniform(_locInverseObjectTransforms, transform.getInverse());
+}
+
+void InteractionProgram::setObjectTransforms(const Matrix4* transforms, std::size_t count)
+{
+    assert(count <= InstancedObjects::MaxInstancesPerDraw);
+
+    // The lighting calculations need the world to object transforms too
+    Matrix4 inverseTransforms[InstancedObjects::MaxInstancesPerDraw];
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        inverseTransforms[i] = transforms[i].getInverse();
+    }
+
+    loadMatrixArrayUniform(_locObjectTransforms, transforms, count);
+    loadMatrixArrayUniform(_locInverseObjectTransforms, inverseTransforms, count);
 }
 
 void InteractionProgram::setDiffuseTextureTransform(const Matrix4& transform)
@@ -229,45 +246,20 @@ void InteractionProgram::setupLightParameters(OpenGLState& state, const Renderer
     loadMatrixUniform(_locLightTextureMatrix, light.getLightTextureTransformation());
 }
 
-void InteractionProgram::setUpObjectLighting(const Vector3& worldLightOrigin,
-    const Vector3& viewer,
-    const Matrix4& inverseObjectTransform)
+void InteractionProgram::setUpLighting(const Vector3& worldLightOrigin, const Vector3& viewer)
 {
-    debug::assertNoGlErrors();
-
-    const auto& worldToObject = inverseObjectTransform;
-
-    // Calculate the light origin in object space
-    auto localLightOrigin = worldToObject.transformPoint(worldLightOrigin);
-
-    // Calculate world up (0,0,1) in object space
-    // This is needed for ambient lights
-    auto worldUpLocal = worldToObject.zCol3();
-
-    // Calculate viewer location in object space
-    auto osViewer = inverseObjectTransform.transformPoint(viewer);
-
-    // Set lighting parameters in the shader
+    // Set lighting parameters in the shader, the vertex program
+    // calculates the local light and view origin per object
     glUniform3f(_locViewOrigin,
-        static_cast<float>(osViewer.x()),
-        static_cast<float>(osViewer.y()),
-        static_cast<float>(osViewer.z())
-    );
-    glUniform3f(_locLocalLightOrigin,
-        static_cast<float>(localLightOrigin.x()),
-        static_cast<float>(localLightOrigin.y()),
-        static_cast<float>(localLightOrigin.z())
+        static_cast<float>(viewer.x()),
+        static_cast<float>(viewer.y()),
+        static_cast<float>(viewer.z())
     );
     glUniform3f(_locWorldLightOrigin,
         static_cast<float>(worldLightOrigin.x()),
         static_cast<float>(worldLightOrigin.y()),
         static_cast<float>(worldLightOrigin.z())
     );
-    glUniform3f(_locWorldUpLocal,
-        static_cast<float>(worldUpLocal.x()),
-        static_cast<float>(worldUpLocal.y()),
-        static_cast<float>(worldUpLocal.z())
-    );
 
     debug::assertNoGlErrors();
 }
@@ -16,9 +16,7 @@ class InteractionProgram: public GLSLProgramBase
 	float _lightScale;
 
     // Uniform/program-local parameter IDs.
-    int _locLocalLightOrigin;
     int _locWorldLightOrigin;
-    int _locWorldUpLocal;
     int _locLightColour;
     int _locViewOrigin;
     int _locLightScale;
@@ -26,7 +24,8 @@ class InteractionProgram: public GLSLProgramBase
     int _locColourModulation;
     int _locColourAddition;
     int _locModelViewProjection;
-    int _locObjectTransform;
+    int _locObjectTransforms;
+    int _locInverseObjectTransforms;
 
     int _locDiffuseTextureMatrix;
     int _locBumpTextureMatrix;
@@ -46,6 +45,10 @@ public:
     void setModelViewProjection(const Matrix4& modelViewProjection);
     void setObjectTransform(const Matrix4& transform);
 
+    // Loads the transforms of the objects drawn by the next instanced draw call
+    // (count must not exceed InstancedObjects::MaxInstancesPerDraw)
+    void setObjectTransforms(const Matrix4* transforms, std::size_t count);
+
     void setDiffuseTextureTransform(const Matrix4& transform);
     void setBumpTextureTransform(const Matrix4& transform);
     void setSpecularTextureTransform(const Matrix4& transform);
@@ -55,9 +58,9 @@ public:
 
     void setupLightParameters(OpenGLState& state, const RendererLight& light, std::size_t renderTime);
 
-    void setUpObjectLighting(const Vector3& worldLightOrigin,
-        const Vector3& viewer,
-        const Matrix4& inverseObjectTransform);
+    // Sets the light and viewer origin (in world space), the program moves
+    // them into the local space of every drawn object
+    void setUpLighting(const Vector3& worldLightOrigin, const Vector3& viewer);
 
     void setShadowMapRectangle(const Rectangle& rectangle);
     void enableShadowMapping(bool enable);
@@ -33,7 +33,7 @@ ShadowMapProgram::ShadowMapProgram()
 
     _locAlphaTest = glGetUniformLocation(_programObj, "u_AlphaTest");
     _locLightOrigin = glGetUniformLocation(_programObj, "u_LightOrigin");
-    _locObjectTransform = glGetUniformLocation(_programObj, "u_ObjectTransform");
+    _locObjectTransforms = glGetUniformLocation(_programObj, "u_ObjectTransforms");
     _locDiffuseTextureMatrix = glGetUniformLocation(_programObj, "u_DiffuseTextureMatrix");
 
     glUseProgram(_programObj);
@@ -80,7 +80,12 @@ void ShadowMapProgram::setLightOrigin(const Vector3& lightOrigin)
 
 void ShadowMapProgram::setObjectTransform(const Matrix4& transform)
 {
-    loadMatrixUniform(_locObjectTransform, transform);
+    loadMatrixUniform(_locObjectTransforms, transform);
+}
+
+void ShadowMapProgram::setObjectTransforms(const Matrix4* transforms, std::size_t count)
+{
+    loadMatrixArrayUniform(_locObjectTransforms, transforms, count);
 }
 
 void ShadowMapProgram::setDiffuseTextureTransform(const Matrix4& transform)
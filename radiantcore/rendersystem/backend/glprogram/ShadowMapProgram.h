@@ -11,7 +11,7 @@ class ShadowMapProgram :
 {
     GLint _locAlphaTest = -1;
     GLint _locLightOrigin = -1;
-    GLint _locObjectTransform = -1;
+    GLint _locObjectTransforms = -1;
     GLint _locDiffuseTextureMatrix = -1;
 
 public:
@@ -22,6 +22,10 @@ public:
 
     void setObjectTransform(const Matrix4& transform);
 
+    // Loads the transforms of the objects drawn by the next instanced draw call
+    // (count must not exceed InstancedObjects::MaxInstancesPerDraw)
+    void setObjectTransforms(const Matrix4* transforms, std::size_t count);
+
     void setDiffuseTextureTransform(const Matrix4& transform) override;
     void setAlphaTest(float alphaTest) override;
     void setLightOrigin(const Vector3& lightOrigin);
@@ -48,6 +48,14 @@ void SelectionTestWalker::performSelectionTest(const scene::INodePtr& selectable
         return;
     }
 
+    // Brush and patch geometry is fully contained in their bounds, if these are outside
+    // the selection volume none of their polygons can yield an intersection
+    if (Node_isPrimitive(nodeToBeTested) &&
+        _test.getVolume().TestAABB(nodeToBeTested->worldAABB()) == VOLUME_OUTSIDE)
+    {
+        return;
+    }
+
     auto selectable = scene::node_cast<ISelectable>(selectableNode);
 
 	if (!selectable) return; // skip non-selectables
@@ -5,6 +5,8 @@
 #include "transformlib.h"
 #include "registry/registry.h"
 #include "selection/algorithm/General.h"
+#include "brush/BrushNode.h"
+#include "util/ParallelFor.h"
 
 // greebo: This is needed e.g. to calculate the translation vector of a rotation transformation
 Vector3 get_local_pivot(const Vector3& world_pivot, const Matrix4& localToWorld)
@@ -157,3 +159,80 @@ void ScaleComponentSelected::visit(const scene::INodePtr& node) const {
       transform->setTranslation(parent_translation);
     }
 }
+
+// ====== Geometry evaluation =========================================================
+
+namespace selection
+{
+
+namespace
+{
+    // Below this number of brushes the B-reps are rebuilt on the calling thread
+    constexpr std::size_t MIN_BRUSHES_PER_THREAD = 32;
+
+    void collectBrushNode(const scene::INodePtr& node, std::vector<BrushNode*>& brushes)
+    {
+        auto brushNode = dynamic_cast<BrushNode*>(node.get());
+
+        if (brushNode != nullptr)
+        {
+            brushes.push_back(brushNode);
+        }
+    }
+}
+
+void evaluateTransformedSelection()
+{
+    std::vector<BrushNode*> brushes;
+
+    GlobalSelectionSystem().foreachSelected([&](const scene::INodePtr& node)
+    {
+        collectBrushNode(node, brushes);
+
+        // Selected entities carry their child primitives along
+        node->foreachNode([&](const scene::INodePtr& child)
+        {
+            collectBrushNode(child, brushes);
+            return true;
+        });
+    });
+
+    std::sort(brushes.begin(), brushes.end());
+    brushes.erase(std::unique(brushes.begin(), brushes.end()), brushes.end());
+
+    std::vector<Brush*> parallelBrushes;
+    parallelBrushes.reserve(brushes.size());
+
+    for (auto brushNode : brushes)
+    {
+        auto& brush = brushNode->getBrush();
+
+        // Applying the transform notifies the parent nodes and the scene graph
+        // about the changed bounds, this needs to happen on this thread
+        brush.evaluateTransform();
+
+        // Rebuilding the B-rep is destroying the component selectables,
+        // which is sending selection change events: keep those on this thread, too
+        if (brushNode->isSelectedComponents())
+        {
+            brush.evaluateBRep();
+            continue;
+        }
+
+        parallelBrushes.push_back(&brush);
+    }
+
+    // The B-rep of each brush only depends on its own face planes
+    util::parallelFor(parallelBrushes.size(), [&](std::size_t index)
+    {
+        parallelBrushes[index]->evaluateBRep();
+    }, MIN_BRUSHES_PER_THREAD);
+
+    // Evaluating the root bounds re-links all changed nodes in the space partition
+    if (GlobalSceneGraph().root())
+    {
+        GlobalSceneGraph().root()->worldAABB();
+    }
+}
+
+}
@@ -114,3 +114,21 @@ public:
 	// This actually applies the change to the node
   	void visit(const scene::INodePtr& node) const;
 };
+
+// =========== Geometry evaluation =====================================================
+
+namespace selection
+{
+
+/**
+ * greebo: Re-evaluates the geometry of all brushes affected by a transformation
+ * of the current selection, including the child primitives of selected entities.
+ *
+ * Pending transforms are resolved on the calling thread first (this is where the
+ * bounds change notifications are sent), then the B-reps of the brushes are
+ * rebuilt on worker threads. The changed bounds are flushed to the scene graph's
+ * space partition in one go afterwards.
+ */
+void evaluateTransformedSelection();
+
+}
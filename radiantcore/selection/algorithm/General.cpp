@@ -16,6 +16,7 @@
 #include "selectionlib.h"
 #include "entitylib.h"
 #include "scene/SelectionIndex.h"
+#include "scene/RayTrace.h"
 
 #include "SelectionPolicies.h"
 #include "selection/SceneWalkers.h"
@@ -99,23 +100,26 @@ void selectAllOfType(const cmd::ArgumentList& args)
 		// Deselect all faces
 		GlobalSelectionSystem().setSelectedAllComponents(false);
 
-		// Select all faces carrying any of the shaders in the set
-		scene::foreachVisibleFaceInstance([&] (FaceInstance& instance)
+		for (const auto& shader : shaders)
 		{
-			if (shaders.find(instance.getFace().getShader()) != shaders.end())
+			// Select all faces carrying any of the shaders in the set
+			scene::foreachVisibleFaceInstanceUsingMaterial(shader, [&] (FaceInstance& instance)
 			{
-				instance.setSelected(selection::ComponentSelectionMode::Face, true);
-			}
-		});
+				if (shaders.find(instance.getFace().getShader()) != shaders.end())
+				{
+					instance.setSelected(selection::ComponentSelectionMode::Face, true);
+				}
+			});
 
-		// Select all visible patches carrying any of the shaders in the set
-		scene::foreachVisiblePatch([&] (const IPatchNodePtr& node)
-		{
-			if (shaders.find(node->getPatch().getShader()) != shaders.end())
+			// Select all visible patches carrying any of the shaders in the set
+			scene::foreachVisiblePatchUsingMaterial(shader, [&] (const IPatchNodePtr& node)
 			{
-				Node_setSelected(std::dynamic_pointer_cast<scene::INode>(node), true);
-			}
-		});
+				if (shaders.find(node->getPatch().getShader()) != shaders.end())
+				{
+					Node_setSelected(std::dynamic_pointer_cast<scene::INode>(node), true);
+				}
+			});
+		}
 	}
 	else
 	{
@@ -148,7 +152,7 @@ void selectAllOfType(const cmd::ArgumentList& args)
 			// matching the one in the texture browser
 			auto shader = ShaderClipboard::Instance().getSource().getShader();
 
-			scene::foreachVisibleBrush([&] (Brush& brush)
+			scene::foreachVisibleBrushUsingMaterial(shader, [&] (Brush& brush)
 			{
 				if (brush.hasShader(shader))
 				{
@@ -157,7 +161,7 @@ void selectAllOfType(const cmd::ArgumentList& args)
 			});
 
 			// Select all visible patches carrying any of the shaders in the set
-			scene::foreachVisiblePatch([&] (const IPatchNodePtr& node)
+			scene::foreachVisiblePatchUsingMaterial(shader, [&] (const IPatchNodePtr& node)
 			{
 				if (node->getPatch().getShader() == shader)
 				{
@@ -755,68 +759,6 @@ void snapSelectionToGrid(const cmd::ArgumentList& args)
     GlobalSelectionSystem().foreachSelected(RemoveDegenerateBrushWalker());
 }
 
-class IntersectionFinder :
-	public scene::NodeVisitor
-{
-private:
-	const Ray& _ray;
-
-	Vector3 _bestPoint;
-
-	const scene::INodePtr& _self;
-
-public:
-	IntersectionFinder(const Ray& ray, const scene::INodePtr& self) :
-		_ray(ray),
-		_bestPoint(_ray.origin),
-		_self(self)
-	{}
-
-	const Vector3& getIntersection() const
-	{
-		return _bestPoint;
-	}
-
-	bool pre(const scene::INodePtr& node)
-	{
-		if (node == _self) return false;
-		if (!node->visible()) return true;
-
-		const AABB& aabb = node->worldAABB();
-		Vector3 intersection;
-
-		if (_ray.intersectAABB(aabb, intersection))
-		{
-			rMessage() << "Ray intersects with node " << node->name() << " at " << intersection;
-
-			// We have an intersection, let's attempt a full trace against the object
-			ITraceablePtr traceable = std::dynamic_pointer_cast<ITraceable>(node);
-
-			if (traceable && traceable->getIntersection(_ray, intersection))
-			{
-				rMessage() << " impacting at " << intersection;
-			}
-			else
-			{
-				// rMessage() << " (no detailed intersection)";
-				return true; // ignore this node
-			}
-
-			auto oldDistSquared = (_bestPoint - _ray.origin).getLengthSquared();
-			auto newDistSquared = (intersection - _ray.origin).getLengthSquared();
-
-			if ((oldDistSquared == 0 && newDistSquared > 0) || newDistSquared < oldDistSquared)
-			{
-				_bestPoint = intersection;
-			}
-
-			rMessage() << std::endl;
-		}
-
-		return true;
-	}
-};
-
 Vector3 getLowestVertexOfModel(const model::IModel& model, const Matrix4& localToWorld)
 {
 	Vector3 bestValue = Vector3(0,0,1e16);
@@ -895,12 +837,22 @@ void floorNode(const scene::INodePtr& node)
 	// when hitting "floor" multiple times in a row
 	Ray ray(objectOrigin + Vector3(0, 0, 1), Vector3(0, 0, -1));
 
-	IntersectionFinder finder(ray, node);
-	GlobalSceneGraph().root()->traverseChildren(finder);
+	// Trace against everything except the node itself and its children
+	auto trace = scene::traceRay(ray, [&](const scene::INodePtr& candidate)
+	{
+		for (auto n = candidate; n; n = n->getParent())
+		{
+			if (n == node) return false;
+		}
+
+		return true;
+	});
 
-	if ((finder.getIntersection() - ray.origin).getLengthSquared() > 0)
+	if (trace.hit())
 	{
-		Vector3 translation = finder.getIntersection() - objectOrigin;
+		rMessage() << "Ray intersects with node " << trace.node->name() << " at " << trace.point << std::endl;
+
+		Vector3 translation = trace.point - objectOrigin;
 
 		ITransformablePtr transformable = scene::node_cast<ITransformable>(node);
 
@@ -755,60 +755,46 @@ void normaliseTexture(const cmd::ArgumentList& args)
 	radiant::TextureChangedMessage::Send();
 }
 
-class ByShaderSelector :
-	public scene::NodeVisitor
+namespace
 {
-private:
-	std::string _shaderName;
 
-	bool _select;
-
-public:
-	ByShaderSelector(const std::string& shaderName, bool select = true) :
-		_shaderName(shaderName),
-		_select(select)
-	{}
-
-	bool pre(const scene::INodePtr& node)
+void setSelectionByShader(const std::string& shaderName, bool select)
+{
+	// Only the nodes using the shader need to be checked
+	GlobalSceneGraph().root()->getMaterialUsageIndex().foreachNodeUsingMaterial(shaderName,
+		[&](const scene::INodePtr& node)
 	{
 		Brush* brush = Node_getBrush(node);
 
 		if (brush != NULL)
 		{
-			if (brush->hasShader(_shaderName))
+			if (brush->hasShader(shaderName))
 			{
-				Node_setSelected(node, _select);
+				Node_setSelected(node, select);
 			}
 
-			return false; // don't traverse primitives
+			return;
 		}
 
 		Patch* patch = Node_getPatch(node);
 
-		if (patch != NULL)
+		if (patch != NULL && patch->getShader() == shaderName)
 		{
-			if (patch->getShader() == _shaderName)
-			{
-				Node_setSelected(node, _select);
-			}
-
-			return false; // don't traverse primitives
+			Node_setSelected(node, select);
 		}
+	});
+}
 
-		return true;
-	}
-};
+}
 
 void selectItemsByShader(const std::string& shaderName)
 {
-	ByShaderSelector selector(shaderName, true);
-	GlobalSceneGraph().root()->traverseChildren(selector);
+	setSelectionByShader(shaderName, true);
 }
 
 void deselectItemsByShader(const std::string& shaderName)
 {
-	ByShaderSelector selector(shaderName, false);
-	GlobalSceneGraph().root()->traverseChildren(selector);
+	setSelectionByShader(shaderName, false);
 }
 
 void selectItemsByShaderCmd(const cmd::ArgumentList& args)
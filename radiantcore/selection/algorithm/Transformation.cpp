@@ -74,6 +74,8 @@ void rotateSelected(const Quaternion& rotation)
 	SceneChangeNotify();
 
 	GlobalSceneGraph().foreachNode(scene::freezeTransformableNode);
+
+	evaluateTransformedSelection();
 }
 
 // greebo: see header for documentation
@@ -124,6 +126,8 @@ void scaleSelected(const Vector3& scaleXYZ)
 		SceneChangeNotify();
 
 		GlobalSceneGraph().foreachNode(scene::freezeTransformableNode);
+
+		evaluateTransformedSelection();
 	}
 	else
 	{
@@ -783,6 +787,8 @@ void translateSelected(const Vector3& translation)
 	SceneChangeNotify();
 
 	GlobalSceneGraph().foreachNode(scene::freezeTransformableNode);
+
+	evaluateTransformedSelection();
 }
 
 // Specialised overload, called by the general nudgeSelected() routine
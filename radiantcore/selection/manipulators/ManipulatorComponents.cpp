@@ -369,6 +369,8 @@ void SelectionTranslator::translate(const Vector3& translation)
 	{
 		// Cycle through the selected items and apply the translation
 		GlobalSelectionSystem().foreachSelected(TranslateSelected(translation));
+
+		evaluateTransformedSelection();
 	}
 
 	// Invoke the feedback function
@@ -308,6 +308,8 @@ void RotateManipulator::rotate(const Quaternion& rotation)
 	{
 		// Cycle through the selections and rotate them
 		GlobalSelectionSystem().foreachSelected(RotateSelected(rotation, _pivot.getVector3()));
+
+		evaluateTransformedSelection();
 	}
 
 	SceneChangeNotify();
@@ -80,27 +80,33 @@ TexturePtr CShader::getEditorImage()
 {
     if (!_editorTexture)
     {
-        auto editorTex = _template->getEditorTexture();
+        // Pass the call to the GLTextureManager to realise this image
+        _editorTexture = GetTextureManager().getBinding(getEditorImageSource());
+    }
+
+    return _editorTexture;
+}
+
+MapExpressionPtr CShader::getEditorImageSource()
+{
+    auto editorTex = _template->getEditorTexture();
 
-        if (!editorTex)
+    if (editorTex)
+    {
+        return editorTex;
+    }
+
+    // If there is no editor expression defined, use the an image from a layer, but no Bump or speculars
+    for (const auto& layer : _template->getLayers())
+    {
+        if (layer->getType() != IShaderLayer::BUMP && layer->getType() != IShaderLayer::SPECULAR &&
+            std::dynamic_pointer_cast<MapExpression>(layer->getMapExpression()))
         {
-            // If there is no editor expression defined, use the an image from a layer, but no Bump or speculars
-            for (const auto& layer : _template->getLayers())
-            {
-                if (layer->getType() != IShaderLayer::BUMP && layer->getType() != IShaderLayer::SPECULAR &&
-                    std::dynamic_pointer_cast<MapExpression>(layer->getMapExpression()))
-                {
-                    editorTex = std::static_pointer_cast<MapExpression>(layer->getMapExpression());
-                    break;
-                }
-            }
+            return std::static_pointer_cast<MapExpression>(layer->getMapExpression());
         }
-
-        // Pass the call to the GLTextureManager to realise this image
-        _editorTexture = GetTextureManager().getBinding(editorTex);
     }
 
-    return _editorTexture;
+    return MapExpressionPtr();
 }
 
 IMapExpression::Ptr CShader::getEditorImageExpression()
@@ -155,6 +155,10 @@ public:
     // Returns the current template (including any modifications) of this material
     const ShaderTemplate::Ptr& getTemplate();
 
+    // Returns the map expression the editor image is generated from, which is either
+    // the qer_editorimage or the first colour layer (might be empty)
+    MapExpressionPtr getEditorImageSource();
+
 private:
     void ensureTemplateCopy();
     void subscribeToTemplateChanges();
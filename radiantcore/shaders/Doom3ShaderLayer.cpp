@@ -299,7 +299,7 @@ void Doom3ShaderLayer::setColourExpression(ColourComponentSelector comp, const I
         break;
     };
 
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::setColour(const Vector4& col)
@@ -322,7 +322,7 @@ void Doom3ShaderLayer::setColour(const Vector4& col)
         }
     }
 
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::appendTransformation(const Transformation& transform)
@@ -345,7 +345,7 @@ void Doom3ShaderLayer::appendTransformation(const Transformation& transform)
     // Construct a transformation matrix and multiply it on top of the existing one
     _textureMatrix.applyTransformation(copy);
 
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 const std::vector<IShaderLayer::Transformation>& Doom3ShaderLayer::getTransformations()
@@ -386,7 +386,7 @@ const Vector2& Doom3ShaderLayer::getRenderMapSize() const
 void Doom3ShaderLayer::setRenderMapSize(const Vector2& size)
 {
     _renderMapSize = size;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 bool Doom3ShaderLayer::hasAlphaTest() const
@@ -407,7 +407,7 @@ const IShaderExpression::Ptr& Doom3ShaderLayer::getAlphaTestExpression() const
 void Doom3ShaderLayer::setAlphaTestExpressionFromString(const std::string& expression)
 {
     _expressionSlots.assignFromString(Expression::AlphaTest, expression, REG_ZERO);
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 const shaders::IShaderExpression::Ptr& Doom3ShaderLayer::getConditionExpression() const
@@ -418,11 +418,19 @@ const shaders::IShaderExpression::Ptr& Doom3ShaderLayer::getConditionExpression(
 void Doom3ShaderLayer::setCondition(const IShaderExpression::Ptr& conditionExpr)
 {
     _expressionSlots.assign(Expression::Condition, conditionExpr, REG_ONE);
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::evaluateExpressions(std::size_t time)
 {
+    auto& program = getExpressionProgram();
+
+    if (program.isValid())
+    {
+        program.execute(time, _registers);
+        return;
+    }
+
     for (const auto& slot : _expressionSlots)
     {
         if (slot.expression)
@@ -442,6 +450,14 @@ void Doom3ShaderLayer::evaluateExpressions(std::size_t time)
 
 void Doom3ShaderLayer::evaluateExpressions(std::size_t time, const IRenderEntity& entity)
 {
+    auto& program = getExpressionProgram();
+
+    if (program.isValid())
+    {
+        program.execute(time, entity, _registers);
+        return;
+    }
+
     for (const auto& slot : _expressionSlots)
     {
         if (slot.expression)
@@ -459,6 +475,44 @@ void Doom3ShaderLayer::evaluateExpressions(std::size_t time, const IRenderEntity
     }
 }
 
+ExpressionProgram& Doom3ShaderLayer::getExpressionProgram()
+{
+    if (_expressionProgram)
+    {
+        return *_expressionProgram;
+    }
+
+    _expressionProgram = std::make_unique<ExpressionProgram>();
+
+    std::vector<const ExpressionSlot*> compiledSlots;
+
+    auto compileSlot = [&](const ExpressionSlot& slot)
+    {
+        if (!slot.expression) return;
+
+        // Slots sharing the same expression and register (like the rgb components) are compiled once
+        for (auto compiled : compiledSlots)
+        {
+            if (compiled->expression == slot.expression && compiled->registerIndex == slot.registerIndex) return;
+        }
+
+        compiledSlots.push_back(&slot);
+        _expressionProgram->addOutput(ShaderExpression::Compile(slot.expression, *_expressionProgram), slot.registerIndex);
+    };
+
+    for (const auto& slot : _expressionSlots)
+    {
+        compileSlot(slot);
+    }
+
+    for (const auto& parm : _vertexParms)
+    {
+        compileSlot(parm);
+    }
+
+    return *_expressionProgram;
+}
+
 IShaderExpression::Ptr Doom3ShaderLayer::getExpression(Expression::Slot slot)
 {
     return _expressionSlots[slot].expression;
@@ -467,7 +521,7 @@ IShaderExpression::Ptr Doom3ShaderLayer::getExpression(Expression::Slot slot)
 void Doom3ShaderLayer::setBindableTexture(NamedBindablePtr btex)
 {
     _bindableTex = btex;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 NamedBindablePtr Doom3ShaderLayer::getBindableTexture() const
@@ -478,7 +532,7 @@ NamedBindablePtr Doom3ShaderLayer::getBindableTexture() const
 void Doom3ShaderLayer::setLayerType(IShaderLayer::Type type)
 {
     _type = type;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 IShaderLayer::Type Doom3ShaderLayer::getType() const
@@ -494,19 +548,19 @@ int Doom3ShaderLayer::getStageFlags() const
 void Doom3ShaderLayer::setStageFlags(int flags)
 {
     _stageFlags = flags;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::setStageFlag(IShaderLayer::Flags flag)
 {
     _stageFlags |= flag;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::clearStageFlag(IShaderLayer::Flags flag)
 {
     _stageFlags &= ~flag;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 ClampType Doom3ShaderLayer::getClampType() const
@@ -517,7 +571,7 @@ ClampType Doom3ShaderLayer::getClampType() const
 void Doom3ShaderLayer::setClampType(ClampType type)
 {
     _clampType = type;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 bool Doom3ShaderLayer::hasOverridingClampType() const
@@ -533,7 +587,7 @@ IShaderLayer::TexGenType Doom3ShaderLayer::getTexGenType() const
 void Doom3ShaderLayer::setTexGenType(TexGenType type)
 {
     _texGenType = type;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 float Doom3ShaderLayer::getTexGenParam(std::size_t index) const
@@ -558,7 +612,7 @@ void Doom3ShaderLayer::setTexGenExpression(std::size_t index, const IShaderExpre
 
     _expressionSlots.assign(slot, expression, REG_ZERO);
 
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::setBlendFuncStrings(const StringPair& func)
@@ -582,7 +636,7 @@ void Doom3ShaderLayer::setBlendFuncStrings(const StringPair& func)
         setLayerType(IShaderLayer::BLEND);
     }
 
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 const StringPair& Doom3ShaderLayer::getBlendFuncStrings() const
@@ -593,19 +647,19 @@ const StringPair& Doom3ShaderLayer::getBlendFuncStrings() const
 void Doom3ShaderLayer::setVertexColourMode(VertexColourMode mode)
 {
     _vertexColourMode = mode;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::setCubeMapMode(CubeMapMode mode)
 {
     _cubeMapMode = mode;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::setAlphaTest(const IShaderExpression::Ptr& expression)
 {
     _expressionSlots.assign(Expression::AlphaTest, expression, REG_ZERO);
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 float Doom3ShaderLayer::getRegisterValue(std::size_t index) const
@@ -634,7 +688,7 @@ const std::string& Doom3ShaderLayer::getVertexProgram() const
 void Doom3ShaderLayer::setVertexProgram(const std::string& name)
 {
     _vertexProgram = name;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 const std::string& Doom3ShaderLayer::getFragmentProgram() const
@@ -645,7 +699,7 @@ const std::string& Doom3ShaderLayer::getFragmentProgram() const
 void Doom3ShaderLayer::setFragmentProgram(const std::string& name)
 {
     _fragmentProgram = name;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 std::size_t Doom3ShaderLayer::getNumFragmentMaps() const
@@ -680,7 +734,7 @@ void Doom3ShaderLayer::addFragmentMap(const IShaderLayer::FragmentMap& fragmentM
     }
 
     _fragmentMaps[fragmentMap.index] = fragmentMap;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 std::string Doom3ShaderLayer::getMapImageFilename() const
@@ -703,7 +757,7 @@ float Doom3ShaderLayer::getPrivatePolygonOffset() const
 void Doom3ShaderLayer::setPrivatePolygonOffset(double value)
 {
     _privatePolygonOffset = static_cast<float>(value);
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 IMapExpression::Ptr Doom3ShaderLayer::getMapExpression() const
@@ -723,7 +777,7 @@ void Doom3ShaderLayer::setMapExpressionFromString(const std::string& expression)
     {
         setBindableTexture(MapExpression::createForString(expression));
     }
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 int Doom3ShaderLayer::getParseFlags() const
@@ -826,7 +880,7 @@ void Doom3ShaderLayer::addVertexParm(const VertexParm& parm)
     // At this point the array needs to be empty or its size a multiple of 4
     assert(_vertexParms.size() % 4 == 0);
 
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::recalculateTransformationMatrix()
@@ -839,10 +893,16 @@ void Doom3ShaderLayer::recalculateTransformationMatrix()
     }
 }
 
+void Doom3ShaderLayer::onLayerChanged()
+{
+    _expressionProgram.reset();
+    _material.onLayerChanged();
+}
+
 void Doom3ShaderLayer::setEnabled(bool enabled)
 {
     _enabled = enabled;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 std::size_t Doom3ShaderLayer::addTransformation(TransformType type, const std::string& expression1, const std::string& expression2)
@@ -856,7 +916,7 @@ std::size_t Doom3ShaderLayer::addTransformation(TransformType type, const std::s
 
     recalculateTransformationMatrix();
 
-    _material.onLayerChanged();
+    onLayerChanged();
 
     return _transformations.size() - 1;
 }
@@ -868,7 +928,7 @@ void Doom3ShaderLayer::removeTransformation(std::size_t index)
     _transformations.erase(_transformations.begin() + index);
 
     recalculateTransformationMatrix();
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::updateTransformation(std::size_t index, TransformType type, const std::string& expression1, const std::string& expression2)
@@ -891,7 +951,7 @@ void Doom3ShaderLayer::updateTransformation(std::size_t index, TransformType typ
 
     recalculateTransformationMatrix();
 
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::setColourExpressionFromString(ColourComponentSelector component, const std::string& expression)
@@ -922,7 +982,7 @@ void Doom3ShaderLayer::setConditionExpressionFromString(const std::string& expre
         condition->setIsSurroundedByParentheses(true);
     }
 
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::setTexGenExpressionFromString(std::size_t index, const std::string& expression)
@@ -931,19 +991,19 @@ void Doom3ShaderLayer::setTexGenExpressionFromString(std::size_t index, const st
 
     auto slot = static_cast<Expression::Slot>(Expression::TexGenParam1 + index);
     _expressionSlots.assignFromString(slot, expression, REG_ZERO);
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::setSoundMapWaveForm(bool waveForm)
 {
     setBindableTexture(std::make_shared<SoundMapExpression>(waveForm));
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::setVideoMapProperties(const std::string& filePath, bool looping)
 {
     setBindableTexture(std::make_shared<VideoMapExpression>(filePath, looping));
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 }
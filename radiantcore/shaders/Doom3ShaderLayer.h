@@ -1,8 +1,10 @@
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "math/Vector4.h"
+#include "scene/shaders/ExpressionProgram.h"
 #include "scene/shaders/NamedBindable.h"
 #include "ExpressionSlots.h"
 #include "TextureMatrix.h"
@@ -26,6 +28,10 @@ class Doom3ShaderLayer: public IEditableShaderLayer
     // The expressions used in this stage
     ExpressionSlots _expressionSlots;
 
+    // All expressions of this stage compiled into one program,
+    // created on demand and discarded whenever the layer is changed
+    std::unique_ptr<ExpressionProgram> _expressionProgram;
+
     static const IShaderExpression::Ptr NULL_EXPRESSION;
     static const std::size_t NOT_DEFINED = std::numeric_limits<std::size_t>::max();
 
@@ -279,6 +285,12 @@ public:
 
 private:
     void recalculateTransformationMatrix();
+
+    // Discards the compiled expressions and notifies the owning material
+    void onLayerChanged();
+
+    // Returns the program evaluating the expression slots and vertex parms
+    ExpressionProgram& getExpressionProgram();
 };
 
 }
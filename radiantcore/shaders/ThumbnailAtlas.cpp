@@ -0,0 +1,175 @@
+#include "ThumbnailAtlas.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace shaders
+{
+
+ThumbnailAtlas::ThumbnailAtlas(std::size_t pageSize, std::size_t cellSize, std::size_t maxPages) :
+    _pageSize(pageSize),
+    _cellSize(cellSize),
+    _maxPages(maxPages),
+    _cellsPerRow(pageSize / cellSize),
+    _useCounter(0),
+    _revisionCounter(0)
+{
+    if (_cellsPerRow == 0 || _maxPages == 0)
+    {
+        throw std::invalid_argument("Thumbnail atlas pages must be able to hold at least one cell");
+    }
+}
+
+bool ThumbnailAtlas::find(const std::string& key, Thumbnail& thumbnail) const
+{
+    auto found = _cellByKey.find(key);
+
+    if (found == _cellByKey.end()) return false;
+
+    auto cellsPerPage = _cellsPerRow * _cellsPerRow;
+    auto indexInPage = found->second % cellsPerPage;
+    const auto& cell = _cells[found->second];
+
+    thumbnail.page = found->second / cellsPerPage;
+    thumbnail.x = (indexInPage % _cellsPerRow) * _cellSize;
+    thumbnail.y = (indexInPage / _cellsPerRow) * _cellSize;
+    thumbnail.width = cell.width;
+    thumbnail.height = cell.height;
+
+    return true;
+}
+
+void ThumbnailAtlas::markUsed(const std::string& key)
+{
+    auto found = _cellByKey.find(key);
+
+    if (found != _cellByKey.end())
+    {
+        _cells[found->second].lastUse = ++_useCounter;
+    }
+}
+
+bool ThumbnailAtlas::insert(const std::string& key, const ThumbnailImage& image,
+    const EvictionFilter& canEvict, std::vector<std::string>& evicted)
+{
+    remove(key);
+
+    std::size_t cellIndex;
+
+    if (!findCellToUse(canEvict, cellIndex)) return false;
+
+    auto& cell = _cells[cellIndex];
+
+    if (!cell.key.empty())
+    {
+        evicted.push_back(cell.key);
+        _cellByKey.erase(cell.key);
+    }
+
+    cell.key = key;
+    cell.width = std::min(image.width, _cellSize);
+    cell.height = std::min(image.height, _cellSize);
+    cell.lastUse = ++_useCounter;
+    _cellByKey[key] = cellIndex;
+
+    Thumbnail location;
+    find(key, location);
+
+    // Copy the rows into the page
+    auto& page = *_pages[location.page];
+
+    for (std::size_t row = 0; row < cell.height; ++row)
+    {
+        std::memcpy(page.pixels + (location.y + row) * _pageSize + location.x,
+            image.pixels.data() + row * image.width * 4, cell.width * 4);
+    }
+
+    _revisions[location.page] = ++_revisionCounter;
+
+    return true;
+}
+
+void ThumbnailAtlas::remove(const std::string& key)
+{
+    auto found = _cellByKey.find(key);
+
+    if (found == _cellByKey.end()) return;
+
+    auto& cell = _cells[found->second];
+    cell.key.clear();
+    cell.lastUse = 0;
+
+    _cellByKey.erase(found);
+}
+
+void ThumbnailAtlas::clear()
+{
+    _cells.clear();
+    _pages.clear();
+    _revisions.clear();
+    _cellByKey.clear();
+}
+
+std::size_t ThumbnailAtlas::getNumPages() const
+{
+    return _pages.size();
+}
+
+const std::shared_ptr<image::RGBAImage>& ThumbnailAtlas::getPage(std::size_t index) const
+{
+    return _pages.at(index);
+}
+
+std::size_t ThumbnailAtlas::getPageRevision(std::size_t index) const
+{
+    return _revisions.at(index);
+}
+
+bool ThumbnailAtlas::findCellToUse(const EvictionFilter& canEvict, std::size_t& cellIndex)
+{
+    // Prefer free cells
+    for (std::size_t i = 0; i < _cells.size(); ++i)
+    {
+        if (_cells[i].key.empty())
+        {
+            cellIndex = i;
+            return true;
+        }
+    }
+
+    if (_pages.size() < _maxPages)
+    {
+        cellIndex = _cells.size();
+        addPage();
+        return true;
+    }
+
+    // Recycle the least recently used cell
+    auto found = _cells.end();
+
+    for (auto cell = _cells.begin(); cell != _cells.end(); ++cell)
+    {
+        if ((found == _cells.end() || cell->lastUse < found->lastUse) && canEvict(cell->key))
+        {
+            found = cell;
+        }
+    }
+
+    if (found == _cells.end()) return false;
+
+    cellIndex = found - _cells.begin();
+    return true;
+}
+
+void ThumbnailAtlas::addPage()
+{
+    auto page = std::make_shared<image::RGBAImage>(_pageSize, _pageSize);
+    std::memset(page->pixels, 0, _pageSize * _pageSize * sizeof(image::RGBAPixel));
+
+    _pages.push_back(page);
+    _revisions.push_back(++_revisionCounter);
+    _cells.resize(_cells.size() + _cellsPerRow * _cellsPerRow);
+}
+
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ithumbnails.h"
+#include "RGBAImage.h"
+#include "ThumbnailCache.h"
+
+namespace shaders
+{
+
+/**
+ * Set of square RGBA pages divided into equally sized cells, each cell
+ * holding one thumbnail. New pages are allocated until the page limit
+ * is reached, after that the least recently used cells are recycled.
+ */
+class ThumbnailAtlas final
+{
+public:
+    // Returns true if the thumbnail with the given key may be removed from the atlas
+    using EvictionFilter = std::function<bool(const std::string&)>;
+
+private:
+    std::size_t _pageSize;
+    std::size_t _cellSize;
+    std::size_t _maxPages;
+    std::size_t _cellsPerRow;
+
+    struct Cell
+    {
+        std::string key;
+        std::size_t width = 0;
+        std::size_t height = 0;
+        std::size_t lastUse = 0;
+    };
+
+    // The cells of all pages, in page order
+    std::vector<Cell> _cells;
+
+    std::vector<std::shared_ptr<image::RGBAImage>> _pages;
+    std::vector<std::size_t> _revisions;
+
+    std::map<std::string, std::size_t> _cellByKey;
+
+    std::size_t _useCounter;
+
+    // Source of the page revisions, not reset by clear() such that
+    // revisions of recreated pages never match the ones of previous pages
+    std::size_t _revisionCounter;
+
+public:
+    ThumbnailAtlas(std::size_t pageSize, std::size_t cellSize, std::size_t maxPages);
+
+    // Returns true and fills in the location if the given key is stored in the atlas
+    bool find(const std::string& key, Thumbnail& thumbnail) const;
+
+    // Marks the given thumbnail as most recently used
+    void markUsed(const std::string& key);
+
+    /**
+     * Copies the given thumbnail into a free cell. If all pages are full, the
+     * least recently used cell accepted by the filter is overwritten, its key
+     * is added to the evicted list. Returns false if no cell could be found.
+     */
+    bool insert(const std::string& key, const ThumbnailImage& image,
+        const EvictionFilter& canEvict, std::vector<std::string>& evicted);
+
+    // Removes the given thumbnail, its cell is reused by the next insert
+    void remove(const std::string& key);
+
+    void clear();
+
+    std::size_t getNumPages() const;
+    const std::shared_ptr<image::RGBAImage>& getPage(std::size_t index) const;
+    std::size_t getPageRevision(std::size_t index) const;
+
+private:
+    bool findCellToUse(const EvictionFilter& canEvict, std::size_t& cellIndex);
+    void addPage();
+};
+
+}
@@ -0,0 +1,260 @@
+#include "ThumbnailCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <zlib.h>
+#include "itextstream.h"
+#include "os/dir.h"
+#include "os/fs.h"
+#include "os/path.h"
+#include "string/replace.h"
+#include "vfs/FileStamp.h"
+
+namespace shaders
+{
+
+namespace
+{
+    constexpr char MAGIC[4] = { 'D', 'R', 'T', 'N' };
+
+    // Increase this whenever the layout below or the downsampling changes
+    constexpr std::uint32_t VERSION = 1;
+
+    // File layout (native byte order):
+    //   magic, version, source size, source modification time, path length, path,
+    //   image width, image height, thumbnail width, thumbnail height,
+    //   compressed pixel size, compressed pixels
+    // The header is read in one go when only the image size is needed
+    constexpr std::size_t MAX_HEADER_SIZE = 4096;
+
+    class Writer
+    {
+    private:
+        std::vector<char> _buffer;
+
+    public:
+        template<typename T>
+        void write(const T& value)
+        {
+            static_assert(std::is_arithmetic_v<T>, "Only arithmetic types can be written");
+
+            auto offset = _buffer.size();
+            _buffer.resize(offset + sizeof(T));
+            std::memcpy(_buffer.data() + offset, &value, sizeof(T));
+        }
+
+        void writeString(const std::string& str)
+        {
+            write(static_cast<std::uint32_t>(str.size()));
+            _buffer.insert(_buffer.end(), str.begin(), str.end());
+        }
+
+        void writeBytes(const void* data, std::size_t size)
+        {
+            auto bytes = static_cast<const char*>(data);
+            _buffer.insert(_buffer.end(), bytes, bytes + size);
+        }
+
+        const std::vector<char>& getBuffer() const
+        {
+            return _buffer;
+        }
+    };
+
+    // Reads values from the buffer, returns false if the buffer is exhausted
+    class Reader
+    {
+    private:
+        const char* _pos;
+        const char* _end;
+
+    public:
+        Reader(const std::vector<char>& buffer) :
+            _pos(buffer.data()),
+            _end(buffer.data() + buffer.size())
+        {}
+
+        template<typename T>
+        bool read(T& value)
+        {
+            if (static_cast<std::size_t>(_end - _pos) < sizeof(T)) return false;
+
+            std::memcpy(&value, _pos, sizeof(T));
+            _pos += sizeof(T);
+            return true;
+        }
+
+        bool readString(std::string& str)
+        {
+            std::uint32_t length;
+
+            if (!read(length) || static_cast<std::size_t>(_end - _pos) < length) return false;
+
+            str.assign(_pos, length);
+            _pos += length;
+            return true;
+        }
+
+        bool readCompressed(std::vector<std::uint8_t>& pixels, std::size_t compressedSize)
+        {
+            if (static_cast<std::size_t>(_end - _pos) < compressedSize) return false;
+
+            auto size = static_cast<uLongf>(pixels.size());
+
+            if (uncompress(reinterpret_cast<Bytef*>(pixels.data()), &size,
+                reinterpret_cast<const Bytef*>(_pos), static_cast<uLong>(compressedSize)) != Z_OK ||
+                size != pixels.size())
+            {
+                return false;
+            }
+
+            _pos += compressedSize;
+            return true;
+        }
+    };
+}
+
+ThumbnailCache::ThumbnailCache(const std::string& cacheFolder) :
+    _cacheFolder(os::standardPathWithSlash(cacheFolder))
+{
+    os::makeDirectory(_cacheFolder);
+}
+
+std::string ThumbnailCache::getCacheFilePath(const std::string& imagePath) const
+{
+    // Flatten the path, collisions are detected by the path stored in the file
+    auto fileName = string::replace_all_copy(imagePath, "/", "_");
+    string::replace_all(fileName, "\\", "_");
+
+    return _cacheFolder + fileName + ".thumb";
+}
+
+bool ThumbnailCache::load(const std::string& imagePath, ThumbnailImage& thumbnail)
+{
+    return read(imagePath, thumbnail, true);
+}
+
+bool ThumbnailCache::loadHeader(const std::string& imagePath, ThumbnailImage& thumbnail)
+{
+    return read(imagePath, thumbnail, false);
+}
+
+bool ThumbnailCache::read(const std::string& imagePath, ThumbnailImage& thumbnail, bool includePixels)
+{
+    std::ifstream stream(getCacheFilePath(imagePath), std::ios::binary | std::ios::ate);
+
+    if (!stream) return false;
+
+    vfs::FileStamp sourceStamp;
+
+    if (!vfs::getFileStamp(imagePath, sourceStamp)) return false;
+
+    auto fileSize = static_cast<std::size_t>(stream.tellg());
+    std::vector<char> buffer(includePixels ? fileSize : std::min(fileSize, MAX_HEADER_SIZE));
+    stream.seekg(0);
+
+    if (!stream.read(buffer.data(), buffer.size())) return false;
+
+    Reader reader(buffer);
+
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t size;
+    std::int64_t modificationTime;
+    std::string storedPath;
+    std::uint32_t imageWidth, imageHeight, width, height, compressedSize;
+
+    if (!reader.read(magic) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        !reader.read(version) || version != VERSION ||
+        !reader.read(size) || size != sourceStamp.size ||
+        !reader.read(modificationTime) || modificationTime != sourceStamp.modificationTime ||
+        !reader.readString(storedPath) || storedPath != imagePath ||
+        !reader.read(imageWidth) || !reader.read(imageHeight) ||
+        !reader.read(width) || !reader.read(height) || !reader.read(compressedSize))
+    {
+        return false; // outdated or foreign file, will be overwritten
+    }
+
+    thumbnail.imageWidth = imageWidth;
+    thumbnail.imageHeight = imageHeight;
+    thumbnail.width = width;
+    thumbnail.height = height;
+    thumbnail.pixels.clear();
+
+    if (!includePixels) return true;
+
+    thumbnail.pixels.resize(static_cast<std::size_t>(width) * height * 4);
+
+    if (!reader.readCompressed(thumbnail.pixels, compressedSize))
+    {
+        rWarning() << "Thumbnail of " << imagePath << " is corrupt" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+void ThumbnailCache::store(const std::string& imagePath, const ThumbnailImage& thumbnail)
+{
+    vfs::FileStamp sourceStamp;
+
+    if (!vfs::getFileStamp(imagePath, sourceStamp)) return;
+
+    auto compressedSize = compressBound(static_cast<uLong>(thumbnail.pixels.size()));
+    std::vector<Bytef> compressed(compressedSize);
+
+    if (compress2(compressed.data(), &compressedSize, thumbnail.pixels.data(),
+        static_cast<uLong>(thumbnail.pixels.size()), Z_DEFAULT_COMPRESSION) != Z_OK)
+    {
+        rWarning() << "Failed to compress thumbnail of " << imagePath << std::endl;
+        return;
+    }
+
+    Writer writer;
+
+    for (auto c : MAGIC)
+    {
+        writer.write(c);
+    }
+
+    writer.write(VERSION);
+    writer.write(sourceStamp.size);
+    writer.write(sourceStamp.modificationTime);
+    writer.writeString(imagePath);
+    writer.write(static_cast<std::uint32_t>(thumbnail.imageWidth));
+    writer.write(static_cast<std::uint32_t>(thumbnail.imageHeight));
+    writer.write(static_cast<std::uint32_t>(thumbnail.width));
+    writer.write(static_cast<std::uint32_t>(thumbnail.height));
+    writer.write(static_cast<std::uint32_t>(compressedSize));
+    writer.writeBytes(compressed.data(), compressedSize);
+
+    // Write to a temporary file first, other threads might be reading the previous version
+    auto cacheFilePath = getCacheFilePath(imagePath);
+    auto tempPath = cacheFilePath + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+    {
+        std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+
+        const auto& buffer = writer.getBuffer();
+
+        if (!stream || !stream.write(buffer.data(), buffer.size()))
+        {
+            rWarning() << "Failed to write thumbnail " << cacheFilePath << std::endl;
+            return;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tempPath, cacheFilePath, ec);
+
+    if (ec)
+    {
+        rWarning() << "Failed to write thumbnail " << cacheFilePath << ": " << ec.message() << std::endl;
+        fs::remove(tempPath, ec);
+    }
+}
+
+}
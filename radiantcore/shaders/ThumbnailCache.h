@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace shaders
+{
+
+/// Downsampled RGBA copy of an image, together with the size of the original
+struct ThumbnailImage
+{
+    std::size_t imageWidth = 0;
+    std::size_t imageHeight = 0;
+
+    std::size_t width = 0;
+    std::size_t height = 0;
+
+    // width * height RGBA pixels, rows are starting at the top
+    std::vector<std::uint8_t> pixels;
+};
+
+/**
+ * On-disk cache of material thumbnails, keyed by the VFS path of the image
+ * file they have been generated from.
+ *
+ * Each cache file is tagged with the size and modification time of the
+ * source file (or the containing archive), a mismatch causes the thumbnail
+ * to be generated from its source image again. The pixels are stored
+ * zlib-compressed.
+ *
+ * Instances of this class can be used from several threads concurrently.
+ */
+class ThumbnailCache final
+{
+private:
+    std::string _cacheFolder;
+
+public:
+    // Cache files are stored in the given folder, which is created if necessary
+    ThumbnailCache(const std::string& cacheFolder);
+
+    // Reads the thumbnail of the given image file, returns false if there is no
+    // cached thumbnail or the image file has been changed since.
+    bool load(const std::string& imagePath, ThumbnailImage& thumbnail);
+
+    // Reads just the dimensions of the full image from the cached thumbnail,
+    // the pixels of the returned thumbnail are left empty
+    bool loadHeader(const std::string& imagePath, ThumbnailImage& thumbnail);
+
+    void store(const std::string& imagePath, const ThumbnailImage& thumbnail);
+
+    // Returns the path of the cache file belonging to the given image path
+    std::string getCacheFilePath(const std::string& imagePath) const;
+
+private:
+    bool read(const std::string& imagePath, ThumbnailImage& thumbnail, bool includePixels);
+};
+
+}
@@ -0,0 +1,468 @@
+#include "ThumbnailManager.h"
+
+#include <algorithm>
+#include "ideclmanager.h"
+#include "ifilesystem.h"
+#include "itextstream.h"
+#include "module/StaticModule.h"
+#include "CShader.h"
+
+namespace shaders
+{
+
+namespace
+{
+    constexpr std::size_t THUMBNAIL_SIZE = 128;
+
+    // Each page holds 8x8 thumbnails
+    constexpr std::size_t ATLAS_PAGE_SIZE = 1024;
+    constexpr std::size_t MAX_ATLAS_PAGES = 16;
+
+    constexpr std::size_t MAX_WORKERS = 4;
+
+    MapExpressionPtr getEditorImageSource(const std::string& materialName)
+    {
+        auto material = std::dynamic_pointer_cast<CShader>(GlobalMaterialManager().getMaterial(materialName));
+
+        return material ? material->getEditorImageSource() : MapExpressionPtr();
+    }
+
+    // Returns the VFS path of the image file the given expression is loading,
+    // or an empty string if it is built-in or combining several images
+    std::string getCacheableImagePath(const MapExpressionPtr& source)
+    {
+        auto imageExpression = std::dynamic_pointer_cast<ImageExpression>(source);
+
+        if (!imageExpression) return std::string();
+
+        auto imageName = imageExpression->getIdentifier();
+
+        if (imageName.empty() || imageName.front() == '_') return std::string();
+
+        return GlobalImageLoader().findImageInVFS(imageName);
+    }
+
+    // Box-filters the given RGBA image down to fit into size x size pixels
+    void downsampleImage(const Image& image, std::size_t size, ThumbnailImage& thumbnail)
+    {
+        auto width = image.getWidth();
+        auto height = image.getHeight();
+        auto longestSide = std::max(width, height);
+
+        thumbnail.imageWidth = width;
+        thumbnail.imageHeight = height;
+        thumbnail.width = longestSide <= size ? width : std::max<std::size_t>(width * size / longestSide, 1);
+        thumbnail.height = longestSide <= size ? height : std::max<std::size_t>(height * size / longestSide, 1);
+        thumbnail.pixels.resize(thumbnail.width * thumbnail.height * 4);
+
+        const auto* source = image.getPixels();
+        auto* target = thumbnail.pixels.data();
+
+        for (std::size_t ty = 0; ty < thumbnail.height; ++ty)
+        {
+            auto y0 = ty * height / thumbnail.height;
+            auto y1 = std::max((ty + 1) * height / thumbnail.height, y0 + 1);
+
+            for (std::size_t tx = 0; tx < thumbnail.width; ++tx)
+            {
+                auto x0 = tx * width / thumbnail.width;
+                auto x1 = std::max((tx + 1) * width / thumbnail.width, x0 + 1);
+
+                std::size_t sum[4] = { 0, 0, 0, 0 };
+
+                for (auto y = y0; y < y1; ++y)
+                {
+                    const auto* pixel = source + (y * width + x0) * 4;
+
+                    for (auto x = x0; x < x1; ++x, pixel += 4)
+                    {
+                        sum[0] += pixel[0];
+                        sum[1] += pixel[1];
+                        sum[2] += pixel[2];
+                        sum[3] += pixel[3];
+                    }
+                }
+
+                auto count = (x1 - x0) * (y1 - y0);
+
+                for (auto channel : sum)
+                {
+                    *target++ = static_cast<std::uint8_t>(channel / count);
+                }
+            }
+        }
+    }
+}
+
+ThumbnailManager::ThumbnailManager() :
+    _activeJobs(0),
+    _shutdown(false)
+{}
+
+std::size_t ThumbnailManager::getThumbnailSize() const
+{
+    return THUMBNAIL_SIZE;
+}
+
+void ThumbnailManager::requestThumbnails(const std::vector<std::string>& materialNames)
+{
+    _requested = std::set<std::string>(materialNames.begin(), materialNames.end());
+
+    std::deque<Job> queue;
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        queue.swap(_queue);
+    }
+
+    // Queued materials not being requested anymore are dropped
+    std::map<std::string, MapExpressionPtr> previouslyQueued;
+
+    for (auto& job : queue)
+    {
+        previouslyQueued.emplace(job.material, job.source);
+        _materials[job.material].status = Status::NotRequested;
+    }
+
+    queue.clear();
+
+    for (const auto& name : materialNames)
+    {
+        auto& state = _materials[name];
+
+        switch (state.status)
+        {
+        case Status::Ready:
+            _atlas->markUsed(name);
+            continue;
+
+        case Status::Unavailable:
+        case Status::Pending: // in the hands of a worker
+            continue;
+
+        case Status::NotRequested:
+            break;
+        }
+
+        auto wasQueued = previouslyQueued.find(name);
+        auto source = wasQueued != previouslyQueued.end() ? wasQueued->second : getEditorImageSource(name);
+
+        if (!source)
+        {
+            state.status = Status::Unavailable;
+            continue;
+        }
+
+        state.status = Status::Pending;
+        queue.push_back(Job{ name, source });
+    }
+
+    if (queue.empty()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        _queue.swap(queue);
+
+        if (_workers.empty())
+        {
+            startWorkers();
+        }
+    }
+
+    _queueChanged.notify_all();
+}
+
+IThumbnailManager::Status ThumbnailManager::getThumbnail(const std::string& materialName, Thumbnail& thumbnail)
+{
+    auto found = _materials.find(materialName);
+
+    if (found == _materials.end()) return Status::NotRequested;
+
+    if (found->second.status == Status::Ready)
+    {
+        _atlas->find(materialName, thumbnail);
+    }
+
+    return found->second.status;
+}
+
+bool ThumbnailManager::getImageSize(const std::string& materialName, std::size_t& width, std::size_t& height)
+{
+    auto& state = _materials[materialName];
+
+    if (!state.hasImageSize && !state.imageSizeLookedUp)
+    {
+        // Thumbnails from previous sessions are carrying the size of their image
+        state.imageSizeLookedUp = true;
+
+        auto imagePath = getCacheableImagePath(getEditorImageSource(materialName));
+        ThumbnailImage header;
+
+        if (!imagePath.empty() && _diskCache->loadHeader(imagePath, header))
+        {
+            state.hasImageSize = true;
+            state.imageWidth = header.imageWidth;
+            state.imageHeight = header.imageHeight;
+        }
+    }
+
+    if (!state.hasImageSize) return false;
+
+    width = state.imageWidth;
+    height = state.imageHeight;
+    return true;
+}
+
+std::size_t ThumbnailManager::getNumPages() const
+{
+    return _atlas->getNumPages();
+}
+
+ImagePtr ThumbnailManager::getPage(std::size_t index) const
+{
+    return _atlas->getPage(index);
+}
+
+std::size_t ThumbnailManager::getPageRevision(std::size_t index) const
+{
+    return _atlas->getPageRevision(index);
+}
+
+void ThumbnailManager::processFinishedThumbnails()
+{
+    std::vector<FinishedThumbnail> finished;
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        finished.swap(_finished);
+    }
+
+    auto changed = false;
+
+    for (auto& thumbnail : finished)
+    {
+        auto state = _materials.find(thumbnail.material);
+
+        // Ignore results of materials which have been cleared in the meantime
+        if (state == _materials.end() || state->second.status != Status::Pending) continue;
+
+        changed = true;
+
+        if (!thumbnail.succeeded)
+        {
+            state->second.status = Status::Unavailable;
+            continue;
+        }
+
+        state->second.hasImageSize = true;
+        state->second.imageWidth = thumbnail.image.imageWidth;
+        state->second.imageHeight = thumbnail.image.imageHeight;
+
+        std::vector<std::string> evicted;
+
+        auto inserted = _atlas->insert(thumbnail.material, thumbnail.image,
+            [this](const std::string& key) { return _requested.count(key) == 0; }, evicted);
+
+        // If the atlas is full of requested thumbnails, this one needs to be requested again
+        state->second.status = inserted ? Status::Ready : Status::NotRequested;
+
+        for (const auto& material : evicted)
+        {
+            _materials[material].status = Status::NotRequested;
+        }
+    }
+
+    if (changed)
+    {
+        _sigThumbnailsChanged.emit();
+    }
+}
+
+void ThumbnailManager::waitForPendingThumbnails()
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    _idle.wait(lock, [this]() { return _queue.empty() && _activeJobs == 0; });
+}
+
+void ThumbnailManager::setThumbnailLoadNotifier(const std::function<void()>& notifier)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    _thumbnailLoadNotifier = notifier;
+}
+
+sigc::signal<void>& ThumbnailManager::signal_thumbnailsChanged()
+{
+    return _sigThumbnailsChanged;
+}
+
+void ThumbnailManager::startWorkers()
+{
+    // Leave one core to the main thread
+    auto numWorkers = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 2u) - 1, MAX_WORKERS);
+
+    for (std::size_t i = 0; i < numWorkers; ++i)
+    {
+        _workers.emplace_back(&ThumbnailManager::processQueue, this);
+    }
+}
+
+void ThumbnailManager::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        _shutdown = true;
+        _queue.clear();
+    }
+
+    _queueChanged.notify_all();
+
+    for (auto& worker : _workers)
+    {
+        worker.join();
+    }
+
+    _workers.clear();
+    _shutdown = false;
+}
+
+void ThumbnailManager::processQueue()
+{
+    while (true)
+    {
+        Job job;
+
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            _queueChanged.wait(lock, [this]() { return _shutdown || !_queue.empty(); });
+
+            if (_shutdown) return;
+
+            job = std::move(_queue.front());
+            _queue.pop_front();
+            ++_activeJobs;
+        }
+
+        FinishedThumbnail thumbnail{ job.material, false };
+
+        try
+        {
+            thumbnail.succeeded = generateThumbnail(job.source, thumbnail.image);
+        }
+        catch (const std::exception& ex)
+        {
+            rError() << "Failed to generate thumbnail of " << job.material << ": " << ex.what() << std::endl;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+
+            _finished.emplace_back(std::move(thumbnail));
+            --_activeJobs;
+
+            // Only the first thumbnail of a batch needs to be announced,
+            // processFinishedThumbnails() picks up all of them at once
+            if (_finished.size() == 1 && _thumbnailLoadNotifier)
+            {
+                _thumbnailLoadNotifier();
+            }
+        }
+
+        _idle.notify_all();
+    }
+}
+
+bool ThumbnailManager::generateThumbnail(const MapExpressionPtr& source, ThumbnailImage& thumbnail)
+{
+    auto imagePath = getCacheableImagePath(source);
+
+    if (!imagePath.empty() && _diskCache->load(imagePath, thumbnail))
+    {
+        return true;
+    }
+
+    auto image = source->getImage();
+
+    // Compressed images would need to be decoded first, these are drawn from the editor image instead
+    if (!image || image->isPrecompressed() || image->getGLFormat() != GL_RGBA ||
+        image->getWidth() == 0 || image->getHeight() == 0)
+    {
+        return false;
+    }
+
+    downsampleImage(*image, THUMBNAIL_SIZE, thumbnail);
+
+    if (!imagePath.empty())
+    {
+        _diskCache->store(imagePath, thumbnail);
+    }
+
+    return true;
+}
+
+void ThumbnailManager::clear()
+{
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        // Running jobs are finishing, their results are ignored
+        _queue.clear();
+        _finished.clear();
+    }
+
+    _idle.notify_all();
+
+    _materials.clear();
+    _requested.clear();
+    _atlas->clear();
+
+    _sigThumbnailsChanged.emit();
+}
+
+std::string ThumbnailManager::getName() const
+{
+    static std::string _name(MODULE_THUMBNAILMANAGER);
+    return _name;
+}
+
+StringSet ThumbnailManager::getDependencies() const
+{
+    static StringSet _dependencies
+    {
+        MODULE_SHADERSYSTEM,
+        MODULE_IMAGELOADER,
+        MODULE_VIRTUALFILESYSTEM,
+        MODULE_DECLMANAGER,
+    };
+
+    return _dependencies;
+}
+
+void ThumbnailManager::initialiseModule(const IApplicationContext& ctx)
+{
+    _atlas = std::make_unique<ThumbnailAtlas>(ATLAS_PAGE_SIZE, THUMBNAIL_SIZE, MAX_ATLAS_PAGES);
+    _diskCache = std::make_unique<ThumbnailCache>(ctx.getCacheDataPath() + "thumbnails/");
+
+    // Editor images might be different after reloading the materials
+    _materialsReloadedConn = GlobalDeclarationManager().signal_DeclsReloaded(decl::Type::Material)
+        .connect(sigc::mem_fun(this, &ThumbnailManager::clear));
+}
+
+void ThumbnailManager::shutdownModule()
+{
+    _materialsReloadedConn.disconnect();
+
+    // Stop the workers before the image loaders are going away
+    stopWorkers();
+
+    _finished.clear();
+    _materials.clear();
+    _atlas.reset();
+    _diskCache.reset();
+}
+
+// Static module instance
+module::StaticModuleRegistration<ThumbnailManager> thumbnailManagerModule;
+
+}
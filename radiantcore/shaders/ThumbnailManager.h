@@ -0,0 +1,119 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+#include <sigc++/connection.h>
+#include "ithumbnails.h"
+#include "MapExpression.h"
+#include "ThumbnailAtlas.h"
+#include "ThumbnailCache.h"
+
+namespace shaders
+{
+
+/**
+ * Thumbnail manager decoding the editor images of the requested materials
+ * on a pool of worker threads. Thumbnails are looked up in the disk cache
+ * first, freshly generated ones are written to it.
+ *
+ * The atlas and the material states are only accessed by the main thread,
+ * the workers are just filling the list of finished thumbnails.
+ */
+class ThumbnailManager final :
+    public IThumbnailManager
+{
+private:
+    struct MaterialState
+    {
+        Status status = Status::NotRequested;
+
+        // Whether the size of the full image is known
+        bool hasImageSize = false;
+
+        // Whether the disk cache has been asked for the image size already
+        bool imageSizeLookedUp = false;
+
+        std::size_t imageWidth = 0;
+        std::size_t imageHeight = 0;
+    };
+
+    std::map<std::string, MaterialState> _materials;
+
+    // The materials of the most recent request, these are not evicted from the atlas
+    std::set<std::string> _requested;
+
+    std::unique_ptr<ThumbnailAtlas> _atlas;
+    std::unique_ptr<ThumbnailCache> _diskCache;
+
+    struct Job
+    {
+        std::string material;
+        MapExpressionPtr source;
+    };
+
+    struct FinishedThumbnail
+    {
+        std::string material;
+        bool succeeded;
+        ThumbnailImage image;
+    };
+
+    std::mutex _lock;
+    std::condition_variable _queueChanged;
+    std::condition_variable _idle;
+
+    std::deque<Job> _queue;
+    std::size_t _activeJobs;
+    std::vector<FinishedThumbnail> _finished;
+
+    std::vector<std::thread> _workers;
+    bool _shutdown;
+
+    // Called with the lock held, such that it can be exchanged at any time
+    std::function<void()> _thumbnailLoadNotifier;
+
+    sigc::signal<void> _sigThumbnailsChanged;
+
+    sigc::connection _materialsReloadedConn;
+
+public:
+    ThumbnailManager();
+
+    std::size_t getThumbnailSize() const override;
+    void requestThumbnails(const std::vector<std::string>& materialNames) override;
+    Status getThumbnail(const std::string& materialName, Thumbnail& thumbnail) override;
+    bool getImageSize(const std::string& materialName, std::size_t& width, std::size_t& height) override;
+    std::size_t getNumPages() const override;
+    ImagePtr getPage(std::size_t index) const override;
+    std::size_t getPageRevision(std::size_t index) const override;
+    void processFinishedThumbnails() override;
+    void waitForPendingThumbnails() override;
+    void setThumbnailLoadNotifier(const std::function<void()>& notifier) override;
+    sigc::signal<void>& signal_thumbnailsChanged() override;
+
+    // RegisterableModule implementation
+    std::string getName() const override;
+    StringSet getDependencies() const override;
+    void initialiseModule(const IApplicationContext& ctx) override;
+    void shutdownModule() override;
+
+private:
+    void startWorkers();
+    void stopWorkers();
+    void processQueue();
+
+    // Produces the thumbnail on a worker thread, returns false if the image can't be downsampled
+    bool generateThumbnail(const MapExpressionPtr& source, ThumbnailImage& thumbnail);
+
+    // Discards all states and thumbnails
+    void clear();
+};
+
+}
@@ -2,6 +2,7 @@
 
 #include "iundo.h"
 
+#include <functional>
 #include <list>
 #include <memory>
 #include <string>
@@ -40,6 +41,21 @@ private:
 			_undoable.importState(_data);
 		}
 
+        std::size_t getMemoryUsage() const
+        {
+            return sizeof(*this) + (_data ? _data->getMemoryUsage() : 0);
+        }
+
+        const IUndoable& getUndoable() const
+        {
+            return _undoable;
+        }
+
+        void compact()
+        {
+            _data = _undoable.compactState(_data);
+        }
+
         void notifyOperationRestored()
         {
             _undoable.onOperationRestored();
@@ -52,11 +68,15 @@ private:
 	// The name of the UndoOperaton
 	std::string _command;
 
+    // The accumulated size of all recorded states
+    std::size_t _memoryUsage;
+
 public:
     using Ptr = std::shared_ptr<Operation>;
 
 	Operation(const std::string& command) :
-		_command(command)
+		_command(command),
+        _memoryUsage(sizeof(Operation))
 	{}
 
 	const std::string& getName() const
@@ -79,8 +99,34 @@ public:
 		// Record the state of the given undable and push it to the snapshot
 		// The order is relevant, we add to the front
 		_snapshot.emplace_front(undoable);
+
+        // Account for the list node holding the state too
+        _memoryUsage += _snapshot.front().getMemoryUsage() + 2 * sizeof(void*);
 	}
 
+    // Returns the approximate number of bytes occupied by this operation
+    std::size_t getMemoryUsage() const
+    {
+        return _memoryUsage;
+    }
+
+    // Lets the undoables replace their recorded states by deltas against their
+    // current state. Undoables that don't pass the given test are left alone.
+    void compact(const std::function<bool(const IUndoable&)>& canCompact)
+    {
+        _memoryUsage = sizeof(Operation);
+
+        for (auto& state : _snapshot)
+        {
+            if (canCompact(state.getUndoable()))
+            {
+                state.compact();
+            }
+
+            _memoryUsage += state.getMemoryUsage() + 2 * sizeof(void*);
+        }
+    }
+
 	void restoreSnapshot()
 	{
         // Walk through the snapshot front-to-back, the most recently added one is at the front
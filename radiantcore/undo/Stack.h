@@ -2,6 +2,7 @@
 
 #include "debugging/debugging.h"
 #include <list>
+#include <functional>
 #include "Operation.h"
 
 namespace undo
@@ -28,6 +29,9 @@ private:
 	// The pending undo operation (will be committed on finish, if not empty)
     Operation::Ptr _pending;
 
+    // The summed up memory usage of all operations in the stack
+    std::size_t _memoryUsage = 0;
+
 public:
 
 	bool empty() const
@@ -52,19 +56,37 @@ public:
 
 	void pop_front()
 	{
+        _memoryUsage -= _stack.front()->getMemoryUsage();
 		_stack.pop_front();
 	}
 
 	void pop_back()
 	{
+        _memoryUsage -= _stack.back()->getMemoryUsage();
 		_stack.pop_back();
 	}
 
 	void clear()
 	{
 		_stack.clear();
+        _memoryUsage = 0;
 	}
 
+    // Returns the approximate number of bytes occupied by the operations in this stack
+    std::size_t getMemoryUsage() const
+    {
+        return _memoryUsage;
+    }
+
+    // Visit each operation, starting with the oldest one
+    void foreachOperation(const std::function<void(const Operation&)>& functor) const
+    {
+        for (const auto& operation : _stack)
+        {
+            functor(*operation);
+        }
+    }
+
 	// Allocate a new Operation to work with
 	void start(const std::string& command)
 	{
@@ -83,8 +105,9 @@ public:
         _pending.reset();
     }
 
-	// Finish the current undo operation
-	bool finish(const std::string& command)
+	// Finish the current undo operation, the recorded states of all undoables
+	// passing the given test are compacted against their current state
+	bool finish(const std::string& command, const std::function<bool(const IUndoable&)>& canCompact)
 	{
 		if (!_pending || _pending->empty())
 		{
@@ -96,8 +119,10 @@ public:
 		
 		// Rename the last undo operation (it may be "unnamed" till now)
         _pending->setName(command);
+        _pending->compact(canCompact);
 
         // Move the pending operation into its place
+        _memoryUsage += _pending->getMemoryUsage();
         _stack.emplace_back(std::move(_pending));
 		return true;
 	}
@@ -12,7 +12,8 @@ namespace undo
 
 UndoSystem::UndoSystem() :
 	_activeUndoStack(nullptr),
-	_undoLevels(RKEY_UNDO_QUEUE_SIZE)
+	_undoLevels(RKEY_UNDO_QUEUE_SIZE),
+	_memoryLimit(RKEY_UNDO_MEMORY_LIMIT)
 {}
 
 UndoSystem::~UndoSystem()
@@ -66,6 +67,8 @@ void UndoSystem::finish(const std::string& command)
 {
 	if (finishUndo(command))
     {
+        enforceMemoryLimit();
+
 		rMessage() << command << std::endl;
         _eventSignal.emit(EventType::OperationRecorded, command);
 	}
@@ -132,6 +135,40 @@ void UndoSystem::clear()
 	// there are some "persistent" observers like EntityInspector and ShaderClipboard
 }
 
+std::size_t UndoSystem::getMemoryUsage() const
+{
+    return _undoStack.getMemoryUsage() + _redoStack.getMemoryUsage();
+}
+
+void UndoSystem::foreachUndoOperation(const std::function<void(const std::string&, std::size_t)>& functor) const
+{
+    _undoStack.foreachOperation([&](const Operation& operation)
+    {
+        functor(operation.getName(), operation.getMemoryUsage());
+    });
+}
+
+void UndoSystem::enforceMemoryLimit()
+{
+    auto limit = _memoryLimit.get() * 1024 * 1024;
+
+    if (limit == 0) return;
+
+    // Drop the oldest operations first, but always keep the most recent one,
+    // even if it exceeds the limit on its own
+    while (_undoStack.size() > 1 && getMemoryUsage() > limit)
+    {
+        _undoStack.pop_front();
+    }
+}
+
+bool UndoSystem::isConnected(const IUndoable& undoable) const
+{
+    // Undoables that have been released in the meantime (like faces removed
+    // from a brush) may not be around anymore, keep their full state
+    return _undoables.count(const_cast<IUndoable*>(&undoable)) > 0;
+}
+
 sigc::signal<void(IUndoSystem::EventType, const std::string&)>& UndoSystem::signal_undoEvent()
 {
     return _eventSignal;
@@ -145,7 +182,7 @@ void UndoSystem::startUndo()
 
 bool UndoSystem::finishUndo(const std::string& command)
 {
-	bool changed = _undoStack.finish(command);
+	bool changed = _undoStack.finish(command, [this](const IUndoable& undoable) { return isConnected(undoable); });
 	setActiveUndoStack(nullptr);
 	return changed;
 }
@@ -158,7 +195,7 @@ void UndoSystem::startRedo()
 
 bool UndoSystem::finishRedo(const std::string& command)
 {
-	bool changed = _redoStack.finish(command);
+	bool changed = _redoStack.finish(command, [this](const IUndoable& undoable) { return isConnected(undoable); });
 	setActiveUndoStack(nullptr);
 	return changed;
 }
@@ -15,6 +15,7 @@ namespace undo
 {
 
 constexpr const char* const RKEY_UNDO_QUEUE_SIZE = "user/ui/undo/queueSize";
+constexpr const char* const RKEY_UNDO_MEMORY_LIMIT = "user/ui/undo/memoryLimit";
 
 /**
 * greebo: The UndoSystem (interface: iundo.h) is maintaining two internal
@@ -48,6 +49,9 @@ private:
 
     registry::CachedKey<std::size_t> _undoLevels;
 
+    // The maximum memory the undo history may occupy (in MB), 0 == unlimited
+    registry::CachedKey<std::size_t> _memoryLimit;
+
     sigc::signal<void(EventType, const std::string&)> _eventSignal;
 
 public:
@@ -68,6 +72,9 @@ public:
 
 	void clear() override;
 
+    std::size_t getMemoryUsage() const override;
+    void foreachUndoOperation(const std::function<void(const std::string&, std::size_t)>& functor) const override;
+
     sigc::signal<void(EventType, const std::string&)>& signal_undoEvent() override;
 
 private:
@@ -79,6 +86,12 @@ private:
 
 	// Assigns the given stack to all of the Undoables listed in the map
 	void setActiveUndoStack(UndoStack* stack);
+
+    // Discards the oldest undo operations until the memory limit is satisfied
+    void enforceMemoryLimit();
+
+    // Returns true if the given undoable is still registered with this system
+    bool isConnected(const IUndoable& undoable) const;
 };
 
 }
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace registry
+{
+
+/**
+ * Hashed map of registry keys to the values returned by Registry::get(),
+ * sparing repeated reads of the same key the XPath evaluation.
+ *
+ * The map is an immutable snapshot which is replaced as a whole (copy-on-write),
+ * readers never take a lock. Any change to the registry trees invalidates the
+ * snapshot, the values are looked up again on their next read. Every snapshot
+ * carries a generation number, values read from the trees before an invalidation
+ * are discarded instead of being inserted into the newer snapshot.
+ */
+class RegistryValueCache final
+{
+public:
+    struct Snapshot
+    {
+        std::size_t generation = 0;
+        std::unordered_map<std::string, std::string> values;
+    };
+    using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+private:
+    // Only accessed through the atomic shared_ptr functions
+    SnapshotPtr _snapshot;
+
+    std::atomic<std::size_t> _hits;
+
+public:
+    RegistryValueCache() :
+        _snapshot(std::make_shared<Snapshot>()),
+        _hits(0)
+    {}
+
+    // Only plain paths like "user/ui/map/numMRU" are cached, anything using
+    // XPath syntax like predicates, wildcards or axes is always evaluated.
+    static bool IsPlainKey(const std::string& key)
+    {
+        return !key.empty() && key.front() != '/' &&
+            key.find_first_of("[]@*()|=:'\" ") == std::string::npos &&
+            key.find("//") == std::string::npos && key.find("..") == std::string::npos;
+    }
+
+    SnapshotPtr getSnapshot() const
+    {
+        return std::atomic_load(&_snapshot);
+    }
+
+    // Returns true and sets the value if the key is present in the given snapshot
+    bool lookup(const SnapshotPtr& snapshot, const std::string& key, std::string& value)
+    {
+        auto found = snapshot->values.find(key);
+
+        if (found == snapshot->values.end())
+        {
+            return false;
+        }
+
+        ++_hits;
+        value = found->second;
+        return true;
+    }
+
+    // Adds the value read from the trees while the given snapshot was current.
+    // The value is dropped if the cache has been invalidated in the meantime.
+    void insert(SnapshotPtr snapshot, const std::string& key, const std::string& value)
+    {
+        auto generation = snapshot->generation;
+
+        while (snapshot->generation == generation)
+        {
+            auto newSnapshot = std::make_shared<Snapshot>(*snapshot);
+            newSnapshot->values[key] = value;
+
+            // Retry with the current snapshot if another reader got there first
+            if (std::atomic_compare_exchange_weak(&_snapshot, &snapshot, SnapshotPtr(std::move(newSnapshot))))
+            {
+                return;
+            }
+        }
+    }
+
+    // Discards all cached values, to be called after the trees have been changed
+    void invalidate()
+    {
+        auto snapshot = getSnapshot();
+        auto newSnapshot = std::make_shared<Snapshot>();
+
+        do
+        {
+            newSnapshot->generation = snapshot->generation + 1;
+        }
+        while (!std::atomic_compare_exchange_weak(&_snapshot, &snapshot, SnapshotPtr(newSnapshot)));
+    }
+
+    // Number of reads answered by the cache
+    std::size_t getHitCount() const
+    {
+        return _hits;
+    }
+};
+
+}
@@ -26,7 +26,8 @@ XMLRegistry::XMLRegistry() :
 
 void XMLRegistry::shutdown()
 {
-    rMessage() << "XMLRegistry Shutdown: " << _queryCounter << " queries processed." << std::endl;
+    rMessage() << "XMLRegistry Shutdown: " << _queryCounter << " queries processed, " <<
+        _valueCache.getHitCount() << " reads answered from the key cache." << std::endl;
 
     saveToDisk();
 
@@ -83,6 +84,14 @@ void XMLRegistry::saveToDisk()
 }
 
 xml::NodeList XMLRegistry::findXPath(const std::string& path)
+{
+    // The caller might modify the returned nodes
+    _valueCache.invalidate();
+
+    return queryTrees(path);
+}
+
+xml::NodeList XMLRegistry::queryTrees(const std::string& path)
 {
     // Query the user tree first
     xml::NodeList results = _userTree.findXPath(path);
@@ -115,10 +124,15 @@ sigc::signal<void> XMLRegistry::signalForKey(const std::string& key) const
     return _keySignals[key]; // will return existing or default-construct
 }
 
+std::size_t XMLRegistry::getXPathQueryCount() const
+{
+    return _queryCounter;
+}
+
 bool XMLRegistry::keyExists(const std::string& key)
 {
-    // Pass the query on to findXPath which queries the subtrees
-    xml::NodeList result = findXPath(key);
+    // Pass the query on to the subtrees
+    xml::NodeList result = queryTrees(key);
     return !result.empty();
 }
 
@@ -134,6 +148,7 @@ void XMLRegistry::deleteXPath(const std::string& path)
     if (numDeletedNodes > 0)
     {
         _changesSinceLastSave++;
+        _valueCache.invalidate();
     }
 }
 
@@ -147,6 +162,9 @@ xml::Node XMLRegistry::createKeyWithName(const std::string& path,
 
     _changesSinceLastSave++;
 
+    // The caller is going to modify the returned node
+    _valueCache.invalidate();
+
     // The key will be created in the user tree (the default tree is read-only)
     return _userTree.createKeyWithName(path, key, name);
 }
@@ -159,6 +177,9 @@ xml::Node XMLRegistry::createKey(const std::string& key)
 
     _changesSinceLastSave++;
 
+    // The caller is going to modify the returned node
+    _valueCache.invalidate();
+
     return _userTree.createKey(key);
 }
 
@@ -172,12 +193,15 @@ void XMLRegistry::setAttribute(const std::string& path,
     _changesSinceLastSave++;
 
     _userTree.setAttribute(path, attrName, attrValue);
+
+    // The value attribute is read by get()
+    _valueCache.invalidate();
 }
 
 std::string XMLRegistry::getAttribute(const std::string& path, const std::string& attrName)
 {
-    // Pass the query to the findXPath method, which queries the user tree first
-    if (xml::NodeList nodeList = findXPath(path); !nodeList.empty()) {
+    // Pass the query to the trees, the user tree is queried first
+    if (xml::NodeList nodeList = queryTrees(path); !nodeList.empty()) {
         return nodeList[0].getAttributeValue(attrName);
     }
     return std::string();
@@ -185,7 +209,26 @@ std::string XMLRegistry::getAttribute(const std::string& path, const std::string
 
 std::string XMLRegistry::get(const std::string& key)
 {
-    if (const xml::NodeList nodeList = findXPath(key); !nodeList.empty()) {
+    if (!RegistryValueCache::IsPlainKey(key))
+    {
+        return readValue(key);
+    }
+
+    auto snapshot = _valueCache.getSnapshot();
+    std::string value;
+
+    if (!_valueCache.lookup(snapshot, key, value))
+    {
+        value = readValue(key);
+        _valueCache.insert(snapshot, key, value);
+    }
+
+    return value;
+}
+
+std::string XMLRegistry::readValue(const std::string& key)
+{
+    if (const xml::NodeList nodeList = queryTrees(key); !nodeList.empty()) {
         if (const auto content = nodeList[0].getContent(); !content.empty()) {
             return string::utf8_to_mb(content);
         }
@@ -208,6 +251,9 @@ void XMLRegistry::set(const std::string& key, const std::string& value)
         _userTree.set(key, string::mb_to_utf8(value));
 
         _changesSinceLastSave++;
+
+        // Observers reading the key need to see the new value
+        _valueCache.invalidate();
     }
 
     // Notify the observers
@@ -231,6 +277,7 @@ void XMLRegistry::import(const std::string& importFilePath, const std::string& p
     }
 
     _changesSinceLastSave++;
+    _valueCache.invalidate();
 }
 
 void XMLRegistry::emitSignalForKey(const std::string& changedKey)
@@ -22,11 +22,13 @@
  */
 
 #include "iregistry.h"
+#include <atomic>
 #include <map>
 #include <mutex>
 
 #include "imodule.h"
 #include "RegistryTree.h"
+#include "RegistryValueCache.h"
 #include "time/Timer.h"
 
 namespace settings { class SettingsManager; }
@@ -50,8 +52,11 @@ private:
 	// Note: this tree is queried first for a given key
 	RegistryTree _userTree;
 
-	// The query counter for some statistics :)
-	unsigned int _queryCounter;
+	// The number of XPath queries evaluated against the trees
+	std::atomic<std::size_t> _queryCounter;
+
+	// Values of plain keys, spares get() the XPath evaluation
+	RegistryValueCache _valueCache;
 
 	// Change tracking counter, is reset when saveToDisk() is called
 	unsigned int _changesSinceLastSave;
@@ -124,12 +129,20 @@ public:
 
 	sigc::signal<void> signalForKey(const std::string& key) const override;
 
+	std::size_t getXPathQueryCount() const override;
+
 	// RegisterableModule implementation
 	std::string getName() const override { return MODULE_XMLREGISTRY; }
 	void initialiseModule(const IApplicationContext& ctx) override;
 	void shutdownModule() override;
 
 private:
+	// Evaluates the given XPath against the user tree, then the default tree
+	xml::NodeList queryTrees(const std::string& path);
+
+	// Reads the value of the given key from the trees
+	std::string readValue(const std::string& key);
+
 	void loadUserFileFromSettingsPath(const settings::SettingsManager& settingsManager,
 		const std::string& filename, const std::string& baseXPath);
 
@@ -8,6 +8,10 @@
 #include "scene/filters/FilterGroup.h"
 #include "scenelib.h"
 #include "xmlutil/Document.h"
+#include "ibrush.h"
+#include "ishaders.h"
+#include "algorithm/Primitives.h"
+#include "algorithm/Scene.h"
 
 namespace test
 {
@@ -360,4 +364,52 @@ TEST_F(FilterTest, OnFiltersChangedInvoked)
     EXPECT_EQ(testNode->onFiltersChangedInvocationCount, 1) << "Node should have been notified";
 }
 
+TEST_F(FilterTest, ToggledFilterUpdatesPrimitivesUsingItsMaterials)
+{
+    // Loading the map runs a full update, toggling filters afterwards is evaluated incrementally
+    loadMap("primitives_with_clip_material.map");
+
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto clipBrush = algorithm::findFirstBrushWithMaterial(worldspawn, "textures/common/clip");
+    auto caulkBrush = algorithm::createCubicBrush(worldspawn, Vector3(512, 0, 0), "textures/common/caulk");
+
+    GlobalFilterSystem().setFilterState("Clip Textures", true);
+
+    EXPECT_TRUE(clipBrush->isFiltered()) << "Clip brush should be filtered";
+    EXPECT_FALSE(caulkBrush->isFiltered()) << "Caulk brush should not be affected";
+
+    GlobalFilterSystem().setFilterState("Clip Textures", false);
+
+    EXPECT_FALSE(clipBrush->isFiltered()) << "Clip brush should be visible again";
+
+    // Changing the material needs to be picked up by the next toggle
+    Node_getIBrush(caulkBrush)->setShader("textures/common/clip");
+
+    GlobalFilterSystem().setFilterState("Clip Textures", true);
+
+    EXPECT_TRUE(clipBrush->isFiltered()) << "Clip brush should be filtered";
+    EXPECT_TRUE(caulkBrush->isFiltered()) << "Former caulk brush should be filtered now";
+
+    GlobalFilterSystem().setFilterState("Clip Textures", false);
+
+    // Materials the map doesn't contain have not been evaluated by the full update
+    auto playerClipBrush = algorithm::createCubicBrush(worldspawn, Vector3(1024, 0, 0), "textures/common/player_clip");
+    auto monsterClipPatch = algorithm::createPatchFromBounds(worldspawn,
+        AABB(Vector3(1536, 0, 0), Vector3(64, 64, 64)), "textures/common/monster_clip");
+
+    EXPECT_FALSE(playerClipBrush->isFiltered()) << "Player clip brush should be visible";
+    EXPECT_FALSE(monsterClipPatch->isFiltered()) << "Monster clip patch should be visible";
+
+    GlobalFilterSystem().setFilterState("Clip Textures", true);
+
+    EXPECT_TRUE(playerClipBrush->isFiltered()) << "Brush with a new clip material should be filtered";
+    EXPECT_TRUE(monsterClipPatch->isFiltered()) << "Patch with a new clip material should be filtered";
+    EXPECT_FALSE(GlobalMaterialManager().getMaterial("textures/common/player_clip")->isVisible());
+
+    GlobalFilterSystem().setFilterState("Clip Textures", false);
+
+    EXPECT_FALSE(playerClipBrush->isFiltered()) << "Player clip brush should be visible again";
+    EXPECT_FALSE(monsterClipPatch->isFiltered()) << "Monster clip patch should be visible again";
+}
+
 }
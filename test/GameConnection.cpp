@@ -0,0 +1,231 @@
+#include "RadiantTest.h"
+
+#include <thread>
+#include <chrono>
+#include "imap.h"
+#include "scenelib.h"
+#include "scene/EntityNode.h"
+#include "algorithm/Entity.h"
+#include "string/predicate.h"
+
+#include "AutomationEngine.h"
+#include "MapObserver.h"
+#include "MapUpdater.h"
+#include "MessageTcp.h"
+#include "clsocket/PassiveSocket.h"
+
+namespace test
+{
+
+namespace
+{
+
+constexpr int TAG_MAPUPDATE = 8;
+
+// Plays the part of the game: listens on a free port, accepts
+// the editor's connection and reads and answers framed messages.
+class StubGameServer
+{
+private:
+    CPassiveSocket _listener;
+    gameconn::MessageTcp _connection;
+
+public:
+    // Listens on a port picked by the system, see getPort()
+    bool listen()
+    {
+        return _listener.Initialize() && _listener.Listen("127.0.0.1", 0);
+    }
+
+    // The port the listener has been bound to
+    int getPort()
+    {
+        sockaddr_in address;
+        socklen_t length = sizeof(address);
+
+        if (getsockname(_listener.GetSocketDescriptor(), reinterpret_cast<sockaddr*>(&address), &length) != 0)
+        {
+            return 0;
+        }
+
+        return ntohs(address.sin_port);
+    }
+
+    bool accept()
+    {
+        std::unique_ptr<CActiveSocket> socket(_listener.Accept());
+
+        if (!socket || !socket->SetNonblocking()) return false;
+
+        _connection.init(std::move(socket));
+        return _connection.isAlive();
+    }
+
+    // Waits for the given number of messages to arrive, returns the ones received
+    std::vector<std::string> receive(std::size_t count)
+    {
+        std::vector<std::string> messages;
+        std::vector<char> message;
+
+        for (int attempt = 0; attempt < 5000 && messages.size() < count && _connection.isAlive(); ++attempt)
+        {
+            while (messages.size() < count && _connection.readMessage(message))
+            {
+                messages.emplace_back(message.begin(), message.end());
+            }
+
+            if (messages.size() < count)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+
+        return messages;
+    }
+
+    void respond(int seqno, const std::string& content)
+    {
+        auto message = "response " + std::to_string(seqno) + "\n" + content;
+        _connection.writeMessage(message.data(), static_cast<int>(message.size()));
+    }
+};
+
+EntityNodePtr createNamedEntity(const std::string& name)
+{
+    auto entity = algorithm::createEntityByClassName("func_static");
+    entity->getEntity().setKeyValue("name", name);
+    scene::addNodeToContainer(entity, GlobalMapModule().getRoot());
+    return entity;
+}
+
+// Parses the "seqno N" line the AutomationEngine puts in front of each request
+int getSeqno(const std::string& request)
+{
+    int seqno = -1;
+    sscanf(request.c_str(), "seqno %d\n", &seqno);
+    return seqno;
+}
+
+}
+
+using GameConnectionTest = RadiantTest;
+
+TEST_F(GameConnectionTest, MapUpdateIsSentAsDiffRequests)
+{
+    StubGameServer game;
+    ASSERT_TRUE(game.listen()) << "Cannot listen on a local port";
+
+    gameconn::AutomationEngine engine;
+    ASSERT_TRUE(engine.connect(game.getPort()));
+    ASSERT_TRUE(game.accept());
+
+    auto first = createNamedEntity("hotreload_first");
+    auto second = createNamedEntity("hotreload_second");
+
+    gameconn::MapObserver observer;
+    observer.setEnabled(true);
+
+    first->getEntity().setKeyValue("origin", "16 0 0");
+    second->getEntity().setKeyValue("origin", "32 0 0");
+    EXPECT_EQ(observer.getChanges().size(), 2);
+
+    // Use a tiny request size, every entity goes into its own request
+    gameconn::MapUpdater updater(engine, observer, TAG_MAPUPDATE, 1);
+    updater.sendChanges();
+
+    EXPECT_TRUE(observer.getChanges().empty()) << "Changes should be taken when sending";
+
+    // Both requests are sent right away, without waiting for a response
+    auto requests = game.receive(2);
+    ASSERT_EQ(requests.size(), 2);
+
+    const std::string expectedHeader =
+        "message \"action\"\n"
+        "action \"reloadmap-diff\"\n"
+        "content:\n"
+        "// diff 1\n"
+        "modify entity\n"
+        "{\n";
+
+    // The changes are sent in the order of the entity names
+    for (const auto& [request, entityName, origin] : {
+        std::make_tuple(requests[0], "hotreload_first", "16 0 0"),
+        std::make_tuple(requests[1], "hotreload_second", "32 0 0") })
+    {
+        auto header = request.find('\n') + 1;
+        EXPECT_EQ(request.substr(header, expectedHeader.size()), expectedHeader) << request;
+        EXPECT_NE(request.find("\"name\" \"" + std::string(entityName) + "\"\n"), std::string::npos) << request;
+        EXPECT_NE(request.find("\"origin\" \"" + std::string(origin) + "\"\n"), std::string::npos) << request;
+        EXPECT_TRUE(string::ends_with(request, "}\n")) << request;
+    }
+
+    // The game applies the first diff only
+    game.respond(getSeqno(requests[0]), "HotReload: SUCCESS\n");
+    game.respond(getSeqno(requests[1]), "HotReload: FAILED\n");
+
+    engine.waitForTags(1 << TAG_MAPUPDATE);
+
+    // The entity of the failed request is pending again
+    EXPECT_EQ(observer.getChanges().size(), 1);
+    EXPECT_EQ(observer.getChanges().count("hotreload_second"), 1);
+
+    observer.setEnabled(false);
+    engine.disconnect(true);
+}
+
+TEST_F(GameConnectionTest, RemovedEntityIsSentAsStub)
+{
+    StubGameServer game;
+    ASSERT_TRUE(game.listen()) << "Cannot listen on a local port";
+
+    gameconn::AutomationEngine engine;
+    ASSERT_TRUE(engine.connect(game.getPort()));
+    ASSERT_TRUE(game.accept());
+
+    auto entity = createNamedEntity("hotreload_removed");
+
+    gameconn::MapObserver observer;
+    observer.setEnabled(true);
+
+    scene::removeNodeFromParent(entity);
+
+    gameconn::MapUpdater updater(engine, observer, TAG_MAPUPDATE, 64 * 1024);
+    updater.sendChanges();
+
+    auto requests = game.receive(1);
+    ASSERT_EQ(requests.size(), 1);
+
+    // No spawnargs of removed entities are sent
+    EXPECT_NE(requests[0].find("// diff 1\nremove entity\n"), std::string::npos) << requests[0];
+    EXPECT_NE(requests[0].find("\"name\" \"hotreload_removed\""), std::string::npos) << requests[0];
+    EXPECT_EQ(requests[0].find("classname"), std::string::npos) << requests[0];
+
+    game.respond(getSeqno(requests[0]), "HotReload: SUCCESS\n");
+    engine.waitForTags(1 << TAG_MAPUPDATE);
+
+    EXPECT_TRUE(observer.getChanges().empty());
+
+    observer.setEnabled(false);
+    engine.disconnect(true);
+}
+
+TEST_F(GameConnectionTest, MapUpdateIsKeptWithoutConnection)
+{
+    auto entity = createNamedEntity("hotreload_offline");
+
+    gameconn::MapObserver observer;
+    observer.setEnabled(true);
+
+    entity->getEntity().setKeyValue("origin", "16 0 0");
+
+    gameconn::AutomationEngine engine;
+    gameconn::MapUpdater updater(engine, observer, TAG_MAPUPDATE, 64 * 1024);
+    updater.sendChanges();
+
+    // Nothing could be sent, the change is still pending
+    EXPECT_EQ(observer.getChanges().count("hotreload_offline"), 1);
+
+    observer.setEnabled(false);
+}
+
+}
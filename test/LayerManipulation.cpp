@@ -4,6 +4,8 @@
 #include "imap.h"
 #include "ilayer.h"
 #include "ifilter.h"
+#include "ientity.h"
+#include "ieclass.h"
 #include "scenelib.h"
 #include "algorithm/Primitives.h"
 #include "os/file.h"
@@ -469,6 +471,70 @@ TEST_F(LayerTest, SetLayerVisibilityWorksRecursively)
         "The parent layer visibility should have propagated down to the boards layer";
 }
 
+TEST_F(LayerTest, SetLayerVisibilityConsidersChildNodes)
+{
+    auto& layerManager = GlobalMapModule().getRoot()->getLayerManager();
+    auto entityLayerId = layerManager.createLayer("EntityLayer");
+    auto brushLayerId = layerManager.createLayer("BrushLayer");
+
+    auto entity = GlobalEntityModule().createEntity(GlobalEntityClassManager().findOrInsert("func_static", true));
+    scene::addNodeToContainer(entity, GlobalMapModule().getRoot());
+    auto brush = algorithm::createCubicBrush(entity);
+
+    entity->moveToLayer(entityLayerId);
+    brush->moveToLayer(brushLayerId);
+
+    // The entity stays visible as long as its child brush is
+    layerManager.setLayerVisibility(entityLayerId, false);
+    EXPECT_TRUE(entity->visible()) << "Entity should be visible because of its brush";
+    EXPECT_TRUE(brush->visible()) << "Brush should still be visible";
+
+    Node_setSelected(brush, true);
+
+    layerManager.setLayerVisibility(brushLayerId, false);
+    EXPECT_FALSE(brush->visible()) << "Brush should be hidden now";
+    EXPECT_FALSE(entity->visible()) << "Entity should be hidden along with its brush";
+    EXPECT_FALSE(Node_isSelected(brush)) << "Hidden brush should have been de-selected";
+
+    layerManager.setLayerVisibility(brushLayerId, true);
+    EXPECT_TRUE(brush->visible()) << "Brush should be visible again";
+    EXPECT_TRUE(entity->visible()) << "Entity should be visible again because of its brush";
+}
+
+TEST_F(LayerTest, SetLayerVisibilityFollowsMembershipChanges)
+{
+    auto& layerManager = GlobalMapModule().getRoot()->getLayerManager();
+
+    // Use an ID beyond the first 64 layers
+    auto highLayerId = layerManager.createLayer("HighLayer", 100);
+    EXPECT_EQ(highLayerId, 100) << "Test setup is wrong";
+
+    auto brush = algorithm::createCubicBrush(GlobalMapModule().findOrInsertWorldspawn());
+
+    // Change the membership of the brush while it is in the scene
+    brush->addToLayer(highLayerId);
+    brush->removeFromLayer(0);
+
+    layerManager.setLayerVisibility(highLayerId, false);
+    EXPECT_FALSE(brush->visible()) << "Brush should be hidden along with its layer";
+
+    layerManager.setLayerVisibility(highLayerId, true);
+    EXPECT_TRUE(brush->visible()) << "Brush should be visible again";
+
+    brush->moveToLayer(0);
+
+    layerManager.setLayerVisibility(highLayerId, false);
+    EXPECT_TRUE(brush->visible()) << "Brush is no longer a member of the hidden layer";
+
+    // A removed brush shouldn't be affected by layer changes
+    brush->moveToLayer(highLayerId);
+    scene::removeNodeFromParent(brush);
+
+    layerManager.setLayerVisibility(highLayerId, true);
+    layerManager.setLayerVisibility(highLayerId, false);
+    EXPECT_FALSE(brush->checkStateFlag(scene::Node::eLayered)) << "Removed brush shouldn't have been updated";
+}
+
 TEST_F(LayerTest, GetParentLayer)
 {
     auto& layerManager = GlobalMapModule().getRoot()->getLayerManager();
@@ -1,6 +1,7 @@
 #include "RadiantTest.h"
 
 #include <fstream>
+#include <set>
 #include "iundo.h"
 #include "imap.h"
 #include "imapformat.h"
@@ -1231,6 +1232,7 @@ TEST_F(MapSavingTest, AutoSaverDoesntChangeSaveCopyAsFilename)
 
     // Now trigger an autosave
     GlobalAutoSaver().performAutosave();
+    GlobalAutoSaver().waitForPendingSave();
 
     // This will (again) ask for a file name, now we check what map file name it remembered and
     // sent to the request handler as default file name
@@ -1261,6 +1263,7 @@ TEST_F(MapSavingTest, AutoSaveSnapshotsSupportRelativePaths)
 
     // Trigger an auto save now
     GlobalAutoSaver().performAutosave();
+    GlobalAutoSaver().waitForPendingSave();
 
     EXPECT_TRUE(GlobalFileSystem().openTextFile(expectedSnapshotPath)) << "Snapshot should now exist in " << expectedSnapshotPath;
 
@@ -1296,6 +1299,7 @@ TEST_F(MapSavingTest, AutoSaveSnapshotsSupportAbsolutePaths)
 
     // Trigger an auto save now
     GlobalAutoSaver().performAutosave();
+    GlobalAutoSaver().waitForPendingSave();
 
     EXPECT_TRUE(GlobalFileSystem().openTextFileInAbsolutePath(expectedSnapshotPath)) << "Snapshot should now exist in " << expectedSnapshotPath;
 
@@ -1307,6 +1311,200 @@ TEST_F(MapSavingTest, AutoSaveSnapshotsSupportAbsolutePaths)
     fs::remove(expectedSnapshotPath);
 }
 
+TEST_F(MapSavingTest, AutoSaveWritesSceneAtTimeOfSave)
+{
+    GlobalCommandSystem().executeCommand("OpenMap", std::string("maps/altar.map"));
+    checkAltarScene();
+
+    auto snapshotFolder = _context.getTemporaryDataPath() + "customsnapshots/";
+    registry::setValue(map::RKEY_AUTOSAVE_SNAPSHOTS_ENABLED, true);
+    registry::setValue(map::RKEY_AUTOSAVE_SNAPSHOTS_FOLDER, snapshotFolder);
+
+    std::string expectedSnapshotPath = snapshotFolder + "altar.0.map";
+
+    GlobalAutoSaver().performAutosave();
+
+    // Edit the scene while the snapshot might still be written
+    {
+        UndoableCommand cmd("editAfterAutosave");
+
+        auto funcStatic = algorithm::getEntityByName(GlobalMapModule().getRoot(), "func_static_66");
+        ASSERT_TRUE(funcStatic);
+        scene::removeNodeFromParent(funcStatic);
+
+        auto worldspawn = algorithm::findWorldspawn(GlobalMapModule().getRoot());
+        worldspawn->tryGetEntity()->setKeyValue("_color", "1 0 0");
+    }
+
+    GlobalAutoSaver().waitForPendingSave();
+
+    // The snapshot contains the map as it was when the autosave was triggered
+    FileSaveConfirmationHelper helper(radiant::FileSaveConfirmation::Action::DiscardChanges);
+    GlobalCommandSystem().executeCommand("OpenMap", expectedSnapshotPath);
+    checkAltarScene();
+
+    fs::remove(os::replaceExtension(expectedSnapshotPath, "darkradiant"));
+    fs::remove(expectedSnapshotPath);
+}
+
+TEST_F(MapSavingTest, AutoSaveMatchesRegularSave)
+{
+    GlobalCommandSystem().executeCommand("OpenMap", std::string("maps/altar.map"));
+    checkAltarScene();
+
+    auto snapshotFolder = _context.getTemporaryDataPath() + "comparedsnapshots/";
+    registry::setValue(map::RKEY_AUTOSAVE_SNAPSHOTS_ENABLED, true);
+    registry::setValue(map::RKEY_AUTOSAVE_SNAPSHOTS_FOLDER, snapshotFolder);
+
+    std::string snapshotPath = snapshotFolder + "altar.0.map";
+
+    GlobalAutoSaver().performAutosave();
+    GlobalAutoSaver().waitForPendingSave();
+
+    // The func_static primitives need to be written relative to their origin, like the exporter does
+    fs::path copyPath = _context.getTemporaryDataPath() + "altar_copy.map";
+    GlobalCommandSystem().executeCommand("SaveMapCopyAs", copyPath.string());
+
+    EXPECT_EQ(algorithm::loadFileToString(snapshotPath), algorithm::loadFileToString(copyPath))
+        << "Snapshot should be the same as the regularly saved map";
+
+    fs::remove(os::replaceExtension(snapshotPath, "darkradiant"));
+    fs::remove(snapshotPath);
+    fs::remove(os::replaceExtension(copyPath.string(), "darkradiant"));
+    fs::remove(copyPath);
+}
+
+TEST_F(MapSavingTest, DeduplicatedSnapshotsShareUnchangedEntities)
+{
+    GlobalCommandSystem().executeCommand("OpenMap", std::string("maps/altar.map"));
+    checkAltarScene();
+
+    auto snapshotFolder = _context.getTemporaryDataPath() + "dedupsnapshots/";
+    registry::setValue(map::RKEY_AUTOSAVE_SNAPSHOTS_ENABLED, true);
+    registry::setValue(map::RKEY_AUTOSAVE_SNAPSHOTS_DEDUPLICATED, true);
+    registry::setValue(map::RKEY_AUTOSAVE_SNAPSHOTS_FOLDER, snapshotFolder);
+
+    auto countChunks = [&]()
+    {
+        auto folder = fs::path(snapshotFolder) / "chunks";
+        return std::distance(fs::directory_iterator(folder), fs::directory_iterator());
+    };
+
+    GlobalAutoSaver().performAutosave();
+    GlobalAutoSaver().waitForPendingSave();
+
+    EXPECT_TRUE(os::fileOrDirExists(snapshotFolder + "altar.0.snapshot"));
+    EXPECT_FALSE(os::fileOrDirExists(snapshotFolder + "altar.0.map")) << "No full copy should have been written";
+
+    auto chunksAfterFirstSnapshot = countChunks();
+
+    // Change a single entity
+    {
+        UndoableCommand cmd("changeEntity");
+        algorithm::getEntityByName(GlobalMapModule().getRoot(), "func_static_66")->tryGetEntity()->setKeyValue("dummy", "1");
+    }
+
+    GlobalAutoSaver().performAutosave();
+    GlobalAutoSaver().waitForPendingSave();
+
+    EXPECT_TRUE(os::fileOrDirExists(snapshotFolder + "altar.1.snapshot"));
+
+    // The changed entity and the info file are the only new chunks
+    EXPECT_LE(countChunks() - chunksAfterFirstSnapshot, 2);
+
+    // Save a full copy of the same state for comparison
+    registry::setValue(map::RKEY_AUTOSAVE_SNAPSHOTS_DEDUPLICATED, false);
+    GlobalAutoSaver().performAutosave();
+    GlobalAutoSaver().waitForPendingSave();
+
+    auto restoredPath = snapshotFolder + "restored.map";
+    GlobalCommandSystem().executeCommand("RestoreMapSnapshot", snapshotFolder + "altar.1.snapshot", restoredPath);
+
+    ASSERT_TRUE(os::fileOrDirExists(restoredPath));
+    EXPECT_EQ(algorithm::loadFileToString(restoredPath), algorithm::loadFileToString(snapshotFolder + "altar.0.map"))
+        << "Restored snapshot should be identical to the full copy";
+
+    // The restored map comes with its info file
+    FileSaveConfirmationHelper helper(radiant::FileSaveConfirmation::Action::DiscardChanges);
+    GlobalCommandSystem().executeCommand("OpenMap", restoredPath);
+    checkAltarScene();
+    EXPECT_EQ(algorithm::getEntityByName(GlobalMapModule().getRoot(), "func_static_66")->tryGetEntity()->getKeyValue("dummy"), "1");
+
+    fs::remove_all(snapshotFolder);
+}
+
+TEST_F(MapSavingTest, DeletedSnapshotsReleaseTheirChunks)
+{
+    GlobalCommandSystem().executeCommand("OpenMap", std::string("maps/altar.map"));
+    checkAltarScene();
+
+    auto snapshotFolder = _context.getTemporaryDataPath() + "prunedsnapshots/";
+    registry::setValue(map::RKEY_AUTOSAVE_SNAPSHOTS_ENABLED, true);
+    registry::setValue(map::RKEY_AUTOSAVE_SNAPSHOTS_DEDUPLICATED, true);
+    registry::setValue(map::RKEY_AUTOSAVE_SNAPSHOTS_FOLDER, snapshotFolder);
+
+    auto chunkFolder = fs::path(snapshotFolder) / "chunks";
+
+    auto getChunks = [&]()
+    {
+        std::set<std::string> chunks;
+
+        for (const auto& entry : fs::directory_iterator(chunkFolder))
+        {
+            chunks.insert(entry.path().filename().string());
+        }
+
+        return chunks;
+    };
+
+    auto changeEntity = [](const std::string& value)
+    {
+        UndoableCommand cmd("changeEntity");
+        algorithm::getEntityByName(GlobalMapModule().getRoot(), "func_static_66")->tryGetEntity()->setKeyValue("dummy", value);
+    };
+
+    changeEntity("1");
+    GlobalAutoSaver().performAutosave();
+    GlobalAutoSaver().waitForPendingSave();
+
+    auto chunksOfFirstSnapshot = getChunks();
+
+    changeEntity("2");
+    GlobalAutoSaver().performAutosave();
+    GlobalAutoSaver().waitForPendingSave();
+
+    // Delete the first snapshot, its chunks are released with the next autosave
+    fs::remove(snapshotFolder + "altar.0.snapshot");
+
+    changeEntity("3");
+    GlobalAutoSaver().performAutosave();
+    GlobalAutoSaver().waitForPendingSave();
+
+    auto chunks = getChunks();
+
+    std::size_t sharedChunks = 0;
+
+    for (const auto& chunk : chunksOfFirstSnapshot)
+    {
+        sharedChunks += chunks.count(chunk);
+    }
+
+    EXPECT_GT(sharedChunks, 0) << "Unchanged entities should still be shared with the remaining snapshots";
+    EXPECT_LT(sharedChunks, chunksOfFirstSnapshot.size()) << "The changed entity of the deleted snapshot should be gone";
+
+    // The chunks of the remaining snapshots are all still there
+    for (auto num : { 1, 2 })
+    {
+        auto restoredPath = snapshotFolder + "restored.map";
+        GlobalCommandSystem().executeCommand("RestoreMapSnapshot",
+            snapshotFolder + "altar." + std::to_string(num) + ".snapshot", restoredPath);
+        EXPECT_TRUE(os::fileOrDirExists(restoredPath)) << "Snapshot " << num << " could not be restored";
+        fs::remove(restoredPath);
+    }
+
+    fs::remove_all(snapshotFolder);
+}
+
 namespace
 {
 
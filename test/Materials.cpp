@@ -1,14 +1,24 @@
 #include "RadiantTest.h"
 
 #include "ishaders.h"
+#include "ithumbnails.h"
+#include "ideclmanager.h"
 #include <algorithm>
+#include <atomic>
 
 #include "string/split.h"
 #include "string/case_conv.h"
 #include "string/trim.h"
 #include "string/join.h"
+#include "string/replace.h"
+#include "os/file.h"
+#include "os/fs.h"
 #include "math/MatrixUtils.h"
 #include "materials/FrobStageSetup.h"
+#include "scene/EntityNode.h"
+#include "scene/shaders/ShaderExpression.h"
+#include "scenelib.h"
+#include "algorithm/Entity.h"
 #include "testutil/TemporaryFile.h"
 
 namespace test
@@ -1458,6 +1468,97 @@ TEST_F(MaterialsTest, MaterialParserStageCondition)
     EXPECT_EQ(material->getLayer(0)->getConditionExpression()->getExpressionString(), "(parm4 > 0)");
 }
 
+TEST_F(MaterialsTest, MaterialStageConditionUsesEntityParms)
+{
+    auto material = GlobalMaterialManager().getMaterial("textures/parsertest/condition");
+    auto layer = material->getLayer(0);
+
+    auto entity = algorithm::createEntityByClassName("func_static");
+    scene::addNodeToContainer(entity, GlobalMapModule().getRoot());
+
+    layer->evaluateExpressions(0, *entity);
+    EXPECT_FALSE(layer->isVisible()) << "parm4 defaults to 0";
+
+    entity->getEntity().setKeyValue("shaderParm4", "1");
+    layer->evaluateExpressions(0, *entity);
+    EXPECT_TRUE(layer->isVisible()) << "parm4 > 0 should be fulfilled";
+
+    // Changing the condition must not keep the outcome of the previous one
+    auto copy = GlobalMaterialManager().copyMaterial(material->getName(), "textures/parsertest/condition_copy");
+    copy->getLayer(0)->evaluateExpressions(0, *entity);
+    EXPECT_TRUE(copy->getLayer(0)->isVisible()) << "parm4 > 0 should be fulfilled";
+
+    copy->getEditableLayer(0)->setConditionExpressionFromString("parm4 > 2");
+    copy->getLayer(0)->evaluateExpressions(0, *entity);
+    EXPECT_FALSE(copy->getLayer(0)->isVisible()) << "parm4 > 2 should not be fulfilled";
+}
+
+TEST_F(MaterialsTest, ShaderExpressionProgramFoldsConstants)
+{
+    auto expression = GlobalMaterialManager().createShaderExpressionFromString("(3 * 4 + global3) * time - sinTable[2 / 8]");
+
+    shaders::ExpressionProgram program;
+    program.addOutput(shaders::ShaderExpression::Compile(expression, program), 0);
+
+    EXPECT_TRUE(program.isValid());
+
+    // Only the time multiplication, the table lookup and the subtraction are left
+    EXPECT_EQ(program.getNumInstructions(), 3);
+
+    shaders::Registers registers(1);
+
+    for (auto time : { 0, 250, 2000 })
+    {
+        program.execute(time, registers);
+        EXPECT_NEAR(registers[0], expression->getValue(time), TestEpsilon) << "Evaluation differs at time " << time;
+    }
+}
+
+TEST_F(MaterialsTest, ShaderExpressionProgramCachesResultsPerParms)
+{
+    auto expression = GlobalMaterialManager().createShaderExpressionFromString("parm0 * 2 + parm5");
+
+    shaders::ExpressionProgram program;
+    program.addOutput(shaders::ShaderExpression::Compile(expression, program), 0);
+
+    auto first = algorithm::createEntityByClassName("func_static");
+    auto second = algorithm::createEntityByClassName("func_static");
+    auto third = algorithm::createEntityByClassName("func_static");
+
+    for (const auto& entity : { first, second, third })
+    {
+        scene::addNodeToContainer(entity, GlobalMapModule().getRoot());
+    }
+
+    first->getEntity().setKeyValue("_color", "0.25 0.5 0.75");
+    second->getEntity().setKeyValue("_color", "0.25 0.5 0.75");
+    third->getEntity().setKeyValue("_color", "0.5 0.5 0.75");
+    third->getEntity().setKeyValue("shaderParm5", "3");
+
+    shaders::Registers registers(1);
+
+    program.execute(1000, *first, registers);
+    EXPECT_EQ(registers[0], 0.5f);
+    EXPECT_EQ(program.getCacheHitCount(), 0);
+
+    // Same parms at a different time, the expression doesn't depend on time
+    program.execute(5000, *second, registers);
+    EXPECT_EQ(registers[0], 0.5f);
+    EXPECT_EQ(program.getCacheHitCount(), 1);
+
+    program.execute(1000, *third, registers);
+    EXPECT_EQ(registers[0], 4.0f);
+    EXPECT_EQ(program.getCacheHitCount(), 1);
+
+    // Without entity parm0 defaults to 1, parm5 to 0
+    program.execute(1000, registers);
+    EXPECT_EQ(registers[0], 2.0f);
+
+    program.execute(1000, *first, registers);
+    EXPECT_EQ(registers[0], 0.5f);
+    EXPECT_EQ(program.getCacheHitCount(), 2);
+}
+
 TEST_F(MaterialsTest, MaterialParserFrobStageNotspecified)
 {
     auto material = GlobalMaterialManager().getMaterial("textures/parsertest/frobStage5");
@@ -2035,4 +2136,96 @@ TEST_F(MaterialsTest, EditorImageUpdatedBeforeMaterialChangedSignalEmission)
     EXPECT_FALSE(material->isEditorImageNoTex()) << "Editor image should have been updated";
 }
 
+TEST_F(MaterialsTest, ThumbnailIsDownsampledIntoAtlas)
+{
+    auto& thumbnails = GlobalThumbnailManager();
+    auto materialName = "textures/a_1024x512";
+
+    std::size_t changedSignalCount = 0;
+    thumbnails.signal_thumbnailsChanged().connect([&]() { ++changedSignalCount; });
+
+    thumbnails.requestThumbnails({ materialName });
+    thumbnails.waitForPendingThumbnails();
+    thumbnails.processFinishedThumbnails();
+
+    EXPECT_EQ(changedSignalCount, 1) << "Changed signal should have been fired once";
+
+    shaders::Thumbnail thumbnail;
+    ASSERT_EQ(thumbnails.getThumbnail(materialName, thumbnail), shaders::IThumbnailManager::Status::Ready);
+
+    // The aspect ratio of the editor image is preserved
+    EXPECT_EQ(thumbnail.width, thumbnails.getThumbnailSize());
+    EXPECT_EQ(thumbnail.height, thumbnails.getThumbnailSize() / 2);
+    ASSERT_LT(thumbnail.page, thumbnails.getNumPages());
+
+    auto page = thumbnails.getPage(thumbnail.page);
+    EXPECT_LE(thumbnail.x + thumbnail.width, page->getWidth());
+    EXPECT_LE(thumbnail.y + thumbnail.height, page->getHeight());
+
+    std::size_t width, height;
+    EXPECT_TRUE(thumbnails.getImageSize(materialName, width, height));
+    EXPECT_EQ(width, 1024);
+    EXPECT_EQ(height, 512);
+}
+
+TEST_F(MaterialsTest, ThumbnailIsStoredOnDisk)
+{
+    auto& thumbnails = GlobalThumbnailManager();
+    auto materialName = "textures/numbers/6";
+    auto cacheFile = _context.getCacheDataPath() + "thumbnails/" +
+        string::replace_all_copy("textures/numbers/6.tga", "/", "_") + ".thumb";
+    fs::remove(cacheFile);
+
+    thumbnails.requestThumbnails({ materialName });
+    thumbnails.waitForPendingThumbnails();
+    thumbnails.processFinishedThumbnails();
+
+    EXPECT_TRUE(os::fileOrDirExists(cacheFile)) << "Thumbnail has not been stored";
+
+    std::size_t width, height;
+    ASSERT_TRUE(thumbnails.getImageSize(materialName, width, height));
+
+    // Reloading the materials discards all thumbnails
+    GlobalDeclarationManager().reloadDeclarations();
+
+    shaders::Thumbnail thumbnail;
+    EXPECT_EQ(thumbnails.getThumbnail(materialName, thumbnail), shaders::IThumbnailManager::Status::NotRequested);
+
+    // The image size is known from the file on disk, without loading the image
+    std::size_t cachedWidth, cachedHeight;
+    EXPECT_TRUE(thumbnails.getImageSize(materialName, cachedWidth, cachedHeight));
+    EXPECT_EQ(cachedWidth, width);
+    EXPECT_EQ(cachedHeight, height);
+
+    thumbnails.requestThumbnails({ materialName });
+    thumbnails.waitForPendingThumbnails();
+    thumbnails.processFinishedThumbnails();
+
+    EXPECT_EQ(thumbnails.getThumbnail(materialName, thumbnail), shaders::IThumbnailManager::Status::Ready);
+}
+
+TEST_F(MaterialsTest, ThumbnailLoadNotifierFiresOncePerBatch)
+{
+    auto& thumbnails = GlobalThumbnailManager();
+
+    std::atomic<int> notifications(0);
+    thumbnails.setThumbnailLoadNotifier([&]() { ++notifications; });
+
+    thumbnails.requestThumbnails({ "textures/numbers/1", "textures/numbers/2", "textures/numbers/3" });
+    thumbnails.waitForPendingThumbnails();
+
+    // None of the thumbnails has been processed in between, so they're all part of the same batch
+    EXPECT_EQ(notifications, 1);
+
+    thumbnails.processFinishedThumbnails();
+
+    thumbnails.requestThumbnails({ "textures/numbers/4" });
+    thumbnails.waitForPendingThumbnails();
+
+    EXPECT_EQ(notifications, 2) << "The first thumbnail after processing should start a new batch";
+
+    thumbnails.setThumbnailLoadNotifier({});
+    thumbnails.processFinishedThumbnails();
+}
+
 }
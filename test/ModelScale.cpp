@@ -1,8 +1,11 @@
 #include "RadiantTest.h"
 
+#include "algorithm/Entity.h"
 #include "algorithm/Scene.h"
 #include "iscenegraph.h"
+#include "scenelib.h"
 #include "imodel.h"
+#include "imodelsurface.h"
 #include "itransformable.h"
 #include "icommandsystem.h"
 #include "iselectable.h"
@@ -13,6 +16,44 @@
 namespace test
 {
 
+namespace
+{
+    inline const std::vector<MeshVertex>& getFirstSurfaceVertices(const model::ModelNodePtr& model)
+    {
+        return dynamic_cast<const model::IIndexedModelSurface&>(model->getIModel().getSurface(0)).getVertexArray();
+    }
+}
+
+// Instances of the same static model share their vertex data until they get scaled
+TEST_F(RadiantTest, ScaledModelStopsSharingVertices)
+{
+    auto first = algorithm::createEntityByClassName("func_static");
+    auto second = algorithm::createEntityByClassName("func_static");
+    scene::addNodeToContainer(first, GlobalMapModule().getRoot());
+    scene::addNodeToContainer(second, GlobalMapModule().getRoot());
+
+    first->getEntity().setKeyValue("model", "models/torch.lwo");
+    second->getEntity().setKeyValue("model", "models/torch.lwo");
+
+    auto firstModel = algorithm::findChildModel(first);
+    auto secondModel = algorithm::findChildModel(second);
+    ASSERT_TRUE(firstModel && secondModel);
+
+    EXPECT_EQ(&getFirstSurfaceVertices(firstModel), &getFirstSurfaceVertices(secondModel));
+
+    auto originalVertex = getFirstSurfaceVertices(secondModel).front().vertex;
+
+    auto transformable = scene::node_cast<ITransformable>(algorithm::findChildModelNode(first));
+    transformable->setType(TRANSFORM_PRIMITIVE);
+    transformable->setScale(Vector3(2, 2, 2));
+    transformable->freezeTransform();
+
+    // The scaled model got its own copy, the other one is unaffected
+    EXPECT_NE(&getFirstSurfaceVertices(firstModel), &getFirstSurfaceVertices(secondModel));
+    EXPECT_TRUE(math::isNear(getFirstSurfaceVertices(firstModel).front().vertex, originalVertex * 2, 0.001));
+    EXPECT_TRUE(math::isNear(getFirstSurfaceVertices(secondModel).front().vertex, originalVertex, 0.001));
+}
+
 // #5263: "Model Scaler" doesn't handle model duplication correctly
 TEST_F(RadiantTest, DuplicateScaledModel)
 {
@@ -1,6 +1,8 @@
 #include "RadiantTest.h"
 
+#include <atomic>
 #include <unordered_set>
+#include "imd5anim.h"
 #include "imodelsurface.h"
 #include "imodelcache.h"
 #include "scenelib.h"
@@ -8,7 +10,10 @@
 #include "algorithm/FileUtils.h"
 #include "algorithm/Scene.h"
 #include "os/file.h"
+#include "registry/registry.h"
 
+#include "benchmark/SkinningGrid.h"
+#include "render/MeshSkinning.h"
 #include "render/VertexHashing.h"
 #include "string/replace.h"
 
@@ -548,6 +553,378 @@ TEST_F(ModelTest, ClearingModelKeyRemovesModel)
     EXPECT_FALSE(algorithm::findChildModel(funcStatic)) << "ModelNode should be gone after clearing the model key";
 }
 
+namespace
+{
+
+// The skinning and normal calculation as performed by MD5Surface before the introduction of the kernel
+void skinVerticesReference(const SkinningGrid& grid, std::vector<MeshVertex>& vertices)
+{
+    for (std::size_t j = 0; j < grid.weights.size(); ++j)
+    {
+        Vector3 skinned(0, 0, 0);
+
+        for (const auto& weight : grid.weights[j])
+        {
+            skinned += (grid.rotations[weight.joint].transformPoint(weight.v) + grid.origins[weight.joint]) * weight.t;
+        }
+
+        vertices[j].vertex = skinned;
+        vertices[j].normal = Normal3(0, 0, 0);
+    }
+
+    for (auto i = grid.indices.begin(); i != grid.indices.end(); i += 3)
+    {
+        auto& a = vertices[*(i + 0)];
+        auto& b = vertices[*(i + 1)];
+        auto& c = vertices[*(i + 2)];
+
+        Vector3 weightedNormal((c.vertex - a.vertex).cross(b.vertex - a.vertex));
+
+        a.normal += weightedNormal;
+        b.normal += weightedNormal;
+        c.normal += weightedNormal;
+    }
+
+    for (auto& vertex : vertices)
+    {
+        vertex.normal.normalise();
+    }
+}
+
+}
+
+// Compares the skinning kernel used by MD5 models against the previous double-precision implementation
+TEST_F(ModelTest, SkinningKernelMatchesReference)
+{
+    SkinningGrid grid(200, 64);
+
+    std::vector<MeshVertex> expected(grid.data.getNumVertices());
+    std::vector<MeshVertex> actual(grid.data.getNumVertices());
+    std::vector<Vector3> triangleNormals;
+
+    skinVerticesReference(grid, expected);
+
+    render::skinVertices(grid.data, grid.jointMatrices, actual);
+    render::calculateVertexNormals(grid.data, grid.indices, actual, triangleNormals);
+
+    for (std::size_t v = 0; v < expected.size(); ++v)
+    {
+        // The kernel is running in single precision
+        EXPECT_TRUE(math::isNear(actual[v].vertex, expected[v].vertex, 0.01)) << "Vertex " << v << " deviates";
+        EXPECT_GT(actual[v].normal.dot(expected[v].normal), 0.999) << "Normal " << v << " deviates";
+    }
+}
+
+TEST_F(ModelTest, SkinningKernelKeepsZeroNormals)
+{
+    std::vector<render::JointMatrix> jointMatrices
+    {
+        render::JointMatrix::fromRotationAndOrigin(Quaternion::Identity(), Vector3(0, 0, 0))
+    };
+
+    render::SkinningData data;
+
+    for (const auto& position : { Vector3(0, 0, 0), Vector3(1, 0, 0), Vector3(0, 1, 0), Vector3(5, 5, 5),
+        Vector3(10, 0, 0), Vector3(11, 0, 0), Vector3(10, 1, 0) })
+    {
+        data.addWeight(0, 1.0f, position);
+        data.finishVertex();
+    }
+
+    // Vertices 0-2 are in two triangles of opposite winding, vertex 3 is not referenced at all
+    std::vector<unsigned int> indices{ 0, 1, 2, 0, 2, 1, 4, 5, 6 };
+    data.buildAdjacency(indices);
+
+    std::vector<MeshVertex> vertices(data.getNumVertices());
+    std::vector<Vector3> triangleNormals;
+
+    render::skinVertices(data, jointMatrices, vertices);
+    render::calculateVertexNormals(data, indices, vertices, triangleNormals);
+
+    for (std::size_t v = 0; v < 4; ++v)
+    {
+        EXPECT_EQ(vertices[v].normal, Normal3(0, 0, 0)) << "Normal " << v << " should be the zero vector";
+    }
+
+    for (std::size_t v = 4; v < vertices.size(); ++v)
+    {
+        EXPECT_NEAR(vertices[v].normal.getLength(), 1.0, 0.0001) << "Normal " << v << " should be normalised";
+    }
+}
+
+TEST_F(ModelTest, MD5AnimFramesAndPoses)
+{
+    auto anim = GlobalAnimationCache().getAnim("models/md5/flag01_wave.md5anim");
+    ASSERT_TRUE(anim);
+
+    EXPECT_EQ(anim->getNumFrames(), 2);
+    EXPECT_EQ(anim->getNumAnimatedComponents(), 1);
+    EXPECT_EQ(anim->getFrameKeys(0)[0], 0);
+    EXPECT_EQ(anim->getFrameKeys(1)[0], 10);
+
+    // The origin joint is moving along X, the root joint is attached 10 units above it
+    auto pose = GlobalAnimationCache().getPose(anim, 0);
+    ASSERT_TRUE(pose);
+    EXPECT_EQ(pose->size(), anim->getNumJoints());
+    EXPECT_TRUE(math::isNear((*pose)[1].origin, { 0, 0, 10 }, 0.001));
+
+    // At 24 fps the second frame is reached after 42 msec
+    auto secondPose = GlobalAnimationCache().getPose(anim, 42);
+    EXPECT_TRUE(math::isNear((*secondPose)[0].origin, { 10, 0, 0 }, 0.001));
+    EXPECT_TRUE(math::isNear((*secondPose)[1].origin, { 10, 0, 10 }, 0.001));
+
+    // Asking for the same time again should return the cached pose
+    EXPECT_EQ(GlobalAnimationCache().getPose(anim, 42), secondPose);
+}
+
+TEST_F(ModelTest, ModelKeyLoadsModelInBackground)
+{
+    registry::setValue("user/ui/models/loadInBackground", true);
+
+    auto funcStatic = algorithm::createEntityByClassName("func_static");
+    scene::addNodeToContainer(funcStatic, GlobalMapModule().getRoot());
+
+    funcStatic->getEntity().setKeyValue("model", "models/torch.lwo");
+
+    // A placeholder is attached while the model is loading
+    auto placeholder = algorithm::findChildModel(funcStatic);
+    EXPECT_TRUE(placeholder) << "No placeholder ModelNode after assigning a model path";
+    EXPECT_EQ(placeholder->getIModel().getModelPath(), "models/torch.lwo");
+    EXPECT_EQ(placeholder->getIModel().getPolyCount(), 0);
+
+    // Another entity requesting a model, which is removed before the load is finished
+    auto removedEntity = algorithm::createEntityByClassName("func_static");
+    scene::addNodeToContainer(removedEntity, GlobalMapModule().getRoot());
+    removedEntity->getEntity().setKeyValue("model", "models/md5/flag01.md5mesh");
+    scene::removeNodeFromParent(removedEntity);
+    removedEntity.reset();
+
+    GlobalModelCache().waitForPendingModelLoads();
+    GlobalModelCache().processFinishedModelLoads();
+
+    // The placeholder should have been exchanged with the real model
+    auto model = algorithm::findChildModel(funcStatic);
+    EXPECT_TRUE(model) << "No ModelNode after the background load finished";
+    EXPECT_NE(model, placeholder);
+    EXPECT_EQ(model->getIModel().getModelPath(), "models/torch.lwo");
+    EXPECT_EQ(model->getIModel().getPolyCount(), 258);
+
+    // Cached models are attached right away
+    auto secondEntity = algorithm::createEntityByClassName("func_static");
+    scene::addNodeToContainer(secondEntity, GlobalMapModule().getRoot());
+    secondEntity->getEntity().setKeyValue("model", "models/torch.lwo");
+
+    EXPECT_EQ(algorithm::findChildModel(secondEntity)->getIModel().getPolyCount(), 258);
+
+    registry::setValue("user/ui/models/loadInBackground", false);
+}
+
+TEST_F(ModelTest, ModelKeyReplacesPlaceholderAfterUndo)
+{
+    registry::setValue("user/ui/models/loadInBackground", true);
+
+    auto funcStatic = algorithm::createEntityByClassName("func_static");
+    scene::addNodeToContainer(funcStatic, GlobalMapModule().getRoot());
+
+    {
+        UndoableCommand cmd("changeModelKey");
+        funcStatic->getEntity().setKeyValue("model", "models/torch.lwo");
+    }
+
+    auto placeholder = algorithm::findChildModel(funcStatic);
+    EXPECT_EQ(placeholder->getIModel().getPolyCount(), 0) << "Expected a placeholder while loading";
+
+    // Change the key again while the first model is still loading
+    {
+        UndoableCommand cmd("changeModelKey");
+        funcStatic->getEntity().setKeyValue("model", "models/md5/flag01.md5mesh");
+    }
+
+    GlobalModelCache().waitForPendingModelLoads();
+    GlobalModelCache().processFinishedModelLoads();
+
+    EXPECT_EQ(algorithm::findChildModel(funcStatic)->getIModel().getPolyCount(), 96);
+
+    // Undo brings back the torch, which must not be stuck with its placeholder
+    GlobalUndoSystem().undo();
+
+    EXPECT_EQ(funcStatic->getEntity().getKeyValue("model"), "models/torch.lwo");
+
+    auto model = algorithm::findChildModel(funcStatic);
+    EXPECT_TRUE(model) << "No ModelNode after undo";
+    EXPECT_NE(model, placeholder) << "The placeholder of the first request is still attached";
+    EXPECT_EQ(model->getIModel().getModelPath(), "models/torch.lwo");
+    EXPECT_EQ(model->getIModel().getPolyCount(), 258);
+
+    registry::setValue("user/ui/models/loadInBackground", false);
+}
+
+TEST_F(ModelTest, PrefetchedModelIsPickedUp)
+{
+    // Prefetching works independently of the background loading setting
+    GlobalModelCache().prefetchModels({ "models/torch.lwo", "func_static_1", "models/nonexistent.lwo" });
+
+    // The request is waiting for the worker and returns its result
+    auto model = GlobalModelCache().getModel("models/torch.lwo");
+    EXPECT_TRUE(model);
+    EXPECT_EQ(model->getPolyCount(), 258);
+
+    GlobalModelCache().waitForPendingModelLoads();
+    GlobalModelCache().processFinishedModelLoads();
+
+    // Moving the prefetched models into the cache must not replace the one handed out
+    EXPECT_EQ(GlobalModelCache().getModel("models/torch.lwo"), model);
+    EXPECT_FALSE(GlobalModelCache().getModel("models/nonexistent.lwo"));
+}
+
+TEST_F(ModelTest, BackgroundLoadNotifierFiresOncePerBatch)
+{
+    std::atomic<int> notifications(0);
+    GlobalModelCache().setBackgroundLoadNotifier([&]() { ++notifications; });
+
+    GlobalModelCache().prefetchModels({ "models/torch.lwo", "models/ase/testsphere.ase", "models/moss_patch.ase" });
+    GlobalModelCache().waitForPendingModelLoads();
+
+    // None of the models has been fetched in between, so they're all part of the same batch
+    EXPECT_EQ(notifications, 1);
+
+    GlobalModelCache().processFinishedModelLoads();
+
+    GlobalModelCache().prefetchModels({ "models/md5/flag01.md5mesh" });
+    GlobalModelCache().waitForPendingModelLoads();
+
+    EXPECT_EQ(notifications, 2) << "The first model after fetching should start a new batch";
+
+    GlobalModelCache().setBackgroundLoadNotifier({});
+    GlobalModelCache().processFinishedModelLoads();
+}
+
+TEST_F(ModelTest, ModelsArePrefetchedDuringMapLoad)
+{
+    loadMap("duplicate_scaled_model.map");
+
+    auto entity = algorithm::getEntityByName(GlobalMapModule().getRoot(), "moss01");
+    ASSERT_TRUE(entity);
+
+    // The entity should have the real model attached, not a placeholder
+    auto model = algorithm::findChildModel(entity);
+    EXPECT_TRUE(model) << "No ModelNode attached after map load";
+    EXPECT_EQ(model->getIModel().getModelPath(), "models/moss_patch.ase");
+    EXPECT_GT(model->getIModel().getPolyCount(), 0);
+}
+
+TEST_F(ModelTest, UnreferencedModelsAreEvictedFromCache)
+{
+    // 50 KB, the sphere model alone is exceeding this
+    registry::setValue("user/ui/models/cacheMemoryLimit", 0.05);
+
+    auto sphere = GlobalModelCache().getModel("models/ase/testsphere.ase");
+    ASSERT_TRUE(sphere);
+    EXPECT_GT(sphere->getMemoryUsage(), 50 * 1024);
+
+    // The most recently loaded model is never evicted
+    EXPECT_EQ(GlobalModelCache().getModel("models/ase/testsphere.ase"), sphere);
+
+    // Loading another model pushes the unreferenced sphere out of the cache
+    EXPECT_TRUE(GlobalModelCache().getModel("models/torch.lwo"));
+    auto reloadedSphere = GlobalModelCache().getModel("models/ase/testsphere.ase");
+    EXPECT_NE(reloadedSphere, sphere) << "Sphere should have been evicted";
+
+    // Once the sphere is used in the scene it has to stay
+    auto funcStatic = algorithm::createEntityByClassName("func_static");
+    scene::addNodeToContainer(funcStatic, GlobalMapModule().getRoot());
+    funcStatic->getEntity().setKeyValue("model", "models/ase/testsphere.ase");
+    ASSERT_TRUE(algorithm::findChildModel(funcStatic));
+
+    EXPECT_TRUE(GlobalModelCache().getModel("models/md5/flag01.md5mesh"));
+    EXPECT_EQ(GlobalModelCache().getModel("models/ase/testsphere.ase"), reloadedSphere)
+        << "Referenced model should not have been evicted";
+
+    // Removing the entity from the scene makes the sphere evictable again
+    scene::removeNodeFromParent(funcStatic);
+    EXPECT_TRUE(GlobalModelCache().getModel("models/ase/testcube.ase"));
+    EXPECT_NE(GlobalModelCache().getModel("models/ase/testsphere.ase"), reloadedSphere)
+        << "Sphere should have been evicted after removing its entity";
+
+    registry::setValue("user/ui/models/cacheMemoryLimit", 0);
+}
+
+inline void expectEqualModelGeometry(const model::IModel& a, const model::IModel& b)
+{
+    ASSERT_EQ(a.getSurfaceCount(), b.getSurfaceCount());
+
+    for (int i = 0; i < a.getSurfaceCount(); ++i)
+    {
+        const auto& surfaceA = static_cast<const model::IIndexedModelSurface&>(a.getSurface(i));
+        const auto& surfaceB = static_cast<const model::IIndexedModelSurface&>(b.getSurface(i));
+
+        EXPECT_EQ(surfaceA.getDefaultMaterial(), surfaceB.getDefaultMaterial());
+        EXPECT_EQ(surfaceA.getIndexArray(), surfaceB.getIndexArray());
+        EXPECT_EQ(surfaceA.getSurfaceBounds().origin, surfaceB.getSurfaceBounds().origin);
+        EXPECT_EQ(surfaceA.getSurfaceBounds().extents, surfaceB.getSurfaceBounds().extents);
+
+        ASSERT_EQ(surfaceA.getVertexArray().size(), surfaceB.getVertexArray().size());
+
+        for (std::size_t v = 0; v < surfaceA.getVertexArray().size(); ++v)
+        {
+            const auto& vertexA = surfaceA.getVertexArray()[v];
+            const auto& vertexB = surfaceB.getVertexArray()[v];
+
+            EXPECT_EQ(vertexA, vertexB) << "Vertex " << v << " of surface " << i << " differs";
+            EXPECT_EQ(vertexA.tangent, vertexB.tangent);
+            EXPECT_EQ(vertexA.bitangent, vertexB.bitangent);
+            EXPECT_EQ(vertexA.colour, vertexB.colour);
+        }
+    }
+}
+
+TEST_F(ModelTest, ImportedModelsAreBakedToDisk)
+{
+    for (const auto& modelPath : { "models/ase/tiles_two_materials.ase", "models/torch.lwo" })
+    {
+        auto bakedFile = _context.getCacheDataPath() + "bakedmodels/" +
+            string::replace_all_copy(modelPath, "/", "_") + ".bin";
+        fs::remove(bakedFile);
+
+        auto imported = GlobalModelCache().getModel(modelPath);
+        ASSERT_TRUE(imported);
+        EXPECT_TRUE(os::fileOrDirExists(bakedFile)) << "Model " << modelPath << " has not been baked";
+
+        // The next request is served from the baked file
+        GlobalModelCache().removeModel(modelPath);
+        auto baked = GlobalModelCache().getModel(modelPath);
+
+        ASSERT_TRUE(baked);
+        EXPECT_NE(baked, imported);
+        EXPECT_EQ(baked->getModelPath(), imported->getModelPath());
+        EXPECT_EQ(baked->getFilename(), imported->getFilename());
+        expectEqualModelGeometry(*imported, *baked);
+    }
+}
+
+TEST_F(ModelTest, CorruptBakedModelIsImportedAgain)
+{
+    auto modelPath = "models/ase/tiles_two_materials.ase";
+    auto bakedFile = _context.getCacheDataPath() + "bakedmodels/models_ase_tiles_two_materials.ase.bin";
+
+    auto imported = GlobalModelCache().getModel(modelPath);
+    ASSERT_TRUE(imported);
+    ASSERT_TRUE(os::fileOrDirExists(bakedFile));
+
+    // Keep the header intact, but cut off the surface data
+    auto bakedFileSize = fs::file_size(bakedFile);
+    fs::resize_file(bakedFile, bakedFileSize / 2);
+
+    GlobalModelCache().removeModel(modelPath);
+    auto reloaded = GlobalModelCache().getModel(modelPath);
+
+    ASSERT_TRUE(reloaded);
+    expectEqualModelGeometry(*imported, *reloaded);
+
+    // The baked file should have been replaced
+    EXPECT_EQ(fs::file_size(bakedFile), bakedFileSize);
+}
+
 // #5504: Reload Defs is not sufficient for reloading modelDefs
 TEST_F(ModelTest, ModelKeyReactsToReloadDecls)
 {
@@ -0,0 +1,134 @@
+#include "RadiantTest.h"
+
+#include "ibrush.h"
+#include "iscenegraph.h"
+#include "itransformable.h"
+#include "scene/RayTrace.h"
+#include "algorithm/Primitives.h"
+#include "algorithm/Scene.h"
+
+namespace test
+{
+
+using RayTraceTest = RadiantTest;
+
+TEST_F(RayTraceTest, EntryDistance)
+{
+    AABB box(Vector3(0, 0, 0), Vector3(16, 16, 16));
+
+    // Ray starting outside, pointing towards the box
+    EXPECT_EQ(scene::getRayEntryDistance(Ray(Vector3(0, 0, 100), Vector3(0, 0, -1)), box), 84);
+
+    // Ray starting inside the box
+    EXPECT_EQ(scene::getRayEntryDistance(Ray(Vector3(0, 0, 0), Vector3(0, 0, -1)), box), 0);
+
+    // Ray pointing away from the box
+    EXPECT_LT(scene::getRayEntryDistance(Ray(Vector3(0, 0, 100), Vector3(0, 0, 1)), box), 0);
+
+    // Ray passing by the box
+    EXPECT_LT(scene::getRayEntryDistance(Ray(Vector3(20, 0, 100), Vector3(0, 0, -1)), box), 0);
+
+    // Invalid bounds are never hit
+    EXPECT_LT(scene::getRayEntryDistance(Ray(Vector3(0, 0, 100), Vector3(0, 0, -1)), AABB()), 0);
+}
+
+TEST_F(RayTraceTest, NearestBrushIsHit)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    // Stack three brushes along the z axis (the cubic brush extends 64 units in each direction)
+    auto lower = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 0));
+    auto middle = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 256));
+    auto upper = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 512));
+
+    auto result = scene::traceRay(Ray(Vector3(0, 0, 1024), Vector3(0, 0, -1)));
+
+    EXPECT_TRUE(result.hit());
+    EXPECT_EQ(result.node, upper);
+    EXPECT_TRUE(math::isNear(result.point, Vector3(0, 0, 576), 0.01));
+    EXPECT_NEAR(result.distance, 448, 0.01);
+
+    // Tracing upwards from below should hit the lower one
+    result = scene::traceRay(Ray(Vector3(0, 0, -1024), Vector3(0, 0, 1)));
+    EXPECT_EQ(result.node, lower);
+    EXPECT_TRUE(math::isNear(result.point, Vector3(0, 0, -64), 0.01));
+
+    // Start in between the middle and the upper brush
+    result = scene::traceRay(Ray(Vector3(0, 0, 384), Vector3(0, 0, -1)));
+    EXPECT_EQ(result.node, middle);
+
+    // A ray passing by should not hit anything
+    result = scene::traceRay(Ray(Vector3(512, 0, 1024), Vector3(0, 0, -1)));
+    EXPECT_FALSE(result.hit());
+}
+
+TEST_F(RayTraceTest, FilteredAndHiddenNodesAreSkipped)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    auto lower = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 0));
+    auto upper = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 256));
+
+    Ray ray(Vector3(0, 0, 1024), Vector3(0, 0, -1));
+
+    auto result = scene::traceRay(ray, [&](const scene::INodePtr& node) { return node != upper; });
+    EXPECT_EQ(result.node, lower);
+
+    upper->enable(scene::Node::eHidden);
+
+    result = scene::traceRay(ray);
+    EXPECT_EQ(result.node, lower);
+
+    upper->disable(scene::Node::eHidden);
+
+    result = scene::traceRay(ray);
+    EXPECT_EQ(result.node, upper);
+}
+
+TEST_F(RayTraceTest, TraceFollowsBoundsChanges)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto brush = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 0));
+
+    Ray ray(Vector3(2048, 0, 1024), Vector3(0, 0, -1));
+    EXPECT_FALSE(scene::traceRay(ray).hit());
+
+    // Move the brush below the ray, the octree needs to pick up the change
+    auto transformable = scene::node_cast<ITransformable>(brush);
+    transformable->setType(TRANSFORM_PRIMITIVE);
+    transformable->setTranslation(Vector3(2048, 0, 0));
+    transformable->freezeTransform();
+
+    auto result = scene::traceRay(ray);
+    EXPECT_EQ(result.node, brush);
+    EXPECT_TRUE(math::isNear(result.point, Vector3(2048, 0, 64), 0.01));
+}
+
+TEST_F(RayTraceTest, BatchTrace)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    std::vector<scene::INodePtr> brushes;
+    std::vector<Ray> rays;
+
+    for (int i = 0; i < 16; ++i)
+    {
+        brushes.push_back(algorithm::createCubicBrush(worldspawn, Vector3(i * 256, 0, 0)));
+        rays.emplace_back(Vector3(i * 256, 0, 1024), Vector3(0, 0, -1));
+    }
+
+    // Add one ray not hitting anything
+    rays.emplace_back(Vector3(-1024, 0, 1024), Vector3(0, 0, -1));
+
+    auto results = scene::traceRays(rays);
+    ASSERT_EQ(results.size(), rays.size());
+
+    for (std::size_t i = 0; i < brushes.size(); ++i)
+    {
+        EXPECT_EQ(results[i].node, brushes[i]) << "Ray " << i << " hit the wrong node";
+    }
+
+    EXPECT_FALSE(results.back().hit());
+}
+
+}
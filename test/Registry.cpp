@@ -111,4 +111,51 @@ TEST_F(RegistryTest, SetAttributeOnNode)
     EXPECT_EQ(node.getContent(), "");
 }
 
+TEST_F(RegistryTest, RepeatedReadsSkipXPathQueries)
+{
+    const char* KEY = "user/ui/map/numMRU";
+
+    EXPECT_EQ(GlobalRegistry().get(KEY), "5");
+    auto queryCount = GlobalRegistry().getXPathQueryCount();
+
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(GlobalRegistry().get(KEY), "5");
+    }
+
+    EXPECT_EQ(GlobalRegistry().getXPathQueryCount(), queryCount) << "Plain keys should be read from the cache";
+
+    // Keys using XPath syntax are evaluated every time
+    GlobalRegistry().get("user/ui/map/*[1]");
+    EXPECT_EQ(GlobalRegistry().getXPathQueryCount(), queryCount + 1);
+}
+
+TEST_F(RegistryTest, CachedValuesFollowChanges)
+{
+    const char* KEY = "user/test/cachedValue";
+
+    EXPECT_EQ(GlobalRegistry().get(KEY), "");
+
+    GlobalRegistry().set(KEY, "first");
+    EXPECT_EQ(GlobalRegistry().get(KEY), "first");
+
+    // Signal handlers should see the new value
+    std::string valueInSignal;
+    GlobalRegistry().signalForKey(KEY).connect([&]() { valueInSignal = GlobalRegistry().get(KEY); });
+
+    GlobalRegistry().set(KEY, "second");
+    EXPECT_EQ(valueInSignal, "second");
+
+    // Nodes modified right after retrieving them
+    GlobalRegistry().findXPath(KEY).at(0).setContent("third");
+    EXPECT_EQ(GlobalRegistry().get(KEY), "third");
+
+    GlobalRegistry().setAttribute(KEY, "value", "fourth");
+    GlobalRegistry().findXPath(KEY).at(0).setContent("");
+    EXPECT_EQ(GlobalRegistry().get(KEY), "fourth");
+
+    GlobalRegistry().deleteXPath(KEY);
+    EXPECT_EQ(GlobalRegistry().get(KEY), "");
+}
+
 }
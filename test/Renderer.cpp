@@ -6,6 +6,8 @@
 #include "ilightnode.h"
 #include "math/Matrix4.h"
 #include "scenelib.h"
+#include "scene/LightInteractionIndex.h"
+#include "render/InstancedObjects.h"
 
 namespace test
 {
@@ -150,6 +152,54 @@ struct Light
     }
 };
 
+TEST_F(RendererTest, InstancedObjectsDrawCalls)
+{
+    render::InstancedObjects objects;
+    EXPECT_TRUE(objects.empty());
+
+    // Two objects sharing slot 1, one using slot 2, many more using slot 3
+    objects.add(1, Matrix4::getTranslation(V3(1, 0, 0)));
+    objects.add(2, Matrix4::getTranslation(V3(2, 0, 0)));
+    objects.add(1, Matrix4::getTranslation(V3(3, 0, 0)));
+
+    auto manyObjects = render::InstancedObjects::MaxInstancesPerDraw + 4;
+
+    for (std::size_t i = 0; i < manyObjects; ++i)
+    {
+        objects.add(3, Matrix4::getTranslation(V3(0, static_cast<double>(i), 0)));
+    }
+
+    EXPECT_FALSE(objects.empty());
+
+    std::vector<std::pair<render::IGeometryStore::Slot, std::vector<Matrix4>>> drawCalls;
+
+    objects.foreachDrawCall([&](render::IGeometryStore::Slot slot, const Matrix4* transforms, std::size_t count)
+    {
+        drawCalls.emplace_back(slot, std::vector<Matrix4>(transforms, transforms + count));
+    });
+
+    // The objects of a slot are drawn together, but never more than the programs can take
+    ASSERT_EQ(drawCalls.size(), 4);
+
+    EXPECT_EQ(drawCalls[0].first, 1);
+    ASSERT_EQ(drawCalls[0].second.size(), 2);
+    EXPECT_EQ(drawCalls[0].second[0].tCol().getVector3(), V3(1, 0, 0));
+    EXPECT_EQ(drawCalls[0].second[1].tCol().getVector3(), V3(3, 0, 0));
+
+    EXPECT_EQ(drawCalls[1].first, 2);
+    ASSERT_EQ(drawCalls[1].second.size(), 1);
+    EXPECT_EQ(drawCalls[1].second[0].tCol().getVector3(), V3(2, 0, 0));
+
+    EXPECT_EQ(drawCalls[2].first, 3);
+    EXPECT_EQ(drawCalls[2].second.size(), render::InstancedObjects::MaxInstancesPerDraw);
+    EXPECT_EQ(drawCalls[3].first, 3);
+    ASSERT_EQ(drawCalls[3].second.size(), 4);
+    EXPECT_EQ(drawCalls[3].second.back().tCol().getVector3(), V3(0, static_cast<double>(manyObjects - 1), 0));
+
+    objects.clear();
+    EXPECT_TRUE(objects.empty());
+}
+
 TEST_F(RendererTest, CreateLightNode)
 {
     Light light;
@@ -490,4 +540,194 @@ TEST_F(RenderSystemTest, AttachmentIsRegisteredAsLight)
     EXPECT_EQ(getLightCount(renderSystem), 1) << "Rendersystem should know of 1 light after removing the torch";
 }
 
+namespace
+{
+
+// Render entity with freely settable renderable bounds
+class TestRenderEntity :
+    public IRenderEntity
+{
+private:
+    AABB _bounds;
+    sigc::signal<void> _sigBoundsChanged;
+
+    ShaderPtr _shader;
+    Vector3 _direction;
+
+public:
+    TestRenderEntity(const AABB& bounds) :
+        _bounds(bounds),
+        _direction(0, 0, 1)
+    {}
+
+    const AABB& getBounds() const
+    {
+        return _bounds;
+    }
+
+    void setBounds(const AABB& bounds)
+    {
+        _bounds = bounds;
+        _sigBoundsChanged.emit();
+    }
+
+    std::string getEntityName() const override { return "test"; }
+    float getShaderParm(int parmNum) const override { return 0; }
+    const Vector3& getDirection() const override { return _direction; }
+    const ShaderPtr& getWireShader() const override { return _shader; }
+    const ShaderPtr& getColourShader() const override { return _shader; }
+    Vector4 getEntityColour() const override { return Vector4(1, 1, 1, 1); }
+    void addRenderable(const render::IRenderableObject::Ptr& object, Shader* shader) override {}
+    void removeRenderable(const render::IRenderableObject::Ptr& object) override {}
+    void foreachRenderable(const ObjectVisitFunction& functor) override {}
+    void foreachRenderableTouchingBounds(const AABB& bounds, const ObjectVisitFunction& functor) override {}
+    AABB getRenderableBounds() override { return _bounds; }
+    sigc::signal<void>& signal_renderableBoundsChanged() override { return _sigBoundsChanged; }
+    bool isShadowCasting() const override { return true; }
+};
+
+// Light which is its own render entity, like the light nodes
+class TestRenderLight :
+    public TestRenderEntity,
+    public RendererLight
+{
+private:
+    ShaderPtr _shader;
+
+public:
+    TestRenderLight(const AABB& bounds) :
+        TestRenderEntity(bounds)
+    {}
+
+    bool isVisible() override { return true; }
+    const IRenderEntity& getLightEntity() const override { return *this; }
+    const ShaderPtr& getShader() const override { return _shader; }
+    Matrix4 getLightTextureTransformation() const override { return Matrix4::getIdentity(); }
+    AABB lightAABB() const override { return getBounds(); }
+    Vector3 getLightOrigin() const override { return lightAABB().getOrigin(); }
+    bool isShadowCasting() const override { return true; }
+    bool isBlendLight() const override { return false; }
+};
+
+bool containsEntity(const std::vector<IRenderEntity*>& entities, const IRenderEntityPtr& entity)
+{
+    return std::find(entities.begin(), entities.end(), entity.get()) != entities.end();
+}
+
+}
+
+TEST_F(RenderSystemTest, LightInteractionIndexEntityMovingThroughLight)
+{
+    render::LightInteractionIndex index;
+
+    auto light = std::make_shared<TestRenderLight>(AABB({ 0, 0, 0 }, { 128, 128, 128 }));
+    auto entity = std::make_shared<TestRenderEntity>(AABB({ 2048, 0, 0 }, { 16, 16, 16 }));
+
+    index.addEntity(light);
+    index.addEntity(entity);
+
+    auto entities = index.getInteractingEntities(*light, light->lightAABB());
+    EXPECT_FALSE(containsEntity(entities, entity)) << "Entity is far away from the light";
+    EXPECT_TRUE(containsEntity(entities, light)) << "Light should be touching its own volume";
+
+    // Move the entity into the light volume, the cached list needs to be rebuilt
+    entity->setBounds(AABB({ 64, 0, 0 }, { 16, 16, 16 }));
+
+    entities = index.getInteractingEntities(*light, light->lightAABB());
+    EXPECT_TRUE(containsEntity(entities, entity)) << "Entity has been moved into the light";
+
+    // Move it within the volume, into a different cell
+    entity->setBounds(AABB({ -64, 0, 0 }, { 16, 16, 16 }));
+
+    entities = index.getInteractingEntities(*light, light->lightAABB());
+    EXPECT_TRUE(containsEntity(entities, entity)) << "Entity is still in the light";
+
+    // And out again
+    entity->setBounds(AABB({ -2048, 0, 0 }, { 16, 16, 16 }));
+
+    entities = index.getInteractingEntities(*light, light->lightAABB());
+    EXPECT_FALSE(containsEntity(entities, entity)) << "Entity has been moved out of the light";
+
+    // Move the light over to the entity
+    light->setBounds(AABB({ -2048, 0, 0 }, { 128, 128, 128 }));
+
+    entities = index.getInteractingEntities(*light, light->lightAABB());
+    EXPECT_TRUE(containsEntity(entities, entity)) << "Light has been moved to the entity";
+
+    // An entity without renderables can't interact with the light
+    entity->setBounds(AABB());
+
+    entities = index.getInteractingEntities(*light, light->lightAABB());
+    EXPECT_FALSE(containsEntity(entities, entity)) << "Entity bounds are invalid";
+}
+
+TEST_F(RenderSystemTest, LightInteractionIndexRemovedEntity)
+{
+    render::LightInteractionIndex index;
+
+    auto light = std::make_shared<TestRenderLight>(AABB({ 0, 0, 0 }, { 128, 128, 128 }));
+    auto entity = std::make_shared<TestRenderEntity>(AABB({ 64, 0, 0 }, { 16, 16, 16 }));
+    auto otherEntity = std::make_shared<TestRenderEntity>(AABB({ -64, 0, 0 }, { 16, 16, 16 }));
+
+    index.addEntity(light);
+    index.addEntity(entity);
+    index.addEntity(otherEntity);
+
+    // Get the light's entity list cached
+    auto entities = index.getInteractingEntities(*light, light->lightAABB());
+    EXPECT_EQ(entities.size(), 3);
+    EXPECT_TRUE(containsEntity(entities, entity));
+
+    index.removeEntity(entity);
+
+    auto* removedEntity = entity.get();
+    entity.reset();
+
+    const auto& result = index.getInteractingEntities(*light, light->lightAABB());
+    EXPECT_EQ(result.size(), 2) << "Cached list should have been rebuilt";
+    EXPECT_EQ(std::count(result.begin(), result.end(), removedEntity), 0) << "Removed entity is still listed";
+    EXPECT_TRUE(containsEntity(result, otherEntity));
+
+    // Moving the remaining entity still works, the removed one is gone from the cells
+    otherEntity->setBounds(AABB({ 64, 0, 0 }, { 16, 16, 16 }));
+    EXPECT_EQ(index.getInteractingEntities(*light, light->lightAABB()).size(), 2);
+}
+
+TEST_F(RenderSystemTest, LightInteractionIndexLargeEntity)
+{
+    render::LightInteractionIndex index;
+
+    // Spanning far more cells than a single entity is sorted into, like worldspawn
+    auto worldspawn = std::make_shared<TestRenderEntity>(AABB({ 0, 0, 0 }, { 16384, 16384, 4096 }));
+    auto light = std::make_shared<TestRenderLight>(AABB({ 8000, -8000, 2000 }, { 64, 64, 64 }));
+
+    index.addEntity(worldspawn);
+    index.addEntity(light);
+
+    EXPECT_TRUE(containsEntity(index.getInteractingEntities(*light, light->lightAABB()), worldspawn))
+        << "Worldspawn should be found by a small light anywhere in the map";
+
+    light->setBounds(AABB({ -12000, 12000, -3000 }, { 64, 64, 64 }));
+
+    EXPECT_TRUE(containsEntity(index.getInteractingEntities(*light, light->lightAABB()), worldspawn))
+        << "Worldspawn should be found after moving the light";
+
+    // Lights outside the bounds of a large entity don't interact with it
+    light->setBounds(AABB({ 20000, 0, 0 }, { 64, 64, 64 }));
+
+    EXPECT_FALSE(containsEntity(index.getInteractingEntities(*light, light->lightAABB()), worldspawn))
+        << "Light is outside of worldspawn";
+
+    // Shrinking the large entity moves it into the grid
+    worldspawn->setBounds(AABB({ 20000, 0, 0 }, { 256, 256, 256 }));
+
+    EXPECT_TRUE(containsEntity(index.getInteractingEntities(*light, light->lightAABB()), worldspawn))
+        << "Shrunk worldspawn should be touching the light";
+
+    index.removeEntity(worldspawn);
+
+    EXPECT_FALSE(containsEntity(index.getInteractingEntities(*light, light->lightAABB()), worldspawn))
+        << "Removed worldspawn should not be listed";
+}
+
 }
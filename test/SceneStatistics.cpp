@@ -1,6 +1,10 @@
 #include "RadiantTest.h"
 
 #include "scene/ShaderBreakdown.h"
+#include "ibrush.h"
+#include "imap.h"
+#include "scenelib.h"
+#include "algorithm/Scene.h"
 
 namespace test
 {
@@ -26,4 +30,31 @@ TEST_F(SceneStatisticsTest, MaterialBreakDown)
     EXPECT_EQ(map.at("torch_shadowcasting"), (std::array<std::size_t, 4>({ 0, 0, 1, 0 })));
 }
 
+
+TEST_F(SceneStatisticsTest, MaterialBreakDownFollowsSceneChanges)
+{
+    loadMap("material_usage.map");
+
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto brush = algorithm::findFirstBrushWithMaterial(worldspawn, "textures/numbers/1");
+    ASSERT_TRUE(brush);
+
+    // Apply a material that is not used anywhere else to one of the faces
+    Node_getIBrush(brush)->getFace(0).setShader("textures/numbers/2");
+
+    auto map = scene::ShaderBreakdown().getMap();
+
+    EXPECT_EQ(map.at("textures/numbers/1"), (std::array<std::size_t, 4>({ 5, 0, 0, 0 })));
+    EXPECT_EQ(map.at("textures/numbers/2"), (std::array<std::size_t, 4>({ 1, 0, 0, 0 })));
+
+    // Removing the brush from the scene removes its faces from the breakdown
+    scene::removeNodeFromParent(brush);
+
+    map = scene::ShaderBreakdown().getMap();
+
+    EXPECT_EQ(map.count("textures/numbers/1"), 0);
+    EXPECT_EQ(map.count("textures/numbers/2"), 0);
+    EXPECT_EQ(map.at("textures/numbers/0"), (std::array<std::size_t, 4>({ 6, 2, 0, 0 })));
+}
+
 }
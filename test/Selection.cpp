@@ -1619,4 +1619,55 @@ TEST_F(OrthoViewSelectionTest, UnfocusedNodeIsAddedToFocusOnSelection)
     EXPECT_FALSE(math::isNear(originalFocusBounds.getExtents(), newFocusBounds.getExtents(), 10)) << "Bounds should have changed form";
 }
 
+// Batched clip-space tests must produce the same intersections as clipping each triangle on its own
+TEST_F(SelectionTest, BatchedMeshSelectionTestMatchesSingleTriangleClipping)
+{
+    // Set up a curved grid of 33x33 vertices, spanning well beyond the selection rectangle
+    std::vector<Vector3> vertices;
+
+    for (int y = -16; y <= 16; ++y)
+    {
+        for (int x = -16; x <= 16; ++x)
+        {
+            vertices.emplace_back(x * 32.0, y * 32.0, sin(x * 0.3) * cos(y * 0.2) * 64);
+        }
+    }
+
+    std::vector<unsigned int> indices;
+    std::vector<Vector3> triangleVertices; // non-indexed copy for the reference algorithm
+
+    for (unsigned int y = 0; y < 32; ++y)
+    {
+        for (unsigned int x = 0; x < 32; ++x)
+        {
+            auto i = y * 33 + x;
+            for (auto index : { i, i + 1, i + 33, i + 1, i + 34, i + 33 })
+            {
+                indices.push_back(index);
+                triangleVertices.push_back(vertices[index]);
+            }
+        }
+    }
+
+    for (const auto& viewOrigin : { Vector3(0, 0, 0), Vector3(101, -37, 0), Vector3(4096, 0, 0) })
+    {
+        render::View view(false);
+        algorithm::constructCenteredOrthoview(view, viewOrigin);
+
+        auto test = algorithm::constructOrthoviewSelectionTest(view);
+        test.BeginMesh(Matrix4::getIdentity(), true);
+
+        SelectionIntersection batched;
+        test.TestTriangles(VertexPointer(vertices.data(), sizeof(Vector3)),
+            IndexPointer(indices.data(), indices.size()), batched);
+
+        SelectionIntersection reference;
+        Triangles_BestPoint(test.getVolume().GetViewProjection(), eClipCullNone,
+            triangleVertices.data(), triangleVertices.data() + triangleVertices.size(), reference);
+
+        EXPECT_EQ(batched.isValid(), reference.isValid()) << "Validity mismatch at view origin " << viewOrigin;
+        EXPECT_FALSE(batched < reference || reference < batched) << "Intersection mismatch at view origin " << viewOrigin;
+    }
+}
+
 }
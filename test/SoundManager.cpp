@@ -1,12 +1,58 @@
 #include "RadiantTest.h"
 
+#include <algorithm>
+#include <fstream>
 #include "isound.h"
+#include "os/fs.h"
+#include "algorithm/FileUtils.h"
 
 namespace test
 {
 
 using SoundManagerTest = RadiantTest;
 
+// Writes a sound duration index before the sound manager is started
+class SoundDurationIndexTest :
+    public RadiantTest
+{
+protected:
+    std::string getIndexPath()
+    {
+        return _context.getCacheDataPath() + "soundDurations.idx";
+    }
+
+    void preStartup() override
+    {
+        auto oggPath = fs::path(_context.getTestProjectPath()) / "sound/test/jorge.ogg";
+        auto wavPath = fs::path(_context.getTestProjectPath()) / "sound/test/jorge.wav";
+
+        std::ofstream stream(getIndexPath(), std::ios::trunc);
+
+        // The stamp of the OGG file is matching, the indexed duration should be used
+        stream << fs::file_size(oggPath) << " " << fs::last_write_time(oggPath).time_since_epoch().count() <<
+            " 42 sound/test/jorge.ogg\n";
+
+        // The WAV file has been changed since it has been indexed
+        stream << (fs::file_size(wavPath) + 1) << " 0 42 sound/test/jorge.wav\n";
+    }
+
+    // Set by tests expecting the outdated entry to be replaced in the index file
+    bool _expectUpdatedIndex = false;
+
+    void postShutdown() override
+    {
+        if (_expectUpdatedIndex)
+        {
+            // The index should have been written back on shutdown
+            EXPECT_TRUE(algorithm::fileContainsText(getIndexPath(), "sound/test/jorge.ogg"));
+            EXPECT_FALSE(algorithm::fileContainsText(getIndexPath(), " 0 42 sound/test/jorge.wav"));
+        }
+
+        // Don't let the fake durations leak into other tests
+        fs::remove(getIndexPath());
+    }
+};
+
 TEST_F(SoundManagerTest, ShaderParsing)
 {
     // All of these shaders need to be parsed and present
@@ -92,6 +138,69 @@ TEST_F(SoundManagerTest, GetSoundFileDurationWithoutExtension)
     EXPECT_NEAR(duration, oggDuration, 0.001) << "The OGG file should have been found, not the wav file";
 }
 
+namespace
+{
+
+// Sink collecting some statistics of the decoded samples
+class PcmStatistics :
+    public IPcmSink
+{
+public:
+    int numChannels = 0;
+    int sampleRate = 0;
+    std::size_t numSamples = 0;
+    std::size_t numBlocks = 0;
+    int peak = 0;
+
+    void setFormat(int channels, int rate) override
+    {
+        numChannels = channels;
+        sampleRate = rate;
+    }
+
+    void writeSamples(const std::int16_t* samples, std::size_t count) override
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            peak = std::max(peak, std::abs(static_cast<int>(samples[i])));
+        }
+
+        numSamples += count;
+        ++numBlocks;
+    }
+};
+
+}
+
+TEST_F(SoundManagerTest, DecodeOggFileToPcm)
+{
+    PcmStatistics sink;
+    GlobalSoundManager().decodeSoundFile("sound/test/jorge.ogg", sink);
+
+    EXPECT_EQ(sink.numChannels, 1);
+    EXPECT_EQ(sink.sampleRate, 44100);
+    EXPECT_GT(sink.peak, 0) << "The decoded sound should not be silent";
+
+    // The decoded length should match the length stated in the file
+    auto duration = GlobalSoundManager().getSoundFileDuration("sound/test/jorge.ogg");
+    EXPECT_NEAR(static_cast<float>(sink.numSamples / sink.numChannels) / sink.sampleRate, duration, 0.001);
+
+    // 12959 samples of 2 bytes should be delivered in the 32 KB chunks of the streamed playback
+    EXPECT_EQ(sink.numBlocks, 1);
+}
+
+TEST_F(SoundManagerTest, DecodeSoundFileWithoutExtension)
+{
+    PcmStatistics sink;
+    GlobalSoundManager().decodeSoundFile("sound/test/jorge", sink);
+
+    EXPECT_EQ(sink.sampleRate, 44100) << "The OGG file should have been found and decoded";
+    EXPECT_GT(sink.numSamples, 0);
+
+    EXPECT_THROW(GlobalSoundManager().decodeSoundFile("sound/test/nonexisting.ogg", sink), std::out_of_range);
+    EXPECT_THROW(GlobalSoundManager().decodeSoundFile("sound/test/jorge.wav", sink), std::runtime_error);
+}
+
 TEST_F(SoundManagerTest, SoundDeclSupportsVisibility)
 {
     // Normal decl
@@ -105,4 +214,21 @@ TEST_F(SoundManagerTest, SoundDeclSupportsVisibility)
     EXPECT_EQ(hidden->getVisibility(), vfs::Visibility::HIDDEN);
 }
 
+TEST_F(SoundDurationIndexTest, IndexedDurationIsUsed)
+{
+    EXPECT_NEAR(GlobalSoundManager().getSoundFileDuration("sound/test/jorge.ogg"), 42, 0.001)
+        << "The duration should have been taken from the index";
+
+    // This should find jorge.ogg in the index too
+    EXPECT_NEAR(GlobalSoundManager().getSoundFileDuration("sound/test/jorge"), 42, 0.001);
+}
+
+TEST_F(SoundDurationIndexTest, OutdatedIndexEntryIsIgnored)
+{
+    EXPECT_NEAR(GlobalSoundManager().getSoundFileDuration("sound/test/jorge.wav"), 0.096, 0.001)
+        << "The outdated index entry should have been replaced";
+
+    _expectUpdatedIndex = true;
+}
+
 }
@@ -9,6 +9,7 @@
 #include "selection/SelectedPlaneSet.h"
 #include "render/View.h"
 #include "algorithm/View.h"
+#include "algorithm/Primitives.h"
 
 namespace test
 {
@@ -151,4 +152,52 @@ TEST_F(TransformationTest, UniformLightDragResize)
     EXPECT_EQ(entityNode->worldAABB().getExtents(), Vector3(320, 320, 320));
 }
 
+TEST_F(TransformationTest, TransformLargeBrushSelection)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    // Enough brushes to have the geometry evaluated on more than one thread
+    std::vector<scene::INodePtr> brushes;
+
+    for (int i = 0; i < 512; ++i)
+    {
+        brushes.push_back(algorithm::createCubicBrush(worldspawn, Vector3((i % 32) * 256, (i / 32) * 256, 0)));
+        Node_setSelected(brushes.back(), true);
+    }
+
+    Vector3 translation(16, 32, 64);
+    GlobalCommandSystem().executeCommand("MoveSelection", cmd::Argument(translation));
+
+    for (int i = 0; i < 512; ++i)
+    {
+        Vector3 expectedOrigin((i % 32) * 256 + 16, (i / 32) * 256 + 32, 64);
+
+        EXPECT_TRUE(math::isNear(brushes[i]->worldAABB().getOrigin(), expectedOrigin, 0.01)) << "Brush " << i << " not moved";
+        EXPECT_TRUE(math::isNear(brushes[i]->worldAABB().getExtents(), Vector3(64, 64, 64), 0.01)) << "Brush " << i << " changed size";
+        EXPECT_EQ(Node_getIBrush(brushes[i])->getNumFaces(), 6);
+    }
+
+    // Scale the whole selection around its center
+    auto pivot = GlobalSelectionSystem().getPivot2World().translation();
+    GlobalCommandSystem().executeCommand("ScaleSelected", cmd::Argument(Vector3(0.5, 0.5, 0.5)));
+
+    for (int i = 0; i < 512; ++i)
+    {
+        Vector3 expectedOrigin = pivot + (Vector3((i % 32) * 256 + 16, (i / 32) * 256 + 32, 64) - pivot) * 0.5;
+
+        EXPECT_TRUE(math::isNear(brushes[i]->worldAABB().getOrigin(), expectedOrigin, 0.01)) << "Brush " << i << " not scaled";
+        EXPECT_TRUE(math::isNear(brushes[i]->worldAABB().getExtents(), Vector3(32, 32, 32), 0.01)) << "Brush " << i << " not scaled";
+    }
+
+    // Both operations can be undone
+    GlobalUndoSystem().undo();
+    GlobalUndoSystem().undo();
+
+    for (int i = 0; i < 512; ++i)
+    {
+        Vector3 originalOrigin((i % 32) * 256, (i / 32) * 256, 0);
+        EXPECT_TRUE(math::isNear(brushes[i]->worldAABB().getOrigin(), originalOrigin, 0.01)) << "Brush " << i << " not restored";
+    }
+}
+
 }
@@ -0,0 +1,100 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include "util/TrigramIndex.h"
+
+namespace test
+{
+
+namespace
+{
+
+std::vector<int> findSorted(const util::TrigramIndex<int>& index, const std::string& needle)
+{
+    auto result = index.find(needle);
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+}
+
+TEST(TrigramIndexTest, FindSubstrings)
+{
+    util::TrigramIndex<int> index;
+
+    index.insert(1, "textures/darkmod/stone/brick/rough_big_blocks");
+    index.insert(2, "textures/common/caulk");
+    index.insert(3, "models/darkmod/architecture/brick_wall");
+
+    EXPECT_EQ(findSorted(index, "brick"), (std::vector<int>{ 1, 3 }));
+    EXPECT_EQ(findSorted(index, "darkmod/"), (std::vector<int>{ 1, 3 }));
+    EXPECT_EQ(findSorted(index, "caulk"), (std::vector<int>{ 2 }));
+
+    // All trigrams of the needle are present, but not in this order
+    EXPECT_TRUE(index.find("kcirb").empty());
+    EXPECT_TRUE(index.find("brickbrick").empty());
+    EXPECT_TRUE(index.find("nonexistent").empty());
+}
+
+TEST(TrigramIndexTest, FindShortNeedles)
+{
+    util::TrigramIndex<int> index;
+
+    index.insert(1, "abc");
+    index.insert(2, "xyz");
+    index.insert(3, "bc");
+
+    EXPECT_EQ(findSorted(index, "bc"), (std::vector<int>{ 1, 3 }));
+    EXPECT_EQ(findSorted(index, "x"), (std::vector<int>{ 2 }));
+    EXPECT_EQ(findSorted(index, ""), (std::vector<int>{ 1, 2, 3 })) << "Empty needle should match everything";
+}
+
+TEST(TrigramIndexTest, ReplaceAndErase)
+{
+    util::TrigramIndex<int> index;
+
+    index.insert(1, "brick");
+    index.insert(2, "stone");
+    EXPECT_EQ(index.size(), 2);
+
+    // Replacing the text of a key must remove the old text
+    index.insert(1, "wood");
+    EXPECT_EQ(index.size(), 2);
+    EXPECT_TRUE(index.find("brick").empty());
+    EXPECT_EQ(findSorted(index, "wood"), (std::vector<int>{ 1 }));
+
+    index.erase(2);
+    EXPECT_EQ(index.size(), 1);
+    EXPECT_TRUE(index.find("stone").empty());
+
+    // Erasing unknown keys is fine
+    index.erase(100);
+    EXPECT_EQ(index.size(), 1);
+}
+
+TEST(TrigramIndexTest, MatchesSurviveCompaction)
+{
+    util::TrigramIndex<int> index;
+
+    index.insert(1, "textures/base_wall/stone");
+
+    // Remove enough entries to trigger a rebuild of the posting lists
+    for (int i = 100; i < 1100; ++i)
+    {
+        index.insert(i, "textures/temp/stone_" + std::to_string(i));
+        index.erase(i);
+    }
+
+    index.insert(2, "textures/base_floor/stone");
+
+    EXPECT_EQ(index.size(), 2);
+    EXPECT_EQ(findSorted(index, "stone"), (std::vector<int>{ 1, 2 }));
+    EXPECT_EQ(findSorted(index, "base_wall"), (std::vector<int>{ 1 }));
+    EXPECT_TRUE(index.find("temp").empty());
+
+    index.clear();
+    EXPECT_TRUE(index.empty());
+    EXPECT_TRUE(index.find("stone").empty());
+}
+
+}
@@ -3,6 +3,8 @@
 #include <sigc++/connection.h>
 #include "iundo.h"
 #include "ibrush.h"
+#include "ipatch.h"
+#include "itransformable.h"
 #include "ieclass.h"
 #include "scene/Entity.h"
 #include "iscenegraphfactory.h"
@@ -12,6 +14,8 @@
 #include "algorithm/Scene.h"
 #include "algorithm/Primitives.h"
 #include "scenelib.h"
+#include "registry/registry.h"
+#include "DeltaUndoMemento.h"
 #include "scene/BasicRootNode.h"
 #include "testutil/FileSelectionHelper.h"
 
@@ -872,4 +876,231 @@ TEST_F(UndoTest, OperationTracking)
     EXPECT_EQ(tracker.receivedOperationName, "") << "Nothing should fire, already detached";
 }
 
+TEST_F(UndoTest, MemoryUsageTracking)
+{
+    auto entity = setupTestEntity();
+    auto sizeBefore = GlobalUndoSystem().getMemoryUsage();
+
+    {
+        UndoableCommand cmd("testOperation");
+        entity->tryGetEntity()->setKeyValue("largekey", std::string(64 * 1024, 'x'));
+    }
+
+    {
+        UndoableCommand cmd("secondOperation");
+        entity->tryGetEntity()->setKeyValue("largekey", "short");
+    }
+
+    // The second operation saved the large value, which must show up in the statistics
+    EXPECT_GT(GlobalUndoSystem().getMemoryUsage(), sizeBefore + 64 * 1024);
+
+    std::vector<std::string> operationNames;
+    GlobalUndoSystem().foreachUndoOperation([&](const std::string& name, std::size_t size)
+    {
+        operationNames.push_back(name);
+        EXPECT_GT(size, 0) << "Operation " << name << " reports no memory usage";
+    });
+
+    EXPECT_EQ(operationNames, std::vector<std::string>({ "testOperation", "secondOperation" }));
+}
+
+TEST_F(UndoTest, PatchChangesAreStoredAsDelta)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto patchNode = algorithm::createPatchFromBounds(worldspawn);
+    auto patch = Node_getIPatch(patchNode);
+
+    patch->setDims(31, 31);
+
+    for (std::size_t row = 0; row < patch->getHeight(); ++row)
+    {
+        for (std::size_t col = 0; col < patch->getWidth(); ++col)
+        {
+            patch->ctrlAt(row, col).vertex = Vector3(col * 16.0, row * 16.0, 0);
+            patch->ctrlAt(row, col).texcoord = Vector2(col, row);
+        }
+    }
+
+    patch->controlPointsChanged();
+
+    auto usageBefore = GlobalUndoSystem().getMemoryUsage();
+
+    {
+        UndoableCommand cmd("moveVertex");
+        patch->undoSave();
+        patch->ctrlAt(5, 7).vertex.z() = 64;
+        patch->controlPointsChanged();
+    }
+
+    // A full copy of the patch state would contain all 961 control points
+    EXPECT_LT(GlobalUndoSystem().getMemoryUsage() - usageBefore, 31 * 31 * sizeof(PatchControl) / 10)
+        << "The undo operation should only store the changed control point";
+
+    GlobalUndoSystem().undo();
+    EXPECT_EQ(patch->ctrlAt(5, 7).vertex, Vector3(7 * 16.0, 5 * 16.0, 0)) << "Control point has not been restored";
+    EXPECT_EQ(patch->ctrlAt(30, 30).vertex, Vector3(30 * 16.0, 30 * 16.0, 0)) << "Unchanged control point is wrong";
+    EXPECT_EQ(patch->getWidth(), 31);
+
+    GlobalUndoSystem().redo();
+    EXPECT_EQ(patch->ctrlAt(5, 7).vertex, Vector3(7 * 16.0, 5 * 16.0, 64)) << "Control point has not been redone";
+    EXPECT_EQ(patch->ctrlAt(5, 7).texcoord, Vector2(7, 5));
+
+    GlobalUndoSystem().undo();
+    EXPECT_EQ(patch->ctrlAt(5, 7).vertex, Vector3(7 * 16.0, 5 * 16.0, 0)) << "Control point has not been restored";
+}
+
+TEST_F(UndoTest, PatchChangedOutsideUndoIsNotMixedWithDelta)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto patchNode = algorithm::createPatchFromBounds(worldspawn);
+    auto patch = Node_getIPatch(patchNode);
+
+    {
+        UndoableCommand cmd("moveVertex");
+        patch->undoSave();
+        patch->ctrlAt(1, 1).vertex.z() = 64;
+        patch->controlPointsChanged();
+    }
+
+    // Modify the patch without saving its state, the delta doesn't fit anymore
+    patch->ctrlAt(0, 0).vertex = Vector3(-512, -512, -512);
+    patch->controlPointsChanged();
+
+    GlobalUndoSystem().undo();
+
+    // The delta is rejected rather than applied to the wrong state
+    EXPECT_EQ(patch->ctrlAt(1, 1).vertex.z(), 64) << "Delta should not have been applied";
+    EXPECT_EQ(patch->ctrlAt(0, 0).vertex, Vector3(-512, -512, -512)) << "Unsaved change should be untouched";
+}
+
+TEST_F(UndoTest, DeltaMementoChecksBaseState)
+{
+    undo::StateBuffer state;
+    undo::writeState(state, 1.0);
+    undo::writeState(state, std::string(40, 'a'));
+
+    undo::StateBuffer current;
+    undo::writeState(current, 2.0);
+    undo::writeState(current, std::string(40, 'a'));
+
+    undo::DeltaUndoMemento delta(state, current);
+
+    EXPECT_EQ(delta.apply(current), state) << "Delta should restore the full state";
+
+    // Same size, different contents
+    auto modified = current;
+    modified.back() = 'b';
+    EXPECT_THROW(delta.apply(modified), undo::InvalidStateError);
+
+    // Different size
+    undo::StateBuffer longer;
+    undo::writeState(longer, 2.0);
+    undo::writeState(longer, std::string(80, 'a'));
+    EXPECT_THROW(delta.apply(longer), undo::InvalidStateError);
+}
+
+TEST_F(UndoTest, StateReaderChecksBufferSize)
+{
+    undo::StateBuffer buffer;
+    undo::writeState(buffer, std::string(40, 'a'));
+
+    // The string length is intact, but the characters are cut off
+    buffer.resize(buffer.size() - 1);
+
+    std::string str;
+    EXPECT_THROW(undo::StateReader(buffer).read(str), undo::InvalidStateError);
+
+    undo::StateBuffer shortBuffer(4);
+    double value;
+    EXPECT_THROW(undo::StateReader(shortBuffer).read(value), undo::InvalidStateError);
+}
+
+TEST_F(UndoTest, TranslatedBrushIsStoredAsDelta)
+{
+    // Keep the texture projection unchanged when translating
+    registry::setValue(RKEY_ENABLE_TEXTURE_LOCK, false);
+
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto brushNode = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 0), "textures/darkmod/stone/brick/blocks_brown");
+    auto& brush = *Node_getIBrush(brushNode);
+
+    std::vector<Plane3> planesBefore;
+    algorithm::foreachFace(brush, [&](IFace& face) { planesBefore.push_back(face.getPlane3()); });
+
+    auto usageBefore = GlobalUndoSystem().getMemoryUsage();
+
+    {
+        UndoableCommand cmd("changeMaterial");
+        algorithm::foreachFace(brush, [&](IFace& face) { face.setShader("textures/numbers/1"); });
+    }
+
+    auto materialChangeUsage = GlobalUndoSystem().getMemoryUsage() - usageBefore;
+    GlobalUndoSystem().undo();
+
+    usageBefore = GlobalUndoSystem().getMemoryUsage();
+
+    {
+        UndoableCommand cmd("translateBrush");
+        scene::node_cast<ITransformable>(brushNode)->setTranslation(Vector3(0, 0, 32));
+        scene::node_cast<ITransformable>(brushNode)->freezeTransform();
+    }
+
+    // Both operations saved the same six faces, but translating along Z only changes
+    // the plane distances, while the material names are differing in many more bytes
+    EXPECT_LT(GlobalUndoSystem().getMemoryUsage() - usageBefore, materialChangeUsage)
+        << "The undo operation should only store the changed plane distances";
+
+    GlobalUndoSystem().undo();
+
+    std::vector<Plane3> planesAfterUndo;
+    algorithm::foreachFace(brush, [&](IFace& face) { planesAfterUndo.push_back(face.getPlane3()); });
+
+    EXPECT_EQ(planesAfterUndo, planesBefore) << "Brush planes have not been restored";
+    EXPECT_EQ(brush.getFace(0).getShader(), "textures/darkmod/stone/brick/blocks_brown");
+
+    GlobalUndoSystem().redo();
+
+    std::vector<Plane3> planesAfterRedo;
+    algorithm::foreachFace(brush, [&](IFace& face) { planesAfterRedo.push_back(face.getPlane3()); });
+
+    EXPECT_NE(planesAfterRedo, planesBefore) << "Translation has not been redone";
+
+    registry::setValue(RKEY_ENABLE_TEXTURE_LOCK, true);
+}
+
+TEST_F(UndoTest, MemoryLimitDropsOldestOperations)
+{
+    // Allow one megabyte of undo data
+    registry::setValue("user/ui/undo/memoryLimit", 1);
+
+    auto entity = setupTestEntity();
+    entity->tryGetEntity()->setKeyValue("largekey", std::string(256 * 1024, 'x'));
+
+    // Every operation saves the previous 256k value
+    for (int i = 0; i < 8; ++i)
+    {
+        UndoableCommand cmd("operation" + std::to_string(i));
+        entity->tryGetEntity()->setKeyValue("largekey", std::string(256 * 1024, 'a' + i));
+    }
+
+    EXPECT_LE(GlobalUndoSystem().getMemoryUsage(), 1024 * 1024) << "Undo memory limit exceeded";
+
+    std::vector<std::string> operationNames;
+    GlobalUndoSystem().foreachUndoOperation([&](const std::string& name, std::size_t)
+    {
+        operationNames.push_back(name);
+    });
+
+    EXPECT_GT(operationNames.size(), 0) << "The most recent operations should have been kept";
+    EXPECT_LT(operationNames.size(), 8) << "The oldest operations should have been dropped";
+    EXPECT_EQ(operationNames.back(), "operation7") << "The most recent operation must be the last one";
+
+    // The most recent operation can still be undone
+    GlobalUndoSystem().undo();
+    EXPECT_EQ(entity->tryGetEntity()->getKeyValue("largekey"), std::string(256 * 1024, 'g'));
+
+    // Zero means unlimited
+    registry::setValue("user/ui/undo/memoryLimit", 0);
+}
+
 }
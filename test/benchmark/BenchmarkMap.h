@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "ientity.h"
+#include "ieclass.h"
+#include "inode.h"
+#include "math/AABB.h"
+#include "scenelib.h"
+#include "string/convert.h"
+#include "../algorithm/Entity.h"
+#include "../algorithm/Primitives.h"
+#include "../algorithm/Scene.h"
+#include "BenchmarkReport.h"
+
+namespace test
+{
+
+/**
+ * Size of the procedurally generated benchmark map. The base counts are
+ * multiplied with the DRBENCH_SCALE environment variable (defaults to 1).
+ */
+struct BenchmarkMapSize
+{
+    std::size_t brushes = 4000;
+    std::size_t patches = 400;
+    std::size_t entities = 400;
+
+    static BenchmarkMapSize FromEnvironment()
+    {
+        BenchmarkMapSize size;
+
+        const auto* scaleValue = std::getenv("DRBENCH_SCALE");
+        auto scale = scaleValue != nullptr ? string::convert<double>(scaleValue, 1.0) : 1.0;
+
+        size.brushes = static_cast<std::size_t>(std::ceil(size.brushes * scale));
+        size.patches = static_cast<std::size_t>(std::ceil(size.patches * scale));
+        size.entities = static_cast<std::size_t>(std::ceil(size.entities * scale));
+
+        return size;
+    }
+
+    BenchmarkReport::Parameters toParameters() const
+    {
+        return { { "brushes", brushes }, { "patches", patches }, { "entities", entities } };
+    }
+};
+
+/**
+ * Generates a map laid out on a square grid in the XY plane: the brushes
+ * fill the ground level, patches and entities are placed above them.
+ * Every fourth entity is a light, every fourth a func_static referencing
+ * a model, the rest are carrying a couple of arbitrary spawnargs.
+ *
+ * The nodes are built without being part of the scene, such that the
+ * insertion into the scene graph (and its octree) can be measured separately.
+ */
+class BenchmarkMap
+{
+public:
+    static constexpr double GRID_SPACING = 128;
+
+private:
+    BenchmarkMapSize _size;
+    std::size_t _columns;
+
+    // The detached worldspawn holding all primitives, plus the other entities
+    std::vector<scene::INodePtr> _entities;
+    std::vector<scene::INodePtr> _brushes;
+
+public:
+    BenchmarkMap(const BenchmarkMapSize& size) :
+        _size(size),
+        _columns(static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(std::max(size.brushes, size.entities))))))
+    {
+        _columns = std::max<std::size_t>(_columns, 1);
+
+        auto worldspawn = algorithm::createEntityByClassName("worldspawn");
+        _entities.push_back(worldspawn);
+
+        for (std::size_t i = 0; i < _size.brushes; ++i)
+        {
+            _brushes.push_back(algorithm::createCuboidBrush(worldspawn,
+                AABB(getGridPosition(i, 0), Vector3(32, 32, 32)), getMaterial(i)));
+        }
+
+        // Spread the patches and entities evenly across the grid
+        for (std::size_t i = 0; i < _size.patches; ++i)
+        {
+            algorithm::createPatchFromBounds(worldspawn,
+                AABB(getGridPosition(i * _size.brushes / _size.patches, 96), Vector3(48, 48, 0)), getMaterial(i));
+        }
+
+        static const char* const MODELS[] =
+        {
+            "models/torch.lwo", "models/moss_patch.ase", "models/ase/testcube.ase", "models/cube_with_usemtl.obj"
+        };
+
+        for (std::size_t i = 0; i < _size.entities; ++i)
+        {
+            auto origin = getGridPosition(i * _size.brushes / _size.entities, 192);
+            EntityNodePtr entity;
+
+            switch (i % 4)
+            {
+            case 0:
+                entity = algorithm::createEntityByClassName("light");
+                entity->getEntity().setKeyValue("light_radius", "320 320 320");
+                entity->getEntity().setKeyValue("_color", "0.8 0.7 0.5");
+                break;
+            case 1:
+                entity = algorithm::createEntityByClassName("func_static");
+                entity->getEntity().setKeyValue("model", MODELS[(i / 4) % std::size(MODELS)]);
+                break;
+            default:
+                entity = algorithm::createEntityByClassName("info_player_start");
+                entity->getEntity().setKeyValue("angle", string::to_string((i * 45) % 360));
+                entity->getEntity().setKeyValue("target", "bench_target_" + string::to_string(i + 1));
+                entity->getEntity().setKeyValue("bench_index", string::to_string(i));
+                break;
+            }
+
+            entity->getEntity().setKeyValue("origin", string::to_string(origin));
+            _entities.push_back(entity);
+        }
+    }
+
+    // Adds the generated entities to the given root node
+    void insertInto(const scene::INodePtr& root)
+    {
+        // Replace the worldspawn of the new map
+        if (auto existing = algorithm::findWorldspawn(root); existing)
+        {
+            scene::removeNodeFromParent(existing);
+        }
+
+        for (const auto& entity : _entities)
+        {
+            scene::addNodeToContainer(entity, root);
+        }
+    }
+
+    const std::vector<scene::INodePtr>& getBrushes() const
+    {
+        return _brushes;
+    }
+
+    // Center of the given grid cell at the given height
+    Vector3 getGridPosition(std::size_t index, double z) const
+    {
+        return Vector3((index % _columns) * GRID_SPACING, (index / _columns) * GRID_SPACING, z);
+    }
+
+    // Bounds of all brushes
+    AABB getBrushBounds() const
+    {
+        AABB bounds;
+
+        for (const auto& brush : _brushes)
+        {
+            bounds.includeAABB(brush->worldAABB());
+        }
+
+        return bounds;
+    }
+
+private:
+    static std::string getMaterial(std::size_t index)
+    {
+        return "textures/numbers/" + string::to_string(index % 10);
+    }
+};
+
+}
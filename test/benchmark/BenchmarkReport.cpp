@@ -0,0 +1,107 @@
+#include "BenchmarkReport.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <numeric>
+#include "version.h"
+
+namespace test
+{
+
+namespace
+{
+    // Owned by the test framework
+    auto* const _report = static_cast<BenchmarkReport*>(
+        ::testing::AddGlobalTestEnvironment(new BenchmarkReport));
+
+    std::string getEnvironmentValue(const char* name, const std::string& defaultValue)
+    {
+        const auto* value = std::getenv(name);
+        return value != nullptr && *value != '\0' ? std::string(value) : defaultValue;
+    }
+}
+
+BenchmarkReport& BenchmarkReport::Instance()
+{
+    return *_report;
+}
+
+void BenchmarkReport::addResult(Result&& result)
+{
+    _results.emplace_back(std::move(result));
+}
+
+std::string BenchmarkReport::EscapeString(const std::string& str)
+{
+    std::string result;
+
+    for (auto c : str)
+    {
+        switch (c)
+        {
+        case '"': result += "\\\""; break;
+        case '\\': result += "\\\\"; break;
+        case '\n': result += "\\n"; break;
+        case '\t': result += "\\t"; break;
+        default: result += c;
+        }
+    }
+
+    return result;
+}
+
+void BenchmarkReport::TearDown()
+{
+    auto outputPath = getEnvironmentValue("DRBENCH_OUTPUT", "drbench.json");
+    std::ofstream stream(outputPath, std::ios::trunc);
+
+    if (!stream)
+    {
+        std::cerr << "Could not write benchmark results to " << outputPath << std::endl;
+        return;
+    }
+
+    stream << std::setprecision(9);
+    stream << "{\n";
+    stream << "  \"version\": \"" << EscapeString(RADIANT_VERSION) << "\",\n";
+    stream << "  \"revision\": \"" << EscapeString(getEnvironmentValue("DRBENCH_REVISION", "")) << "\",\n";
+    stream << "  \"timestamp\": " << std::time(nullptr) << ",\n";
+    stream << "  \"results\": [";
+
+    for (std::size_t r = 0; r < _results.size(); ++r)
+    {
+        const auto& result = _results[r];
+
+        auto total = std::accumulate(result.seconds.begin(), result.seconds.end(), 0.0);
+        auto minmax = std::minmax_element(result.seconds.begin(), result.seconds.end());
+        auto iterations = result.seconds.size();
+
+        stream << (r > 0 ? "," : "") << "\n    {\n";
+        stream << "      \"name\": \"" << EscapeString(result.name) << "\",\n";
+        stream << "      \"parameters\": {";
+
+        std::size_t p = 0;
+        for (const auto& [key, value] : result.parameters)
+        {
+            stream << (p++ > 0 ? ", " : " ") << "\"" << EscapeString(key) << "\": " << value;
+        }
+
+        stream << (result.parameters.empty() ? "},\n" : " },\n");
+        stream << "      \"iterations\": " << iterations << ",\n";
+        stream << "      \"totalSeconds\": " << total << ",\n";
+        stream << "      \"meanSeconds\": " << (iterations > 0 ? total / iterations : 0.0) << ",\n";
+        stream << "      \"minSeconds\": " << (iterations > 0 ? *minmax.first : 0.0) << ",\n";
+        stream << "      \"maxSeconds\": " << (iterations > 0 ? *minmax.second : 0.0) << "\n";
+        stream << "    }";
+    }
+
+    stream << "\n  ]\n}\n";
+
+    std::cout << "Wrote " << _results.size() << " benchmark results to " << outputPath << std::endl;
+}
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+
+namespace test
+{
+
+/**
+ * Collects the timings of all benchmarks run by the drbench executable and
+ * writes them to a JSON file once all benchmarks are done.
+ *
+ * The output path is taken from the DRBENCH_OUTPUT environment variable
+ * (defaulting to drbench.json in the working directory). The value of
+ * DRBENCH_REVISION is copied to the report, such that results can be
+ * tracked per commit.
+ */
+class BenchmarkReport :
+    public ::testing::Environment
+{
+public:
+    // Size parameters of the scene an operation has been measured on
+    using Parameters = std::map<std::string, std::size_t>;
+
+    struct Result
+    {
+        std::string name;
+        Parameters parameters;
+        std::vector<double> seconds; // one entry per iteration
+    };
+
+private:
+    std::vector<Result> _results;
+
+public:
+    // The instance registered with the test framework
+    static BenchmarkReport& Instance();
+
+    void addResult(Result&& result);
+
+    // Writes the JSON file
+    void TearDown() override;
+
+private:
+    static std::string EscapeString(const std::string& str);
+};
+
+/**
+ * Runs the operation the given number of times and adds the durations to the report.
+ * The optional reset function is invoked after every iteration (except the last)
+ * to restore the initial state, its duration is not measured.
+ */
+inline void measure(const std::string& name, const BenchmarkReport::Parameters& parameters,
+    std::size_t iterations, const std::function<void()>& operation,
+    const std::function<void()>& reset = std::function<void()>())
+{
+    BenchmarkReport::Result result{ name, parameters, {} };
+
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        operation();
+
+        result.seconds.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+        if (reset && i + 1 < iterations)
+        {
+            reset();
+        }
+    }
+
+    BenchmarkReport::Instance().addResult(std::move(result));
+}
+
+}
@@ -0,0 +1,25 @@
+#include "render/MeshSkinning.h"
+#include "SkinningGrid.h"
+#include "BenchmarkReport.h"
+
+namespace test
+{
+
+// Skins and re-calculates the normals of a vertex grid, as done by MD5 models for every animation frame
+TEST(ModelBenchmark, MD5Skinning)
+{
+    constexpr std::size_t NumJoints = 64;
+
+    SkinningGrid grid(200, NumJoints);
+
+    std::vector<MeshVertex> vertices(grid.data.getNumVertices());
+    std::vector<Vector3> triangleNormals;
+
+    measure("md5.skinning", { { "vertices", grid.data.getNumVertices() }, { "joints", NumJoints } }, 20, [&]()
+    {
+        render::skinVertices(grid.data, grid.jointMatrices, vertices);
+        render::calculateVertexNormals(grid.data, grid.indices, vertices, triangleNormals);
+    });
+}
+
+}
@@ -0,0 +1,232 @@
+#include "../RadiantTest.h"
+
+#include "ibrush.h"
+#include "imapformat.h"
+#include "imapresource.h"
+#include "irender.h"
+#include "iselection.h"
+#include "render/CamRenderer.h"
+#include "render/RenderableCollectionWalker.h"
+#include "render/View.h"
+#include "registry/registry.h"
+#include "scene/merge/GraphComparer.h"
+#include "../algorithm/View.h"
+#include "../testutil/FileSelectionHelper.h"
+#include "../testutil/TemporaryFile.h"
+#include "BenchmarkMap.h"
+#include "BenchmarkReport.h"
+
+namespace test
+{
+
+// Fixture generating the benchmark map in an empty scene
+class SceneBenchmark :
+    public RadiantTest
+{
+protected:
+    BenchmarkMapSize _size;
+    BenchmarkReport::Parameters _parameters;
+    std::unique_ptr<BenchmarkMap> _map;
+
+    void SetUp() override
+    {
+        RadiantTest::SetUp();
+
+        // CSG subtract would ask for confirmation first
+        registry::setValue("user/ui/brush/emitCSGSubtractWarning", false);
+
+        _size = BenchmarkMapSize::FromEnvironment();
+        _parameters = _size.toParameters();
+        _map = std::make_unique<BenchmarkMap>(_size);
+    }
+
+    void preShutdown() override
+    {
+        _map.reset();
+    }
+};
+
+TEST_F(SceneBenchmark, SceneInsertion)
+{
+    measure("scene.insert", _parameters, 1, [&]()
+    {
+        _map->insertInto(GlobalMapModule().getRoot());
+    });
+
+    EXPECT_EQ(algorithm::getChildCount(algorithm::findWorldspawn(GlobalMapModule().getRoot())),
+        _size.brushes + _size.patches);
+}
+
+TEST_F(SceneBenchmark, MapSaveLoadAndCompare)
+{
+    _map->insertInto(GlobalMapModule().getRoot());
+
+    auto mapPath = _context.getTemporaryDataPath() + "drbench.map";
+    TemporaryFile tempFile(mapPath);
+
+    FileSelectionHelper responder(mapPath, GlobalMapFormatManager().getMapFormatForFilename(mapPath));
+
+    measure("map.save", _parameters, 3, []()
+    {
+        GlobalCommandSystem().executeCommand("SaveMapCopyAs");
+    });
+
+    IMapResourcePtr resource;
+
+    measure("map.load", _parameters, 3, [&]()
+    {
+        resource = GlobalMapResourceManager().createFromPath(mapPath);
+        EXPECT_TRUE(resource->load());
+    });
+
+    measure("map.compare", _parameters, 3, [&]()
+    {
+        scene::merge::GraphComparer::Compare(resource->getRootNode(), GlobalMapModule().getRoot());
+    });
+}
+
+TEST_F(SceneBenchmark, PointAndAreaSelection)
+{
+    _map->insertInto(GlobalMapModule().getRoot());
+
+    const auto& brushes = _map->getBrushes();
+    ASSERT_FALSE(brushes.empty());
+
+    std::size_t index = 0;
+
+    measure("selection.point", _parameters, 100, [&]()
+    {
+        // Walk across the grid
+        const auto& brush = brushes[(index++ * 7919) % brushes.size()];
+
+        render::View view(false);
+        algorithm::constructCenteredOrthoview(view, brush->worldAABB().getOrigin());
+        auto test = algorithm::constructOrthoviewSelectionTest(view);
+
+        GlobalSelectionSystem().selectPoint(test, selection::SelectionSystem::eReplace, false);
+    });
+
+    measure("selection.area", _parameters, 20, [&]()
+    {
+        const auto& brush = brushes[(index++ * 7919) % brushes.size()];
+
+        render::View view(false);
+        algorithm::constructCenteredOrthoview(view, brush->worldAABB().getOrigin());
+
+        // Drag a rectangle across the whole view
+        ConstructSelectionTest(view, selection::Rectangle::ConstructFromArea(Vector2(-1, -1), Vector2(2, 2)));
+        SelectionVolume test(view);
+
+        GlobalSelectionSystem().selectArea(test, selection::SelectionSystem::eReplace, false);
+    });
+
+    EXPECT_GT(GlobalSelectionSystem().countSelected(), 1) << "Area selection should have selected several brushes";
+}
+
+TEST_F(SceneBenchmark, TransformSelection)
+{
+    _map->insertInto(GlobalMapModule().getRoot());
+
+    GlobalSelectionSystem().setSelectedAll(true);
+
+    double direction = 1;
+
+    measure("transform.move", _parameters, 10, [&]()
+    {
+        GlobalCommandSystem().executeCommand("MoveSelection", cmd::Argument(Vector3(8 * direction, 0, 0)));
+        direction = -direction;
+    });
+
+    measure("transform.rotate", _parameters, 4, []()
+    {
+        GlobalCommandSystem().executeCommand("RotateSelectionZ");
+    });
+}
+
+TEST_F(SceneBenchmark, CsgSubtract)
+{
+    _map->insertInto(GlobalMapModule().getRoot());
+
+    // Cut through the lower left quarter of the grid
+    auto bounds = _map->getBrushBounds();
+    auto cutterBounds = AABB(bounds.getOrigin() - bounds.getExtents() * 0.5,
+        Vector3(bounds.getExtents().x() * 0.5, bounds.getExtents().y() * 0.5, 16));
+
+    auto cutter = algorithm::createCuboidBrush(algorithm::findWorldspawn(GlobalMapModule().getRoot()),
+        cutterBounds, "textures/numbers/1");
+
+    auto selectCutter = [&]()
+    {
+        GlobalSelectionSystem().setSelectedAll(false);
+        Node_setSelected(cutter, true);
+    };
+
+    selectCutter();
+
+    measure("csg.subtract", _parameters, 3, []()
+    {
+        GlobalCommandSystem().executeCommand("CSGSubtract");
+    }, [&]()
+    {
+        GlobalCommandSystem().executeCommand("Undo");
+        selectCutter();
+    });
+}
+
+TEST_F(SceneBenchmark, RenderCollection)
+{
+    _map->insertInto(GlobalMapModule().getRoot());
+
+    // Look down on the whole map
+    render::View view(true);
+    algorithm::constructCameraView(view, _map->getBrushBounds(), Vector3(0, 0, -1), Vector3(-90, 0, 0));
+
+    render::CamRenderer::HighlightShaders shaders;
+    render::CamRenderer renderer(view, shaders);
+
+    RenderStateFlags fullBrightFlags = RENDER_DEPTHTEST | RENDER_MASKCOLOUR | RENDER_DEPTHWRITE | RENDER_ALPHATEST |
+        RENDER_BLEND | RENDER_CULLFACE | RENDER_OFFSETLINE | RENDER_VERTEX_COLOUR |
+        RENDER_FILL | RENDER_LIGHTING | RENDER_TEXTURE_2D | RENDER_SMOOTH | RENDER_SCALED;
+
+    RenderStateFlags litFlags = fullBrightFlags | RENDER_TEXTURE_CUBEMAP | RENDER_BUMP | RENDER_PROGRAM;
+
+    // The front end collection and the back end rendering are measured separately
+    auto renderFrames = [&](const std::string& name, const std::function<void()>& renderBackEnd)
+    {
+        BenchmarkReport::Result collect{ name + ".collect", _parameters, {} };
+        BenchmarkReport::Result draw{ name + ".render", _parameters, {} };
+
+        for (int i = 0; i < 10; ++i)
+        {
+            GlobalRenderSystem().startFrame();
+            renderer.prepare();
+
+            auto start = std::chrono::steady_clock::now();
+            render::RenderableCollectionWalker::CollectRenderablesInScene(renderer, view);
+            auto collected = std::chrono::steady_clock::now();
+            renderBackEnd();
+            auto rendered = std::chrono::steady_clock::now();
+
+            renderer.cleanup();
+            GlobalRenderSystem().endFrame();
+
+            collect.seconds.push_back(std::chrono::duration<double>(collected - start).count());
+            draw.seconds.push_back(std::chrono::duration<double>(rendered - collected).count());
+        }
+
+        BenchmarkReport::Instance().addResult(std::move(collect));
+        BenchmarkReport::Instance().addResult(std::move(draw));
+    };
+
+    renderFrames("render.fullbright", [&]()
+    {
+        GlobalRenderSystem().renderFullBrightScene(RenderViewType::Camera, fullBrightFlags, view);
+    });
+
+    renderFrames("render.lighting", [&]()
+    {
+        GlobalRenderSystem().renderLitScene(litFlags, view);
+    });
+}
+
+}
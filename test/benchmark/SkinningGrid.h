@@ -0,0 +1,81 @@
+#pragma once
+
+#include <random>
+#include <vector>
+#include "math/Quaternion.h"
+#include "math/Vector3.h"
+#include "render/MeshSkinning.h"
+
+namespace test
+{
+
+/**
+ * A regular grid of vertices, each attached to 1-4 out of a number of
+ * randomly placed joints. Used by the tests and benchmarks of the MD5
+ * skinning kernel, the random sequence is the same on every run.
+ */
+struct SkinningGrid
+{
+    struct Weight
+    {
+        std::size_t joint;
+        float t;
+        Vector3 v;
+    };
+
+    std::vector<Quaternion> rotations;
+    std::vector<Vector3> origins;
+    std::vector<render::JointMatrix> jointMatrices;
+
+    // The weights per vertex, the same weights are stored in the skinning data
+    std::vector<std::vector<Weight>> weights;
+    render::SkinningData data;
+
+    std::vector<unsigned int> indices;
+
+    SkinningGrid(std::size_t gridSize, std::size_t numJoints) :
+        weights(gridSize * gridSize)
+    {
+        std::mt19937 random(1234);
+        std::uniform_real_distribution<double> unit(-1.0, 1.0);
+
+        for (std::size_t i = 0; i < numJoints; ++i)
+        {
+            rotations.push_back(Quaternion(unit(random), unit(random), unit(random), unit(random)).getNormalised());
+            origins.emplace_back(unit(random) * 100, unit(random) * 100, unit(random) * 100);
+            jointMatrices.push_back(render::JointMatrix::fromRotationAndOrigin(rotations.back(), origins.back()));
+        }
+
+        for (std::size_t v = 0; v < weights.size(); ++v)
+        {
+            auto numWeights = 1 + v % 4;
+            Vector3 position(static_cast<double>(v % gridSize), static_cast<double>(v / gridSize), 0);
+
+            for (std::size_t k = 0; k < numWeights; ++k)
+            {
+                Weight weight{ (v * 7 + k * 13) % numJoints, 1.0f / numWeights, position + Vector3(unit(random), unit(random), unit(random)) };
+
+                weights[v].push_back(weight);
+                data.addWeight(weight.joint, weight.t, weight.v);
+            }
+
+            data.finishVertex();
+        }
+
+        auto rowSize = static_cast<unsigned int>(gridSize);
+
+        for (unsigned int y = 0; y + 1 < rowSize; ++y)
+        {
+            for (unsigned int x = 0; x + 1 < rowSize; ++x)
+            {
+                auto i = y * rowSize + x;
+                indices.insert(indices.end(), { i, i + 1, i + rowSize });
+                indices.insert(indices.end(), { i + 1, i + rowSize + 1, i + rowSize });
+            }
+        }
+
+        data.buildAdjacency(indices);
+    }
+};
+
+}